@@ -23,6 +23,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Globals.h"
 #include "Timer.h"
 #include "Logs.h"
+#include "sn_utils.h"
 
 TAnimContainer *TAnimModel::acAnimList = NULL;
 
@@ -417,6 +418,9 @@ TAnimModel::~TAnimModel()
 
 bool TAnimModel::Init(std::string const &asName, std::string const &asReplacableTexture)
 {
+    m_modelname = asName;
+    m_skinname = asReplacableTexture;
+
     if( asReplacableTexture.substr( 0, 1 ) == "*" ) {
         // od gwiazdki zaczynają się teksty na wyświetlaczach
         asText = asReplacableTexture.substr( 1, asReplacableTexture.length() - 1 ); // zapamiętanie tekstu
@@ -467,26 +471,8 @@ bool TAnimModel::Load(cParser *parser, bool ter)
     }
     else
     { // wiązanie świateł, o ile model wczytany
-        LightsOn[0] = pModel->GetFromName("Light_On00");
-        LightsOn[1] = pModel->GetFromName("Light_On01");
-        LightsOn[2] = pModel->GetFromName("Light_On02");
-        LightsOn[3] = pModel->GetFromName("Light_On03");
-        LightsOn[4] = pModel->GetFromName("Light_On04");
-        LightsOn[5] = pModel->GetFromName("Light_On05");
-        LightsOn[6] = pModel->GetFromName("Light_On06");
-        LightsOn[7] = pModel->GetFromName("Light_On07");
-        LightsOff[0] = pModel->GetFromName("Light_Off00");
-        LightsOff[1] = pModel->GetFromName("Light_Off01");
-        LightsOff[2] = pModel->GetFromName("Light_Off02");
-        LightsOff[3] = pModel->GetFromName("Light_Off03");
-        LightsOff[4] = pModel->GetFromName("Light_Off04");
-        LightsOff[5] = pModel->GetFromName("Light_Off05");
-        LightsOff[6] = pModel->GetFromName("Light_Off06");
-        LightsOff[7] = pModel->GetFromName("Light_Off07");
+        bind_lights();
     }
-    for (int i = 0; i < iMaxNumLights; ++i)
-        if (LightsOn[i] || LightsOff[i]) // Ra: zlikwidowałem wymóg istnienia obu
-            iNumLights = i + 1;
 
     std::string token;
     do {
@@ -916,17 +902,69 @@ TAnimModel::radius_() {
             0.f );
 }
 
+// binds light submodels of the loaded model
+void TAnimModel::bind_lights() {
+
+    LightsOn[0] = pModel->GetFromName("Light_On00");
+    LightsOn[1] = pModel->GetFromName("Light_On01");
+    LightsOn[2] = pModel->GetFromName("Light_On02");
+    LightsOn[3] = pModel->GetFromName("Light_On03");
+    LightsOn[4] = pModel->GetFromName("Light_On04");
+    LightsOn[5] = pModel->GetFromName("Light_On05");
+    LightsOn[6] = pModel->GetFromName("Light_On06");
+    LightsOn[7] = pModel->GetFromName("Light_On07");
+    LightsOff[0] = pModel->GetFromName("Light_Off00");
+    LightsOff[1] = pModel->GetFromName("Light_Off01");
+    LightsOff[2] = pModel->GetFromName("Light_Off02");
+    LightsOff[3] = pModel->GetFromName("Light_Off03");
+    LightsOff[4] = pModel->GetFromName("Light_Off04");
+    LightsOff[5] = pModel->GetFromName("Light_Off05");
+    LightsOff[6] = pModel->GetFromName("Light_Off06");
+    LightsOff[7] = pModel->GetFromName("Light_Off07");
+    for (int i = 0; i < iMaxNumLights; ++i)
+        if (LightsOn[i] || LightsOff[i]) // Ra: zlikwidowałem wymóg istnienia obu
+            iNumLights = i + 1;
+}
+
 // serialize() subclass details, sends content of the subclass to provided stream
 void
 TAnimModel::serialize_( std::ostream &Output ) const {
-    
-    // TODO: implement
+    // 3d shape and skin
+    sn_utils::s_str( Output, m_modelname );
+    sn_utils::s_str( Output, m_skinname );
+    // orientation
+    sn_utils::s_vec3( Output, vAngle );
+    // light submodels activation configuration
+    for( int lightidx = 0; lightidx < iMaxNumLights; ++lightidx ) {
+        sn_utils::ls_float32( Output, lsLights[ lightidx ] );
+        sn_utils::s_vec3( Output, m_lightcolors[ lightidx ] );
+    }
+    sn_utils::s_bool( Output, m_transition );
 }
 // deserialize() subclass details, restores content of the subclass from provided stream
 void
 TAnimModel::deserialize_( std::istream &Input ) {
-
-    // TODO: implement
+    // 3d shape and skin
+    auto const modelname { sn_utils::d_str( Input ) };
+    auto const skinname { sn_utils::d_str( Input ) };
+    // location was restored by the base class, so the textures can be prioritized the same as on text load
+    texture_manager::request_location( location() );
+    auto const isloaded { Init( modelname, skinname ) };
+    texture_manager::request_location( std::nullopt );
+    if( true == isloaded ) {
+        bind_lights();
+    }
+    else if( modelname != "notload" ) {
+        ErrorLog( "Missed file: " + modelname );
+    }
+    // orientation
+    vAngle = sn_utils::d_vec3( Input );
+    // light submodels activation configuration
+    for( int lightidx = 0; lightidx < iMaxNumLights; ++lightidx ) {
+        lsLights[ lightidx ] = sn_utils::ld_float32( Input );
+        m_lightcolors[ lightidx ] = sn_utils::d_vec3( Input );
+    }
+    m_transition = sn_utils::d_bool( Input );
 }
 
 // export() subclass details, sends basic content of the class in legacy (text) format to provided stream
@@ -179,6 +179,8 @@ private:
     void export_as_text_( std::ostream &Output ) const;
     // checks whether provided token is a legacy (text) format keyword
     bool is_keyword( std::string const &Token ) const;
+    // binds light submodels of the loaded model
+    void bind_lights();
 
 // members
     TAnimContainer *pRoot { nullptr }; // pojemniki sterujące, tylko dla aniomowanych submodeli
@@ -187,6 +189,8 @@ private:
     material_data m_materialdata;
 
     std::string asText; // tekst dla wyświetlacza znakowego
+    std::string m_modelname; // source name of the model, as provided on initialization
+    std::string m_skinname; // source name of the replacable skin, as provided on initialization
     TAnimAdvanced *pAdvanced { nullptr };
     // TODO: wrap into a light state struct, remove fixed element count
     int iNumLights { 0 };
@@ -40,6 +40,7 @@ class memory_table;
 class powergridsource_table;
 class instance_table;
 class vehicle_table;
+class ai_scheduler;
 class train_table;
 struct light_array;
 class particle_manager;
@@ -26,16 +26,20 @@ http://mozilla.org/MPL/2.0/.
 #include "MemCell.h"
 #include "simulation.h"
 #include "simulationtime.h"
+#include "Timer.h"
 #include "Track.h"
 #include "station.h"
 #include "keyboardinput.h"
 #include "utilities.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "application.h"
+#include "sn_utils.h"
 
 #define LOGVELOCITY 0
 #define LOGORDERS 1
 #define LOGSTOPS 1
 #define LOGBACKSCAN 0
-#define LOGPRESS 0
 
 // finds point of specified track nearest to specified event. returns: distance to that point from the specified end of the track
 // TODO: move this to file with all generic routines, too easy to forget it's here and it may come useful
@@ -50,7 +54,8 @@ ProjectEventOnTrack( basic_event const *Event, TTrack const *Track, double const
             ( 1.0 - nearestpoint ) * segment->GetLength() ); // measure from point2
 };
 
-double GetDistanceToEvent(TTrack const *track, basic_event const *event, double scan_dir, double start_dist, int iter = 0, bool back = false)
+// NOTE: if provided, the crossed flag is set when the search reaches beyond the specified track
+double GetDistanceToEvent(TTrack const *track, basic_event const *event, double scan_dir, double start_dist, int iter = 0, bool back = false, bool *crossed = nullptr)
 {
     if( track == nullptr ) { return start_dist; }
 
@@ -75,6 +80,9 @@ double GetDistanceToEvent(TTrack const *track, basic_event const *event, double
         sd = -sd; // jeśli tylko jeden krok tzn, że event przy poprzednim sprawdzaym torze
     if (((1 == krok) || (seg_len <= dzielnik) || (seg_len > (1.0 - dzielnik))) && (iter < 3))
     { // przejście na inny tor
+        if( crossed != nullptr ) {
+            *crossed = true;
+        }
         track = track->Connected(int(sd), sd);
         start_dist += (1 == krok) ? 0 : back ? -segment->GetLength() : segment->GetLength();
         if( ( track != nullptr )
@@ -86,7 +94,7 @@ double GetDistanceToEvent(TTrack const *track, basic_event const *event, double
             return start_dist;
         }
         else {
-            return GetDistanceToEvent( track, event, sd, start_dist, ++iter, 1 == krok ? true : false );
+            return GetDistanceToEvent( track, event, sd, start_dist, ++iter, 1 == krok ? true : false, crossed );
         }
     }
     else
@@ -99,6 +107,71 @@ double GetDistanceToEvent(TTrack const *track, basic_event const *event, double
     }
 };
 
+// shared cache of scan data derived from the track layout, reused by all drivers scanning the same paths
+// NOTE: only the placement of events is cached. velocities and signal states are still read by the drivers, as they can change at any time
+class route_cache {
+
+public:
+// types
+    struct event_point {
+        basic_event *event;
+        double offset; // distance from the scan entry point of the track to the place where the event applies
+    };
+    using eventpoint_sequence = std::vector<event_point>;
+// methods
+    // returns passive events of specified track for the given scan direction, in the order they're listed by the track
+    eventpoint_sequence const &
+        events( TTrack const *Track, double const Direction );
+
+private:
+// types
+    struct track_data {
+        eventpoint_sequence events;
+        std::uint32_t revision { 0 }; // layout revision the data was built for
+        bool layoutdependent { false }; // event placement depends on states of switches and has to be rebuilt when they change. always set for switches
+        bool valid { false };
+    };
+// members
+    std::unordered_map<TTrack const *, std::array<track_data, 2>> m_tracks;
+};
+
+route_cache::eventpoint_sequence const &
+route_cache::events( TTrack const *Track, double const Direction ) {
+
+    auto &data { m_tracks[ Track ][ ( Direction > 0 ? 1 : 0 ) ] };
+    // crossroads select their segment during the scan and turntables can move at any time, so data for these is never reused
+    auto const isvolatile { ( Track->eType == tt_Cross ) || ( Track->eType == tt_Table ) };
+
+    if( ( true == data.valid )
+     && ( false == isvolatile )
+     && ( ( false == data.layoutdependent )
+       || ( data.revision == TTrack::LayoutRevision() ) ) ) {
+        return data.events;
+    }
+
+    data.events.clear();
+    data.revision = TTrack::LayoutRevision();
+    // events of a switch are placed along its currently active segment, so they move whenever the switch changes state
+    data.layoutdependent = ( Track->eType == tt_Switch );
+    auto const &eventsequence { ( Direction > 0 ? Track->m_events2 : Track->m_events1 ) };
+    for( auto const &event : eventsequence ) {
+        if( ( event.second == nullptr )
+         || ( false == event.second->m_passive ) ) {
+            continue;
+        }
+        auto crossed { false };
+        data.events.push_back( {
+            event.second,
+            GetDistanceToEvent( Track, event.second, Direction, 0.0, 0, false, &crossed ) } );
+        data.layoutdependent |= crossed;
+    }
+    data.valid = true;
+
+    return data.events;
+}
+
+route_cache RouteCache;
+
 /*
 
 Moduł obsługujący sterowanie pojazdami (składami pociągów, samochodami).
@@ -458,19 +531,6 @@ void TController::TableClear()
     eSignSkip = nullptr; // nic nie pomijamy
 };
 
-std::vector<basic_event *> TController::CheckTrackEvent( TTrack *Track, double const fDirection ) const
-{ // sprawdzanie eventów na podanym torze do podstawowego skanowania
-    std::vector<basic_event *> events;
-    auto const &eventsequence { ( fDirection > 0 ? Track->m_events2 : Track->m_events1 ) };
-    for( auto const &event : eventsequence ) {
-        if( ( event.second != nullptr )
-         && ( event.second->m_passive ) ) {
-            events.emplace_back( event.second );
-        }
-    }
-    return events;
-}
-
 bool TController::TableAddNew()
 { // zwiększenie użytej tabelki o jeden rekord
     sSpeedTable.emplace_back(); // add a new slot
@@ -504,6 +564,7 @@ void TController::TableTraceRoute(double fDistance, TDynamicObject *pVehicle)
 { // skanowanie trajektorii na odległość (fDistance) od (pVehicle) w kierunku przodu składu i
     // uzupełnianie tabelki
     // WriteLog("Starting TableTraceRoute");
+    EU07_PROFILE_SCOPE( "TController::TableTraceRoute" );
 
     TTrack *pTrack{ nullptr }; // zaczynamy od ostatniego analizowanego toru
     double fTrackLength{ 0.0 }; // długość aktualnego toru (krótsza dla pierwszego)
@@ -597,8 +658,8 @@ void TController::TableTraceRoute(double fDistance, TDynamicObject *pVehicle)
                 WriteLog( "Speed table for " + OwnerName() + " tracing through track " + pTrack->name() );
             }
 
-            auto const events { CheckTrackEvent( pTrack, fLastDir ) };
-            for( auto *pEvent : events ) {
+            for( auto const &eventpoint : RouteCache.events( pTrack, fLastDir ) ) {
+                auto *pEvent { eventpoint.event };
                 if( pEvent != nullptr ) // jeśli jest semafor na tym torze
                 { // trzeba sprawdzić tabelkę, bo dodawanie drugi raz tego samego przystanku nie jest korzystne
                     if (TableNotFound(pEvent, fCurrentDistance)) // jeśli nie ma
@@ -617,7 +678,7 @@ void TController::TableTraceRoute(double fDistance, TDynamicObject *pVehicle)
 */
                         if( newspeedpoint.Set(
                             pEvent,
-                            GetDistanceToEvent( pTrack, pEvent, fLastDir, fCurrentDistance ),
+                            fCurrentDistance + eventpoint.offset,
                             fLength,
                             OrderCurrentGet() ) ) {
 
@@ -1831,22 +1892,20 @@ void TController::TableSort() {
         // we skip last slot and no point in checking if there's only one other entry
         return;
     }
-    TSpeedPos sp_temp = TSpeedPos(); // uzywany do przenoszenia
-    for( int i = 0; i < ( iLast - 1 ); ++i ) {
-        // pętla tylko do dwóch pozycji od końca bo ostatniej nie modyfikujemy
-        if (sSpeedTable[i].fDist > sSpeedTable[i + 1].fDist)
-        { // jesli pozycja wcześniejsza jest dalej to źle
-            sp_temp = sSpeedTable[i + 1];
-            sSpeedTable[i + 1] = sSpeedTable[i]; // zamiana
-            sSpeedTable[i] = sp_temp;
+    // the table is filled in roughly increasing order of distance, so insertion sort typically has little to move around
+    // NOTE: the last slot holds the point where the scan continues and is never moved
+    for( int i = 1; i < iLast; ++i ) {
+        for( int j = i; ( j > 0 ) && ( sSpeedTable[ j - 1 ].fDist > sSpeedTable[ j ].fDist ); --j ) {
+            // jesli pozycja wcześniejsza jest dalej to źle
+            std::swap( sSpeedTable[ j - 1 ], sSpeedTable[ j ] );
             // jeszcze sprawdzenie czy pozycja nie była indeksowana dla eventów
-            if (SemNextIndex == i)
+            if( SemNextIndex == j - 1 )
                 ++SemNextIndex;
-            else if (SemNextIndex == i + 1)
+            else if( SemNextIndex == j )
                 --SemNextIndex;
-            if (SemNextStopIndex == i)
+            if( SemNextStopIndex == j - 1 )
                 ++SemNextStopIndex;
-            else if (SemNextStopIndex == i + 1)
+            else if( SemNextStopIndex == j )
                 --SemNextStopIndex;
         }
     }
@@ -1914,46 +1973,12 @@ TController::TController(bool AI, TDynamicObject *NewControll, bool InitPsyche,
     SetDriverPsyche(); // na końcu, bo wymaga ustawienia zmiennych
     TableClear();
 
-    if( WriteLogFlag ) {
-#ifdef _WIN32
-        _mkdir( "physicslog" );
-#elif __linux__
-        mkdir( "physicslog", 0644 );
-#endif
-        LogFile.open( std::string( "physicslog/" + VehicleName + ".dat" ),
-            std::ios::in | std::ios::out | std::ios::trunc );
-#if LOGPRESS == 0
-        LogFile
-            << "Time[s] Velocity[m/s] Acceleration[m/ss] "
-            << "Coupler.Dist[m] Coupler.Force[N] TractionForce[kN] FrictionForce[kN] BrakeForce[kN] "
-            << "BrakePress[MPa] PipePress[MPa] MotorCurrent[A] "
-            << "MCP SCP BCP LBP Direction Command CVal1 CVal2 "
-            << "Security Wheelslip "
-            << "EngineTemp[Deg] OilTemp[Deg] WaterTemp[Deg] WaterAuxTemp[Deg]"
-            << "\r\n";
-        LogFile << std::fixed << std::setprecision( 4 );
-#endif
-#if LOGPRESS == 1
-        LogFile << string( "t\tVel\tAcc\tPP\tVVP\tBP\tBVP\tCVP" ).c_str() << "\n";
-#endif
-        LogFile.flush();
-    }
-
     // HACK: give the simulation a small window to potentially replace the AI with a human driver
     fActionTime = -5.0;
 };
 
-void TController::CloseLog()
-{
-    if (WriteLogFlag)
-    {
-        LogFile.close();
-    }
-};
-
 TController::~TController()
 { // wykopanie mechanika z roboty
-    CloseLog();
 };
 
 // zamiana kodu rozkazu na opis
@@ -2650,6 +2675,19 @@ TBrakeSystem TController::consist_brake_system() const {
     return ( isepcapable ? TBrakeSystem::ElectroPneumatic : TBrakeSystem::Pneumatic );
 }
 
+void TController::export_state( std::ostream &Output ) const {
+
+    sn_utils::s_bool( Output, AIControllFlag );
+    sn_utils::ls_int32( Output, static_cast<std::int32_t>( OrderCurrentGet() ) );
+    sn_utils::ls_int32( Output, iDrivigFlags );
+    sn_utils::ls_int32( Output, iDirection );
+    for( auto const value : {
+        VelDesired, AccDesired, AccPreferred, VelSignal, VelLimit, VelNext,
+        fStopTime, BrakeCtrlPosition, ReactionTime } ) {
+        sn_utils::ls_float64( Output, value );
+    }
+}
+
 int TController::OrderDirectionChange(int newdir, TMoverParameters *Vehicle)
 { // zmiana kierunku jazdy, niezależnie od kabiny
     int testd = newdir;
@@ -4881,54 +4919,7 @@ bool TController::PutCommand( std::string NewCommand, double NewValue1, double N
 
 void TController::PhysicsLog()
 { // zapis logu - na razie tylko wypisanie parametrów
-    if (LogFile.is_open())
-    {
-#if LOGPRESS == 0
-/*
-<< "Time[s] Velocity[m/s] Acceleration[m/ss] "
-<< "Coupler.Dist[m] Coupler.Force[N] TractionForce[kN] FrictionForce[kN] BrakeForce[kN] "
-<< "BrakePress[MPa] PipePress[MPa] MotorCurrent[A]    "
-<< "MCP SCP BCP LBP DmgFlag Command CVal1 CVal2 "
-<< "EngineTemp[Deg] OilTemp[Deg] WaterTemp[Deg] WaterAuxTemp[Deg]"
-*/
-        LogFile
-            << ElapsedTime << " "
-            << fabs(11.31 * mvOccupied->WheelDiameter * mvOccupied->nrot) << " "
-            << mvControlling->AccS << " "
-            << mvOccupied->Couplers[1].Dist << " "
-            << mvOccupied->Couplers[1].CForce << " "
-            << mvOccupied->Ft << " "
-            << mvOccupied->Ff << " "
-            << mvOccupied->Fb << " "
-            << mvOccupied->BrakePress << " "
-            << mvOccupied->PipePress << " "
-            << mvControlling->Im << " "
-            << int(mvControlling->MainCtrlPos) << " "
-            << int(mvControlling->ScndCtrlPos) << " "
-            << mvOccupied->fBrakeCtrlPos << " "
-            << mvOccupied->LocalBrakePosA << " "
-            << int(mvControlling->DirActive) << " "
-            << ( mvOccupied->CommandIn.Command.empty() ? "none" : mvOccupied->CommandIn.Command.c_str() ) << " "
-            << mvOccupied->CommandIn.Value1 << " "
-            << mvOccupied->CommandIn.Value2 << " "
-            << int(mvControlling->SecuritySystem.Status) << " "
-            << int(mvControlling->SlippingWheels) << " "
-            << mvControlling->dizel_heat.Ts << " "
-            << mvControlling->dizel_heat.To << " "
-            << mvControlling->dizel_heat.temperatura1 << " "
-            << mvControlling->dizel_heat.temperatura2
-            << "\r\n";
-#endif
-#if LOGPRESS == 1
-        LogFile << ElapsedTime << "\t" << fabs(11.31 * mvOccupied->WheelDiameter * mvOccupied->nrot)
-                << "\t";
-        LogFile << Controlling->AccS << "\t";
-        LogFile << mvOccupied->PipePress << "\t" << mvOccupied->CntrlPipePress << "\t"
-                << mvOccupied->BrakePress << "\t";
-        LogFile << mvOccupied->Volume << "\t" << mvOccupied->Hamulec->GetCRP() << "\n";
-#endif
-        LogFile.flush();
-    }
+    telemetry::record_vehicle( telemetry::Recorder, VehicleName, *mvOccupied, *mvControlling );
 };
 
 void
@@ -4940,10 +4931,15 @@ TController::Update( double const Timedelta ) {
     update_timers( Timedelta );
     update_logs( Timedelta );
 
-    auto const reactiontime { std::min( ReactionTime, 2.0 ) };
+    // drivers with nothing relevant nearby can get by with less frequent updates
+    auto const reactiontime { simulation::AIScheduler.interval( m_urgency, std::min( ReactionTime, 2.0 ) ) };
 
     if( LastReactionTime < reactiontime ) { return; }
+    auto const overdue { LastReactionTime - reactiontime };
+    if( false == simulation::AIScheduler.request( m_urgency, overdue ) ) { return; }
     LastReactionTime -= reactiontime;
+
+    auto const updatestart { std::chrono::steady_clock::now() };
 /*
     // TBD, TODO: put this in an appropriate place, or get rid of it
     // NOTE: this section moved all cars to the edge of their respective roads
@@ -4998,6 +4994,39 @@ TController::Update( double const Timedelta ) {
         control_tractive_and_braking_force();
     }
     SetTimeControllers();
+
+    m_urgency = update_urgency();
+    simulation::AIScheduler.complete( std::chrono::steady_clock::now() - updatestart, overdue );
+}
+
+// determines how soon the driver needs its next full update, based on current situation
+ai_scheduler::urgency
+TController::update_urgency() const {
+
+    if( false == AIControllFlag ) {
+        // hints for human drivers should keep up with their actions
+        return ai_scheduler::urgency::urgent;
+    }
+    if( mvOccupied->Vel < EU07_AI_MOVEMENT ) {
+        // waiting for a signal, passengers or departure time doesn't require quick reactions, but getting under way does
+        return (
+            ( ( false == is_active() ) || ( VelDesired == 0.0 ) ) ?
+                ai_scheduler::urgency::relaxed :
+                ai_scheduler::urgency::normal );
+    }
+    // distance left before the driver has to start braking for the nearest relevant point ahead
+    auto const margin { std::min<double>( ActualProximityDist, Obstacle.distance ) - fBrakeDist };
+    if( ( margin < 200.0 )
+     || ( AccDesired < EU07_AI_NOACCELERATION )
+     || ( mvOccupied->Vel > VelDesired + fVelPlus ) ) {
+        return ai_scheduler::urgency::urgent;
+    }
+    if( ( margin > 500.0 )
+     && ( std::abs( mvOccupied->Vel - VelDesired ) < 10.0 ) ) {
+        // cruising at desired speed
+        return ai_scheduler::urgency::relaxed;
+    }
+    return ai_scheduler::urgency::normal;
 }
 
 // configures vehicle heating given current situation; returns: true if vehicle can be operated normally, false otherwise
@@ -5966,6 +5995,7 @@ TController::update_logs( double const dt ) {
     // log vehicle data
     LastUpdatedTime += dt;
     if( ( WriteLogFlag )
+     && ( false == Global.PhysicsLogAllVehicles ) // in this mode the vehicle table takes care of the logging
      && ( LastUpdatedTime > deltalog ) ) {
         // zapis do pliku DAT
         PhysicsLog();
@@ -16,6 +16,7 @@ http://mozilla.org/MPL/2.0/.
 #include "DynObj.h"
 #include "mtable.h"
 #include "translation.h"
+#include "aischeduler.h"
 
 auto const EU07_AI_ACCELERATION = 0.05;
 auto const EU07_AI_NOACCELERATION = -0.05;
@@ -177,6 +178,7 @@ static const bool Humandriver = false;
 static const int maxorders = 64; // ilość rozkazów w tabelce
 static const int maxdriverfails = 4; // ile błędów może zrobić AI zanim zmieni nastawienie
 extern bool WriteLogFlag; // logowanie parametrów fizycznych
+extern double const deltalog; // odstęp między kolejnymi wpisami logu
 static const int BrakeAccTableSize = 20;
 
 static const int gbh_NP = -2; //odciecie w hamulcu ogolnym
@@ -253,6 +255,8 @@ public:
               || ( mvControlling->EngineType == TEngineType::DieselEngine ) );
     }
     TBrakeSystem consist_brake_system() const;
+    // sends dynamic state of the driver to provided stream, in binary format. used to compare state of the simulation between runs
+    void export_state( std::ostream &Output ) const;
 private:
     void Activation(); // umieszczenie obsady w odpowiednim członie
     void ControllingSet(); // znajduje człon do sterowania
@@ -299,6 +303,8 @@ private:
             return mvOccupied->Vel * sign( iDirection * mvOccupied->V ); }
 
     void update_timers( double const dt );
+    // determines how soon the driver needs its next full update, based on current situation
+    ai_scheduler::urgency update_urgency() const;
     void update_logs( double const dt );
     void determine_consist_state();
     void determine_braking_distance();
@@ -447,6 +453,7 @@ private:
     double DBT_MidPointAcc = 0;
     int StaticBrakeTest = 0; //is it necessary to make brake test while standing
     double LastReactionTime = 0.0;
+    ai_scheduler::urgency m_urgency { ai_scheduler::urgency::normal }; // situation assessed during last full update
     double fActionTime = 0.0; // czas używany przy regulacji prędkości i zamykaniu drzwi
     double m_radiocontroltime{ 0.0 }; // timer used to control speed of radio operations
 	double m_securitysystemreset { 1.0 }; // timer used to control speed of security system resetting
@@ -491,7 +498,6 @@ public:
     } //jak jedzie do tyłu to trzeba uwzględniać, że distance jest ujemna
 private:
     // Ra: metody obsługujące skanowanie toru
-    std::vector<basic_event *> CheckTrackEvent( TTrack *Track, double const fDirection ) const;
     bool TableAddNew();
     bool TableNotFound( basic_event const *Event, double const Distance ) const;
     void TableTraceRoute( double fDistance, TDynamicObject *pVehicle );
@@ -606,9 +612,7 @@ private:
 // logs
 // methods
     void PhysicsLog();
-    void CloseLog();
 // members
-    std::ofstream LogFile; // zapis parametrow fizycznych
     double LastUpdatedTime = 0.0; // czas od ostatniego logu
     double ElapsedTime = 0.0; // czas od poczatku logu
 
@@ -22,6 +22,9 @@ http://mozilla.org/MPL/2.0/.
 #include "Driver.h"
 #include "Globals.h"
 #include "Timer.h"
+#include "profiler.h"
+#include "jobsystem.h"
+#include "telemetry.h"
 #include "Logs.h"
 #include "Console.h"
 #include "MdlMngr.h"
@@ -29,6 +32,7 @@ http://mozilla.org/MPL/2.0/.
 #include "renderer.h"
 #include "uitranscripts.h"
 #include "messaging.h"
+#include "sn_utils.h"
 #include "Driver.h"
 
 // Ra: taki zapis funkcjonuje lepiej, ale może nie jest optymalny
@@ -2583,6 +2587,68 @@ void TDynamicObject::Move(double fDistance)
     }
 };
 
+// sends dynamic state of the vehicle to provided stream, in binary format. used to compare state of the simulation between runs
+void TDynamicObject::export_state( std::ostream &Output ) const
+{
+    Axle0.serialize( Output );
+    Axle1.serialize( Output );
+    sn_utils::ls_int32( Output, iAxleFirst );
+    // motion
+    for( auto const value : {
+        MoverParameters->V, MoverParameters->Vel, MoverParameters->AccS, MoverParameters->nrot,
+        MoverParameters->DistCounter, fAdjustment } ) {
+        sn_utils::ls_float64( Output, value );
+    }
+    // pneumatics
+    for( auto const value : {
+        MoverParameters->PipePress, MoverParameters->ScndPipePress, MoverParameters->BrakePress,
+        MoverParameters->Volume, MoverParameters->CompressedVolume, MoverParameters->Compressor,
+        MoverParameters->PantPress } ) {
+        sn_utils::ls_float64( Output, value );
+    }
+    // forces and power
+    for( auto const value : {
+        MoverParameters->Ft, MoverParameters->Fb, MoverParameters->Ff,
+        MoverParameters->Im, MoverParameters->Itot, MoverParameters->EnginePower,
+        MoverParameters->enrot, MoverParameters->dizel_fill, MoverParameters->RventRot } ) {
+        sn_utils::ls_float64( Output, value );
+    }
+    // controls
+    for( auto const value : {
+        MoverParameters->MainCtrlPos, MoverParameters->ScndCtrlPos,
+        MoverParameters->MainCtrlActualPos, MoverParameters->ScndCtrlActualPos,
+        MoverParameters->DirActive, MoverParameters->CabActive,
+        MoverParameters->BrakeCtrlPos,
+        ( MoverParameters->Hamulec ? MoverParameters->Hamulec->GetBrakeStatus() : 0 ),
+        MoverParameters->SecuritySystem.Status } ) {
+        sn_utils::ls_int32( Output, value );
+    }
+    for( auto const value : { MoverParameters->fBrakeCtrlPos, MoverParameters->LocalBrakePosA } ) {
+        sn_utils::ls_float64( Output, value );
+    }
+    // switches and devices
+    for( auto const value : {
+        MoverParameters->Mains, MoverParameters->ConverterFlag, MoverParameters->CompressorFlag,
+        MoverParameters->DynamicBrakeFlag, MoverParameters->SandDose, MoverParameters->Heating } ) {
+        sn_utils::s_bool( Output, value );
+    }
+    for( auto const &door : MoverParameters->Doors.instances ) {
+        sn_utils::ls_float64( Output, door.position );
+    }
+    // couplers and load
+    for( auto const &coupler : MoverParameters->Couplers ) {
+        sn_utils::ls_int32( Output, coupler.CouplingFlag );
+        sn_utils::ls_float64( Output, coupler.Dist );
+        sn_utils::ls_float64( Output, coupler.CForce );
+    }
+    sn_utils::ls_float64( Output, MoverParameters->LoadAmount );
+    // driver, if any
+    sn_utils::s_bool( Output, ( Mechanik != nullptr ) );
+    if( Mechanik != nullptr ) {
+        Mechanik->export_state( Output );
+    }
+}
+
 void TDynamicObject::AttachNext(TDynamicObject *Object, int iType)
 { // Ra: doczepia Object na końcu składu (nazwa funkcji może być myląca)
     // Ra: używane tylko przy wczytywaniu scenerii
@@ -2700,6 +2766,12 @@ float TDynamicObject::LoadExchangeSpeed() const {
     return exchangespeedfactor;
 }
 
+// returns true if there's load left to unload or load in current load change
+bool TDynamicObject::is_exchanging() const {
+
+    return ( ( m_exchange.unload_count >= 0.01 ) || ( m_exchange.load_count >= 0.01 ) );
+}
+
 // update state of load exchange operation
 void TDynamicObject::update_exchange( double const Deltatime ) {
 
@@ -8019,48 +8091,353 @@ TDynamicObject::powertrain_sounds::render( TMoverParameters const &Vehicle, doub
 }
 
 
+auto const EU07_VEHICLESLEEPDELAY { 5.0 }; // time an idle consist has to remain unchanged before its physics is suspended
+
 // legacy method, calculates changes in simulation state over specified time
 void
 vehicle_table::update( double Deltatime, int Iterationcount ) {
+
+    EU07_PROFILE_SCOPE( "vehicle_table::update" );
     // Ra: w zasadzie to trzeba by utworzyć oddzielną listę taboru do liczenia fizyki
     //    na którą by się zapisywały wszystkie pojazdy będące w ruchu
     //    pojazdy stojące nie potrzebują aktualizacji, chyba że np. ktoś im zmieni nastawę hamulca
     //    oddzielną listę można by zrobić na pojazdy z napędem, najlepiej posortowaną wg typu napędu
-    for( auto *vehicle : m_items ) {
+    // NOTE: consists which stay idle are moved to the sleeping set and skip mover physics, until disturbed
+    update_awake();
+    for( auto *vehicle : m_activeitems ) {
         if( false == vehicle->bEnabled ) { continue; }
-        // Ra: zmienić warunek na sprawdzanie pantografów w jednej zmiennej: czy pantografy i czy podniesione
-        if( vehicle->MoverParameters->EnginePowerSource.SourceType == TPowerSource::CurrentCollector ) {
-            update_traction( vehicle );
-        }
-        vehicle->MoverParameters->ComputeConstans();
-        vehicle->update_neighbours();
+        update_surroundings( vehicle );
+    }
+    if( true == update_collisions() ) {
+        update_awake();
     }
+    // force calculations are split into independent work units, which can be processed in parallel
+    // NOTE: movement is left on the main thread, as it modifies shared track data
+    update_workunits( Deltatime );
+
     if( Iterationcount > 1 ) {
         // ABu: ponizsze wykonujemy tylko jesli wiecej niz jedna iteracja
         for( int iteration = 0; iteration < ( Iterationcount - 1 ); ++iteration ) {
-            for( auto *vehicle : m_items ) {
-                vehicle->UpdateForce( Deltatime );
-            }
-            for( auto *vehicle : m_items ) {
+            update_forces( Deltatime );
+            for( auto *vehicle : m_activeitems ) {
                 vehicle->FastUpdate( Deltatime );
             }
         }
     }
-    for( auto *vehicle : m_items ) {
-        vehicle->UpdateForce( Deltatime );
-    }
+    update_forces( Deltatime );
 
     auto const totaltime { Deltatime * Iterationcount }; // całkowity czas
 
+    // sleeping vehicles are updated as well, only their surroundings and forces are left out above
     for( auto *vehicle : m_items ) {
         // Ra 2015-01: tylko tu przelicza sieć trakcyjną
         vehicle->Update( Deltatime, totaltime );
     }
 
+    update_asleep( totaltime );
+    if( ( true == WriteLogFlag )
+     && ( true == Global.PhysicsLogAllVehicles ) ) {
+        update_logs( totaltime );
+    }
     // jeśli jest coś do usunięcia z listy, to trzeba na końcu
     erase_disabled();
 }
 
+// updates traction, constants and collision sources of specified vehicle
+void
+vehicle_table::update_surroundings( TDynamicObject *Vehicle ) {
+
+    // Ra: zmienić warunek na sprawdzanie pantografów w jednej zmiennej: czy pantografy i czy podniesione
+    if( Vehicle->MoverParameters->EnginePowerSource.SourceType == TPowerSource::CurrentCollector ) {
+        update_traction( Vehicle );
+    }
+    Vehicle->MoverParameters->ComputeConstans();
+    Vehicle->update_neighbours();
+}
+
+// wakes up sleeping consists affected by outside changes, and rebuilds the set of active vehicles if needed
+void
+vehicle_table::update_awake() {
+
+    if( m_items.size() != m_itemcount ) {
+        m_activeitemsdirty = true;
+    }
+    // gather disturbed vehicles first, as waking them up modifies the sleeping set
+    type_sequence disturbedvehicles;
+    for( auto const &sleepingitem : m_sleepingitems ) {
+        if( ( false == Global.PhysicsSleep )
+         || ( false == is_idle( sleepingitem.first ) )
+         || ( true == is_disturbed( sleepingitem.first, sleepingitem.second ) ) ) {
+            disturbedvehicles.emplace_back( sleepingitem.first );
+        }
+    }
+    type_sequence wokenvehicles;
+    for( auto *vehicle : disturbedvehicles ) {
+        wake( vehicle, wokenvehicles );
+    }
+
+    if( false == m_activeitemsdirty ) { return; }
+
+    m_activeitems.clear();
+    for( auto *vehicle : m_items ) {
+        if( m_sleepingitems.find( vehicle ) == m_sleepingitems.end() ) {
+            m_activeitems.emplace_back( vehicle );
+        }
+    }
+    m_itemcount = m_items.size();
+    m_activeitemsdirty = false;
+}
+
+// wakes up sleeping consists within range of moving vehicles. returns: true if any consist was woken up
+bool
+vehicle_table::update_collisions() {
+
+    if( true == m_sleepingitems.empty() ) { return false; }
+
+    type_sequence wokenvehicles;
+    for( auto *vehicle : m_activeitems ) {
+        if( false == vehicle->bEnabled ) { continue; }
+        auto const *mover { vehicle->MoverParameters };
+        if( ( mover->Vel <= 0.0001 )
+         && ( std::abs( mover->AccS ) <= 0.0001 ) ) {
+            // stationary vehicles don't affect their neighbours
+            continue;
+        }
+        for( auto const &neighbour : mover->Neighbours ) {
+            if( ( neighbour.vehicle != nullptr )
+             && ( m_sleepingitems.find( neighbour.vehicle ) != m_sleepingitems.end() ) ) {
+                wake( neighbour.vehicle, wokenvehicles );
+            }
+        }
+    }
+    // woken vehicles missed the regular update of their surroundings, so we catch them up here
+    for( auto *vehicle : wokenvehicles ) {
+        update_surroundings( vehicle );
+    }
+
+    return ( false == wokenvehicles.empty() );
+}
+
+// puts to sleep consists which stayed idle long enough
+void
+vehicle_table::update_asleep( double const Deltatime ) {
+
+    if( false == Global.PhysicsSleep ) {
+        m_idleitems.clear();
+        return;
+    }
+    // track how long active vehicles stay in unchanged idle state...
+    for( auto *vehicle : m_activeitems ) {
+        if( false == is_idle( vehicle ) ) {
+            m_idleitems.erase( vehicle );
+            continue;
+        }
+        auto &idleitem { m_idleitems[ vehicle ] };
+        if( ( idleitem.time > 0.0 )
+         && ( false == is_disturbed( vehicle, idleitem.state ) ) ) {
+            idleitem.time += Deltatime;
+        }
+        else {
+            // (re)start tracking from current state
+            idleitem.time = Deltatime;
+            idleitem.state = idle_snapshot( vehicle );
+        }
+    }
+    // ...then put to sleep consists idle long enough as a whole
+    auto const isidlelongenough = [&]( TDynamicObject const *Vehicle ) {
+        auto const lookup { m_idleitems.find( Vehicle ) };
+        return ( ( lookup != m_idleitems.end() )
+              && ( lookup->second.time >= EU07_VEHICLESLEEPDELAY ) ); };
+
+    for( auto *vehicle : m_activeitems ) {
+        if( false == isidlelongenough( vehicle ) ) { continue; }
+
+        auto consistisidle { true };
+        vehicle->for_each(
+            coupling::coupler,
+            [&]( TDynamicObject *Vehicle ) {
+                consistisidle = ( consistisidle && isidlelongenough( Vehicle ) ); } );
+        if( false == consistisidle ) { continue; }
+
+        vehicle->for_each(
+            coupling::coupler,
+            [&]( TDynamicObject *Vehicle ) {
+                auto const lookup { m_idleitems.find( Vehicle ) };
+                m_sleepingitems.emplace( Vehicle, lookup->second.state );
+                m_idleitems.erase( lookup ); } );
+        m_activeitemsdirty = true;
+    }
+}
+
+// checks whether specified vehicle is in state which allows it to skip physics calculations
+bool
+vehicle_table::is_idle( TDynamicObject const *Vehicle ) const {
+
+    auto const *mover { Vehicle->MoverParameters };
+
+    return (
+        ( true == Vehicle->bEnabled )
+        // physics deactivation covers standstill, inactive cab and lack of moving neighbours
+     && ( false == mover->PhysicActivation )
+     && ( Vehicle->Mechanik == nullptr )
+     && ( false == Vehicle->MechInside )
+     && ( true == mover->CommandIn.Command.empty() )
+     && ( false == Vehicle->is_exchanging() )
+     && ( false == mover->CompressorFlag )
+     && ( std::none_of(
+            std::begin( mover->Pantographs ), std::end( mover->Pantographs ),
+            []( auto const &Pantograph ) {
+                return Pantograph.is_active; } ) )
+     && ( std::none_of(
+            std::begin( mover->Couplers ), std::end( mover->Couplers ),
+            []( TCoupling const &Coupler ) {
+                return ( ( Coupler.stretch_duration > 0.f ) || ( Coupler.sounds != 0 ) ); } ) ) );
+}
+
+// captures current state of specified vehicle
+vehicle_table::idle_state
+vehicle_table::idle_snapshot( TDynamicObject const *Vehicle ) const {
+
+    auto const *mover { Vehicle->MoverParameters };
+
+    return {
+        mover->PipePress,
+        mover->ScndPipePress,
+        mover->BrakePress,
+        { mover->Couplers[ end::front ].CouplingFlag, mover->Couplers[ end::rear ].CouplingFlag },
+        { mover->Couplers[ end::front ].Connected, mover->Couplers[ end::rear ].Connected } };
+}
+
+// checks whether state of specified vehicle differs from provided snapshot
+bool
+vehicle_table::is_disturbed( TDynamicObject const *Vehicle, idle_state const &State ) const {
+
+    auto const current { idle_snapshot( Vehicle ) };
+
+    return (
+        ( current.pipe_pressure != State.pipe_pressure )
+     || ( current.scndpipe_pressure != State.scndpipe_pressure )
+     || ( current.brake_pressure != State.brake_pressure )
+     || ( current.couplings != State.couplings )
+     || ( current.connections != State.connections ) );
+}
+
+// moves consist containing specified sleeping vehicle to the set of active vehicles, adding woken vehicles to provided list
+void
+vehicle_table::wake( TDynamicObject *Vehicle, type_sequence &Wokenvehicles ) {
+
+    auto const wakevehicle = [&]( TDynamicObject *Sleeper ) {
+        auto const lookup { m_sleepingitems.find( Sleeper ) };
+        if( lookup == m_sleepingitems.end() ) { return; }
+        m_sleepingitems.erase( lookup );
+        Wokenvehicles.emplace_back( Sleeper );
+        m_activeitemsdirty = true; };
+    // the vehicle itself may have been uncoupled from the rest, so make sure it gets woken up too
+    wakevehicle( Vehicle );
+    Vehicle->for_each( coupling::coupler, wakevehicle );
+}
+
+// splits enabled vehicles into independent work units
+void
+vehicle_table::update_workunits( double const Deltatime ) {
+
+    m_workunits.clear();
+
+    if( ( Global.PhysicsThreads <= 0 )
+     || ( threading::jobs.workers() == 0 ) ) {
+        return;
+    }
+
+    // each consist starts as a separate set...
+    std::unordered_map<TDynamicObject const *, std::size_t> vehiclesets;
+    std::vector<std::size_t> setparents;
+    for( auto *vehicle : m_activeitems ) {
+        if( false == vehicle->bEnabled ) { continue; }
+        if( vehiclesets.find( vehicle ) != vehiclesets.end() ) { continue; }
+        auto const set { setparents.size() };
+        setparents.emplace_back( set );
+        vehicle->for_each(
+            coupling::coupler,
+            [&]( TDynamicObject *Vehicle ) {
+                vehiclesets.emplace( Vehicle, set ); } );
+    }
+    auto const root = [&]( std::size_t Set ) {
+        while( setparents[ Set ] != Set ) {
+            setparents[ Set ] = setparents[ setparents[ Set ] ];
+            Set = setparents[ Set ]; }
+        return Set; };
+    // ...then sets interacting through buffers or loose couplings are merged together
+    for( auto *vehicle : m_activeitems ) {
+        if( false == vehicle->bEnabled ) { continue; }
+        auto const vehicleset { root( vehiclesets[ vehicle ] ) };
+        for( auto const &neighbour : vehicle->MoverParameters->Neighbours ) {
+            if( neighbour.vehicle == nullptr ) { continue; }
+            auto const lookup { vehiclesets.find( neighbour.vehicle ) };
+            if( lookup == vehiclesets.end() ) { continue; }
+            auto const neighbourset { root( lookup->second ) };
+            // lower set id becomes the root, so the unit order follows the vehicle sequence
+            setparents[ std::max( vehicleset, neighbourset ) ] = std::min( vehicleset, neighbourset );
+        }
+    }
+    // with sets established, build the units, retaining vehicle order from the main sequence
+    std::vector<std::size_t> setunits( setparents.size(), WORKUNIT_NONE );
+    for( auto *vehicle : m_activeitems ) {
+        if( false == vehicle->bEnabled ) { continue; }
+        auto &unit { setunits[ root( vehiclesets[ vehicle ] ) ] };
+        if( unit == WORKUNIT_NONE ) {
+            unit = m_workunits.size();
+            m_workunits.emplace_back();
+        }
+        m_workunits[ unit ].vehicles.emplace_back( vehicle );
+    }
+}
+
+// calculates forces acting on all enabled vehicles, processing work units in parallel when possible
+void
+vehicle_table::update_forces( double const Deltatime ) {
+
+    if( m_workunits.size() < 2 ) {
+        for( auto *vehicle : m_activeitems ) {
+            vehicle->UpdateForce( Deltatime );
+        }
+        return;
+    }
+    // units capable of damaging their couplers draw from the shared random number generator,
+    // these are kept on the main thread, to retain the sequence of draws from the serial update
+    auto parallelcount { m_workunits.size() };
+    for( auto &unit : m_workunits ) {
+        unit.serial =
+            std::any_of(
+                std::begin( unit.vehicles ), std::end( unit.vehicles ),
+                [=]( TDynamicObject const *Vehicle ) {
+                    return std::any_of(
+                        std::begin( Vehicle->MoverParameters->Couplers ), std::end( Vehicle->MoverParameters->Couplers ),
+                        [=]( TCoupling const &Coupler ) {
+                            return ( ( Coupler.stretch_duration > 0.f ) || ( Deltatime >= 1.0 ) ); } ); } );
+        if( unit.serial ) {
+            --parallelcount;
+        }
+    }
+    // main thread takes care of the serial units, then the rest is spread across the job system
+    for( auto const &unit : m_workunits ) {
+        if( false == unit.serial ) { continue; }
+        for( auto *vehicle : unit.vehicles ) {
+            vehicle->UpdateForce( Deltatime );
+        }
+    }
+    if( parallelcount == 0 ) { return; }
+
+    threading::jobs.parallel_for(
+        m_workunits.size(),
+        [&]( std::size_t const Index ) {
+            auto const &unit { m_workunits[ Index ] };
+            if( true == unit.serial ) { return; }
+            for( auto *vehicle : unit.vehicles ) {
+                vehicle->UpdateForce( Deltatime );
+            } },
+        Global.PhysicsThreads );
+}
+
 // legacy method, checks for presence and height of traction wire for specified vehicle
 void
 vehicle_table::update_traction( TDynamicObject *Vehicle ) {
@@ -8171,6 +8548,20 @@ vehicle_table::DynamicList( bool const Onlycontrolled ) const {
     multiplayer::WyslijString( "none", 6 );
 }
 
+// records state of all enabled vehicles in the physics log, in regular intervals
+void
+vehicle_table::update_logs( double const Deltatime ) {
+
+    m_logtime += Deltatime;
+    if( m_logtime <= deltalog ) { return; }
+    m_logtime -= deltalog;
+    // sleeping vehicles are included as well, so the recording of each vehicle has no gaps
+    for( auto *vehicle : m_items ) {
+        if( false == vehicle->bEnabled ) { continue; }
+        telemetry::record_vehicle( telemetry::Recorder, vehicle->name(), *vehicle->MoverParameters, *vehicle->MoverParameters );
+    }
+}
+
 // maintenance; removes from tracks consists with vehicles marked as disabled
 bool
 vehicle_table::erase_disabled() {
@@ -629,6 +629,8 @@ private:
     float LoadExchangeTime() const;
     // calculates current load exchange factor, where 1 = nominal rate, higher = faster
     float LoadExchangeSpeed() const; // TODO: make private when cleaning up
+    // returns true if there's load left to unload or load in current load change
+    bool is_exchanging() const;
     void LoadUpdate();
     void update_load_sections();
     void update_load_visibility();
@@ -639,6 +641,8 @@ private:
     bool FastUpdate(double dt);
     void Move(double fDistance);
     void FastMove(double fDistance);
+    // sends dynamic state of the vehicle to provided stream, in binary format. used to compare state of the simulation between runs
+    void export_state( std::ostream &Output ) const;
     void RenderSounds();
     inline Math3D::vector3 GetPosition() const {
         return vPosition; };
@@ -812,6 +816,7 @@ public:
 class vehicle_table : public basic_table<TDynamicObject> {
 
 public:
+// methods
     // legacy method, calculates changes in simulation state over specified time
     void
         update( double dt, int iter );
@@ -823,9 +828,72 @@ public:
         DynamicList( bool const Onlycontrolled = false ) const;
 
 private:
+// types
+    // set of vehicles which can interact with each other, but not with vehicles outside of the set
+    struct work_unit {
+        std::vector<TDynamicObject *> vehicles; // in the same order as in the main vehicle sequence
+        bool serial { false }; // unit has to be processed on the main thread
+    };
+    using workunit_sequence = std::vector<work_unit>;
+    // snapshot of vehicle state, used to detect changes made to idle vehicles
+    struct idle_state {
+        double pipe_pressure { 0.0 };
+        double scndpipe_pressure { 0.0 };
+        double brake_pressure { 0.0 };
+        std::array<int, 2> couplings { 0, 0 };
+        std::array<TMoverParameters const *, 2> connections { nullptr, nullptr };
+    };
+    struct idle_data {
+        double time { 0.0 }; // time spent in unchanged idle state
+        idle_state state;
+    };
+// constants
+    static std::size_t const WORKUNIT_NONE { std::numeric_limits<std::size_t>::max() }; // marks vehicle set without assigned unit
+// methods
     // maintenance; removes from tracks consists with vehicles marked as disabled
     bool
         erase_disabled();
+    // updates traction, constants and collision sources of specified vehicle
+    void
+        update_surroundings( TDynamicObject *Vehicle );
+    // wakes up sleeping consists affected by outside changes, and rebuilds the set of active vehicles if needed
+    void
+        update_awake();
+    // wakes up sleeping consists within range of moving vehicles. returns: true if any consist was woken up
+    bool
+        update_collisions();
+    // puts to sleep consists which stayed idle long enough
+    void
+        update_asleep( double const Deltatime );
+    // checks whether specified vehicle is in state which allows it to skip physics calculations
+    bool
+        is_idle( TDynamicObject const *Vehicle ) const;
+    // captures current state of specified vehicle
+    idle_state
+        idle_snapshot( TDynamicObject const *Vehicle ) const;
+    // checks whether state of specified vehicle differs from provided snapshot
+    bool
+        is_disturbed( TDynamicObject const *Vehicle, idle_state const &State ) const;
+    // moves consist containing specified sleeping vehicle to the set of active vehicles, adding woken vehicles to provided list
+    void
+        wake( TDynamicObject *Vehicle, type_sequence &Wokenvehicles );
+    // splits enabled vehicles into independent work units
+    void
+        update_workunits( double const Deltatime );
+    // calculates forces acting on all enabled vehicles, processing work units in parallel when possible
+    void
+        update_forces( double const Deltatime );
+    // records state of all enabled vehicles in the physics log, in regular intervals
+    void
+        update_logs( double const Deltatime );
+// members
+    type_sequence m_activeitems; // vehicles with active physics, in the same order as in the main vehicle sequence
+    std::unordered_map<TDynamicObject *, idle_state> m_sleepingitems; // vehicles with suspended physics
+    std::unordered_map<TDynamicObject const *, idle_data> m_idleitems; // active vehicles in idle state
+    std::size_t m_itemcount { 0 }; // size of the main vehicle sequence at the time of last active set rebuild
+    bool m_activeitemsdirty { true }; // set of active vehicles has to be rebuilt
+    workunit_sequence m_workunits;
+    double m_logtime { 0.0 }; // time since last physics log entry
 };
 
 
@@ -25,6 +25,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Console.h"
 #include "simulationtime.h"
 #include "utilities.h"
+#include "sn_utils.h"
 
 //---------------------------------------------------------------------------
 
@@ -247,14 +248,52 @@ TEventLauncher::radius_() {
 // serialize() subclass details, sends content of the subclass to provided stream
 void
 TEventLauncher::serialize_( std::ostream &Output ) const {
-
-    // TODO: implement
+    // activation
+    sn_utils::ls_float64( Output, dRadius );
+    sn_utils::ls_int32( Output, iKey );
+    sn_utils::ls_float64( Output, DeltaTime );
+    // scheduled activation is stored without the scenario time offset, which is applied anew on load
+    auto const timeoffset { static_cast<int>( Global.ScenarioTimeOffset * 60 ) };
+    auto const launchtime { (
+        ( iHour >= 0 ) && ( timeoffset != 0 ) ?
+            clamp_circular( iHour * 60 + iMinute - timeoffset, 24 * 60 ) :
+            iHour * 60 + iMinute ) };
+    sn_utils::ls_int32( Output, ( iHour >= 0 ? launchtime / 60 : iHour ) );
+    sn_utils::ls_int32( Output, ( iHour >= 0 ? launchtime % 60 : iMinute ) );
+    // events
+    sn_utils::s_str( Output, asEvent1Name );
+    sn_utils::s_str( Output, asEvent2Name );
+    // conditions
+    sn_utils::s_str( Output, asMemCellName );
+    sn_utils::ls_int32( Output, iCheckMask );
+    sn_utils::s_str( Output, szText );
+    sn_utils::ls_float64( Output, fVal1 );
+    sn_utils::ls_float64( Output, fVal2 );
 }
 // deserialize() subclass details, restores content of the subclass from provided stream
 void
 TEventLauncher::deserialize_( std::istream &Input ) {
-
-    // TODO: implement
+    // activation
+    dRadius = sn_utils::ld_float64( Input );
+    iKey = sn_utils::ld_int32( Input );
+    DeltaTime = sn_utils::ld_float64( Input );
+    iHour = sn_utils::ld_int32( Input );
+    iMinute = sn_utils::ld_int32( Input );
+    auto const timeoffset { static_cast<int>( Global.ScenarioTimeOffset * 60 ) };
+    if( ( iHour >= 0 ) && ( timeoffset != 0 ) ) {
+        auto const adjustedtime { clamp_circular( iHour * 60 + iMinute + timeoffset, 24 * 60 ) };
+        iHour = ( adjustedtime / 60 ) % 24;
+        iMinute = adjustedtime % 60;
+    }
+    // events
+    asEvent1Name = sn_utils::d_str( Input );
+    asEvent2Name = sn_utils::d_str( Input );
+    // conditions
+    asMemCellName = sn_utils::d_str( Input );
+    iCheckMask = sn_utils::ld_int32( Input );
+    szText = sn_utils::d_str( Input );
+    fVal1 = sn_utils::ld_float64( Input );
+    fVal2 = sn_utils::ld_float64( Input );
 }
 
 // export() subclass details, sends basic content of the class in legacy (text) format to provided stream
@@ -31,7 +31,9 @@ http://mozilla.org/MPL/2.0/.
 #include "Driver.h"
 #include "renderer.h"
 #include "Timer.h"
+#include "profiler.h"
 #include "Logs.h"
+#include "sn_utils.h"
 
 void
 basic_event::event_conditions::bind( basic_event::node_sequence *Nodes ) {
@@ -2331,37 +2333,7 @@ event_manager::AddToQuery( basic_event *Event, TDynamicObject const *Owner ) {
                     + Event->m_delaydeparture;
             }
         }
-        if( QueryRootEvent != nullptr ) {
-            basic_event *target { QueryRootEvent };
-            basic_event *previous { nullptr };
-            while( ( Event->m_launchtime >= target->m_launchtime )
-                && ( target->m_next != nullptr ) ) {
-                previous = target;
-                target = target->m_next;
-            }
-            // the new event will be either before or after the one we located
-            if( Event->m_launchtime >= target->m_launchtime ) {
-                assert( target->m_next == nullptr );
-                target->m_next = Event;
-                // if we have resurrected event land at the end of list, the link from previous run could potentially "add" unwanted events to the queue
-                Event->m_next = nullptr;
-            }
-            else {
-                if( previous != nullptr ) {
-                    previous->m_next = Event;
-                    Event->m_next = target;
-                }
-                else {
-                    // special case, we're inserting our event at the very start
-                    Event->m_next = QueryRootEvent;
-                    QueryRootEvent = Event;
-                }
-            }
-        }
-        else {
-            QueryRootEvent = Event;
-            QueryRootEvent->m_next = nullptr;
-        }
+        queue_push( { Event->m_launchtime, m_queuesequence++, Event } );
     }
 
     return true;
@@ -2371,21 +2343,29 @@ event_manager::AddToQuery( basic_event *Event, TDynamicObject const *Owner ) {
 bool
 event_manager::CheckQuery() {
 
-    while( ( QueryRootEvent != nullptr )
-        && ( QueryRootEvent->m_launchtime < Timer::GetTime() ) )
+    EU07_PROFILE_SCOPE( "event_manager::CheckQuery" );
+    auto const time { Timer::GetTime() };
+
+    while( ( false == m_eventqueue.empty() )
+        && ( m_eventqueue.front().launch_time < time ) )
     { // eventy są posortowana wg czasu wykonania
-        m_workevent = QueryRootEvent; // wyjęcie eventu z kolejki
-        if (QueryRootEvent->m_sibling) // jeśli jest kolejny o takiej samej nazwie
+        auto const entry { queue_pop() }; // wyjęcie eventu z kolejki
+        m_workevent = entry.event;
+        if (m_workevent->m_sibling) // jeśli jest kolejny o takiej samej nazwie
         { // to teraz on będzie następny do wykonania
-            QueryRootEvent = QueryRootEvent->m_sibling; // następny będzie ten doczepiony
-            QueryRootEvent->m_next = m_workevent->m_next; // pamiętając o następnym z kolejki
-            QueryRootEvent->m_launchtime = m_workevent->m_launchtime; // czas musi być ten sam, bo nie jest aktualizowany
-            QueryRootEvent->m_activator = m_workevent->m_activator; // pojazd aktywujący
-            QueryRootEvent->m_inqueue = 1;
-            // w sumie można by go dodać normalnie do kolejki, ale trzeba te połączone posortować wg czasu wykonania
-        }
-        else // a jak nazwa jest unikalna, to kolejka idzie dalej
-            QueryRootEvent = QueryRootEvent->m_next; // NULL w skrajnym przypadku
+            auto *sibling { m_workevent->m_sibling };
+            sibling->m_launchtime = m_workevent->m_launchtime; // czas musi być ten sam, bo nie jest aktualizowany
+            sibling->m_activator = m_workevent->m_activator; // pojazd aktywujący
+            sibling->m_inqueue = 1;
+            // the sibling takes over position of the event in the queue, including its insertion sequence
+            queue_push( { entry.launch_time, entry.sequence, sibling } );
+        }
+        // a jak nazwa jest unikalna, to kolejka idzie dalej
+        ++m_queuestats.executed;
+        auto const latency { time - entry.launch_time };
+        m_queuestats.latency_total += latency;
+        m_queuestats.latency_max = std::max( m_queuestats.latency_max, latency );
+
         if( ( false == m_workevent->m_ignored ) && ( false == m_workevent->m_passive ) ) {
             // w zasadzie te wyłączone są skanowane i nie powinny się nigdy w kolejce znaleźć
             --(m_workevent->m_inqueue); // teraz moze być ponownie dodany do kolejki
@@ -2395,6 +2375,81 @@ event_manager::CheckQuery() {
     return true;
 }
 
+// places provided entry in the event queue
+void
+event_manager::queue_push( queue_entry const &Entry ) {
+
+    m_eventqueue.emplace_back( Entry );
+    std::push_heap( std::begin( m_eventqueue ), std::end( m_eventqueue ), queue_order() );
+    m_queuestats.depth_peak = std::max( m_queuestats.depth_peak, m_eventqueue.size() );
+}
+
+// removes the earliest entry from the event queue
+event_manager::queue_entry
+event_manager::queue_pop() {
+
+    std::pop_heap( std::begin( m_eventqueue ), std::end( m_eventqueue ), queue_order() );
+    auto const entry { m_eventqueue.back() };
+    m_eventqueue.pop_back();
+
+    return entry;
+}
+
+// retrieves up to specified number of queued events accepted by optional filter, in order of their execution
+std::vector<basic_event const *>
+event_manager::queued( std::size_t const Count, std::function<bool( basic_event const * )> const &Filter ) const {
+
+    std::vector<basic_event const *> events;
+    if( ( Count == 0 ) || ( m_eventqueue.empty() ) ) { return events; }
+    events.reserve( std::min( Count, m_eventqueue.size() ) );
+    // best-first walk of the binary heap: the earliest entry not yet visited is always either the root
+    // or a child of an already visited entry, so we keep these candidates in a small heap of their own.
+    // NOTE: relies on the std heap layout, with children of entry n placed at 2n+1 and 2n+2
+    auto const order {
+        [ this ]( std::size_t const Left, std::size_t const Right ) {
+            return queue_order()( m_eventqueue[ Left ], m_eventqueue[ Right ] ); } };
+    std::vector<std::size_t> candidates { 0 };
+    while( ( false == candidates.empty() )
+        && ( events.size() < Count ) ) {
+        std::pop_heap( std::begin( candidates ), std::end( candidates ), order );
+        auto const index { candidates.back() };
+        candidates.pop_back();
+        auto const *event { m_eventqueue[ index ].event };
+        if( ( !Filter ) || ( true == Filter( event ) ) ) {
+            events.emplace_back( event );
+        }
+        for( auto const child : { 2 * index + 1, 2 * index + 2 } ) {
+            if( child < m_eventqueue.size() ) {
+                candidates.emplace_back( child );
+                std::push_heap( std::begin( candidates ), std::end( candidates ), order );
+            }
+        }
+    }
+    return events;
+}
+
+// sends content of the event queue to provided stream, in binary format
+void
+event_manager::serialize_queue( std::ostream &Output ) const {
+
+    sn_utils::ls_uint64( Output, m_queuesequence );
+    sn_utils::ls_uint32( Output, m_eventqueue.size() );
+    for( auto const &entry : m_eventqueue ) {
+        // events sharing the same name are identified by their position in the chain of siblings
+        auto *event { m_events[ m_eventmap.at( entry.event->m_name ) ] };
+        std::uint32_t sibling { 0 };
+        while( ( event != entry.event ) && ( event != nullptr ) ) {
+            event = event->m_sibling;
+            ++sibling;
+        }
+        sn_utils::s_str( Output, entry.event->m_name );
+        sn_utils::ls_uint32( Output, sibling );
+        sn_utils::ls_float64( Output, entry.launch_time );
+        sn_utils::ls_uint64( Output, entry.sequence );
+        sn_utils::s_str( Output, entry.event->m_activator != nullptr ? entry.event->m_activator->name() : "" );
+    }
+}
+
 // legacy method, initializes events after deserialization from scenario file
 void
 event_manager::InitEvents() {
@@ -2405,6 +2460,20 @@ event_manager::InitEvents() {
     }
 }
 
+// returns all event launchers, input driven launchers first
+std::vector<TEventLauncher *>
+event_manager::launchers() const {
+
+    std::vector<TEventLauncher *> launchers;
+    for( auto *launcher : m_inputdrivenlaunchers.sequence() ) {
+        if( launcher != nullptr ) { launchers.emplace_back( launcher ); }
+    }
+    for( auto *launcher : m_radiodrivenlaunchers.sequence() ) {
+        if( launcher != nullptr ) { launchers.emplace_back( launcher ); }
+    }
+    return launchers;
+}
+
 // legacy method, initializes event launchers after deserialization from scenario file
 void
 event_manager::InitLaunchers() {
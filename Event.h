@@ -81,7 +81,6 @@ public:
     scene::group_handle group() const;
 	std::string const &name() const { return m_name; }
 // members
-    basic_event *m_next { nullptr }; // następny w kolejce // TODO: replace with event list in the manager
     basic_event *m_sibling { nullptr }; // kolejny event z tą samą nazwą - od wersji 378
     std::string m_name;
     bool m_ignored { false }; // replacement for tp_ignored
@@ -638,14 +637,26 @@ public:
                 Launcher->IsRadioActivated() ?
                     m_radiodrivenlaunchers.insert( Launcher ) :
                     m_inputdrivenlaunchers.insert( Launcher ) ); }
-    // returns first event in the queue
+    // retrieves up to specified number of queued events accepted by optional filter, in order of their execution.
+    // only the examined part of the queue is visited, so the cost depends on the count rather than on the queue size
+    std::vector<basic_event const *>
+        queued( std::size_t const Count, std::function<bool( basic_event const * )> const &Filter = nullptr ) const;
+    // returns number of events in the queue
     inline
-    basic_event *
-        begin() {
-            return QueryRootEvent; }
+    std::size_t
+        queue_size() const {
+            return m_eventqueue.size(); }
+    // returns event queue statistics
+    inline
+    auto const &
+        queue_stats() const {
+            return m_queuestats; }
     // legacy method, returns pointer to specified event, or null
     basic_event *
         FindEvent( std::string const &Name );
+    // returns all event launchers, input driven launchers first
+    std::vector<TEventLauncher *>
+        launchers() const;
 	inline TEventLauncher* FindEventlauncher(std::string const &Name) {
 		auto ptr = m_inputdrivenlaunchers.find(Name);
 		return ptr ? ptr : m_radiodrivenlaunchers.find(Name);
@@ -665,20 +676,49 @@ public:
     // sends basic content of the class in legacy (text) format to provided stream
     void
         export_as_text( std::ostream &Output ) const;
+    // sends content of the event queue to provided stream, in binary format
+    void
+        serialize_queue( std::ostream &Output ) const;
+
+// types
+    struct queue_statistics {
+        std::size_t depth_peak { 0 }; // highest number of simultaneously queued events
+        std::size_t executed { 0 }; // number of events taken from the queue for execution
+        double latency_max { 0.0 }; // longest time between scheduled and actual execution, in seconds
+        double latency_total { 0.0 }; // sum of times between scheduled and actual execution, in seconds
+    };
 
 private:
 // types
     using event_sequence = std::deque<basic_event *>;
     using event_map = std::unordered_map<std::string, std::size_t>;
     using eventlauncher_sequence = std::vector<TEventLauncher *>;
+    // event queue entry. events with the same launch time are ordered by their insertion sequence
+    struct queue_entry {
+        double launch_time;
+        std::uint64_t sequence;
+        basic_event *event;
+    };
+    // heap ordering predicate, places the earliest entry at the top
+    struct queue_order {
+        bool operator()( queue_entry const &Left, queue_entry const &Right ) const {
+            return (
+                Left.launch_time != Right.launch_time ?
+                    Left.launch_time > Right.launch_time :
+                    Left.sequence > Right.sequence ); } };
+    using queue_heap = std::vector<queue_entry>;
+// methods
+    // places provided entry in the event queue
+    void
+        queue_push( queue_entry const &Entry );
+    // removes the earliest entry from the event queue
+    queue_entry
+        queue_pop();
 // members
     event_sequence m_events;
-/*
-    // NOTE: disabled until event class refactoring
-    event_sequence m_eventqueue;
-*/
-    // legacy version of the above
-    basic_event *QueryRootEvent { nullptr };
+    queue_heap m_eventqueue; // binary heap of queued events, ordered by launch time
+    std::uint64_t m_queuesequence { 0 }; // insertion counter for the event queue
+    queue_statistics m_queuestats;
     basic_event *m_workevent { nullptr };
     event_map m_eventmap;
     basic_table<TEventLauncher> m_inputdrivenlaunchers;
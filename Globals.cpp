@@ -179,6 +179,16 @@ global_settings::ConfigParse(cParser &Parser) {
             Parser >> PausedVolume;
             PausedVolume = clamp( PausedVolume, 0.f, 1.f );
         }
+        else if( token == "sound.voices" ) {
+            Parser.getTokens();
+            Parser >> AudioVoices;
+            AudioVoices = std::max( 1, AudioVoices );
+        }
+        else if( token == "sound.streaming.threshold" ) {
+            Parser.getTokens();
+            Parser >> AudioStreamingThreshold;
+            AudioStreamingThreshold = std::max( 0.f, AudioStreamingThreshold );
+        }
         // else if (str==AnsiString("renderalpha")) //McZapkie-1312302 - dwuprzebiegowe renderowanie
         // bRenderAlpha=(GetNextSymbol().LowerCase()==AnsiString("yes"));
         else if (token == "physicslog")
@@ -187,11 +197,46 @@ global_settings::ConfigParse(cParser &Parser) {
             Parser.getTokens();
             Parser >> WriteLogFlag;
         }
+        else if (token == "physicslog.allvehicles")
+        {
+            Parser.getTokens();
+            Parser >> PhysicsLogAllVehicles;
+        }
         else if (token == "fullphysics")
         { // McZapkie-291103 - usypianie fizyki
             Parser.getTokens();
             Parser >> FullPhysics;
         }
+        else if (token == "physics.threads")
+        {
+            Parser.getTokens(1, false);
+            Parser >> PhysicsThreads;
+        }
+        else if (token == "ai.relaxedinterval")
+        {
+            Parser.getTokens(1, false);
+            Parser >> AIRelaxedInterval;
+        }
+        else if (token == "ai.framebudget")
+        {
+            Parser.getTokens(1, false);
+            Parser >> AIFrameBudget;
+        }
+        else if (token == "jobs.threads")
+        {
+            Parser.getTokens(1, false);
+            Parser >> JobThreads;
+        }
+        else if (token == "physics.sleep")
+        {
+            Parser.getTokens(1, false);
+            Parser >> PhysicsSleep;
+        }
+        else if (token == "powergrid.solver")
+        {
+            Parser.getTokens(1, false);
+            Parser >> PowerGridSolver;
+        }
         else if (token == "debuglog")
         {
             // McZapkie-300402 - wylaczanie log.txt
@@ -220,6 +265,16 @@ global_settings::ConfigParse(cParser &Parser) {
             Parser.getTokens();
             Parser >> DisabledLogTypes;
         }
+        else if (token == "logs.async")
+        {
+            Parser.getTokens();
+            Parser >> AsyncLogs;
+        }
+        else if (token == "logs.lossy")
+        {
+            Parser.getTokens();
+            Parser >> LossyLogs;
+        }
         else if (token == "mousescale")
         {
             // McZapkie-060503 - czulosc ruchu myszy (krecenia glowa)
@@ -483,6 +538,12 @@ global_settings::ConfigParse(cParser &Parser) {
             Parser.getTokens(1, false);
             Parser >> file_binary_terrain;
         }
+        else if (token == "file.preload")
+        {
+            // background loading of included scenario files
+            Parser.getTokens(1, false);
+            Parser >> file_preload;
+        }
         else if (token == "inactivepause")
         {
             // automatyczna pauza, gdy okno nieaktywne
@@ -888,6 +949,11 @@ global_settings::ConfigParse_gfx( cParser &Parser, std::string_view const Token
         Parser.getTokens();
         Parser >> ResourceMove;
     }
+    else if (Token == "gfx.resource.streaming")
+    {
+        Parser.getTokens();
+        Parser >> ResourceStreaming;
+    }
     else if (Token == "gfx.reflections.framerate")
     {
         auto const updatespersecond{std::abs(Parser.getToken<double>())};
@@ -1057,11 +1123,22 @@ global_settings::export_as_text( std::ostream &Output ) const {
     export_as_text( Output, "sound.volume.positional", EnvironmentPositionalVolume );
     export_as_text( Output, "sound.volume.ambient", EnvironmentAmbientVolume );
     export_as_text( Output, "sound.volume.paused", PausedVolume );
+    export_as_text( Output, "sound.voices", AudioVoices );
+    export_as_text( Output, "sound.streaming.threshold", AudioStreamingThreshold );
     export_as_text( Output, "physicslog", WriteLogFlag );
+    export_as_text( Output, "physicslog.allvehicles", PhysicsLogAllVehicles );
     export_as_text( Output, "fullphysics", FullPhysics );
+    export_as_text( Output, "physics.threads", PhysicsThreads );
+    export_as_text( Output, "physics.sleep", PhysicsSleep );
+    export_as_text( Output, "powergrid.solver", PowerGridSolver );
+    export_as_text( Output, "ai.relaxedinterval", AIRelaxedInterval );
+    export_as_text( Output, "ai.framebudget", AIFrameBudget );
+    export_as_text( Output, "jobs.threads", JobThreads );
     export_as_text( Output, "debuglog", iWriteLogEnabled );
     export_as_text( Output, "multiplelogs", MultipleLogs );
     export_as_text( Output, "logs.filter", DisabledLogTypes );
+    export_as_text( Output, "logs.async", AsyncLogs );
+    export_as_text( Output, "logs.lossy", LossyLogs );
     Output
         << "mousescale "
         << fMouseXScale << " "
@@ -1108,6 +1185,7 @@ global_settings::export_as_text( std::ostream &Output ) const {
     export_as_text( Output, "createswitchtrackbeds", CreateSwitchTrackbeds );
     export_as_text( Output, "gfx.resource.sweep", ResourceSweep );
     export_as_text( Output, "gfx.resource.move", ResourceMove );
+    export_as_text( Output, "gfx.resource.streaming", ResourceStreaming );
     export_as_text( Output, "gfx.reflections.framerate", 1.0 / reflectiontune.update_interval );
     export_as_text( Output, "gfx.reflections.fidelity", reflectiontune.fidelity );
     export_as_text( Output, "timespeed", fTimeSpeed );
@@ -1115,6 +1193,7 @@ global_settings::export_as_text( std::ostream &Output ) const {
     export_as_text( Output, "latitude", fLatitudeDeg );
     export_as_text( Output, "convertmodels", iConvertModels + ( iConvertModels > 0 ? 128 : 0 ) );
     export_as_text( Output, "file.binary.terrain", file_binary_terrain );
+    export_as_text( Output, "file.preload", file_preload );
     export_as_text( Output, "inactivepause", bInactivePause );
     export_as_text( Output, "slowmotion", iSlowMotionMask );
     export_as_text( Output, "hideconsole", bHideConsole );
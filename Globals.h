@@ -68,11 +68,14 @@ struct global_settings {
     std::string SceneryFile{ "td.scn" };
     std::string local_start_vehicle{ "EU07-424" };
     int iConvertModels{ 0 }; // tworzenie plików binarnych
-    bool file_binary_terrain{ true }; // enable binary terrain (de)serialization
+    bool file_binary_terrain{ true }; // enable binary scene (terrain, memory cells, event launchers, model instances) (de)serialization
+    bool file_preload{ true }; // files included by the scenario are loaded ahead by background threads
     // logs
     int iWriteLogEnabled{ 3 }; // maska bitowa: 1-zapis do pliku, 2-okienko, 4-nazwy torów
     bool MultipleLogs{ false };
     unsigned int DisabledLogTypes{ 0 };
+    bool AsyncLogs{ true }; // log entries are written to disk by a background thread
+    bool LossyLogs{ false }; // log entries are discarded instead of stalling the caller, when the log queue is full
     // simulation
     bool RealisticControlMode{ false }; // controls ability to steer the vehicle from outside views
     bool bEnableTraction{ true };
@@ -86,6 +89,13 @@ struct global_settings {
     std::string Weather{ "cloudy:" }; // current weather
     std::string Period{}; // time of the day, based on sun position
     bool FullPhysics{ true }; // full calculations performed for each simulation step
+    bool PhysicsLogAllVehicles{ false }; // physics log records every vehicle rather than only these with a driver
+    int PhysicsThreads{ 0 }; // job system workers used for vehicle force calculations. 0: serial update
+    int JobThreads{ -1 }; // worker threads of the shared job system. -1: one less than the number of cpu cores
+    bool PhysicsSleep{ false }; // idle consists skip physics calculations until disturbed
+    bool PowerGridSolver{ false }; // traction voltages come from power flow model of the whole network, rather than estimate for each span
+    double AIRelaxedInterval{ 1.0 }; // seconds between full updates of ai drivers with nothing relevant nearby
+    float AIFrameBudget{ 2.f }; // msec per frame for full ai driver updates which can be deferred. 0: unlimited
     bool bnewAirCouplers{ true };
     float fMoveLight{ 0.f }; // numer dnia w roku albo -1
     bool FakeLight{ false }; // toggle between fixed and dynamic daylight
@@ -146,6 +156,7 @@ struct global_settings {
     float SmokeFidelity{ 1.f }; // determines amount of generated smoke particles
     bool ResourceSweep{ true }; // gfx resource garbage collection
     bool ResourceMove{ false }; // gfx resources are moved between cpu and gpu side instead of sending a copy
+    bool ResourceStreaming{ true }; // gfx resource data is loaded by background threads
     bool compress_tex{ true }; // all textures are compressed on gpu side
     std::string asSky{ "1" };
     float fFpsAverage{ 0.f }; // oczekiwana wartosć FPS
@@ -160,6 +171,8 @@ struct global_settings {
     float EnvironmentPositionalVolume{ 1.0f };
     float EnvironmentAmbientVolume{ 1.0f };
     float PausedVolume { 0.15f };
+    int AudioVoices { 64 }; // max number of simultaneously emitted sounds. sounds above the limit are tracked silently until they're loud enough to get a voice
+    float AudioStreamingThreshold { 2.f }; // decoded size of sound file in MB, above which the file is streamed during playback rather than loaded whole. 0: disabled
     std::string AudioRenderer;
     // input
     float fMouseXScale{ 1.5f };
@@ -236,6 +249,20 @@ struct global_settings {
     std::optional<std::pair<std::string, std::string>> network_client;
     double desync = 0.0;
 
+    // headless simulation run, configured from the command line
+    bool headless { false }; // run the simulation without window, renderer and audio
+    std::string headless_replay; // command log recorded by the network server, replayed instead of fixed step run if set
+    std::string headless_hashes { "headless_hashes.txt" }; // per-frame state hashes are written to this file
+    int headless_frames { 0 }; // number of frames to run, 0 for the whole replay or 60 seconds of fixed step run
+    double headless_timestep { 0.01 }; // simulation time advanced per frame in fixed step run
+    std::string headless_report; // per-subsystem frame cost report in json format is written to this file, if set
+    std::string headless_benchmark; // layout of synthetic scenario generated and run instead of the specified one, if set
+    int headless_benchmarksize { 0 }; // scale of the synthetic scenario, 0 for layout default
+    std::string headless_benchmarkvehicle { "pkp/eu07_v1,eu07-424,eu07" }; // data folder, skin and model of vehicles in synthetic scenario
+    // offline conversion of physics log, configured from the command line
+    std::string telemetry_input; // telemetry recording converted to text instead of running the simulation, if set
+    std::string telemetry_output; // comma separated text output of the conversion. default: input file name with .csv extension
+
     float m_skysaturationcorrection{ 1.65f };
     float m_skyhuecorrection{ 0.5f };
 
@@ -48,52 +48,225 @@ std::string filename_scenery() {
     }
 }
 
-void WriteLog( const char *str, logtype const Type ) {
+// destination of a log entry
+enum class log_target {
+    log,
+    errors
+};
 
-    if( str == nullptr ) { return; }
-    if( true == TestFlag( Global.DisabledLogTypes, static_cast<unsigned int>( Type ) ) ) { return; }
+// sends provided text to specified log destination
+// NOTE: caller is expected to hold the log lock
+void write_entry( log_target const Target, std::string const &Text ) {
 
-    if (Global.iWriteLogEnabled & 1) {
-        if( !output.is_open() ) {
+    switch( Target ) {
+        case log_target::log: {
+            if( Global.iWriteLogEnabled & 1 ) {
+                if( !output.is_open() ) {
 
-            std::string const filename =
-                ( Global.MultipleLogs ?
-                    "logs/log (" + filename_scenery() + ") " + filename_date() + ".txt" :
-                    "log.txt" );
-            output.open( filename, std::ios::trunc );
+                    std::string const filename =
+                        ( Global.MultipleLogs ?
+                            "logs/log (" + filename_scenery() + ") " + filename_date() + ".txt" :
+                            "log.txt" );
+                    output.open( filename, std::ios::trunc );
+                }
+                output << Text << "\n";
+            }
+            if( Global.iWriteLogEnabled & 2 ) {
+                // hunter-271211: pisanie do konsoli tylko, gdy nie jest ukrywana
+                SetConsoleTextAttribute( GetStdHandle( STD_OUTPUT_HANDLE ), FOREGROUND_GREEN | FOREGROUND_INTENSITY );
+                DWORD wr = 0;
+                WriteConsole( GetStdHandle( STD_OUTPUT_HANDLE ), Text.c_str(), (DWORD)Text.size(), &wr, NULL );
+                WriteConsole( GetStdHandle( STD_OUTPUT_HANDLE ), endstring, (DWORD)strlen( endstring ), &wr, NULL );
+            }
+            break;
         }
-        output << str << "\n";
-        output.flush();
-    }
+        case log_target::errors: {
+            if (!errors.is_open()) {
 
-    if( Global.iWriteLogEnabled & 2 ) {
-        // hunter-271211: pisanie do konsoli tylko, gdy nie jest ukrywana
-        SetConsoleTextAttribute( GetStdHandle( STD_OUTPUT_HANDLE ), FOREGROUND_GREEN | FOREGROUND_INTENSITY );
-        DWORD wr = 0;
-        WriteConsole( GetStdHandle( STD_OUTPUT_HANDLE ), str, (DWORD)strlen( str ), &wr, NULL );
-        WriteConsole( GetStdHandle( STD_OUTPUT_HANDLE ), endstring, (DWORD)strlen( endstring ), &wr, NULL );
+                std::string const filename =
+                    ( Global.MultipleLogs ?
+                        "logs/errors (" + filename_scenery() + ") " + filename_date() + ".txt" :
+                        "errors.txt" );
+                errors.open( filename, std::ios::trunc );
+                errors << "EU07.EXE " + Global.asVersion << "\n";
+            }
+            errors << Text << "\n";
+            break;
+        }
+        default: {
+            break;
+        }
     }
 }
 
+// collects log entries from any thread and writes them to disk in batches, on a background thread
+class log_sink {
+
+public:
+// constructors
+    log_sink() {
+        for( std::size_t idx = 0; idx < m_slots.size(); ++idx ) {
+            m_slots[ idx ].sequence = idx; } }
+// destructor
+    // NOTE: the sink is expected to be stopped explicitly before the program exit; at this point other globals
+    // (including the settings used by write_entry) can be gone already, so we only make sure the thread is joined
+    ~log_sink() {
+        m_exit = true;
+        if( m_writer.joinable() ) {
+            m_writer.join(); } }
+// methods
+    // adds provided entry to the log, either directly or through the background writer
+    void
+        insert( log_target const Target, std::string Text ) {
+            if( ( false == Global.AsyncLogs )
+             || ( true == m_exit ) ) {
+                std::lock_guard<std::timed_mutex> lock( m_lock );
+                // the writer could have been started earlier; entries still in its queue go first, to retain the order
+                drain();
+                write_entry( Target, Text );
+                flush_streams();
+                return; }
+            std::call_once( m_started, [this]() { start(); } );
+            while( false == push( Target, Text ) ) {
+                if( true == Global.LossyLogs ) {
+                    // under overload discard the entry, but keep track of the loss
+                    ++m_dropped;
+                    return; }
+                if( true == m_exit ) {
+                    // the writer was stopped in the meantime, make the room ourselves
+                    std::lock_guard<std::timed_mutex> lock( m_lock );
+                    drain();
+                    continue; }
+                // otherwise wait for the writer to make some room
+                std::this_thread::yield(); } }
+    // writes all queued entries to disk. returns: true if the writer was able to complete the task
+    bool
+        flush() {
+            std::unique_lock<std::timed_mutex> lock( m_lock, std::chrono::seconds( 1 ) );
+            // NOTE: if the lock can't be acquired, e.g. due to a crash inside the writer, we give up
+            if( false == lock.owns_lock() ) { return false; }
+            drain();
+            return true; }
+    // stops the background writer, after writing all pending entries
+    void
+        stop() {
+            m_exit = true;
+            if( m_writer.joinable() ) {
+                m_writer.join(); }
+            std::lock_guard<std::timed_mutex> lock( m_lock );
+            drain(); }
+
+private:
+// types
+    struct log_slot {
+        std::atomic<std::size_t> sequence { 0 };
+        log_target target { log_target::log };
+        std::string text;
+    };
+// constants
+    static std::size_t const SLOTCOUNT { 4096 }; // NOTE: has to be power of two
+// methods
+    void
+        start() {
+            m_writer = std::thread( &log_sink::run, this ); }
+    // places provided entry in the queue. returns: false if the queue is full
+    bool
+        push( log_target const Target, std::string &Text ) {
+            auto position { m_enqueueposition.load( std::memory_order_relaxed ) };
+            log_slot *slot;
+            while( true ) {
+                slot = &m_slots[ position & ( SLOTCOUNT - 1 ) ];
+                auto const sequence { slot->sequence.load( std::memory_order_acquire ) };
+                auto const difference { static_cast<std::intptr_t>( sequence ) - static_cast<std::intptr_t>( position ) };
+                if( difference == 0 ) {
+                    // slot is free, try to claim it
+                    if( m_enqueueposition.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+                        break; } }
+                else if( difference < 0 ) {
+                    // slot still holds unprocessed entry from the previous lap
+                    return false; }
+                else {
+                    // another producer claimed the slot, catch up
+                    position = m_enqueueposition.load( std::memory_order_relaxed ); } }
+            slot->target = Target;
+            slot->text.swap( Text );
+            slot->sequence.store( position + 1, std::memory_order_release );
+            return true; }
+    // writes all queued entries to disk, then flushes the streams
+    // NOTE: caller is expected to hold the log lock
+    void
+        drain() {
+            auto written { false };
+            while( true ) {
+                auto &slot { m_slots[ m_dequeueposition & ( SLOTCOUNT - 1 ) ] };
+                if( slot.sequence.load( std::memory_order_acquire ) != m_dequeueposition + 1 ) { break; }
+                write_entry( slot.target, slot.text );
+                slot.text.clear();
+                slot.sequence.store( m_dequeueposition + SLOTCOUNT, std::memory_order_release );
+                ++m_dequeueposition;
+                written = true; }
+            auto const dropped { m_dropped.exchange( 0 ) };
+            if( dropped > 0 ) {
+                write_entry( log_target::log, "Log overload: " + std::to_string( dropped ) + " entries discarded" );
+                written = true; }
+            if( written ) {
+                flush_streams(); } }
+    void
+        flush_streams() {
+            if( output.is_open() ) { output.flush(); }
+            if( errors.is_open() ) { errors.flush(); } }
+    // background writer main loop
+    void
+        run() {
+            while( false == m_exit ) {
+                {
+                    std::lock_guard<std::timed_mutex> lock( m_lock );
+                    drain();
+                }
+                // entries are gathered between passes, so they can be written out in a single batch
+                std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ); } }
+// members
+    std::array<log_slot, SLOTCOUNT> m_slots;
+    std::atomic<std::size_t> m_enqueueposition { 0 };
+    std::size_t m_dequeueposition { 0 }; // guarded by the log lock
+    std::atomic<std::size_t> m_dropped { 0 }; // number of entries discarded in lossy mode
+    std::timed_mutex m_lock; // guards log streams and the consumer side of the queue
+    std::once_flag m_started;
+    std::thread m_writer;
+    std::atomic<bool> m_exit { false };
+};
+
+log_sink logsink;
+
+void WriteLog( const char *str, logtype const Type ) {
+
+    if( str == nullptr ) { return; }
+    if( true == TestFlag( Global.DisabledLogTypes, static_cast<unsigned int>( Type ) ) ) { return; }
+    if( ( Global.iWriteLogEnabled & ( 1 | 2 ) ) == 0 ) { return; }
+
+    logsink.insert( log_target::log, str );
+}
+
 // Ra: bezwarunkowa rejestracja poważnych błędów
 void ErrorLog( const char *str, logtype const Type ) {
 
     if( str == nullptr ) { return; }
     if( true == TestFlag( Global.DisabledLogTypes, static_cast<unsigned int>( Type ) ) ) { return; }
 
-    if (!errors.is_open()) {
+    logsink.insert( log_target::errors, str );
+};
 
-        std::string const filename =
-            ( Global.MultipleLogs ?
-                "logs/errors (" + filename_scenery() + ") " + filename_date() + ".txt" :
-                "errors.txt" );
-        errors.open( filename, std::ios::trunc );
-        errors << "EU07.EXE " + Global.asVersion << "\n";
-    }
+// writes pending log entries to disk
+bool FlushLogs() {
 
-    errors << str << "\n";
-    errors.flush();
-};
+    return logsink.flush();
+}
+
+// writes pending log entries to disk and stops the background writer
+void CloseLogs() {
+
+    logsink.stop();
+}
 
 void Error(const std::string &asMessage, bool box)
 {
@@ -32,3 +32,7 @@ void ErrorLog( const std::string &str, logtype const Type = logtype::generic );
 void WriteLog( const std::string &str, logtype const Type = logtype::generic );
 void CommLog( const char *str );
 void CommLog( const std::string &str );
+// writes pending log entries to disk. returns: true on success
+bool FlushLogs();
+// writes pending log entries to disk and stops the background writer. subsequent entries are written directly
+void CloseLogs();
@@ -20,6 +20,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Driver.h"
 #include "Event.h"
 #include "Logs.h"
+#include "sn_utils.h"
 
 //---------------------------------------------------------------------------
 
@@ -222,14 +223,24 @@ void TMemCell::LogValues() const {
 // serialize() subclass details, sends content of the subclass to provided stream
 void
 TMemCell::serialize_( std::ostream &Output ) const {
-
-    // TODO: implement
+    // content
+    sn_utils::s_str( Output, szText );
+    sn_utils::ls_float64( Output, fValue1 );
+    sn_utils::ls_float64( Output, fValue2 );
+    // associated track
+    sn_utils::s_str( Output, asTrackName );
 }
 // deserialize() subclass details, restores content of the subclass from provided stream
 void
 TMemCell::deserialize_( std::istream &Input ) {
+    // content
+    szText = sn_utils::d_str( Input );
+    fValue1 = sn_utils::ld_float64( Input );
+    fValue2 = sn_utils::ld_float64( Input );
+    // associated track
+    asTrackName = sn_utils::d_str( Input );
 
-    // TODO: implement
+    CommandCheck();
 }
 
 // export() subclass details, sends basic content of the class in legacy (text) format to provided stream
@@ -1787,21 +1787,45 @@ void TSubModel::deserialize(std::istream &s)
 	m_rotation_init_done = true;
 }
 
-void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
+// collects null-terminated strings stored in provided chunk data
+void TModel3d::deserialize_strings(std::string_view Data, std::vector<std::string> &Strings)
+{
+	while (false == Data.empty())
+	{
+		auto const length = std::min(Data.find('\0'), Data.size());
+		Strings.emplace_back(Data.substr(0, length));
+		Data.remove_prefix(std::min(length + 1, Data.size()));
+	}
+}
+
+void TModel3d::deserialize(std::string_view const Data, bool dynamic)
 {
 	Root = nullptr;
     if( m_geometrybank == null_handle ) {
         m_geometrybank = GfxRenderer->Create_Bank();
     }
 
-	std::streampos end = s.tellg() + (std::streampos)size;
+    // validate chunk headers up front, so the chunk handlers can work directly on the mapped data
+    std::vector< std::pair<uint32_t, std::string_view> > chunks; // chunk type, chunk data
+    for( std::size_t offset { 0 }; offset < Data.size(); ) {
+        if( Data.size() - offset < 8 )
+            throw std::runtime_error( "e3d: truncated chunk header" );
+        auto const *header { Data.data() + offset };
+        uint32_t const type = sn_utils::ld_uint32( header );
+        uint32_t const size = sn_utils::ld_uint32( header );
+        if( ( size < 8 ) || ( size > Data.size() - offset ) )
+            throw std::runtime_error( "e3d: chunk size doesn't match file size" );
+        chunks.emplace_back( type, Data.substr( offset + 8, size - 8 ) );
+        offset += size;
+    }
+
     bool hastangents { false };
 
-	while (s.tellg() < end)
+	for (auto const &chunk : chunks)
 	{
-		uint32_t type = sn_utils::ld_uint32(s);
-		uint32_t size = sn_utils::ld_uint32(s) - 8;
-		std::streampos end = s.tellg() + (std::streampos)size;
+		uint32_t const type = chunk.first;
+		std::size_t const size = chunk.second.size();
+		char const *data = chunk.second.data();
 
 		if ((type & 0x00FFFFFF) == MAKE_ID4('S', 'U', 'B', 0)) // submodels
 		{
@@ -1812,10 +1836,10 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
 			size_t sm_cnt = size / sm_size;
 			iSubModelsCount = (int)sm_cnt;
 			Root = new TSubModel[sm_cnt];
-			size_t pos = s.tellg();
 			for (size_t i = 0; i < sm_cnt; ++i)
 			{
-				s.seekg(pos + sm_size * i);
+				memory_streambuf buffer(data + sm_size * i, sm_size);
+				std::istream s(&buffer);
 				Root[i].deserialize(s);
 			}
 		}
@@ -1827,10 +1851,12 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                 throw std::runtime_error( "e3d: VNT chunk encountered before SUB chunk" );
             std::vector< std::pair<int, int> > submodeloffsets; // vertex data offset, submodel index
             submodeloffsets.reserve( iSubModelsCount );
+            std::size_t vertexcount { 0 };
             for( auto submodelindex = 0; submodelindex < iSubModelsCount; ++submodelindex ) {
                 auto const &submodelgeometry { Root[ submodelindex ].m_geometry };
                 if( submodelgeometry.vertex_count <= 0 ) { continue; }
                 submodeloffsets.emplace_back( submodelgeometry.vertex_offset, submodelindex );
+                vertexcount += submodelgeometry.vertex_count;
             }
             std::sort(
                 std::begin( submodeloffsets ),
@@ -1840,6 +1866,13 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
             // once sorted we can grab geometry as it comes, and assign it to the chunks it belongs to
             size_t const vertextype { ( ( ( type & 0xFF000000 ) >> 24 ) - '0' ) };
             hastangents = ( vertextype > 0 );
+            std::size_t const vertexsize {
+                vertextype == 0 ? 32 :
+                vertextype == 1 ? 20 :
+                vertextype == 2 ? 48 :
+                0 };
+            if( vertexcount * vertexsize > size )
+                throw std::runtime_error( "e3d: VNT chunk is smaller than declared vertex count" );
             for( auto const &submodeloffset : submodeloffsets ) {
                 auto &submodel { Root[ submodeloffset.second ] };
                 auto const &submodelgeometry { submodel.m_geometry };
@@ -1849,7 +1882,7 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                     case 0: {
                         // legacy vnt0 format
                         for( auto &vertex : submodel.Vertices ) {
-                            vertex.deserialize( s, hastangents );
+                            vertex.deserialize( data, hastangents );
                             if( submodel.eType < TP_ROTATOR ) {
                                 // normal vectors debug routine
                                 if( ( false == submodel.m_normalizenormals )
@@ -1864,14 +1897,14 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                     case 1: {
                         // expanded chunk formats
                         for( auto &vertex : submodel.Vertices ) {
-                            vertex.deserialize_packed( s, hastangents );
+                            vertex.deserialize_packed( data, hastangents );
                         }
                         break;
                     }
                     case 2: {
                         // expanded chunk formats
                         for( auto &vertex : submodel.Vertices ) {
-                            vertex.deserialize( s, hastangents );
+                            vertex.deserialize( data, hastangents );
                         }
                         break;
                     }
@@ -1891,10 +1924,12 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                 throw std::runtime_error( "e3d: IDX chunk encountered before SUB chunk" );
             std::vector< std::pair<int, int> > submodeloffsets; // index data offset, submodel index
             submodeloffsets.reserve( iSubModelsCount );
+            std::size_t indexcount { 0 };
             for( auto submodelindex = 0; submodelindex < iSubModelsCount; ++submodelindex ) {
                 auto const &submodelgeometry { Root[ submodelindex ].m_geometry };
                 if( submodelgeometry.index_count <= 0 ) { continue; }
                 submodeloffsets.emplace_back( submodelgeometry.index_offset, submodelindex );
+                indexcount += submodelgeometry.index_count;
             }
             std::sort(
                 std::begin( submodeloffsets ),
@@ -1903,6 +1938,8 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                     return (Left.first) < (Right.first); } );
             // once sorted we can grab indices in a continuous read, and assign them to the chunks they belong to
             size_t const indexsize { ( ( ( type & 0xFF000000 ) >> 24 ) - '0' ) };
+            if( indexcount * indexsize > size )
+                throw std::runtime_error( "e3d: IDX chunk is smaller than declared index count" );
             for( auto const &submodeloffset : submodeloffsets ) {
                 auto &submodel { Root[ submodeloffset.second ] };
                 auto const &submodelgeometry { submodel.m_geometry };
@@ -1911,19 +1948,19 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                 switch( indexsize ) {
                     case 1: {
                         for( auto &index : submodel.Indices ) {
-                            index = sn_utils::d_uint8( s );
+                            index = sn_utils::d_uint8( data );
                         }
                         break;
                     }
                     case 2: {
                         for( auto &index : submodel.Indices ) {
-                            index = sn_utils::ld_uint16( s );
+                            index = sn_utils::ld_uint16( data );
                         }
                         break;
                     }
                     case 4: {
                         for( auto &index : submodel.Indices ) {
-                            index = sn_utils::ld_uint32( s );
+                            index = sn_utils::ld_uint32( data );
                         }
                         break;
                     }
@@ -1939,6 +1976,8 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                 throw std::runtime_error("e3d: duplicated TRA chunk");
 			size_t t_cnt = size / 64;
 
+			memory_streambuf buffer(data, size);
+			std::istream s(&buffer);
 			Matrices.resize(t_cnt);
 			for (size_t i = 0; i < t_cnt; ++i)
 				Matrices[i].deserialize_float32(s);
@@ -1949,6 +1988,8 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
                 throw std::runtime_error("e3d: duplicated TRA chunk");
 			size_t t_cnt = size / 128;
 
+			memory_streambuf buffer(data, size);
+			std::istream s(&buffer);
             Matrices.resize( t_cnt );
             for (size_t i = 0; i < t_cnt; ++i)
 				Matrices[i].deserialize_float64(s);
@@ -1957,18 +1998,14 @@ void TModel3d::deserialize(std::istream &s, size_t size, bool dynamic)
 		{
 			if (Textures.size())
 				throw std::runtime_error("e3d: duplicated TEX chunk");
-			while (s.tellg() < end)
-				Textures.push_back(sn_utils::d_str(s));
+			deserialize_strings(chunk.second, Textures);
 		}
 		else if (type == MAKE_ID4('N', 'A', 'M', '0'))
 		{
 			if (Names.size())
 				throw std::runtime_error("e3d: duplicated NAM chunk");
-			while (s.tellg() < end)
-				Names.push_back(sn_utils::d_str(s));
+			deserialize_strings(chunk.second, Names);
 		}
-
-		s.seekg(end);
 	}
 
 	if (!Root)
@@ -2137,17 +2174,22 @@ void TSubModel::BinInit(TSubModel *s, float4x4 *m, std::vector<std::string> *t,
 void TModel3d::LoadFromBinFile(std::string const &FileName, bool dynamic)
 { // wczytanie modelu z pliku binarnego
     WriteLog( "Loading binary format 3d model data from \"" + FileName + "\"...", logtype::model );
-	
-	std::ifstream file(FileName, std::ios::binary);
 
-	uint32_t type = sn_utils::ld_uint32(file);
-	uint32_t size = sn_utils::ld_uint32(file) - 8;
+	// the file is only needed for the duration of the load, and mapping it spares us a copy of the whole content
+	mapped_buffer file;
+	if ((false == file.map(FileName)) || (file.size < 8))
+		throw std::runtime_error("e3d: unknown main chunk");
+
+	char const *data = file.data;
+	uint32_t type = sn_utils::ld_uint32(data);
+	uint32_t size = sn_utils::ld_uint32(data);
 
 	if (type != MAKE_ID4('E', '3', 'D', '0'))
 		throw std::runtime_error("e3d: unknown main chunk");
+	if ((size < 8) || (size > file.size))
+		throw std::runtime_error("e3d: main chunk size doesn't match file size");
 
-	deserialize(file, size, dynamic);
-	file.close();
+	deserialize(file.view().substr(8, size - 8), dynamic);
 
     WriteLog( "Finished loading 3d model data from \"" + FileName + "\"", logtype::model );
 };
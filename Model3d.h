@@ -293,7 +293,9 @@ public:
         return m_smokesources; }
 	int TerrainCount() const;
 	TSubModel * TerrainSquare(int n);
-	void deserialize(std::istream &s, size_t size, bool dynamic);
+	void deserialize(std::string_view const Data, bool dynamic);
+private:
+	static void deserialize_strings(std::string_view Data, std::vector<std::string> &Strings);
 };
 
 //---------------------------------------------------------------------------
@@ -10,12 +10,20 @@ http://mozilla.org/MPL/2.0/.
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <string_view>
 
 template <typename Type_>
 class basic_table {
 
 public:
+// types
+    // stable reference to an item, resolved from the item name once and invalidated when the item is removed from the table
+    struct handle {
+        std::uint32_t index { std::numeric_limits<std::uint32_t>::max() };
+        std::uint32_t generation { 0 };
+    };
 // destructor
     ~basic_table() {
         for( auto *item : m_items ) {
@@ -25,20 +33,22 @@ public:
     bool
         insert( Type_ *Item ) {
             m_items.emplace_back( Item );
-            auto const itemname = Item->name();
+            m_generations.emplace_back( 0 );
+            auto const &itemname = Item->name();
             if( ( true == itemname.empty() ) || ( itemname == "none" ) ) {
                 return true;
             }
             auto const itemhandle { m_items.size() - 1 };
-            // add item name to the map
-            auto mapping = m_itemmap.emplace( itemname, itemhandle );
-            if( true == mapping.second ) {
+            auto lookup = m_itemmap.find( itemname );
+            if( lookup == m_itemmap.end() ) {
+                // add item name to the map. map keys are views of the names held by the table
+                m_itemmap.emplace( *( m_names.emplace( itemname ).first ), itemhandle );
                 return true;
             }
             // item with this name already exists; update mapping to point to the new one, for backward compatibility
-            mapping.first->second = itemhandle;
+            lookup->second = itemhandle;
             return false; }
-	void purge (std::string const &Name)
+	void purge (std::string_view const Name)
 	{
 		auto lookup = m_itemmap.find( Name );
 		if (lookup == m_itemmap.end())
@@ -47,16 +57,19 @@ public:
 
 		detach(Name);
 	}
-	void detach (std::string const &Name)
+	void detach (std::string_view const Name)
 	{
 		auto lookup = m_itemmap.find( Name );
 		if (lookup == m_itemmap.end())
 			return;
 
 		m_items[lookup->second] = nullptr;
+		++m_generations[lookup->second];
 		// TBD, TODO: remove from m_items?
 
+		std::string const name { lookup->first };
 		m_itemmap.erase(lookup);
+		m_names.erase(name);
 	}
 	void purge (Type_ *Item)
 	{
@@ -64,26 +77,46 @@ public:
 			if (*it == Item) {
 				delete *it;
 				*it = nullptr;
+				++m_generations[it - m_items.begin()];
 				return;
 			}
 		}
 	}
     // locates item with specified name. returns pointer to the item, or nullptr
     Type_ *
-        find( std::string const &Name ) const {
+        find( std::string_view const Name ) const {
             auto lookup = m_itemmap.find( Name );
             return (
                 lookup != m_itemmap.end() ?
                     m_items[ lookup->second ] :
                     nullptr ); }
+    // locates item with specified name. returns handle to the item, or invalid handle
+    handle
+        find_handle( std::string_view const Name ) const {
+            auto lookup = m_itemmap.find( Name );
+            if( lookup == m_itemmap.end() ) {
+                return {}; }
+            return {
+                static_cast<std::uint32_t>( lookup->second ),
+                m_generations[ lookup->second ] }; }
+    // locates item with specified handle. returns pointer to the item, or nullptr if the handle is invalid or stale
+    Type_ *
+        find( handle const Handle ) const {
+            return (
+                ( Handle.index < m_items.size() )
+             && ( m_generations[ Handle.index ] == Handle.generation ) ?
+                    m_items[ Handle.index ] :
+                    nullptr ); }
 
 protected:
 // types
     using type_sequence = std::deque<Type_ *>;
-    using index_map = std::unordered_map<std::string, std::size_t>;
+    using index_map = std::unordered_map<std::string_view, std::size_t>;
 // members
     type_sequence m_items;
+    std::deque<std::uint32_t> m_generations; // removal counters of item slots, used to detect stale handles
     index_map m_itemmap;
+    std::unordered_set<std::string> m_names; // storage for keys of the name map
 
 public:
     // data access
@@ -22,6 +22,8 @@ http://mozilla.org/MPL/2.0/.
 #include "dictionary.h"
 #include "Globals.h"
 #include "Logs.h"
+#include "profiler.h"
+#include "loadqueue.h"
 #include "utilities.h"
 #include "sn_utils.h"
 
@@ -104,6 +106,17 @@ texture_manager::texture_manager() {
     m_textures.emplace_back( new opengl_texture(), std::chrono::steady_clock::time_point() );
 }
 
+texture_manager::~texture_manager() {
+
+    m_loader.reset();
+    delete_textures();
+}
+
+namespace {
+// location of the content requesting textures from the calling thread, if any
+thread_local std::optional<glm::dvec3> t_requestlocation;
+}
+
 // convert image to format suitable for given internalformat
 // required for GLES, on desktop GL it will be done by driver
 void opengl_texture::gles_match_internalformat(GLuint internalformat)
@@ -227,7 +240,7 @@ void opengl_texture::gles_match_internalformat(GLuint internalformat)
 }
 
 // loads texture data from specified file
-// TODO: wrap it in a workitem class, for the job system deferred loading
+// NOTE: can be called from the background loader, so it shouldn't touch anything but the texture itself
 void
 opengl_texture::load() {
 
@@ -242,6 +255,10 @@ opengl_texture::load() {
 
         WriteLog( "Loading texture data from \"" + name + "\"", logtype::texture );
 
+        if( max_size == 0 ) {
+            max_size = Global.CurrentMaxTextureSize;
+        }
+
         data_state = resource_state::loading;
 
              if( type == ".dds" ) { load_DDS(); }
@@ -282,6 +299,96 @@ fail:
     return;
 }
 
+// reads basic properties of the texture from the file header, without loading the data. returns: true if the file seems usable
+bool
+opengl_texture::probe() {
+
+    std::ifstream file( name + type, std::ios::binary ); file.unsetf( std::ios::skipws );
+    if( false == file.is_open() ) { return false; }
+
+    if( type == ".dds" ) {
+
+        char filecode[ 5 ] {};
+        file.read( filecode, 4 );
+        if( filecode != std::string( "DDS " ) ) { return false; }
+
+        auto const ddsd { deserialize_ddsd( file ) };
+        auto const fourcc { ddsd.ddpfPixelFormat.dwFourCC };
+        if( ( fourcc != FOURCC_DXT1 )
+         && ( fourcc != FOURCC_DXT3 )
+         && ( fourcc != FOURCC_DXT5 ) ) {
+            return false;
+        }
+        data_width = ddsd.dwWidth;
+        data_height = ddsd.dwHeight;
+        has_alpha = ( fourcc != FOURCC_DXT1 );
+    }
+    else if( type == ".tga" ) {
+
+        unsigned char tgaheader[ 18 ] {};
+        file.read( (char *)tgaheader, sizeof( unsigned char ) * 18 );
+        int const bytesperpixel = tgaheader[ 16 ] / 8;
+        if( ( ( tgaheader[ 2 ] != 2 ) && ( tgaheader[ 2 ] != 10 ) )
+         || ( ( bytesperpixel != 1 ) && ( bytesperpixel != 3 ) && ( bytesperpixel != 4 ) ) ) {
+            return false;
+        }
+        data_width = tgaheader[ 13 ] * 256 + tgaheader[ 12 ];
+        data_height = tgaheader[ 15 ] * 256 + tgaheader[ 14 ];
+        has_alpha = ( bytesperpixel == 4 );
+    }
+    else if( type == ".bmp" ) {
+
+        BITMAPFILEHEADER header;
+        file.read( (char *)&header, sizeof( BITMAPFILEHEADER ) );
+        BITMAPINFOHEADER info;
+        file.read( (char *)&info, sizeof( BITMAPINFOHEADER ) );
+        if( info.biCompression != BI_RGB ) { return false; }
+
+        data_width = info.biWidth;
+        data_height = info.biHeight;
+        has_alpha = ( info.biBitCount == 32 );
+    }
+    else if( type == ".tex" ) {
+
+        char head[ 5 ] {};
+        file.read( head, 4 );
+             if( std::string( "RGB " ) == head ) { has_alpha = false; }
+        else if( std::string( "RGBA" ) == head ) { has_alpha = true; }
+        else { return false; }
+
+        file.read( (char *)&data_width, sizeof( int ) );
+        file.read( (char *)&data_height, sizeof( int ) );
+    }
+    else {
+        return false;
+    }
+
+    return (
+        ( false == file.fail() )
+     && ( data_width > 0 )
+     && ( data_height > 0 ) );
+}
+
+// takes over texture data loaded by provided helper object
+void
+opengl_texture::assign( opengl_texture &&Source ) {
+
+    data = std::move( Source.data );
+    data_state = Source.data_state;
+    data_width = Source.data_width;
+    data_height = Source.data_height;
+    data_mapcount = Source.data_mapcount;
+    data_format = Source.data_format;
+    data_components = Source.data_components;
+    has_alpha = Source.has_alpha;
+    size = Source.size;
+
+    if( data_state == resource_state::failed ) {
+        // NOTE: temporary workaround for texture assignment errors, same as with direct load
+        id = 0;
+    }
+}
+
 void
 opengl_texture::make_stub() {
 
@@ -486,7 +593,7 @@ opengl_texture::load_DDS() {
     int blockSize = ( data_format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ? 8 : 16 );
     int offset = 0;
 
-    while( ( data_width > Global.CurrentMaxTextureSize ) || ( data_height > Global.CurrentMaxTextureSize ) ) {
+    while( ( data_width > max_size ) || ( data_height > max_size ) ) {
         // pomijanie zbyt dużych mipmap, jeśli wymagane jest ograniczenie rozmiaru
         offset += ( ( data_width + 3 ) / 4 ) * ( ( data_height + 3 ) / 4 ) * blockSize;
         data_width /= 2;
@@ -727,7 +834,7 @@ opengl_texture::load_TGA() {
     }
 
     downsize( GL_BGRA );
-    if( ( data_width > Global.CurrentMaxTextureSize ) || ( data_height > Global.CurrentMaxTextureSize ) ) {
+    if( ( data_width > max_size ) || ( data_height > max_size ) ) {
         // for non-square textures there's currently possibility the scaling routine will have to abort
         // before it gets all work done
         data_state = resource_state::failed;
@@ -1087,7 +1194,7 @@ opengl_texture::set_filtering() const {
 void
 opengl_texture::downsize( GLuint const Format ) {
 
-    while( ( data_width > Global.CurrentMaxTextureSize ) || ( data_height > Global.CurrentMaxTextureSize ) ) {
+    while( ( data_width > max_size ) || ( data_height > max_size ) ) {
         // scale down the base texture, if it's larger than allowed maximum
         // NOTE: scaling is uniform along both axes, meaning non-square textures can drop below the maximum
         // TODO: replace with proper scaling function once we have image middleware in place
@@ -1222,12 +1329,32 @@ texture_manager::create( std::string Filename, bool const Loadnow, GLint Formath
 
     if( true == Loadnow ) {
 
-        texture_manager::texture( textureindex ).load();
+        texture->max_size = Global.CurrentMaxTextureSize;
+        if( ( true == Global.ResourceStreaming )
+         && ( false == isgenerated )
+         && ( true == texture->probe() ) ) {
+            // the header provides everything the texture users need at this stage, the data itself can arrive later
+            if( m_loader == nullptr ) {
+                m_loader = std::make_unique<load_queue>(
+                    []( opengl_texture &Texture ) {
+                        Texture.load(); } );
+            }
+            texture->is_loading = true;
+            auto priority { 0.f };
+            if( t_requestlocation ) {
+                m_loadlocations.emplace( textureindex, *t_requestlocation );
+                priority = static_cast<float>( glm::distance( *t_requestlocation, glm::dvec3{ Global.pCamera.Pos } ) );
+            }
+            m_loader->insert( textureindex, *texture, priority );
+        }
+        else {
+            texture_manager::texture( textureindex ).load();
 #ifndef EU07_DEFERRED_TEXTURE_UPLOAD
-        texture_manager::texture( textureindex ).create();
-        // texture creation binds a different texture, force a re-bind on next use
-        m_activetexture = -1;
+            texture_manager::texture( textureindex ).create();
+            // texture creation binds a different texture, force a re-bind on next use
+            m_activetexture = -1;
 #endif
+        }
     }
 
     return textureindex;
@@ -1248,10 +1375,37 @@ opengl_texture &
 texture_manager::mark_as_used(const texture_handle Texture) {
 
     auto &pair = m_textures[ Texture ];
+    if( true == pair.first->is_loading ) {
+        // the texture is about to be used, so it can't wait for its turn in the background loader
+        collect_loaded( Texture );
+    }
     pair.second = m_garbagecollector.timestamp();
     return *pair.first;
 }
 
+// moves data of textures loaded in the background to their target objects. if a texture is specified, waits for it to be loaded
+void
+texture_manager::collect_loaded( texture_handle const Texture ) {
+
+    if( m_loader == nullptr ) { return; }
+
+    load_queue::resource_sequence loaded;
+    if( Texture != null_handle ) {
+        opengl_texture helper;
+        if( true == m_loader->acquire( Texture, helper ) ) {
+            loaded.emplace_back( Texture, std::move( helper ) );
+        }
+    }
+    m_loader->collect( loaded );
+
+    for( auto &entry : loaded ) {
+        auto &texture { *( m_textures[ entry.first ].first ) };
+        texture.assign( std::move( entry.second ) );
+        texture.is_loading = false;
+        m_loadlocations.erase( entry.first );
+    }
+}
+
 void
 texture_manager::delete_textures() {
     for( auto const &texture : m_textures ) {
@@ -1268,6 +1422,22 @@ texture_manager::delete_textures() {
 void
 texture_manager::update() {
 
+    EU07_PROFILE_SCOPE( "texture_manager::update" );
+    collect_loaded();
+
+    if( ( m_loader != nullptr )
+     && ( false == m_loadlocations.empty() ) ) {
+        // the camera moves while the data is being loaded, so the queue is reordered to serve the closest content first
+        auto const camera { glm::dvec3{ Global.pCamera.Pos } };
+        m_loader->prioritize(
+            [&]( texture_handle const Texture, opengl_texture const & ) {
+                auto const lookup { m_loadlocations.find( Texture ) };
+                return (
+                    lookup != m_loadlocations.end() ?
+                        static_cast<float>( glm::distance( lookup->second, camera ) ) :
+                        0.f ); } );
+    }
+
     if( m_garbagecollector.sweep() > 0 ) {
         for( auto &unit : opengl_texture::units ) {
             unit = -1;
@@ -1275,6 +1445,13 @@ texture_manager::update() {
     }
 }
 
+// sets location of the content requesting textures from the calling thread, or clears it if no location is provided
+void
+texture_manager::request_location( std::optional<glm::dvec3> const &Location ) {
+
+    t_requestlocation = Location;
+}
+
 // debug performance string
 std::string
 texture_manager::info() const {
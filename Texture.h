@@ -15,6 +15,11 @@ http://mozilla.org/MPL/2.0/.
 #include "ResourceManager.h"
 #include "gl/ubo.h"
 
+namespace threading {
+template <typename Key_, typename Resource_>
+class load_queue;
+}
+
 struct opengl_texture {
 	static DDSURFACEDESC2 deserialize_ddsd(std::istream&);
 	static DDCOLORKEY deserialize_ddck(std::istream&);
@@ -26,6 +31,12 @@ struct opengl_texture {
 // methods
     void
         load();
+    // reads basic properties of the texture from the file header, without loading the data. returns: true if the file seems usable
+    bool
+        probe();
+    // takes over texture data loaded by provided helper object
+    void
+        assign( opengl_texture &&Source );
     bool
         bind( size_t unit );
     static void
@@ -55,11 +66,13 @@ struct opengl_texture {
     GLuint id{ (GLuint)-1 }; // associated GL resource
     bool has_alpha{ false }; // indicates the texture has alpha channel
     bool is_ready{ false }; // indicates the texture was processed and is ready for use
+    bool is_loading{ false }; // indicates the texture data is being loaded in the background
     std::string traits; // requested texture attributes: wrapping modes etc
     std::string name; // name of the texture source file
     std::string type; // type of the texture source file
     std::size_t size{ 0 }; // size of the texture data, in kb
     GLint components_hint = 0; // components that material wants
+    int max_size{ 0 }; // largest allowed texture dimension. if not set, the current global limit is captured on load
 
 	GLenum target = GL_TEXTURE_2D;
     static std::array<GLuint, gl::MAX_TEXTURES + gl::HELPER_TEXTURES> units;
@@ -107,7 +120,7 @@ class texture_manager {
 
 public:
     texture_manager();
-    ~texture_manager() { delete_textures(); }
+    ~texture_manager();
 
     // activates specified texture unit
     void
@@ -126,6 +139,11 @@ public:
     // performs a resource sweep
     void
         update();
+    // sets location of the content requesting textures from the calling thread, or clears it if no location is provided.
+    // data of textures requested with a location is loaded in the background closest to the camera first, after textures requested without one
+    static
+    void
+        request_location( std::optional<glm::dvec3> const &Location );
     // debug performance string
     std::string
         info() const;
@@ -140,6 +158,9 @@ private:
 
     typedef std::unordered_map<std::string, std::size_t> index_map;
 
+    using load_queue = threading::load_queue<texture_handle, opengl_texture>;
+    using location_map = std::unordered_map<texture_handle, glm::dvec3>;
+
 // methods:
     // checks whether specified texture is in the texture bank. returns texture id, or npos.
     texture_handle
@@ -149,12 +170,17 @@ private:
         find_on_disk( std::string const &Texturename ) const;
     void
         delete_textures();
+    // moves data of textures loaded in the background to their target objects. if a texture is specified, waits for it to be loaded
+    void
+        collect_loaded( texture_handle const Texture = null_handle );
 
 // members:
     texture_handle const npos { 0 }; // should be -1, but the rest of the code uses -1 for something else
     texturetimepointpair_sequence m_textures;
     index_map m_texturemappings;
     garbage_collector<texturetimepointpair_sequence> m_garbagecollector { m_textures, 600, 60, "texture" };
+    std::unique_ptr<load_queue> m_loader; // background loader of texture data
+    location_map m_loadlocations; // locations of content which requested textures queued in the background loader
 };
 
 // reduces provided data image to half of original size, using basic 2x2 average
@@ -36,6 +36,7 @@ public:
         stop() {
 		    m_last = std::chrono::duration_cast<std::chrono::microseconds>( ( std::chrono::steady_clock::now() - m_start ) );
 			m_accumulator = 0.95f * m_accumulator + m_last.count() / 1000.f;
+			m_sum += m_last;
 			return m_last; }
     float
         average() const {
@@ -43,12 +44,20 @@ public:
 	std::chrono::microseconds
 	    last() const {
 		    return m_last; }
+    // total of measurements taken since last reset, for sections timed more than once per frame
+	std::chrono::microseconds
+	    sum() const {
+		    return m_sum; }
+    void
+        reset_sum() {
+            m_sum = std::chrono::microseconds::zero(); }
 
 private:
 // members
     std::chrono::time_point<std::chrono::steady_clock> m_start { std::chrono::steady_clock::now() };
     float m_accumulator { 1000.f / 30.f * 20.f }; // 20 last samples, initial 'neutral' rate of 30 fps
     std::chrono::microseconds m_last;
+    std::chrono::microseconds m_sum { 0 };
 };
 
 struct subsystem_stopwatches {
@@ -46,6 +46,7 @@ TIsolated *TIsolated::pRoot = NULL;
 
 TTrack::profiles_array TTrack::m_profiles;
 TTrack::profiles_map TTrack::m_profilesmap;
+std::uint32_t TTrack::m_layoutrevision { 0 };
 
 TSwitchExtension::TSwitchExtension(TTrack *owner, int const what)
 { // na początku wszystko puste
@@ -1559,6 +1560,9 @@ bool TTrack::SetConnections(int i)
 
 bool TTrack::Switch(int i, float const t, float const d)
 { // przełączenie torów z uruchomieniem animacji
+    if( SwitchExtension ) {
+        ++m_layoutrevision;
+    }
     if (SwitchExtension) // tory przełączalne mają doklejkę
         if (eType == tt_Switch)
         { // przekładanie zwrotnicy jak zwykle
@@ -1682,6 +1686,7 @@ bool TTrack::SwitchForced(int i, TDynamicObject *o)
         else if (eType == tt_Cross)
         { // ustawienie wskaźnika na wskazany segment
             Segment = SwitchExtension->Segments[i];
+            ++m_layoutrevision;
         }
     return true;
 };
@@ -256,6 +256,11 @@ public:
             SwitchExtension != nullptr ?
                 SwitchExtension->iRoads - 1 :
                 1 ); }
+    // returns number of changes made to switch and crossing states, used to invalidate route data cached by the drivers
+    static
+    std::uint32_t
+        LayoutRevision() {
+            return m_layoutrevision; }
     void Load(cParser *parser, glm::dvec3 const &pOrigin);
     bool AssignEvents();
     bool AssignForcedEvents(basic_event *NewEventPlus, basic_event *NewEventMinus);
@@ -330,6 +335,7 @@ private:
 // members
     static profiles_array m_profiles; // shared database of path element profiles
     static profiles_map m_profilesmap;
+    static std::uint32_t m_layoutrevision; // incremented whenever a path changes its active segment or connections
 };
 
 
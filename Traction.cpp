@@ -20,6 +20,7 @@ http://mozilla.org/MPL/2.0/.
 #include "TractionPower.h"
 #include "Logs.h"
 #include "renderer.h"
+#include "sn_utils.h"
 
 //---------------------------------------------------------------------------
 /*
@@ -481,6 +482,14 @@ double TTraction::VoltageGet(double u, double i)
         (i != 0.0) ?
             (u / i) :
             10000.0 );
+    if( iGridNode[ 0 ] != -1 ) {
+        // pieces included in the power grid network get voltage calculated for all sources and loads in their sub-grid
+        auto &network { simulation::Powergrid.network() };
+        if( i != 0.0 ) {
+            network.insert( *this, u, i );
+        }
+        return network.voltage( *this );
+    }
     if( psPowered != nullptr ) {
         // yB: dla zasilanego nie baw się w gwiazdy, tylko bierz bezpośrednio
         return (
@@ -681,14 +690,50 @@ TTraction::radius_() {
 // serialize() subclass details, sends content of the subclass to provided stream
 void
 TTraction::serialize_( std::ostream &Output ) const {
-
-    // TODO: implement
+    // electrical attributes
+    sn_utils::s_str( Output, asPowerSupplyName );
+    sn_utils::ls_float32( Output, NominalVoltage );
+    sn_utils::ls_float32( Output, MaxCurrent );
+    sn_utils::ls_float32( Output, fResistivity );
+    sn_utils::ls_uint32( Output, Material );
+    sn_utils::ls_float32( Output, WireThickness );
+    sn_utils::ls_uint32( Output, DamageFlag );
+    // path data
+    sn_utils::s_dvec3( Output, pPoint1 );
+    sn_utils::s_dvec3( Output, pPoint2 );
+    sn_utils::s_dvec3( Output, pPoint3 );
+    sn_utils::s_dvec3( Output, pPoint4 );
+    sn_utils::ls_float64( Output, fHeightDifference );
+    sn_utils::ls_int32( Output, iNumSections );
+    // wire data
+    sn_utils::ls_int32( Output, Wires );
+    sn_utils::ls_float32( Output, WireOffset );
+    sn_utils::s_str( Output, asParallel );
 }
 // deserialize() subclass details, restores content of the subclass from provided stream
 void
 TTraction::deserialize_( std::istream &Input ) {
+    // electrical attributes
+    asPowerSupplyName = sn_utils::d_str( Input );
+    NominalVoltage = sn_utils::ld_float32( Input );
+    MaxCurrent = sn_utils::ld_float32( Input );
+    fResistivity = sn_utils::ld_float32( Input );
+    Material = sn_utils::ld_uint32( Input );
+    WireThickness = sn_utils::ld_float32( Input );
+    DamageFlag = sn_utils::ld_uint32( Input );
+    // path data
+    pPoint1 = sn_utils::d_dvec3( Input );
+    pPoint2 = sn_utils::d_dvec3( Input );
+    pPoint3 = sn_utils::d_dvec3( Input );
+    pPoint4 = sn_utils::d_dvec3( Input );
+    fHeightDifference = sn_utils::ld_float64( Input );
+    iNumSections = sn_utils::ld_int32( Input );
+    // wire data
+    Wires = sn_utils::ld_int32( Input );
+    WireOffset = sn_utils::ld_float32( Input );
+    asParallel = sn_utils::d_str( Input );
 
-    // TODO: implement
+    Init();
 }
 
 // export() subclass details, sends basic content of the class in legacy (text) format to provided stream
@@ -928,6 +973,7 @@ traction_table::InitTraction() {
                 if( matchingtraction != nullptr ) {
                     // jak znalezione przęsło z zasilaniem, to podłączenie "równoległe"
                     end->ResistanceCalc( 0, matchingtraction->fResistance[ connection ], matchingtraction->psPower[ connection ] );
+                    end->hvTension[ 1 ] = matchingtraction;
                     // jak coś zostało podłączone, to może zasilanie gdzieś dodatkowo dotrze
                     connected = true;
                     end = nullptr;
@@ -939,6 +985,7 @@ traction_table::InitTraction() {
                 if( matchingtraction != nullptr ) {
                     // jak znalezione przęsło z zasilaniem, to podłączenie "równoległe"
                     end->ResistanceCalc( 1, matchingtraction->fResistance[ connection ], matchingtraction->psPower[ connection ] );
+                    end->hvTension[ 0 ] = matchingtraction;
                     // jak coś zostało podłączone, to może zasilanie gdzieś dodatkowo dotrze
                     connected = true;
                     end = nullptr;
@@ -950,4 +997,9 @@ traction_table::InitTraction() {
             }
         }
     } while( true == connected );
+
+    if( true == Global.PowerGridSolver ) {
+        // without the network model the pieces stay outside of it, and use the legacy estimate based on their power sources
+        simulation::Powergrid.network().build( m_items );
+    }
 }
@@ -49,6 +49,8 @@ class TTraction : public scene::basic_node {
     float fResistance[ 2 ] { -1.0f, -1.0f }; // rezystancja zastępcza do punktu zasilania (0: przęsło zasilane, <0: do policzenia)
     int iTries { 1 }; // 0 is used later down the road to mark directly powered pieces
     int PowerState { 0 }; // type of incoming power, if any
+    TTraction *hvTension[ 2 ] { nullptr, nullptr }; // pieces of neighbouring tension section tied with the piece ends
+    int iGridNode[ 2 ] { -1, -1 }; // power grid network nodes at the piece ends
     // visualization data
     glm::dvec3 m_origin;
     gfx::geometry_handle m_geometry;
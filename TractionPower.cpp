@@ -16,11 +16,16 @@ http://mozilla.org/MPL/2.0/.
 #include "stdafx.h"
 #include "TractionPower.h"
 
+#include "Traction.h"
 #include "parser.h"
 #include "Logs.h"
+#include "sn_utils.h"
 
 //---------------------------------------------------------------------------
 
+double const EU07_POWERGRID_FEEDERRESISTANCE { 0.01 }; // [ohm] resistance of the cable connecting power source with the end of fed span
+double const EU07_POWERGRID_TIERESISTANCE { 0.01 }; // [ohm] resistance of the tie between tension sections
+
 TTractionPowerSource::TTractionPowerSource( scene::node_data const &Nodedata ) : basic_node( Nodedata ) {}
 // legacy constructor
 
@@ -143,15 +148,33 @@ void TTractionPowerSource::PowerSet(TTractionPowerSource *ps)
 // serialize() subclass details, sends content of the subclass to provided stream
 void
 TTractionPowerSource::serialize_( std::ostream &Output ) const {
-
-    // TODO: implement
+    // basic attributes
+    sn_utils::ls_float64( Output, NominalVoltage );
+    sn_utils::ls_float64( Output, VoltageFrequency );
+    sn_utils::ls_float64( Output, InternalRes );
+    sn_utils::ls_float64( Output, MaxOutputCurrent );
+    sn_utils::ls_float64( Output, FastFuseTimeOut );
+    sn_utils::ls_int32( Output, FastFuseRepetition );
+    sn_utils::ls_float64( Output, SlowFuseTimeOut );
+    // optional attributes
+    sn_utils::s_bool( Output, Recuperation );
+    sn_utils::s_bool( Output, bSection );
 }
 
 // deserialize() subclass details, restores content of the subclass from provided stream
 void
 TTractionPowerSource::deserialize_( std::istream &Input ) {
-
-    // TODO: implement
+    // basic attributes
+    NominalVoltage = sn_utils::ld_float64( Input );
+    VoltageFrequency = sn_utils::ld_float64( Input );
+    InternalRes = sn_utils::ld_float64( Input );
+    MaxOutputCurrent = sn_utils::ld_float64( Input );
+    FastFuseTimeOut = sn_utils::ld_float64( Input );
+    FastFuseRepetition = sn_utils::ld_int32( Input );
+    SlowFuseTimeOut = sn_utils::ld_float64( Input );
+    // optional attributes
+    Recuperation = sn_utils::d_bool( Input );
+    bSection = sn_utils::d_bool( Input );
 }
 
 // export() subclass details, sends basic content of the class in legacy (text) format to provided stream
@@ -188,9 +211,138 @@ TTractionPowerSource::export_as_text_( std::ostream &Output ) const {
 
 
 
+// builds the network model from provided traction pieces
+void
+powergrid_network::build( std::deque<TTraction *> const &Traction ) {
+
+    m_network.clear();
+    m_sources.clear();
+
+    for( auto *traction : Traction ) {
+        if( traction == nullptr ) { continue; }
+        traction->iGridNode[ 0 ] = traction->iGridNode[ 1 ] = -1;
+    }
+    // span ends connected with each other share the same node
+    for( auto *traction : Traction ) {
+        if( traction == nullptr ) { continue; }
+        for( int end = 0; end < 2; ++end ) {
+            if( traction->iGridNode[ end ] != -1 ) { continue; }
+            traction->iGridNode[ end ] = m_network.insert_node();
+            auto *neighbour { traction->hvNext[ end ] };
+            if( neighbour != nullptr ) {
+                neighbour->iGridNode[ traction->iNext[ end ] ] = traction->iGridNode[ end ];
+            }
+        }
+    }
+    // spans, ties between tension sections and feeders
+    std::unordered_map<TTractionPowerSource const *, int> busbars;
+    for( auto *traction : Traction ) {
+        if( traction == nullptr ) { continue; }
+        if( false == TestFlag( traction->DamageFlag, 128 ) ) {
+            // broken wire doesn't conduct
+            m_network.insert_branch(
+                traction->iGridNode[ 0 ], traction->iGridNode[ 1 ],
+                traction->fResistivity * glm::length( traction->vParametric ) );
+        }
+        for( int end = 0; end < 2; ++end ) {
+            auto const *tie { traction->hvTension[ end ] };
+            if( tie == nullptr ) { continue; }
+            auto const &point { ( end == 0 ? traction->pPoint1 : traction->pPoint2 ) };
+            auto const tieend { (
+                glm::length2( tie->pPoint1 - point ) <= glm::length2( tie->pPoint2 - point ) ?
+                    0 :
+                    1 ) };
+            m_network.insert_branch(
+                traction->iGridNode[ end ], tie->iGridNode[ tieend ],
+                EU07_POWERGRID_TIERESISTANCE );
+        }
+        auto *source { traction->psPowered };
+        if( source == nullptr ) { continue; }
+        // all spans fed by the same source share its busbar, and with it the internal resistance of the source
+        auto lookup { busbars.find( source ) };
+        if( lookup == busbars.end() ) {
+            lookup = busbars.emplace( source, m_network.insert_node() ).first;
+            m_network.insert_supply( lookup->second );
+            m_sources.emplace_back( source );
+        }
+        for( int end = 0; end < 2; ++end ) {
+            m_network.insert_branch(
+                lookup->second, traction->iGridNode[ end ],
+                EU07_POWERGRID_FEEDERRESISTANCE );
+        }
+    }
+    // initial state of the whole network
+    export_sources();
+    m_network.build();
+    import_sources();
+}
+
+// adds load drawing specified current at specified voltage to provided traction piece, for the current step
+void
+powergrid_network::insert( TTraction const &Traction, double const Voltage, double const Current ) {
+
+    if( Traction.iGridNode[ 0 ] == -1 ) { return; }
+    // without location of the pantograph within the span the load is shared equally by both span ends
+    m_network.insert_load( Traction.iGridNode[ 0 ], Traction.iGridNode[ 1 ], Voltage, Current );
+}
+
+// returns voltage at provided traction piece, calculated by the last solution of its sub-grid
+double
+powergrid_network::voltage( TTraction const &Traction ) const {
+
+    if( Traction.iGridNode[ 0 ] == -1 ) { return 0.0; }
+
+    return 0.5 * ( m_network.voltage( Traction.iGridNode[ 0 ] ) + m_network.voltage( Traction.iGridNode[ 1 ] ) );
+}
+
+// calculates node voltages of sub-grids affected by changes since the last update
+void
+powergrid_network::update() {
+
+    if( true == m_network.empty() ) { return; }
+
+    export_sources();
+    m_network.update();
+    import_sources();
+}
+
+// copies parameters of the power sources to the network model
+void
+powergrid_network::export_sources() {
+
+    for( std::size_t idx = 0; idx < m_sources.size(); ++idx ) {
+        auto const *source { m_sources[ idx ] };
+        auto &supply { m_network.source( static_cast<int>( idx ) ) };
+        supply.voltage = source->NominalVoltage;
+        supply.resistance = source->InternalRes;
+        supply.fuse = source->Fuse();
+    }
+}
+
+// copies results of the last solution to the power sources
+void
+powergrid_network::import_sources() {
+
+    for( std::size_t idx = 0; idx < m_sources.size(); ++idx ) {
+        auto *source { m_sources[ idx ] };
+        auto const &supply { m_network.source( static_cast<int>( idx ) ) };
+        source->TotalCurrent = supply.current;
+        source->OutputVoltage = supply.outputvoltage;
+        if( ( true == supply.overloaded )
+         && ( true == supply.fuse ) ) {
+            // fuse timer doesn't run until the load goes away
+            source->FuseTimer = 0.0;
+        }
+    }
+}
+
+
+
 // legacy method, calculates changes in simulation state over specified time
 void
 powergridsource_table::update( double const Deltatime ) {
+    // network state is calculated first, as it determines currents drawn from the sources
+    m_network.update();
 
     for( auto *powersource : m_items ) {
         powersource->Update( Deltatime );
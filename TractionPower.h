@@ -12,10 +12,12 @@ http://mozilla.org/MPL/2.0/.
 #include "Classes.h"
 #include "scenenode.h"
 #include "Names.h"
+#include "powergrid.h"
 
 class TTractionPowerSource : public scene::basic_node {
 
     friend class debug_panel;
+    friend class powergrid_network;
 
 public:
 // constructor
@@ -67,6 +69,42 @@ private:
 
 
 
+// power flow model of the traction network. spans are lines between their end nodes, power sources feed the busbar nodes
+// connected with their spans, and pantographs are loads placed on the spans
+class powergrid_network {
+
+public:
+// methods
+    // builds the network model from provided traction pieces
+    void
+        build( std::deque<TTraction *> const &Traction );
+    // adds load drawing specified current at specified voltage to provided traction piece, for the current step
+    void
+        insert( TTraction const &Traction, double const Voltage, double const Current );
+    // returns voltage at provided traction piece, calculated by the last solution of its sub-grid
+    double
+        voltage( TTraction const &Traction ) const;
+    // calculates node voltages of sub-grids affected by changes since the last update
+    void
+        update();
+    // returns true if the network doesn't hold any nodes
+    bool
+        empty() const {
+            return m_network.empty(); }
+
+private:
+// methods
+    // copies parameters of the power sources to the network model
+    void
+        export_sources();
+    // copies results of the last solution to the power sources
+    void
+        import_sources();
+// members
+    powergrid::network m_network;
+    std::vector<TTractionPowerSource *> m_sources; // power sources of the network model, in order of their indices
+};
+
 // collection of generators for power grid present in the scene
 class powergridsource_table : public basic_table<TTractionPowerSource> {
 
@@ -74,6 +112,13 @@ public:
     // legacy method, calculates changes in simulation state over specified time
     void
         update( double const Deltatime );
+    // power flow model of the traction network fed by the sources
+    powergrid_network &
+        network() {
+            return m_network; }
+
+private:
+    powergrid_network m_network;
 };
 
 //---------------------------------------------------------------------------
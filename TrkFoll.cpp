@@ -21,6 +21,7 @@ http://mozilla.org/MPL/2.0/.
 #include "DynObj.h"
 #include "Driver.h"
 #include "Logs.h"
+#include "sn_utils.h"
 
 TTrackFollower::~TTrackFollower()
 {
@@ -44,6 +45,17 @@ void TTrackFollower::Reset()
 	fDirection = 1.0;
 }
 
+// sends placement of the axle to provided stream, in binary format
+void TTrackFollower::serialize( std::ostream &Output ) const
+{
+    sn_utils::s_str( Output, ( pCurrentTrack != nullptr ? pCurrentTrack->name() : "" ) );
+    sn_utils::ls_float64( Output, fCurrentDistance );
+    sn_utils::ls_float64( Output, fDirection );
+    sn_utils::ls_int32( Output, iSegment );
+    sn_utils::ls_int32( Output, iEventFlag );
+    sn_utils::ls_int32( Output, iEventallFlag );
+}
+
 TTrack * TTrackFollower::SetCurrentTrack(TTrack *pTrack, int end)
 { // przejechanie na inny odcinkek toru, z ewentualnym rozpruciem
     if (pTrack)
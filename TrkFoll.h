@@ -41,6 +41,8 @@ public:
     // inline double GetRadius(double L, double d);  //McZapkie-150503
     bool Init(TTrack *pTrack, TDynamicObject *NewOwner, double fDir);
 	void Reset();
+    // sends placement of the axle to provided stream, in binary format
+    void serialize( std::ostream &Output ) const;
     void Render(float fNr);
 // members
     double fOffsetH = 0.0; // Ra: odległość środka osi od osi toru (dla samochodów) - użyć do wężykowania
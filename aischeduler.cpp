@@ -0,0 +1,65 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "aischeduler.h"
+
+auto const EU07_AI_MAXDEFERRAL { 1.0 }; // updates overdue by this many seconds aren't deferred any further
+
+// starts new frame of the simulation, with specified settings
+void
+ai_scheduler::begin_frame( settings const &Settings ) {
+
+    m_settings = Settings;
+    m_frame.cost = frame_cost();
+    m_lastframe = m_frame;
+    m_frame = {};
+    m_cost = std::chrono::steady_clock::duration::zero();
+}
+
+// returns interval between full updates for a driver in specified situation
+double
+ai_scheduler::interval( urgency const Urgency, double const Reactiontime ) const {
+
+    if( ( Urgency != urgency::relaxed )
+     || ( false == m_settings.adaptive ) ) {
+        return Reactiontime;
+    }
+    return std::max( Reactiontime, m_settings.relaxedinterval );
+}
+
+// returns true if a driver in specified situation, with update overdue by specified time, can perform its full update now
+bool
+ai_scheduler::request( urgency const Urgency, double const Overdue ) {
+
+    if( ( Urgency == urgency::urgent )
+     || ( m_settings.framebudget <= 0.f )
+     || ( Overdue >= EU07_AI_MAXDEFERRAL )
+     || ( false == m_settings.adaptive )
+     || ( false == m_settings.budgeted ) ) {
+        return true;
+    }
+    if( std::chrono::duration_cast<std::chrono::microseconds>( m_cost ).count() < m_settings.framebudget * 1000.f ) {
+        return true;
+    }
+    ++m_frame.deferred;
+    ++m_deferredtotal;
+    return false;
+}
+
+// registers completed full update
+void
+ai_scheduler::complete( std::chrono::steady_clock::duration const Cost, double const Overdue ) {
+
+    ++m_frame.updates;
+    m_cost += Cost;
+    m_worstlatency = std::max( m_worstlatency, Overdue );
+}
+
+//---------------------------------------------------------------------------
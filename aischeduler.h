@@ -0,0 +1,73 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+// distributes full updates of ai drivers over time, based on urgency of their situations and the per-frame time budget
+class ai_scheduler {
+
+public:
+// types
+    enum class urgency {
+        urgent, // approaching signal, stop point, obstacle or speed change. updated at reaction rate of the driver, never deferred
+        normal, // updated at reaction rate of the driver, can be deferred when the frame budget runs out
+        relaxed // cruising or waiting with nothing relevant nearby. updated at reduced rate, can be deferred
+    };
+    struct settings {
+        double relaxedinterval { 1.0 }; // seconds between full updates of drivers with nothing relevant nearby
+        float framebudget { 2.f }; // msec per frame for full updates which can be deferred. 0: unlimited
+        bool adaptive { true }; // reduced update rates and budget can be used; false when the simulation has to match other instances
+        bool budgeted { true }; // the budget can be used; false when the run has to be repeatable, as the budget depends on wall clock
+    };
+    struct statistics {
+        int updates { 0 }; // full updates performed
+        int deferred { 0 }; // updates postponed due to exhausted budget
+        float cost { 0.f }; // time spent on full updates, in msec
+    };
+// methods
+    // starts new frame of the simulation, with specified settings
+    void
+        begin_frame( settings const &Settings );
+    // returns interval between full updates for a driver in specified situation
+    double
+        interval( urgency const Urgency, double const Reactiontime ) const;
+    // returns true if a driver in specified situation, with update overdue by specified time, can perform its full update now
+    bool
+        request( urgency const Urgency, double const Overdue );
+    // registers completed full update
+    void
+        complete( std::chrono::steady_clock::duration const Cost, double const Overdue );
+    // returns time spent on full updates in the frame in progress, in msec
+    float
+        frame_cost() const {
+            return std::chrono::duration_cast<std::chrono::microseconds>( m_cost ).count() / 1000.f; }
+    // returns statistics of the last completed frame
+    statistics const &
+        frame_stats() const {
+            return m_lastframe; }
+    // returns total number of deferred updates
+    std::uint64_t
+        deferred_total() const {
+            return m_deferredtotal; }
+    // returns longest delay of an update past its due time, in seconds of simulation time
+    double
+        worst_latency() const {
+            return m_worstlatency; }
+
+private:
+// members
+    settings m_settings;
+    statistics m_frame; // statistics of the frame in progress
+    statistics m_lastframe;
+    std::chrono::steady_clock::duration m_cost { 0 }; // time spent on full updates in current frame
+    std::uint64_t m_deferredtotal { 0 };
+    double m_worstlatency { 0.0 };
+};
+
+//---------------------------------------------------------------------------
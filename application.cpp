@@ -15,16 +15,22 @@ http://mozilla.org/MPL/2.0/.
 
 #include "Globals.h"
 #include "simulation.h"
+#include "simulationtime.h"
+#include "simulationenvironment.h"
+#include "simulationbenchmark.h"
 #include "simulationsounds.h"
 #include "Train.h"
 #include "dictionary.h"
 #include "sceneeditor.h"
 #include "openglrenderer.h"
 #include "opengl33renderer.h"
+#include "nullrenderer.h"
 #include "uilayer.h"
 #include "translation.h"
 #include "Logs.h"
 #include "Timer.h"
+#include "jobsystem.h"
+#include "telemetry.h"
 
 #ifdef EU07_BUILD_STATIC
 #pragma comment( lib, "glfw3.lib" )
@@ -107,6 +113,33 @@ void char_callback(GLFWwindow *window, unsigned int c)
     Application.on_char(c);
 }
 
+// 64-bit fnv-1a hash of provided data, used to fingerprint simulation state in headless runs
+std::uint64_t fnv1a_hash( std::string const &Data ) {
+
+    std::uint64_t hash { 0xcbf29ce484222325ULL };
+    for( auto const byte : Data ) {
+        hash ^= static_cast<std::uint8_t>( byte );
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// converts value of command line option to a number no lower than specified minimum. returns: true on success, false with error report otherwise
+template <typename Type_>
+bool parse_argument( std::string const &Option, std::string const &Value, Type_ &Output, Type_ const Minimum ) {
+
+    std::istringstream input( Value );
+    Type_ value;
+    if( ( input >> value )
+     && ( ( input >> std::ws ).eof() )
+     && ( value >= Minimum ) ) {
+        Output = value;
+        return true;
+    }
+    std::cout << "invalid value \"" << Value << "\" for " << Option << ", expected number no lower than " << Minimum << std::endl;
+    return false;
+}
+
 // public:
 
 int
@@ -137,6 +170,20 @@ eu07_application::init( int Argc, char *Argv[] ) {
 
     WriteLog( "// startup" );
 
+    threading::jobs.start( Global.JobThreads );
+
+    if( false == Global.telemetry_input.empty() ) {
+        // conversion run, the simulation isn't started
+        return 0;
+    }
+    if( true == WriteLogFlag ) {
+        telemetry::Recorder.open( "physicslog/telemetry.dat" );
+    }
+
+    if( true == Global.headless ) {
+        return init_headless();
+    }
+
     if( ( result = init_glfw() ) != 0 ) {
         return result;
     }
@@ -174,6 +221,11 @@ double eu07_application::generate_sync() {
 }
 
 void eu07_application::queue_quit() {
+	if (m_windows.empty()) {
+		// headless run, there's no window to close
+		m_quitrequested = true;
+		return;
+	}
 	glfwSetWindowShouldClose(m_windows[0], GLFW_TRUE);
 }
 
@@ -191,6 +243,21 @@ eu07_application::is_client() const {
 
 int
 eu07_application::run() {
+
+    if( false == Global.telemetry_input.empty() ) {
+        auto const output { (
+            Global.telemetry_output.empty() ?
+                Global.telemetry_input.substr( 0, Global.telemetry_input.rfind( '.' ) ) + ".csv" :
+                Global.telemetry_output ) };
+        return (
+            true == telemetry::recorder::export_as_csv( Global.telemetry_input, output ) ?
+                0 :
+                -1 );
+    }
+    if( true == Global.headless ) {
+        return run_headless();
+    }
+
     auto frame{ 0 };
     // main application loop
     while (!glfwWindowShouldClose( m_windows.front() ) && !m_modestack.empty())
@@ -242,6 +309,8 @@ eu07_application::run() {
 					Timer::set_delta_override(delta);
 					slave_sync = std::get<1>(frame_info);
 					add_to_dequemap(commands_to_exec, std::get<2>(frame_info));
+					// event launchers are polled where the master polled them, for launchers with limited range to fire in the same frames
+					simulation::Region->set_events_origin(std::get<3>(frame_info));
 
 					// and send our local commands to master
 					m_network->client->send_commands(local_commands);
@@ -272,7 +341,7 @@ eu07_application::run() {
 					// send delta, sync, and commands we just executed to clients
 					double delta = Timer::GetDeltaTime();
 					double render = Timer::GetDeltaRenderTime();
-					m_network->servers->push_delta(render, delta, sync, commands_to_exec);
+					m_network->servers->push_delta(render, delta, sync, simulation::Region->events_origin(), commands_to_exec);
 				}
 
 				// if we're slave
@@ -337,6 +406,145 @@ eu07_application::run() {
     return 0;
 }
 
+// loads the scenario and steps the simulation at fixed or replayed time steps, without window, renderer or audio
+// writes state hash of each frame to specified file. returns: 0 if the run completed and matched the replay, non-zero otherwise
+int
+eu07_application::run_headless() {
+
+    WriteLog( "using simulation seed: " + std::to_string( Global.random_seed ), logtype::generic );
+    WriteLog( "\nLoading scenario \"" + Global.SceneryFile + "\"..." );
+
+    auto const timestart { std::chrono::steady_clock::now() };
+    try {
+        auto state { simulation::State.deserialize_begin( Global.SceneryFile ) };
+        while( true == simulation::State.deserialize_continue( state ) ) {
+            ; // without ui to keep responsive we load everything in one go
+        }
+    }
+    catch( invalid_scenery_exception & ) {
+        ErrorLog( "Bad init: scenario loading failed" );
+        return -1;
+    }
+    WriteLog( "Scenario loading time: " + std::to_string( std::chrono::duration_cast<std::chrono::seconds>( ( std::chrono::steady_clock::now() - timestart ) ).count() ) + " seconds" );
+    simulation::benchmark_recorder benchmark;
+    benchmark.load_time( std::chrono::duration_cast<std::chrono::duration<double>>( std::chrono::steady_clock::now() - timestart ).count() );
+
+    simulation::Time.init( Global.starting_timestamp );
+    simulation::Environment.init();
+    // without replayed command log, event launchers are polled around the camera, placed where the scenario places free camera
+    Global.pCamera.Init( Global.FreeCameraInit[ 0 ], Global.FreeCameraInitAngle[ 0 ], nullptr );
+
+    std::ifstream replay;
+    network::stream_context replaycontext;
+    if( false == Global.headless_replay.empty() ) {
+        replay.open( Global.headless_replay, std::ios::binary );
+        if( false == replay.is_open() ) {
+            ErrorLog( "Bad file: failed to open command log \"" + Global.headless_replay + "\"" );
+            return -1;
+        }
+    }
+    std::ofstream hashes( Global.headless_hashes, std::ios::trunc );
+    if( false == hashes.is_open() ) {
+        ErrorLog( "Bad file: failed to open hash output \"" + Global.headless_hashes + "\"" );
+        return -1;
+    }
+
+    auto const framelimit { (
+        Global.headless_frames > 0 ? Global.headless_frames :
+        replay.is_open() ? std::numeric_limits<int>::max() :
+        static_cast<int>( std::ceil( 60.0 / Global.headless_timestep ) ) ) };
+    auto frame { 0 };
+    auto desynccount { 0 };
+
+    Timer::ResetTimers();
+    // allocations are counted only for the report, which benchmark runs always produce
+    simulation::count_allocations( false == Global.headless_report.empty() );
+    auto const runstart { std::chrono::steady_clock::now() };
+
+    while( ( frame < framelimit ) && ( false == m_quitrequested ) ) {
+
+        command_queue::commands_map commands;
+        // commands issued by the simulation itself during previous frame
+        auto const localcommands { simulation::Commands.pop_intercept_queue() };
+        auto deltatime { Global.headless_timestep };
+        std::optional<double> recordedsync;
+
+        if( replay.is_open() ) {
+            if( replay.peek() == EOF ) {
+                break;
+            }
+            auto const message { network::deserialize_message( replay, replaycontext ) };
+            if( message->type != network::message::FRAME_INFO ) {
+                ErrorLog( "Bad file: unexpected message in command log at frame " + std::to_string( frame ) );
+                break;
+            }
+            auto const &frameinfo { static_cast<network::frame_info const &>( *message ) };
+            deltatime = frameinfo.dt;
+            recordedsync = frameinfo.sync;
+            // event launchers with limited range depend on the camera of the recording session
+            simulation::Region->set_events_origin( frameinfo.events_origin );
+            // the log holds everything the recording session executed, local commands included
+            add_to_dequemap( commands, frameinfo.commands );
+        }
+        else {
+            add_to_dequemap( commands, localcommands );
+        }
+
+        Timer::set_delta_override( deltatime );
+        Timer::UpdateTimers( false );
+        simulation::Commands.push_commands( commands );
+
+        auto const allocationsstart { simulation::allocation_count() };
+        Timer::subsystem.sim_total.start();
+        // same sequence as driver mode update, minus the camera, ui and audio
+        simulation::State.update_clocks();
+        simulation::State.update_scripting_interface();
+        simulation::Environment.update();
+        simulation::State.update_dynamics( deltatime, 1.0 / 100.0 );
+        simulation::State.update_scenario( deltatime );
+        simulation::State.process_commands();
+        Timer::subsystem.sim_total.stop();
+        benchmark.record_frame( simulation::allocation_count() - allocationsstart );
+        simulation::is_ready = true;
+
+        // NOTE: sync value draws from the simulation random engine, it has to be generated every frame just like the recording session did
+        auto const sync { generate_sync() };
+        if( ( recordedsync )
+         && ( *recordedsync != sync ) ) {
+            WriteLog( "headless: desync at frame " + std::to_string( frame ) + "! calculated: " + std::to_string( sync ) + ", recorded: " + std::to_string( *recordedsync ), logtype::net );
+            ++desynccount;
+        }
+
+        std::ostringstream state;
+        simulation::State.export_state( state );
+        hashes
+            << frame << ' '
+            << std::fixed << std::setprecision( 4 ) << Timer::GetTime() << ' '
+            << std::hex << std::setw( 16 ) << std::setfill( '0' ) << fnv1a_hash( state.str() )
+            << std::dec << '\n';
+
+        ++frame;
+    }
+
+    simulation::count_allocations( false );
+    auto const runtime { std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - runstart ).count() };
+    WriteLog(
+        "headless: " + std::to_string( frame ) + " frames, " + std::to_string( Timer::GetTime() ) + " seconds of simulation in " + std::to_string( runtime ) + " ms"
+        + ( replay.is_open() ? ", " + std::to_string( desynccount ) + " desynced frames" : "" ) );
+
+    if( false == Global.headless_report.empty() ) {
+        std::ofstream report( Global.headless_report, std::ios::trunc );
+        if( true == report.is_open() ) {
+            benchmark.export_as_json( report, Global.SceneryFile, Timer::GetTime() );
+        }
+        else {
+            ErrorLog( "Bad file: failed to open report output \"" + Global.headless_report + "\"" );
+        }
+    }
+
+    return ( desynccount == 0 ? 0 : 1 );
+}
+
 // issues request for a worker thread to perform specified task. returns: true if task was scheduled
 bool
 eu07_application::request( python_taskqueue::task_request const &Task ) {
@@ -373,14 +581,20 @@ eu07_application::exit() {
 
 //    SafeDelete( simulation::Train );
     SafeDelete( simulation::Region );
+    telemetry::Recorder.close();
+    threading::jobs.stop();
 
-    ui_layer::shutdown();
+    if( false == Global.headless ) {
+        ui_layer::shutdown();
 
-    for( auto *window : m_windows ) {
-        glfwDestroyWindow( window );
+        for( auto *window : m_windows ) {
+            glfwDestroyWindow( window );
+        }
+        m_taskqueue.exit();
+        glfwTerminate();
     }
-    m_taskqueue.exit();
-    glfwTerminate();
+
+    CloseLogs();
 
 	if (!Global.exec_on_exit.empty())
 		system(Global.exec_on_exit.c_str());
@@ -695,11 +909,75 @@ eu07_application::init_settings( int Argc, char *Argv[] ) {
 				Global.local_start_vehicle = ToLower( Argv[ ++i ] );
             }
         }
+        else if( token == "-headless" ) {
+            Global.headless = true;
+        }
+        else if( token == "-replay" ) {
+            if( i + 1 < Argc ) {
+                Global.headless_replay = Argv[ ++i ];
+            }
+        }
+        else if( token == "-hashes" ) {
+            if( i + 1 < Argc ) {
+                Global.headless_hashes = Argv[ ++i ];
+            }
+        }
+        else if( token == "-frames" ) {
+            if( i + 1 < Argc ) {
+                if( false == parse_argument( token, Argv[ ++i ], Global.headless_frames, 0 ) ) { return -1; }
+            }
+        }
+        else if( token == "-timestep" ) {
+            if( i + 1 < Argc ) {
+                if( false == parse_argument( token, Argv[ ++i ], Global.headless_timestep, std::numeric_limits<double>::min() ) ) { return -1; }
+            }
+        }
+        else if( token == "-timestamp" ) {
+            if( i + 1 < Argc ) {
+                if( false == parse_argument( token, Argv[ ++i ], Global.starting_timestamp, std::numeric_limits<decltype( Global.starting_timestamp )>::lowest() ) ) { return -1; }
+            }
+        }
+        else if( token == "-report" ) {
+            if( i + 1 < Argc ) {
+                Global.headless_report = Argv[ ++i ];
+            }
+        }
+        else if( token == "-benchmark" ) {
+            if( i + 1 < Argc ) {
+                Global.headless = true;
+                Global.headless_benchmark = ToLower( Argv[ ++i ] );
+            }
+        }
+        else if( token == "-benchmarksize" ) {
+            if( i + 1 < Argc ) {
+                if( false == parse_argument( token, Argv[ ++i ], Global.headless_benchmarksize, 0 ) ) { return -1; }
+            }
+        }
+        else if( token == "-benchmarkvehicle" ) {
+            if( i + 1 < Argc ) {
+                Global.headless_benchmarkvehicle = ToLower( Argv[ ++i ] );
+            }
+        }
+        else if( token == "-telemetry" ) {
+            if( i + 1 < Argc ) {
+                // no window needed for the conversion, so it's set up like a headless run
+                Global.headless = true;
+                Global.telemetry_input = Argv[ ++i ];
+            }
+        }
+        else if( token == "-csv" ) {
+            if( i + 1 < Argc ) {
+                Global.telemetry_output = Argv[ ++i ];
+            }
+        }
         else {
             std::cout
                 << "usage: " << std::string( Argv[ 0 ] )
                 << " [-s sceneryfilepath]"
                 << " [-v vehiclename]"
+                << " [-headless [-replay backbufferfile] [-hashes outputfile] [-frames count] [-timestep seconds] [-timestamp seconds] [-report outputfile]]"
+                << " [-benchmark loop|signals|catenary|depot [-benchmarksize count] [-benchmarkvehicle datafolder,skin,model]]"
+                << " [-telemetry recordingfile [-csv outputfile]]"
                 << std::endl;
             return -1;
         }
@@ -912,6 +1190,49 @@ eu07_application::init_modes() {
     return 0;
 }
 
+// sets up the application for a run without window, renderer and audio
+int
+eu07_application::init_headless() {
+
+    if( false == Global.headless_benchmark.empty() ) {
+        // synthetic scenario takes place of the specified one
+        Global.SceneryFile = simulation::generate_benchmark_scenario( Global.headless_benchmark, Global.headless_benchmarksize, Global.headless_benchmarkvehicle );
+        if( Global.SceneryFile.empty() ) {
+            return -1;
+        }
+        if( Global.headless_report.empty() ) {
+            Global.headless_report = "benchmark_" + Global.headless_benchmark + ".json";
+        }
+    }
+    if( Global.SceneryFile.empty() ) {
+        ErrorLog( "Bad init: headless run requires scenario, specified with -s" );
+        return -1;
+    }
+
+    Global.bSoundEnabled = false;
+    Global.python_enabled = false;
+    Global.GfxRenderer = "null";
+    GfxRenderer = std::make_unique<null_renderer>();
+
+    auto const result { init_data() };
+    if( result != 0 ) {
+        return result;
+    }
+    // seed and starting time have to match those of the recorded session for the replay to stay in sync
+    // both default to fixed values, so separate runs without explicit settings produce the same hashes
+    if( !Global.random_seed ) {
+        Global.random_seed = 5489; // default seed of the mersenne twister
+    }
+    Global.random_engine.seed( Global.random_seed );
+    Global.local_random_engine.seed( Global.random_seed );
+    if( Global.starting_timestamp == 0 ) {
+        Global.starting_timestamp = 1577880000; // 2020-01-01 12:00
+    }
+    WriteLog( "headless: starting timestamp " + std::to_string( Global.starting_timestamp ) );
+
+    return 0;
+}
+
 bool eu07_application::init_network() {
 	if (!Global.network_servers.empty() || Global.network_client) {
 		// create network manager
@@ -946,6 +1267,8 @@ bool eu07_application::init_network() {
 
 		Global.starting_timestamp = utc_now + offset;
 		Global.ready_to_load = true;
+
+		WriteLog("using starting timestamp: " + std::to_string(Global.starting_timestamp), logtype::generic);
 	}
 
 	return true;
@@ -116,6 +116,8 @@ private:
     int  init_data();
     int  init_modes();
 	bool init_network();
+    int  init_headless();
+    int  run_headless();
     GLFWmonitor * find_monitor( const std::string &str ) const;
     std::string describe_monitor( GLFWmonitor *monitor ) const;
 // members
@@ -125,6 +127,7 @@ private:
     std::vector<GLFWwindow *> m_windows;
 
 	std::optional<network::manager> m_network;
+    bool m_quitrequested { false }; // quit request for headless run, which has no window to flag
 };
 
 extern eu07_application Application;
@@ -15,115 +15,66 @@ http://mozilla.org/MPL/2.0/.
 #include "Logs.h"
 #include "ResourceManager.h"
 
-#define STB_VORBIS_HEADER_ONLY
-#include "stb_vorbis.c"
-#define DR_WAV_IMPLEMENTATION
-#include "dr_wav.h"
-#define DR_FLAC_IMPLEMENTATION
-#include "dr_flac.h"
-
 namespace audio {
 
 openal_buffer::openal_buffer( std::string const &Filename ) :
     name( Filename ) {
 
-    WriteLog( "Loading sound data from \"" + Filename + "\"", logtype::sound );
-
-    ::alGenBuffers( 1, &id );
-    // fetch audio data
-    if( ends_with( Filename, ".wav" ) ) {
-        // .wav audio data file
-        auto *file { drwav_open_file( Filename.c_str() ) };
-        if( file != nullptr ) {
-            rate = file->sampleRate;
-            auto const samplecount{ static_cast<std::size_t>( file->totalSampleCount ) };
-            data.resize( samplecount );
-            drwav_read_s16(
-                file,
-                samplecount,
-                &data[ 0 ] );
-            if( file->channels > 1 ) {
-                narrow_to_mono( file->channels );
-                data.resize( samplecount / file->channels );
-            }
-        }
-        else {
-            ErrorLog( "Bad file: failed to load audio file \"" + Filename + "\"", logtype::file );
-        }
-        // we're done with the disk data
-        drwav_close( file );
+    audio::decoder file { Filename };
+    if( false == file.is_open() ) {
+        ErrorLog( "Bad file: failed to load audio file \"" + Filename + "\"", logtype::file );
     }
-    else if( ends_with( Filename, ".flac" ) ) {
-        // .flac audio data file
-        auto *file { drflac_open_file( Filename.c_str() ) };
-        if( file != nullptr ) {
-            rate = file->sampleRate;
-            auto const samplecount{ static_cast<std::size_t>( file->totalSampleCount ) };
-            data.resize( samplecount );
-            drflac_read_s16(
-                file,
-                samplecount,
-                &data[ 0 ] );
-            if( file->channels > 1 ) {
-                narrow_to_mono( file->channels );
-                data.resize( samplecount / file->channels );
-            }
+    else {
+        rate = file.rate();
+        length = file.frames();
+        // long sounds are decoded piece by piece during playback, so their data doesn't linger in the memory
+        streamed = (
+            ( Global.AudioStreamingThreshold > 0.f )
+         && ( length * sizeof( std::int16_t ) > Global.AudioStreamingThreshold * 1024 * 1024 ) );
+        if( true == streamed ) {
+            WriteLog( "Streaming sound data from \"" + Filename + "\"", logtype::sound );
         }
         else {
-            ErrorLog( "Bad file: failed to load audio file \"" + Filename + "\"", logtype::file );
+            load( file );
         }
-        // we're done with the disk data
-        drflac_close( file );
-    }
-    else if( ends_with( Filename, ".ogg" ) ) {
-        // vorbis .ogg audio data file
-        // TBD, TODO: customized vorbis_decode to avoid unnecessary shuffling around of the decoded data
-        int channels, samplerate;
-        std::int16_t *filedata { nullptr };
-        auto const samplecount { stb_vorbis_decode_filename( Filename.c_str(), &channels, &samplerate, &filedata ) };
-        if( samplecount > 0 ) {
-            rate = samplerate;
-            data.resize( samplecount * channels );
-            std::copy( filedata, filedata + data.size(), std::begin( data ) );
-            free( filedata );
-            if( channels > 1 ) {
-                narrow_to_mono( channels );
-                data.resize( samplecount );
-            }
-        }
-        else {
-            ErrorLog( "Bad file: failed to load audio file \"" + Filename + "\"", logtype::file );
-        }
-    }
-
-    if( false == data.empty() ) {
-        // send the data to openal side
-        ::alBufferData( id, AL_FORMAT_MONO16, data.data(), data.size() * sizeof( std::int16_t ), rate );
-        // and get rid of the source, we shouldn't need it anymore
-        // TBD, TODO: delay data fetching and transfers until the buffer is actually used?
-        std::vector<std::int16_t>().swap( data );
     }
     fetch_caption();
 }
 
-// mix specified number of interleaved multi-channel data, down to mono
+// sends whole audio data to the AL resource. streamed buffer becomes regular one
 void
-openal_buffer::narrow_to_mono( std::uint16_t const Channelcount ) {
- 
-    std::size_t monodataindex { 0 };
-    std::int64_t accumulator { 0 };
-    auto channelcount { Channelcount };
+openal_buffer::load() {
+
+    if( id != null_resource ) { return; } // already loaded
 
-    for( auto const channeldata : data ) {
+    audio::decoder file { name };
+    if( false == file.is_open() ) {
+        ErrorLog( "Bad file: failed to load audio file \"" + name + "\"", logtype::file );
+        return;
+    }
+    load( file );
+}
 
-        accumulator += channeldata;
-        if( --channelcount == 0 ) {
+void
+openal_buffer::load( audio::decoder &File ) {
 
-            data[ monodataindex++ ] = static_cast<std::int16_t>( accumulator / Channelcount );
-            accumulator = 0;
-            channelcount = Channelcount;
-        }
+    WriteLog( "Loading sound data from \"" + name + "\"", logtype::sound );
+
+    ::alGenBuffers( 1, &id );
+    // fetch audio data
+    std::vector<std::int16_t> data( File.frames() * File.channels() );
+    data.resize( File.read( data.data(), File.frames() ) * File.channels() );
+    if( File.channels() > 1 ) {
+        narrow_to_mono( data, File.channels() );
     }
+    if( false == data.empty() ) {
+        // send the data to openal side
+        ::alBufferData( id, AL_FORMAT_MONO16, data.data(), data.size() * sizeof( std::int16_t ), rate );
+    }
+    // the source data gets discarded on the way out, we shouldn't need it anymore
+    // TBD, TODO: delay data fetching and transfers until the buffer is actually used?
+    length = data.size();
+    streamed = false;
 }
 
 // retrieves sound caption in currently set language
@@ -205,6 +156,18 @@ buffer_manager::buffer( audio::buffer_handle const Buffer ) const {
     return m_buffers[ Buffer ];
 }
 
+// sends whole audio data of specified streamed buffer to its AL resource, so the buffer can be used in multi-part sequences
+void
+buffer_manager::load( audio::buffer_handle const Buffer ) {
+
+    if( Buffer == null_handle ) { return; }
+
+    auto &buffer { m_buffers[ Buffer ] };
+    if( true == buffer.streamed ) {
+        buffer.load();
+    }
+}
+
 // places in the bank a buffer containing data stored in specified file. returns: handle to the buffer
 audio::buffer_handle
 buffer_manager::emplace( std::string Filename ) {
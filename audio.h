@@ -9,18 +9,18 @@ http://mozilla.org/MPL/2.0/.
 
 #pragma once
 
-#include "al.h"
+#include "audiostream.h"
 #include "alc.h"
 
 namespace audio {
 
-ALuint const null_resource{ ~( ALuint { 0 } ) };
-
 // wrapper for audio sample
 struct openal_buffer {
 // members
-    ALuint id { null_resource }; // associated AL resource
+    ALuint id { null_resource }; // associated AL resource. not used by streamed buffers
     unsigned int rate {}; // sample rate of the data
+    std::size_t length {}; // number of samples in the (mono) data
+    bool streamed { false }; // data is decoded during playback, rather than held whole in the AL resource
     std::string name;
     std::string caption;
 // constructors
@@ -30,14 +30,14 @@ struct openal_buffer {
     // retrieves sound caption in currently set language
     void
         fetch_caption();
+    // sends whole audio data to the AL resource. streamed buffer becomes regular one
+    void
+        load();
 
 private:
 // methods
-    // mix specified number of interleaved multi-channel data, down to mono
     void
-        narrow_to_mono( std::uint16_t const Channelcount );
-// members
-    std::vector<std::int16_t> data; // audio data
+        load( audio::decoder &File );
 };
 
 using buffer_handle = std::size_t;
@@ -58,6 +58,9 @@ public:
     // provides direct access to a specified buffer
     audio::openal_buffer const &
         buffer( audio::buffer_handle const Buffer ) const;
+    // sends whole audio data of specified streamed buffer to its AL resource, so the buffer can be used in multi-part sequences
+    void
+        load( audio::buffer_handle const Buffer );
 
 private:
 // types
@@ -39,10 +39,64 @@ limit_velocity( glm::vec3 const &Velocity ) {
             Velocity );
 }
 
+// returns current volume settings of sound categories
+audio::category_volumes
+volume_settings() {
+
+    return {
+        Global.VehicleVolume,
+        Global.EnvironmentPositionalVolume,
+        Global.EnvironmentAmbientVolume };
+}
+
+// places assigned buffers in the queue of the AL source, with playback set to start from specified point of the first one, in 0-1 range
+void
+openal_source::queue_buffers( float const Start ) {
+
+    if( id == audio::null_resource ) { return; }
+
+    // long single-part sounds are fed to the source piece by piece
+    if( ( false == is_multipart )
+     && ( true == audio::renderer.buffer( buffers.front() ).streamed ) ) {
+        stream = std::make_shared<audio::openal_stream>( audio::renderer.buffer( buffers.front() ).name );
+        stream->loop( is_looping );
+        stream->bind( id, Start );
+        ::alSourceRewind( id );
+        return;
+    }
+    // look up and queue assigned buffers
+    // NOTE: multi-part sounds rely on the buffer queue of the source to track the active part, so their buffers can't be streamed.
+    // the emitters load streamed buffers they can use in such sequences whole, when they're created
+    std::vector<ALuint> bufferids;
+    for( auto const bufferhandle : buffers ) {
+        bufferids.emplace_back( audio::renderer.buffer( bufferhandle ).id );
+    }
+    ::alSourceQueueBuffers( id, static_cast<ALsizei>( bufferids.size() ), bufferids.data() );
+    ::alSourceRewind( id );
+    if( Start == 0.f ) {
+        // regular case with no offset, reset bound source just in case
+        ::alSourcei( id, AL_SAMPLE_OFFSET, 0 );
+    }
+    else {
+        // move playback start to specified point in 0-1 range
+        ALint buffersize;
+        ::alGetBufferi( bufferids.front(), AL_SIZE, &buffersize );
+        ::alSourcei(
+            id,
+            AL_SAMPLE_OFFSET,
+            static_cast<ALint>( Start * ( buffersize / sizeof( std::int16_t ) ) ) );
+    }
+}
+
 // starts playback of queued buffers
 void
 openal_source::play() {
 
+    if( true == is_virtual ) {
+        // virtual source only tracks the playback
+        is_playing = true;
+        return;
+    }
     if( id == audio::null_resource ) { return; } // no implementation-side source to match, no point
 
     ::alGetError(); // pop the error stack
@@ -63,6 +117,11 @@ openal_source::play() {
 void
 openal_source::stop() {
 
+    if( true == is_virtual ) {
+        loop( false );
+        is_playing = false;
+        return;
+    }
     if( id == audio::null_resource ) { return; } // no implementation-side source to match, no point
 
     loop( false );
@@ -91,7 +150,19 @@ openal_source::update( double const Deltatime, glm::vec3 const &Listenervelocity
         stop();
     }
 */
-    if( id != audio::null_resource ) {
+    if( ( id != audio::null_resource )
+     && ( stream != nullptr ) ) {
+
+        sound_change = false;
+        stream->update( id );
+        // streamed sound is single-part, so the sequence is done once the stream runs dry
+        sound_index = ( stream->is_finished() ? 1 : 0 );
+
+        int state;
+        ::alGetSourcei( id, AL_SOURCE_STATE, &state );
+        is_playing = ( state == AL_PLAYING );
+    }
+    else if( id != audio::null_resource ) {
 
         sound_change = false;
         ::alGetSourcei( id, AL_BUFFERS_PROCESSED, &sound_index );
@@ -102,6 +173,7 @@ openal_source::update( double const Deltatime, glm::vec3 const &Listenervelocity
             && ( sounds.size() > 1 ) ) {
             ::alSourceUnqueueBuffers( id, 1, &bufferid );
             sounds.erase( std::begin( sounds ) );
+            buffers.erase( std::begin( buffers ) );
             --sound_index;
             sound_change = true;
         }
@@ -110,6 +182,13 @@ openal_source::update( double const Deltatime, glm::vec3 const &Listenervelocity
         ::alGetSourcei( id, AL_SOURCE_STATE, &state );
         is_playing = ( state == AL_PLAYING );
     }
+    else if( true == is_virtual ) {
+
+        sound_change = false;
+        if( true == is_playing ) {
+            update_virtual( Deltatime );
+        }
+    }
 
     // request instructions from the controller
     controller->update( *this );
@@ -119,7 +198,8 @@ openal_source::update( double const Deltatime, glm::vec3 const &Listenervelocity
 void
 openal_source::sync_with( sound_properties const &State ) {
 
-    if( id == audio::null_resource ) {
+    if( ( id == audio::null_resource )
+     && ( false == is_virtual ) ) {
         // no implementation-side source to match, return sync error so the controller can clean up on its end
         sync = sync_state::bad_resource;
         return;
@@ -131,8 +211,6 @@ openal_source::sync_with( sound_properties const &State ) {
         // after sound position was initialized we can start velocity calculations
         sound_velocity = limit_velocity( ( State.location - properties.location ) / update_deltatime );
     }
-    // NOTE: velocity at this point can be either listener velocity for global sounds, actual sound velocity, or 0 if sound position is yet unknown
-    ::alSourcefv( id, AL_VELOCITY, glm::value_ptr( sound_velocity ) );
     // location
     sound_distance = State.location - glm::dvec3 { Global.pCamera.Pos };
     if( sound_range != -1 ) {
@@ -148,6 +226,14 @@ openal_source::sync_with( sound_properties const &State ) {
             return;
         }
     }
+    if( true == is_virtual ) {
+        // virtual source only keeps track of the properties, they're sent to the AL source if the emitter gets one
+        properties = State;
+        sync = sync_state::good;
+        return;
+    }
+    // NOTE: velocity at this point can be either listener velocity for global sounds, actual sound velocity, or 0 if sound position is yet unknown
+    ::alSourcefv( id, AL_VELOCITY, glm::value_ptr( sound_velocity ) );
     if( sound_range >= 0 ) {
         ::alSourcefv( id, AL_POSITION, glm::value_ptr( sound_distance ) );
     }
@@ -156,13 +242,7 @@ openal_source::sync_with( sound_properties const &State ) {
         ::alSourcefv( id, AL_POSITION, glm::value_ptr( glm::vec3() ) );
     }
     // gain
-    auto const gain {
-        State.gain
-        * State.soundproofing
-        * ( State.category == sound_category::vehicle ? Global.VehicleVolume :
-            State.category == sound_category::local ? Global.EnvironmentPositionalVolume :
-            State.category == sound_category::ambient ? Global.EnvironmentAmbientVolume :
-            1.f ) };
+    auto const gain { category_gain( State, volume_settings() ) };
     if( ( State.gain != properties.gain )
      || ( State.soundproofing_stamp != properties.soundproofing_stamp )
      || ( audio::event_volume_change ) ) {
@@ -232,10 +312,16 @@ openal_source::pitch( float const Pitch ) {
 void
 openal_source::loop( bool const State ) {
 
-    if( id == audio::null_resource ) { return; } // no implementation-side source to match, no point
     if( is_looping == State ) { return; }
 
     is_looping = State;
+    // NOTE: virtual sources only keep the flag, to be applied if they get an AL source
+    if( id == audio::null_resource ) { return; } // no implementation-side source to match, no point
+    if( stream != nullptr ) {
+        // streamed data is looped by the stream, as the source holds only part of the sound at a time
+        stream->loop( State );
+        return;
+    }
     ::alSourcei(
         id,
         AL_LOOPING,
@@ -253,11 +339,17 @@ openal_source::clear() {
         // unqueue bound buffers:
         // ensure no buffer is in use...
         stop();
-        // ...prepare space for returned ids of unqueued buffers (not that we need that info)...
-        std::vector<ALuint> bufferids;
-        bufferids.resize( sounds.size() );
-        // ...release the buffers...
-        ::alSourceUnqueueBuffers( id, bufferids.size(), bufferids.data() );
+        if( stream != nullptr ) {
+            // ...streams can have any number of queued buffers, so release them all in one go...
+            ::alSourcei( id, AL_BUFFER, 0 );
+        }
+        else {
+            // ...prepare space for returned ids of unqueued buffers (not that we need that info)...
+            std::vector<ALuint> bufferids;
+            bufferids.resize( sounds.size() );
+            // ...release the buffers...
+            ::alSourceUnqueueBuffers( id, bufferids.size(), bufferids.data() );
+        }
     }
     // ...and reset reset the properties, except for the id of the allocated source
     // NOTE: not strictly necessary since except for the id the source data typically get discarded in next step
@@ -266,6 +358,101 @@ openal_source::clear() {
     id = sourceid;
 }
 
+// estimates loudness of the emitted sound at the listener location, with specified volume settings
+float
+openal_source::audibility( audio::category_volumes const &Volumes ) const {
+
+    if( false == is_playing ) { return 0.f; }
+
+    return estimate_audibility( properties, sound_range, glm::length( sound_distance ), Volumes );
+}
+
+// releases AL resource of the playing source, which continues as virtual one. returns: released resource
+ALuint
+openal_source::virtualize() {
+
+    ALfloat offset { 0.f };
+    ::alGetSourcef( id, AL_SEC_OFFSET, &offset );
+    ::alSourceStop( id );
+    ::alSourcei( id, AL_LOOPING, AL_FALSE );
+    ::alSourcei( id, AL_BUFFER, 0 );
+    stream.reset();
+
+    auto const sourceid { id };
+    id = audio::null_resource;
+    is_virtual = true;
+    virtual_offset = offset;
+    // the offset is measured from the start of the queue, so it can extend past the first sample of multi-part sound
+    update_virtual( 0.0 );
+
+    return sourceid;
+}
+
+// assigns provided AL resource to the virtual source, and resumes playback from the tracked point
+void
+openal_source::realize( ALuint const Source ) {
+
+    id = Source;
+    is_virtual = false;
+
+    auto const &buffer { audio::renderer.buffer( buffers.front() ) };
+    queue_buffers(
+        buffer.length > 0 ?
+            clamp<float>( virtual_offset * buffer.rate / buffer.length, 0.f, 1.f ) :
+            0.f );
+    if( stream == nullptr ) {
+        ::alSourcei( id, AL_LOOPING, ( is_looping ? AL_TRUE : AL_FALSE ) );
+    }
+    range( sound_range );
+    // invalidate cached state of the emitter, to send full set of properties to the AL source
+    auto const state { properties };
+    properties.gain = -1.f;
+    properties.pitch = -1.f;
+    is_in_range = false;
+    sync_with( state );
+
+    if( true == is_playing ) {
+        ::alSourcePlay( id );
+    }
+}
+
+// advances tracked playback point of the virtual source by specified time
+void
+openal_source::update_virtual( double const Deltatime ) {
+
+    virtual_offset += Deltatime * clamp( properties.pitch * pitch_variation, 0.1f, 10.f );
+
+    while( false == buffers.empty() ) {
+
+        auto const &buffer { audio::renderer.buffer( buffers.front() ) };
+        auto const duration { (
+            buffer.rate > 0 ?
+                static_cast<double>( buffer.length ) / buffer.rate :
+                0.0 ) };
+        if( virtual_offset < duration ) { break; }
+
+        if( buffers.size() > 1 ) {
+            // move on to the next sample of multi-part sound
+            virtual_offset -= duration;
+            buffers.erase( std::begin( buffers ) );
+            sounds.erase( std::begin( sounds ) );
+            sound_change = true;
+        }
+        else if( ( true == is_looping )
+              && ( duration > 0.0 ) ) {
+            virtual_offset = std::fmod( virtual_offset, duration );
+            break;
+        }
+        else {
+            // last sample is done, and with it the whole sequence
+            is_playing = false;
+            sound_index = static_cast<int>( sounds.size() );
+            return;
+        }
+    }
+    sound_index = 0;
+}
+
 
 
 openal_renderer::~openal_renderer() {
@@ -289,6 +476,13 @@ openal_renderer::buffer( audio::buffer_handle const Buffer ) const {
     return m_buffers.buffer( Buffer );
 }
 
+// sends whole audio data of specified streamed buffer to its AL resource, so the buffer can be used in multi-part sequences
+void
+openal_renderer::load_buffer( audio::buffer_handle const Buffer ) {
+
+    m_buffers.load( Buffer );
+}
+
 // initializes the service
 bool
 openal_renderer::init() {
@@ -317,10 +511,8 @@ openal_renderer::erase( sound_source const *Controller ) {
         if( source->controller == Controller ) {
             // if the controller is the one specified, kill it
             source->clear();
-            if( source->id != audio::null_resource ) {
-                // keep around functional sources, but no point in doing it with the above-the-limit ones
-                m_sourcespares.push( source->id );
-            }
+            // keep around functional sources, but no point in doing it with the above-the-limit ones
+            m_voices.release( source->id );
             source = m_sources.erase( source );
         }
         else {
@@ -381,10 +573,8 @@ openal_renderer::update( double const Deltatime ) {
         // if after the update the source isn't playing, put it away on the spare stack, it's done
         if( false == source->is_playing ) {
             source->clear();
-            if( source->id != audio::null_resource ) {
-                // keep around functional sources, but no point in doing it with the above-the-limit ones
-                m_sourcespares.push( source->id );
-            }
+            // keep around functional sources, but no point in doing it with the above-the-limit ones
+            m_voices.release( source->id );
             source = m_sources.erase( source );
         }
         else {
@@ -392,6 +582,8 @@ openal_renderer::update( double const Deltatime ) {
             ++source;
         }
     }
+    // keep the voices with the most audible sources
+    update_voices();
     // reset potentially used volume change flag
     audio::event_volume_change = false;
 }
@@ -401,54 +593,12 @@ audio::openal_source
 openal_renderer::fetch_source() {
 
     audio::openal_source newsource;
-    if( false == m_sourcespares.empty() ) {
-        // reuse (a copy of) already allocated source
-        newsource.id = m_sourcespares.top();
-        m_sourcespares.pop();
-    }
+    newsource.id = m_voices.acquire( Global.AudioVoices );
     if( newsource.id == audio::null_resource ) {
-        // if there's no source to reuse, try to generate a new one
-        ::alGenSources( 1, &( newsource.id ) );
+        // with all voices taken the new source starts as virtual, it can get a voice later if it's audible enough
+        newsource.is_virtual = true;
     }
-    if( newsource.id == audio::null_resource ) {
-        // if we still don't have a working source, see if we can sacrifice an already active one
-        // under presumption it's more important to play new sounds than keep the old ones going
-        // TBD, TODO: for better results we could use range and/or position for the new sound
-        // to better weight whether the new sound is really more important
-        auto leastimportantsource { std::end( m_sources ) };
-        auto leastimportantweight { std::numeric_limits<float>::max() };
-
-        for( auto source { std::begin( m_sources ) }; source != std::cend( m_sources ); ++source ) {
-
-            if( ( source->id == audio::null_resource )
-             || ( true == source->is_multipart )
-             || ( false == source->is_playing ) ) {
-
-                continue;
-            }
-            auto const sourceweight { (
-                source->sound_range != -1 ?
-                    ( source->sound_range * source->sound_range ) / ( glm::length2( source->sound_distance ) + 1 ) :
-                    std::numeric_limits<float>::max() ) };
-            if( sourceweight < leastimportantweight ) {
-                leastimportantsource = source;
-                leastimportantweight = sourceweight;
-            }
-        }
-        if( ( leastimportantsource != std::end( m_sources ) )
-         && ( leastimportantweight < 1.f ) ) {
-            // only accept the candidate if it's outside of its nominal hearing range
-            leastimportantsource->stop();
-            // HACK: dt of 0 is a roundabout way to notify the controller its emitter has stopped
-            leastimportantsource->update( 0, m_listenervelocity );
-            leastimportantsource->clear();
-            // we should be now free to grab the id and get rid of the remains
-            newsource.id = leastimportantsource->id;
-            m_sources.erase( leastimportantsource );
-        }
-    }
-
-    if( newsource.id == audio::null_resource ) {
+    else {
         // for sources with functional emitter reset emitter parameters from potential last use
         ::alSourcef( newsource.id, AL_PITCH, 1.f );
         ::alSourcef( newsource.id, AL_GAIN, 1.f );
@@ -459,6 +609,52 @@ openal_renderer::fetch_source() {
     return newsource;
 }
 
+// gives available voices to the most audible playing sources, the rest of the sources continues as virtual
+void
+openal_renderer::update_voices() {
+
+    auto const volumes { volume_settings() };
+    std::vector<audio::voice_candidate> candidates;
+    m_voicecandidates.clear();
+    for( auto &source : m_sources ) {
+        if( false == source.is_playing ) { continue; }
+        m_voicecandidates.emplace_back( &source );
+        candidates.push_back( {
+            source.audibility( volumes ),
+            ( false == source.is_virtual ),
+            // streamed sounds keep their voices, as their playback point can't be tracked
+            ( source.stream != nullptr ) } );
+    }
+    m_voices.assign( candidates, Global.AudioVoices );
+}
+
+// creates new AL source. returns: the source, or null_resource if the implementation can't provide more
+ALuint
+openal_renderer::create_voice() {
+
+    ALuint sourceid { audio::null_resource };
+    ::alGetError(); // pop the error stack
+    ::alGenSources( 1, &sourceid );
+    if( ::alGetError() != AL_NO_ERROR ) {
+        return audio::null_resource;
+    }
+    return sourceid;
+}
+
+// takes AL source away from specified playing source, which continues as virtual one. returns: released AL source
+ALuint
+openal_renderer::virtualize( std::size_t const Emitter ) {
+
+    return m_voicecandidates[ Emitter ]->virtualize();
+}
+
+// hands AL source to specified virtual source, which resumes playback from its tracked point
+void
+openal_renderer::realize( std::size_t const Emitter, ALuint const Voice ) {
+
+    m_voicecandidates[ Emitter ]->realize( Voice );
+}
+
 bool
 openal_renderer::init_caps() {
 
@@ -10,6 +10,7 @@ http://mozilla.org/MPL/2.0/.
 #pragma once
 
 #include "audio.h"
+#include "audiovoices.h"
 #include "ResourceManager.h"
 #include "uitranscripts.h"
 
@@ -20,23 +21,6 @@ class sound_source;
 
 using uint32_sequence = std::vector<std::uint32_t>;
 
-enum class sound_category : unsigned int {
-    unknown = 0, // source gain is unaltered
-    vehicle, // source gain is altered by vehicle sound volume modifier
-    local, // source gain is altered by positional environment sound volume modifier
-    ambient, // source gain is altered by ambient environment sound volume modifier
-};
-
-// sound emitter state sync item
-struct sound_properties {
-    glm::dvec3 location;
-    float pitch { 1.f };
-    sound_category category { sound_category::unknown };
-    float gain { 1.f };
-    float soundproofing { 1.f };
-    std::uintptr_t soundproofing_stamp { ~( std::uintptr_t{ 0 } ) };
-};
-
 enum class sync_state {
     good,
     bad_distance,
@@ -58,13 +42,15 @@ struct openal_source {
     ALuint id { audio::null_resource }; // associated AL resource
     sound_source *controller { nullptr }; // source controller 
     uint32_sequence sounds; // 
-//    buffer_sequence buffers; // sequence of samples the source will emit
+    buffer_sequence buffers; // sequence of samples the source will emit
     int sound_index { 0 }; // currently queued sample from the buffer sequence
     bool sound_change { false }; // indicates currently queued sample has changed
     bool is_playing { false };
     bool is_looping { false };
+    bool is_virtual { false }; // source has no AL resource, its playback is only tracked until it gets one
     sound_properties properties;
     sync_state sync { sync_state::good };
+    std::shared_ptr<audio::openal_stream> stream; // data feed of streamed sound, if any
 // constructors
     openal_source() = default;
 // methods
@@ -96,10 +82,27 @@ struct openal_source {
     // NOTE: doesn't release allocated implementation-side source
     void
         clear();
+    // estimates loudness of the emitted sound at the listener location, with specified volume settings
+    float
+        audibility( audio::category_volumes const &Volumes ) const;
+    // releases AL resource of the playing source, which continues as virtual one. returns: released resource
+    ALuint
+        virtualize();
+    // assigns provided AL resource to the virtual source, and resumes playback from the tracked point
+    void
+        realize( ALuint const Source );
 
 private:
+// methods
+    // places assigned buffers in the queue of the AL source, with playback set to start from specified point of the first one, in 0-1 range
+    void
+        queue_buffers( float const Start );
+    // advances tracked playback point of the virtual source by specified time
+    void
+        update_virtual( double const Deltatime );
 // members
     double update_deltatime { 0.0 }; // time delta of most current update
+    double virtual_offset { 0.0 }; // tracked playback point in current sample of the virtual source, in seconds
     float pitch_variation { 1.f }; // emitter-specific variation of the base pitch
     float sound_range { 50.f }; // cached audible range of the emitted samples
     glm::vec3 sound_distance { 0.f }; // cached distance between sound and the listener
@@ -110,7 +113,7 @@ private:
 
 
 
-class openal_renderer {
+class openal_renderer : public audio::voice_backend {
 
     friend opengl_renderer;
 
@@ -127,6 +130,9 @@ public:
     // provides direct access to a specified buffer
     audio::openal_buffer const &
         buffer( audio::buffer_handle const Buffer ) const;
+    // sends whole audio data of specified streamed buffer to its AL resource, so the buffer can be used in multi-part sequences
+    void
+        load_buffer( audio::buffer_handle const Buffer );
     // core methods
     // initializes the service
     bool
@@ -146,13 +152,25 @@ public:
 private:
 // types
     using source_list = std::list<audio::openal_source>;
-    using source_sequence = std::stack<ALuint>;
 // methods
     bool
         init_caps();
     // returns an instance of implementation-side part of the sound emitter
     audio::openal_source
         fetch_source();
+    // gives available voices to the most audible playing sources, the rest of the sources continues as virtual
+    void
+        update_voices();
+    // voice_backend methods
+    // creates new AL source. returns: the source, or null_resource if the implementation can't provide more
+    ALuint
+        create_voice() override;
+    // takes AL source away from specified playing source, which continues as virtual one. returns: released AL source
+    ALuint
+        virtualize( std::size_t const Emitter ) override;
+    // hands AL source to specified virtual source, which resumes playback from its tracked point
+    void
+        realize( std::size_t const Emitter, ALuint const Voice ) override;
 // members
     ALCdevice * m_device { nullptr };
     ALCcontext * m_context { nullptr };
@@ -169,7 +187,8 @@ private:
     buffer_manager m_buffers;
     // TBD: list of sources as vector, sorted by distance, for openal implementations with limited number of active sources?
     source_list m_sources;
-    source_sequence m_sourcespares; // already created and currently unused sound sources
+    audio::voice_pool m_voices { *this };
+    std::vector<audio::openal_source *> m_voicecandidates; // playing sources, in order of the last voice assignment
 };
 
 extern openal_renderer renderer;
@@ -183,33 +202,15 @@ openal_source::bind( sound_source *Controller, uint32_sequence Sounds, Iterator_
 
     controller = Controller;
     sounds = Sounds;
-    // look up and queue assigned buffers
-    std::vector<ALuint> buffers;
-    std::for_each(
-        First, Last,
-        [&]( audio::buffer_handle const &bufferhandle ) {
-            auto const &buffer { audio::renderer.buffer( bufferhandle ) };
-            buffers.emplace_back( buffer.id ); } );
-
+    buffers.assign( First, Last );
     is_multipart = ( buffers.size() > 1 );
-
-    if( id != audio::null_resource ) {
-        ::alSourceQueueBuffers( id, static_cast<ALsizei>( buffers.size() ), buffers.data() );
-        ::alSourceRewind( id );
-        // sound controller can potentially request playback to start from certain buffer point
-        if( controller->start() == 0.f ) {
-            // regular case with no offset, reset bound source just in case
-            ::alSourcei( id, AL_SAMPLE_OFFSET, 0 );
-        }
-        else {
-            // move playback start to specified point in 0-1 range
-            ALint buffersize;
-            ::alGetBufferi( buffers.front(), AL_SIZE, &buffersize );
-            ::alSourcei(
-                id,
-                AL_SAMPLE_OFFSET,
-                static_cast<ALint>( controller->start() * ( buffersize / sizeof( std::int16_t ) ) ) );
-        }
+    // sound controller can potentially request playback to start from certain buffer point
+    if( true == is_virtual ) {
+        auto const &buffer { audio::renderer.buffer( buffers.front() ) };
+        virtual_offset = controller->start() * buffer.length / std::max( 1u, buffer.rate );
+    }
+    else {
+        queue_buffers( controller->start() );
     }
 
     return *this;
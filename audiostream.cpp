@@ -0,0 +1,286 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "audiostream.h"
+
+#define STB_VORBIS_HEADER_ONLY
+#include "stb_vorbis.c"
+#define DR_WAV_IMPLEMENTATION
+#include "dr_wav.h"
+#define DR_FLAC_IMPLEMENTATION
+#include "dr_flac.h"
+
+namespace audio {
+
+std::size_t const EU07_SOUND_STREAMBLOCKSIZE { 16384 }; // samples per buffer of streamed sound, ~0.37 sec at 44.1 kHz
+std::size_t const EU07_SOUND_STREAMBUFFERCOUNT { 4 }; // buffers in the ring of streamed sound
+
+// mixes interleaved multi-channel data down to mono
+void
+narrow_to_mono( std::vector<std::int16_t> &Data, std::uint16_t const Channelcount ) {
+
+    std::size_t monodataindex { 0 };
+    std::int64_t accumulator { 0 };
+    auto channelcount { Channelcount };
+
+    for( auto const channeldata : Data ) {
+
+        accumulator += channeldata;
+        if( --channelcount == 0 ) {
+
+            Data[ monodataindex++ ] = static_cast<std::int16_t>( accumulator / Channelcount );
+            accumulator = 0;
+            channelcount = Channelcount;
+        }
+    }
+    Data.resize( Data.size() / Channelcount );
+}
+
+
+
+decoder::decoder( std::string const &Filename ) {
+
+    auto const extension { std::filesystem::path( Filename ).extension().string() };
+
+    if( extension == ".wav" ) {
+        // .wav audio data file
+        auto *file { drwav_open_file( Filename.c_str() ) };
+        if( file != nullptr ) {
+            m_file = file;
+            m_format = format::wav;
+            m_rate = file->sampleRate;
+            m_channels = file->channels;
+            m_frames = static_cast<std::size_t>( file->totalSampleCount / file->channels );
+        }
+    }
+    else if( extension == ".flac" ) {
+        // .flac audio data file
+        auto *file { drflac_open_file( Filename.c_str() ) };
+        if( file != nullptr ) {
+            m_file = file;
+            m_format = format::flac;
+            m_rate = file->sampleRate;
+            m_channels = file->channels;
+            m_frames = static_cast<std::size_t>( file->totalSampleCount / file->channels );
+        }
+    }
+    else if( extension == ".ogg" ) {
+        // vorbis .ogg audio data file
+        auto *file { stb_vorbis_open_filename( Filename.c_str(), nullptr, nullptr ) };
+        if( file != nullptr ) {
+            auto const info { stb_vorbis_get_info( file ) };
+            m_file = file;
+            m_format = format::ogg;
+            m_rate = info.sample_rate;
+            m_channels = static_cast<std::uint16_t>( info.channels );
+            m_frames = stb_vorbis_stream_length_in_samples( file );
+        }
+    }
+    if( m_channels == 0 ) {
+        // sanity check, shouldn't happen with valid files
+        close();
+    }
+}
+
+void
+decoder::close() {
+
+    if( m_file == nullptr ) { return; }
+
+    switch( m_format ) {
+        case format::wav:  { drwav_close( static_cast<drwav *>( m_file ) ); break; }
+        case format::flac: { drflac_close( static_cast<drflac *>( m_file ) ); break; }
+        case format::ogg:  { stb_vorbis_close( static_cast<stb_vorbis *>( m_file ) ); break; }
+        default:           { break; }
+    }
+    m_file = nullptr;
+}
+
+// reads up to specified number of frames of interleaved audio data. returns: number of read frames
+std::size_t
+decoder::read( std::int16_t *Output, std::size_t const Framecount ) {
+
+    if( m_file == nullptr ) { return 0; }
+
+    switch( m_format ) {
+        case format::wav: {
+            return static_cast<std::size_t>( drwav_read_s16( static_cast<drwav *>( m_file ), Framecount * m_channels, Output ) / m_channels ); }
+        case format::flac: {
+            return static_cast<std::size_t>( drflac_read_s16( static_cast<drflac *>( m_file ), Framecount * m_channels, Output ) / m_channels ); }
+        case format::ogg: {
+            return static_cast<std::size_t>( stb_vorbis_get_samples_short_interleaved( static_cast<stb_vorbis *>( m_file ), m_channels, Output, static_cast<int>( Framecount * m_channels ) ) ); }
+        default: {
+            return 0; }
+    }
+}
+
+// moves read position to specified frame. returns: true on success
+bool
+decoder::seek( std::size_t const Frame ) {
+
+    if( m_file == nullptr ) { return false; }
+
+    switch( m_format ) {
+        case format::wav: {
+            return ( drwav_seek_to_sample( static_cast<drwav *>( m_file ), Frame * m_channels ) == DRWAV_TRUE ); }
+        case format::flac: {
+            return ( drflac_seek_to_sample( static_cast<drflac *>( m_file ), Frame * m_channels ) == DRFLAC_TRUE ); }
+        case format::ogg: {
+            return ( stb_vorbis_seek( static_cast<stb_vorbis *>( m_file ), static_cast<unsigned int>( Frame ) ) != 0 ); }
+        default: {
+            return false; }
+    }
+}
+
+
+
+openal_stream::openal_stream( std::string const &Filename ) :
+    m_decoding( std::make_shared<decode_state>( Filename ) ) {
+
+    m_rate = m_decoding->decoder.rate();
+    m_buffers.resize( EU07_SOUND_STREAMBUFFERCOUNT, null_resource );
+    ::alGenBuffers( static_cast<ALsizei>( m_buffers.size() ), m_buffers.data() );
+    m_freebuffers = m_buffers;
+    m_decoding->ended = ( false == m_decoding->decoder.is_open() );
+}
+
+openal_stream::~openal_stream() {
+
+    // pending decode job keeps the decoder alive on its own, and its results are no longer needed
+    ::alDeleteBuffers( static_cast<ALsizei>( m_buffers.size() ), m_buffers.data() );
+}
+
+// queues initial data in specified source, starting from specified point of the sound in 0-1 range
+void
+openal_stream::bind( ALuint const Source, float const Start ) {
+
+    auto &decoding { *m_decoding };
+    if( Start > 0.f ) {
+        decoding.decoder.seek( static_cast<std::size_t>( Start * decoding.decoder.frames() ) );
+    }
+    // the first block is decoded right away, so the playback can start without delay. the rest is left to the job system
+    decoding.decode( 1 );
+    queue_blocks( Source );
+    request_blocks();
+}
+
+// moves newly decoded data to buffers already played by specified source, and resumes playback interrupted by data starvation
+void
+openal_stream::update( ALuint const Source ) {
+
+    // reclaim played buffers
+    ALint processedcount { 0 };
+    ::alGetSourcei( Source, AL_BUFFERS_PROCESSED, &processedcount );
+    while( processedcount > 0 ) {
+        ALuint bufferid;
+        ::alSourceUnqueueBuffers( Source, 1, &bufferid );
+        m_freebuffers.emplace_back( bufferid );
+        --m_queuedcount;
+        --processedcount;
+    }
+
+    if( true == is_decoding() ) {
+        // decoded data isn't ready yet, we'll try again next time. a source which ran dry stays stopped until then
+        return;
+    }
+    auto &decoding { *m_decoding };
+    if( ( true == decoding.ended )
+     && ( true == decoding.looping ) ) {
+        // looping might have been enabled after all data was decoded
+        decoding.ended = ( false == decoding.decoder.seek( 0 ) );
+    }
+    queue_blocks( Source );
+    request_blocks();
+
+    ALint state;
+    ::alGetSourcei( Source, AL_SOURCE_STATE, &state );
+    if( ( state == AL_STOPPED )
+     && ( m_queuedcount > 0 ) ) {
+        ::alSourcePlay( Source );
+    }
+}
+
+// returns true if all data was played and released by the source
+bool
+openal_stream::is_finished() const {
+
+    if( true == is_decoding() ) {
+        return false;
+    }
+    return (
+        ( true == m_decoding->ended )
+     && ( m_queuedcount == 0 )
+     && ( true == m_decoding->blocks.empty() ) );
+}
+
+// decodes up to specified number of blocks of audio data
+void
+openal_stream::decode_state::decode( std::size_t const Blockcount ) {
+
+    auto const channels { decoder.channels() };
+
+    while( ( blocks.size() < Blockcount )
+        && ( false == ended ) ) {
+
+        std::vector<std::int16_t> block( EU07_SOUND_STREAMBLOCKSIZE * channels );
+        auto framecount { decoder.read( block.data(), EU07_SOUND_STREAMBLOCKSIZE ) };
+        if( ( framecount < EU07_SOUND_STREAMBLOCKSIZE )
+         && ( true == looping )
+         && ( true == decoder.seek( 0 ) ) ) {
+            // looping sound continues from the start, without gap between the blocks
+            framecount += decoder.read( block.data() + framecount * channels, EU07_SOUND_STREAMBLOCKSIZE - framecount );
+        }
+        ended = ( framecount < EU07_SOUND_STREAMBLOCKSIZE );
+        if( framecount == 0 ) { break; }
+
+        block.resize( framecount * channels );
+        if( channels > 1 ) {
+            narrow_to_mono( block, channels );
+        }
+        blocks.emplace_back( std::move( block ) );
+    }
+}
+
+// schedules decoding of blocks for currently unused AL buffers
+void
+openal_stream::request_blocks() {
+
+    if( ( true == m_decoding->ended )
+     || ( m_freebuffers.size() <= m_decoding->blocks.size() ) ) {
+        return;
+    }
+    auto const blockcount { m_freebuffers.size() };
+    m_decodejob =
+        threading::jobs.submit(
+            [ decoding = m_decoding, blockcount ]() {
+                decoding->decode( blockcount ); } );
+}
+
+// sends decoded blocks to unused AL buffers and places them in the queue of specified source
+void
+openal_stream::queue_blocks( ALuint const Source ) {
+
+    auto &blocks { m_decoding->blocks };
+    while( ( false == blocks.empty() )
+        && ( false == m_freebuffers.empty() ) ) {
+
+        auto const bufferid { m_freebuffers.back() };
+        auto const &block { blocks.front() };
+        ::alBufferData( bufferid, AL_FORMAT_MONO16, block.data(), static_cast<ALsizei>( block.size() * sizeof( std::int16_t ) ), m_rate );
+        ::alSourceQueueBuffers( Source, 1, &bufferid );
+        m_freebuffers.pop_back();
+        blocks.pop_front();
+        ++m_queuedcount;
+    }
+}
+
+} // audio
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "al.h"
+#include "jobsystem.h"
+
+namespace audio {
+
+ALuint const null_resource{ ~( ALuint { 0 } ) };
+
+// mixes interleaved multi-channel data down to mono
+void
+narrow_to_mono( std::vector<std::int16_t> &Data, std::uint16_t const Channelcount );
+
+// sequential reader of audio data stored in .wav, .flac or .ogg file
+class decoder {
+
+public:
+// constructors
+    explicit decoder( std::string const &Filename );
+    decoder( decoder const & ) = delete;
+    decoder & operator=( decoder const & ) = delete;
+// destructor
+    ~decoder() {
+        close(); }
+// methods
+    // reads up to specified number of frames of interleaved audio data. returns: number of read frames
+    std::size_t
+        read( std::int16_t *Output, std::size_t const Framecount );
+    // moves read position to specified frame. returns: true on success
+    bool
+        seek( std::size_t const Frame );
+    bool
+        is_open() const {
+            return ( m_file != nullptr ); }
+    unsigned int
+        rate() const {
+            return m_rate; }
+    std::uint16_t
+        channels() const {
+            return m_channels; }
+    // total number of frames in the file
+    std::size_t
+        frames() const {
+            return m_frames; }
+
+private:
+// types
+    enum class format {
+        wav,
+        flac,
+        ogg
+    };
+// methods
+    void
+        close();
+// members
+    void *m_file { nullptr }; // decoder-specific file handle
+    format m_format { format::wav };
+    unsigned int m_rate {};
+    std::uint16_t m_channels {};
+    std::size_t m_frames {};
+};
+
+// feeds audio data of a streamed sound file to a single source, through a small ring of AL buffers refilled with data decoded ahead by the job system
+class openal_stream {
+
+public:
+// constructors
+    explicit openal_stream( std::string const &Filename );
+    openal_stream( openal_stream const & ) = delete;
+    openal_stream & operator=( openal_stream const & ) = delete;
+// destructor
+    ~openal_stream();
+// methods
+    // queues initial data in specified source, starting from specified point of the sound in 0-1 range
+    void
+        bind( ALuint const Source, float const Start );
+    // moves newly decoded data to buffers already played by specified source, and resumes playback interrupted by data starvation
+    void
+        update( ALuint const Source );
+    // returns true if all data was played and released by the source
+    bool
+        is_finished() const;
+    // the sound is repeated until the looping is disabled
+    void
+        loop( bool const State ) {
+            m_decoding->looping = State; }
+
+private:
+// types
+    using block_sequence = std::deque< std::vector<std::int16_t> >;
+    // data shared with the decode job. while the job is pending only the job accesses it, except for the looping flag
+    struct decode_state {
+        audio::decoder decoder;
+        block_sequence blocks; // data decoded for the free resources
+        bool ended { false }; // all data was decoded
+        std::atomic<bool> looping { false };
+    // constructors
+        explicit decode_state( std::string const &Filename ) :
+            decoder( Filename ) {}
+    // methods
+        // decodes up to specified number of blocks of audio data
+        void
+            decode( std::size_t const Blockcount );
+    };
+// methods
+    // returns true if the decode job is still working on the shared data
+    bool
+        is_decoding() const {
+            return ( ( m_decodejob != nullptr ) && ( false == m_decodejob->done() ) ); }
+    // schedules decoding of blocks for currently unused AL buffers
+    void
+        request_blocks();
+    // sends decoded blocks to unused AL buffers and places them in the queue of specified source
+    void
+        queue_blocks( ALuint const Source );
+// members
+    // the decode job holds its own reference to the shared data, so the stream doesn't have to wait for the job when it goes away
+    std::shared_ptr<decode_state> m_decoding;
+    unsigned int m_rate {}; // sample rate of the data
+    std::vector<ALuint> m_buffers; // ring of AL resources
+    std::vector<ALuint> m_freebuffers; // resources not queued in the source
+    int m_queuedcount { 0 }; // number of buffers in the source queue
+    threading::job_handle m_decodejob;
+};
+
+} // audio
+
+//---------------------------------------------------------------------------
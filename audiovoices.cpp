@@ -0,0 +1,131 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "audiovoices.h"
+
+#include "utilities.h"
+#include "Logs.h"
+
+namespace audio {
+
+// returns gain of sound with specified properties, adjusted by volume setting of its category
+float
+category_gain( sound_properties const &State, category_volumes const &Volumes ) {
+
+    return (
+        State.gain
+        * State.soundproofing
+        * ( State.category == sound_category::vehicle ? Volumes.vehicle :
+            State.category == sound_category::local ? Volumes.local :
+            State.category == sound_category::ambient ? Volumes.ambient :
+            1.f ) );
+}
+
+// estimates loudness of sound with specified properties and audible range, at specified distance from the listener
+float
+estimate_audibility( sound_properties const &State, float const Range, float const Distance, category_volumes const &Volumes ) {
+
+    auto const gain { category_gain( State, Volumes ) };
+    if( Range < 0 ) {
+        // sounds with 'unlimited' or negative range are positioned on top of the listener
+        return gain;
+    }
+    // approximation of the inverse distance clamped model, with the parameters the renderer sets for the sources
+    auto const referencedistance { std::max( 0.01f, Range * ( 1.f / 16.f ) * State.soundproofing ) };
+    auto const attenuation { referencedistance / ( referencedistance + 1.75f * ( std::max( Distance, referencedistance ) - referencedistance ) ) };
+    // sounds outside of their nominal hearing range are faded out
+    auto const fadedistance { std::max( 0.01f, Range * 0.75f ) };
+    auto const rangefactor {
+        clamp<float>(
+            1.f - ( Distance * Distance - Range * Range ) / ( fadedistance * fadedistance ),
+            0.f, 1.f ) };
+
+    return gain * attenuation * rangefactor;
+}
+
+// returns device-side source if one is available within specified voice limit, or null_resource
+ALuint
+voice_pool::acquire( int const Voicelimit ) {
+
+    if( false == m_spares.empty() ) {
+        // reuse already allocated source
+        auto const voice { m_spares.top() };
+        m_spares.pop();
+        return voice;
+    }
+    if( m_count >= std::min( Voicelimit, m_limit ) ) {
+        return null_resource;
+    }
+    // if there's no source to reuse, try to create a new one
+    auto const voice { m_backend.create_voice() };
+    if( voice == null_resource ) {
+        // the device ran out of sources, there's no point in asking for more
+        m_limit = m_count;
+        WriteLog( "Audio Renderer: voice limit reduced to " + std::to_string( m_limit ) + " sources", logtype::sound );
+        return null_resource;
+    }
+    ++m_count;
+    return voice;
+}
+
+// puts away no longer used device-side source, for reuse
+void
+voice_pool::release( ALuint const Voice ) {
+
+    if( Voice == null_resource ) { return; }
+
+    m_spares.push( Voice );
+}
+
+// gives available voices to the most audible of provided emitters, the rest of the emitters continues as virtual
+void
+voice_pool::assign( std::vector<voice_candidate> const &Candidates, int const Voicelimit ) {
+
+    using emitter_weight = std::pair<float, std::size_t>;
+    std::vector<emitter_weight> emitters;
+    emitters.reserve( Candidates.size() );
+    for( std::size_t idx = 0; idx < Candidates.size(); ++idx ) {
+        auto const &candidate { Candidates[ idx ] };
+        auto const weight { (
+            candidate.pinned ?
+                std::numeric_limits<float>::max() :
+                candidate.audibility
+                // emitters with voices get an edge, so the voices don't change hands each update between sounds of similar loudness
+                * ( candidate.voiced ? 1.25f : 1.f ) ) };
+        emitters.emplace_back( weight, idx );
+    }
+    auto const voicecount { std::min<std::size_t>( std::max( 0, std::min( Voicelimit, m_limit ) ), emitters.size() ) };
+    if( voicecount < emitters.size() ) {
+        std::nth_element(
+            std::begin( emitters ), std::begin( emitters ) + voicecount, std::end( emitters ),
+            []( emitter_weight const &Left, emitter_weight const &Right ) {
+                return ( Left.first > Right.first ); } );
+    }
+    // take voices away from emitters which didn't make it to the audible set...
+    for( auto idx { voicecount }; idx < emitters.size(); ++idx ) {
+        auto const emitter { emitters[ idx ].second };
+        if( true == Candidates[ emitter ].voiced ) {
+            release( m_backend.virtualize( emitter ) );
+        }
+    }
+    // ...and hand them to these which did
+    for( std::size_t idx = 0; idx < voicecount; ++idx ) {
+        auto const emitter { emitters[ idx ].second };
+        if( false == Candidates[ emitter ].voiced ) {
+            auto const voice { acquire( Voicelimit ) };
+            if( voice == null_resource ) { break; }
+            m_backend.realize( emitter, voice );
+        }
+    }
+}
+
+} // audio
+
+//---------------------------------------------------------------------------
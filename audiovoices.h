@@ -0,0 +1,111 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "audiostream.h"
+
+enum class sound_category : unsigned int {
+    unknown = 0, // source gain is unaltered
+    vehicle, // source gain is altered by vehicle sound volume modifier
+    local, // source gain is altered by positional environment sound volume modifier
+    ambient, // source gain is altered by ambient environment sound volume modifier
+};
+
+// sound emitter state sync item
+struct sound_properties {
+    glm::dvec3 location;
+    float pitch { 1.f };
+    sound_category category { sound_category::unknown };
+    float gain { 1.f };
+    float soundproofing { 1.f };
+    std::uintptr_t soundproofing_stamp { ~( std::uintptr_t{ 0 } ) };
+};
+
+namespace audio {
+
+// volume modifiers of sound categories
+struct category_volumes {
+    float vehicle { 1.f };
+    float local { 1.f };
+    float ambient { 1.f };
+};
+
+// returns gain of sound with specified properties, adjusted by volume setting of its category
+float
+category_gain( sound_properties const &State, category_volumes const &Volumes );
+// estimates loudness of sound with specified properties and audible range, at specified distance from the listener
+float
+estimate_audibility( sound_properties const &State, float const Range, float const Distance, category_volumes const &Volumes );
+
+// device side of the voice management. emitters are identified by their index in the candidate list given to the voice pool
+class voice_backend {
+
+public:
+// destructor
+    virtual ~voice_backend() = default;
+// methods
+    // creates new device-side source. returns: the source, or null_resource if the device can't provide more
+    virtual
+    ALuint
+        create_voice() = 0;
+    // takes device-side source away from specified playing emitter, which continues as virtual one. returns: released source
+    virtual
+    ALuint
+        virtualize( std::size_t const Emitter ) = 0;
+    // hands device-side source to specified virtual emitter, which resumes playback from its tracked point
+    virtual
+    void
+        realize( std::size_t const Emitter, ALuint const Voice ) = 0;
+};
+
+// playing emitter competing for a voice
+struct voice_candidate {
+    float audibility { 0.f }; // estimated loudness at the listener location
+    bool voiced { false }; // the emitter holds device-side source
+    bool pinned { false }; // the emitter can't be virtualized, as its playback point can't be recovered
+};
+
+// keeps track of device-side sources, and hands them to the most audible emitters
+class voice_pool {
+
+public:
+// constructors
+    explicit voice_pool( voice_backend &Backend ) :
+        m_backend( Backend ) {}
+// methods
+    // returns device-side source if one is available within specified voice limit, or null_resource
+    ALuint
+        acquire( int const Voicelimit );
+    // puts away no longer used device-side source, for reuse
+    void
+        release( ALuint const Voice );
+    // gives available voices to the most audible of provided emitters, the rest of the emitters continues as virtual
+    void
+        assign( std::vector<voice_candidate> const &Candidates, int const Voicelimit );
+    // number of created device-side sources
+    int
+        count() const {
+            return m_count; }
+    // max number of device-side sources the device was able to create
+    int
+        limit() const {
+            return m_limit; }
+
+private:
+// members
+    voice_backend &m_backend;
+    std::stack<ALuint> m_spares; // already created and currently unused sources
+    int m_count { 0 };
+    int m_limit { std::numeric_limits<int>::max() };
+};
+
+} // audio
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,177 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace scene {
+
+// bounding volume hierarchy over axis aligned boxes of provided items. the hierarchy is built lazily, on the first lookup after changes
+template <typename Type_>
+class bounding_tree {
+
+public:
+// types
+    using item_sequence = std::vector<Type_ *>;
+// methods
+    // adds provided item with specified bounds to the hierarchy. the hierarchy is rebuilt on the next lookup
+    void
+        insert( Type_ *Item, glm::dvec3 const &Min, glm::dvec3 const &Max );
+    // finds items with bounds overlapping cube of specified half-size around specified point. returns: list of found items
+    item_sequence const &
+        find( glm::dvec3 const &Point, double const Radius );
+    std::size_t
+        size() const {
+            return m_items.size(); }
+
+private:
+// types
+    struct item_data {
+        Type_ *item;
+        glm::dvec3 min;
+        glm::dvec3 max;
+    };
+    struct tree_node {
+        glm::dvec3 min;
+        glm::dvec3 max;
+        int first; // index of the first item held by the leaf node, or of the first child of the inner node
+        int count; // number of items held by the leaf node, 0 for inner nodes
+    };
+// methods
+    // builds the hierarchy from current list of items
+    void
+        build();
+    // fills specified node with specified range of items, subdividing it as needed
+    void
+        build( int const Node, int const First, int const Last );
+// members
+    std::vector<item_data> m_items;
+    std::vector<tree_node> m_nodes;
+    bool m_isdirty { false };
+    std::vector<int> m_stack; // scratchpad for lookups
+    item_sequence m_found; // results of the last lookup
+};
+
+// adds provided item with specified bounds to the hierarchy. the hierarchy is rebuilt on the next lookup
+template <typename Type_>
+void
+bounding_tree<Type_>::insert( Type_ *Item, glm::dvec3 const &Min, glm::dvec3 const &Max ) {
+
+    m_items.push_back( { Item, Min, Max } );
+    m_isdirty = true;
+}
+
+// finds items with bounds overlapping cube of specified half-size around specified point. returns: list of found items
+template <typename Type_>
+typename bounding_tree<Type_>::item_sequence const &
+bounding_tree<Type_>::find( glm::dvec3 const &Point, double const Radius ) {
+
+    if( true == m_isdirty ) {
+        build();
+    }
+    m_found.clear();
+    if( true == m_nodes.empty() ) { return m_found; }
+
+    auto const min { Point - Radius };
+    auto const max { Point + Radius };
+    auto const overlaps {
+        [&]( glm::dvec3 const &Min, glm::dvec3 const &Max ) {
+            return (
+                ( Min.x <= max.x ) && ( Max.x >= min.x )
+             && ( Min.y <= max.y ) && ( Max.y >= min.y )
+             && ( Min.z <= max.z ) && ( Max.z >= min.z ) ); } };
+
+    m_stack.clear();
+    m_stack.emplace_back( 0 );
+    while( false == m_stack.empty() ) {
+        auto const &node { m_nodes[ m_stack.back() ] };
+        m_stack.pop_back();
+        if( false == overlaps( node.min, node.max ) ) { continue; }
+        if( node.count == 0 ) {
+            m_stack.emplace_back( node.first );
+            m_stack.emplace_back( node.first + 1 );
+            continue;
+        }
+        for( auto idx = node.first; idx < node.first + node.count; ++idx ) {
+            auto const &item { m_items[ idx ] };
+            if( true == overlaps( item.min, item.max ) ) {
+                m_found.emplace_back( item.item );
+            }
+        }
+    }
+    return m_found;
+}
+
+// builds the hierarchy from current list of items
+template <typename Type_>
+void
+bounding_tree<Type_>::build() {
+
+    // items can be registered more than once, e.g. traction pieces with both ends in the same section
+    std::sort(
+        std::begin( m_items ), std::end( m_items ),
+        []( item_data const &Left, item_data const &Right ) {
+            return ( Left.item < Right.item ); } );
+    m_items.erase(
+        std::unique(
+            std::begin( m_items ), std::end( m_items ),
+            []( item_data const &Left, item_data const &Right ) {
+                return ( Left.item == Right.item ); } ),
+        std::end( m_items ) );
+
+    m_nodes.clear();
+    if( false == m_items.empty() ) {
+        m_nodes.reserve( 2 * m_items.size() );
+        m_nodes.emplace_back();
+        build( 0, 0, static_cast<int>( m_items.size() ) );
+    }
+    m_isdirty = false;
+}
+
+// fills specified node with specified range of items, subdividing it as needed
+template <typename Type_>
+void
+bounding_tree<Type_>::build( int const Node, int const First, int const Last ) {
+
+    auto min { m_items[ First ].min };
+    auto max { m_items[ First ].max };
+    for( auto idx = First + 1; idx < Last; ++idx ) {
+        min = glm::min( min, m_items[ idx ].min );
+        max = glm::max( max, m_items[ idx ].max );
+    }
+    m_nodes[ Node ].min = min;
+    m_nodes[ Node ].max = max;
+
+    if( Last - First <= 4 ) {
+        m_nodes[ Node ].first = First;
+        m_nodes[ Node ].count = Last - First;
+        return;
+    }
+    // split in half along the longest axis
+    auto const extent { max - min };
+    auto const axis { (
+        extent.x >= extent.y && extent.x >= extent.z ? 0 :
+        extent.y >= extent.z ? 1 :
+        2 ) };
+    auto const middle { First + ( Last - First ) / 2 };
+    std::nth_element(
+        std::begin( m_items ) + First, std::begin( m_items ) + middle, std::begin( m_items ) + Last,
+        [=]( item_data const &Left, item_data const &Right ) {
+            return ( Left.min[ axis ] + Left.max[ axis ] ) < ( Right.min[ axis ] + Right.max[ axis ] ); } );
+
+    auto const child { static_cast<int>( m_nodes.size() ) };
+    m_nodes.resize( m_nodes.size() + 2 );
+    m_nodes[ Node ].first = child;
+    m_nodes[ Node ].count = 0;
+    build( child, First, middle );
+    build( child + 1, middle, Last );
+}
+
+} // scene
+
+//---------------------------------------------------------------------------
@@ -315,40 +315,157 @@ commanddescription_sequence Commands_descriptions = {
 
 } // simulation
 
-// posts specified command for specified recipient
+// bounded lock-free multi-producer, single-consumer queue of posted commands
+struct command_queue::inbound_ring {
+
+    struct cell_data {
+        std::atomic<std::size_t> sequence;
+        command_data command;
+        uint32_t recipient;
+    };
+
+    explicit inbound_ring( std::size_t const Size ) :
+        cells( new cell_data[ Size ] ),
+        mask( Size - 1 ) {
+        for( std::size_t idx = 0; idx < Size; ++idx ) {
+            cells[ idx ].sequence.store( idx, std::memory_order_relaxed );
+        } }
+
+    // adds provided command to the queue. returns: true on success, false if the queue is full
+    bool
+        push( command_data const &Command, uint32_t const Recipient ) {
+            auto position { tail.load( std::memory_order_relaxed ) };
+            cell_data *cell;
+            while( true ) {
+                cell = &cells[ position & mask ];
+                auto const sequence { cell->sequence.load( std::memory_order_acquire ) };
+                auto const difference { static_cast<std::intptr_t>( sequence ) - static_cast<std::intptr_t>( position ) };
+                if( difference == 0 ) {
+                    // the cell is free, try to claim it
+                    if( true == tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) ) {
+                        break;
+                    }
+                }
+                else if( difference < 0 ) {
+                    // the consumer didn't release the cell yet
+                    return false;
+                }
+                else {
+                    // another producer claimed the cell
+                    position = tail.load( std::memory_order_relaxed );
+                }
+            }
+            cell->command = Command;
+            cell->recipient = Recipient;
+            cell->sequence.store( position + 1, std::memory_order_release );
+            return true; }
+    // retrieves the oldest command from the queue. returns: true on retrieval, false if there's nothing to retrieve
+    bool
+        pop( command_data &Command, uint32_t &Recipient ) {
+            auto &cell { cells[ head & mask ] };
+            if( cell.sequence.load( std::memory_order_acquire ) != head + 1 ) {
+                return false;
+            }
+            Command = std::move( cell.command );
+            Recipient = cell.recipient;
+            cell.sequence.store( head + mask + 1, std::memory_order_release );
+            ++head;
+            return true; }
+
+    std::unique_ptr<cell_data[]> cells;
+    std::size_t const mask;
+    std::atomic<std::size_t> tail { 0 }; // next cell to be claimed by producers
+    std::size_t head { 0 }; // next cell to be read by the consumer
+};
+
+command_queue::command_queue() :
+    m_inbound( std::make_unique<inbound_ring>( 1024 ) ),
+    m_consumer( std::this_thread::get_id() )
+{}
+
+command_queue::~command_queue() = default;
+
+// posts specified command for specified recipient. safe to call from any thread
 void
 command_queue::push( command_data const &Command, std::size_t const Recipient ) {
-	if (is_network_target(Recipient)) {
-		auto lookup = m_intercept_queue.emplace(Recipient, commanddata_sequence());
-		lookup.first->second.emplace_back(Command);
-	} else {
-		push_direct(Command, Recipient);
-	}
+
+    while( false == m_inbound->push( Command, static_cast<uint32_t>( Recipient ) ) ) {
+        // the ring is full. the consumer can make room itself, other threads have to wait for it
+        if( std::this_thread::get_id() == m_consumer ) {
+            dispatch();
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// moves commands posted since the last call from the inbound ring to their recipients
+void
+command_queue::dispatch() {
+
+    command_data command;
+    uint32_t recipient;
+    while( true == m_inbound->pop( command, recipient ) ) {
+        if( is_network_target( recipient ) ) {
+            auto lookup = m_intercept_queue.emplace( recipient, commanddata_sequence() );
+            lookup.first->second.emplace_back( std::move( command ) );
+        }
+        else {
+            push_direct( command, recipient );
+        }
+    }
+}
+
+// provides access to command sequence of specified recipient. returns: pointer to the sequence, or nullptr if the recipient is invalid or has no sequence and isn't meant to get one
+command_queue::commanddata_sequence *
+command_queue::sequence( uint32_t const Recipient, bool const Create ) {
+
+    auto const target { (
+        static_cast<command_target>( Recipient & ~0xffff ) == command_target::userinterface ? 0 :
+        static_cast<command_target>( Recipient & ~0xffff ) == command_target::vehicle ? 1 :
+        static_cast<command_target>( Recipient & ~0xffff ) == command_target::signal ? 2 :
+        static_cast<command_target>( Recipient & ~0xffff ) == command_target::entity ? 3 :
+        static_cast<command_target>( Recipient & ~0xffff ) == command_target::simulation ? 4 :
+        -1 ) };
+    if( target == -1 ) {
+        return nullptr;
+    }
+    auto &recipients { m_commands[ target ] };
+    auto const id { Recipient & 0xffff };
+    if( id >= recipients.size() ) {
+        if( false == Create ) {
+            return nullptr;
+        }
+        recipients.resize( id + 1 );
+    }
+    return &recipients[ id ];
 }
 
 void command_queue::push_direct(const command_data &Command, const uint32_t Recipient) {
-	auto lookup = m_commands.emplace( Recipient, commanddata_sequence() );
-	// recipient stack was either located or created, so we can add to it quite safely
-	lookup.first->second.emplace_back( Command );
+	auto *commands = sequence( Recipient, true );
+	if( commands == nullptr ) {
+		ErrorLog( "Bad command: invalid recipient " + to_hex_str( Recipient ) );
+		return;
+	}
+	commands->emplace_back( Command );
 }
 
 // retrieves oldest posted command for specified recipient, if any. returns: true on retrieval, false if there's nothing to retrieve
 bool
 command_queue::pop( command_data &Command, std::size_t const Recipient ) {
 
-    auto lookup = m_commands.find( Recipient );
-    if( lookup == m_commands.end() ) {
-        // no command stack for this recipient, so no commands
-        return false;
-    }
-    auto &commands = lookup->second;
-    if( true == commands.empty() ) {
+    dispatch();
 
+    auto *commands = sequence( static_cast<uint32_t>( Recipient ), false );
+    if( ( commands == nullptr )
+     || ( true == commands->empty() ) ) {
+        // no command stack for this recipient, or no commands on it
         return false;
     }
     // we have command stack with command(s) on it, retrieve and pop the first one
-    Command = commands.front();
-    commands.pop_front();
+    Command = std::move( commands->front() );
+    commands->pop_front();
 
     return true;
 }
@@ -363,8 +480,9 @@ bool command_queue::is_network_target(uint32_t const Recipient) {
 }
 
 command_queue::commands_map command_queue::pop_intercept_queue() {
-	commands_map map(m_intercept_queue);
-	m_intercept_queue.clear();
+	dispatch();
+	commands_map map;
+	map.swap(m_intercept_queue);
 	return map;
 }
 
@@ -343,8 +343,8 @@ struct command_data {
 };
 
 // command_queues: collects and holds commands from input sources, for processing by their intended recipients
-// NOTE: this won't scale well.
-// TODO: turn it into a dispatcher and build individual command sequences into the items, where they can be examined without lookups
+// commands can be posted from any thread. they're collected in a lock-free inbound ring, and moved in batches
+// to per-recipient sequences by the thread which created the queue, when it retrieves them
 
 class command_queue {
 
@@ -352,8 +352,12 @@ public:
 // types
 	typedef std::deque<command_data> commanddata_sequence;
 	typedef std::unordered_map<uint32_t, commanddata_sequence> commands_map;
+// constructors
+    command_queue();
+// destructor
+    ~command_queue();
 // methods
-    // posts specified command for specified recipient
+    // posts specified command for specified recipient. safe to call from any thread
     void
         push( command_data const &Command, std::size_t const Recipient );
     // retrieves oldest posted command for specified recipient, if any. returns: true on retrieval, false if there's nothing to retrieve
@@ -370,9 +374,22 @@ public:
 	void push_commands(const commands_map &commands);
 
 private:
+// types
+    struct inbound_ring;
+    // command sequences of recipients of the same type, indexed with recipient id
+    using recipient_array = std::vector<commanddata_sequence>;
+// methods
+    // moves commands posted since the last call from the inbound ring to their recipients
+    void
+        dispatch();
+    // provides access to command sequence of specified recipient. returns: pointer to the sequence, or nullptr if the recipient is invalid or has no sequence and isn't meant to get one
+    commanddata_sequence *
+        sequence( uint32_t const Recipient, bool const Create );
 // members
+    std::unique_ptr<inbound_ring> m_inbound; // commands posted but not yet dispatched
+    std::thread::id m_consumer; // thread dispatching and retrieving the commands
 	// contains command ready to execution
-	commands_map m_commands;
+    std::array<recipient_array, 5> m_commands;
 
 	// contains intercepted commands to be read by application layer
 	commands_map m_intercept_queue;
@@ -158,59 +158,11 @@ driver_mode::update() {
 	if (deltatime != 0.0)
 	{
         // jak pauza, to nie ma po co tego przeliczać
-        simulation::Time.update( deltatime );
-
-    // fixed step, simulation time based updates
+        // fixed step, simulation time based updates
 	//  m_primaryupdateaccumulator += dt; // unused for the time being
 		m_secondaryupdateaccumulator += deltatime;
-	/*
-		// NOTE: until we have no physics state interpolation during render, we need to rely on the old code,
-		// as doing fixed step calculations but flexible step render results in ugly mini jitter
-		// core routines (physics)
-		int updatecount = 0;
-		while( ( m_primaryupdateaccumulator >= m_primaryupdaterate )
-			 &&( updatecount < 20 ) ) {
-			// no more than 20 updates per single pass, to keep physics from hogging up all run time
-			Ground.Update( m_primaryupdaterate, 1 );
-			++updatecount;
-			m_primaryupdateaccumulator -= m_primaryupdaterate;
-		}
-	*/
-		int updatecount = 1;
-		if( deltatime > m_primaryupdaterate ) // normalnie 0.01s
-		{
-	/*
-			// NOTE: experimentally disabled physics update cap
-			auto const iterations = std::ceil(dt / m_primaryupdaterate);
-			updatecount = std::min( 20, static_cast<int>( iterations ) );
-	*/
-			updatecount = std::ceil( deltatime / m_primaryupdaterate );
-	/*
-			// NOTE: changing dt wrecks things further down the code. re-acquire proper value later or cleanup here
-			dt = dt / iterations; // Ra: fizykę lepiej by było przeliczać ze stałym krokiem
-	*/
-		}
-		auto const stepdeltatime { deltatime / updatecount };
-		// NOTE: updates are limited to 20, but dt is distributed over potentially many more iterations
-		// this means at count > 20 simulation and render are going to desync. is that right?
-		// NOTE: experimentally changing this to prevent the desync.
-		// TODO: test what happens if we hit more than 20 * 0.01 sec slices, i.e. less than 5 fps
-		Timer::subsystem.sim_dynamics.start();
-		if( true == Global.FullPhysics ) {
-			// mixed calculation mode, steps calculated in ~0.05s chunks
-			while( updatecount >= 5 ) {
-				simulation::State.update( stepdeltatime, 5 );
-				updatecount -= 5;
-			}
-			if( updatecount ) {
-				simulation::State.update( stepdeltatime, updatecount );
-			}
-		}
-		else {
-			// simplified calculation mode; faster but can lead to errors
-			simulation::State.update( stepdeltatime, updatecount );
-		}
-		Timer::subsystem.sim_dynamics.stop();
+
+		simulation::State.update_dynamics( deltatime, m_primaryupdaterate );
 
 		// secondary fixed step simulation time routines
 		while( m_secondaryupdateaccumulator >= m_secondaryupdaterate ) {
@@ -258,10 +210,7 @@ driver_mode::update() {
 		else
 			TSubModel::iInstance = 0;
 
-		simulation::Trains.update(deltatime);
-		simulation::Events.update();
-		simulation::Region->update_events();
-		simulation::Lights.update();
+		simulation::State.update_scenario( deltatime );
 	}
 
     // render time routines follow:
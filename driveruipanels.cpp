@@ -30,6 +30,7 @@ http://mozilla.org/MPL/2.0/.
 #include "renderer.h"
 #include "utilities.h"
 #include "Logs.h"
+#include "profiler.h"
 
 void
 drivingaid_panel::update() {
@@ -633,6 +634,11 @@ debug_panel::render() {
         // toggles
         ImGui::Separator();
         ImGui::Checkbox( "Debug Mode", &DebugModeFlag );
+#ifdef EU07_USE_PROFILER
+        if( ImGui::Button( "Save Trace" ) ) {
+            profiler::export_trace( "trace.json" );
+        }
+#endif
     }
     ImGui::End();
 }
@@ -1223,6 +1229,14 @@ debug_panel::update_section_scenario( std::vector<text_line> &Output ) {
         "vehicles: " + to_string( Timer::subsystem.sim_dynamics.average(), 2 ) + " msec"
         + " update total: " + to_string( Timer::subsystem.sim_total.average(), 2 ) + " msec";
 
+    Output.emplace_back( textline, Global.UITextColor );
+    // ai scheduling
+    auto const &aistats { simulation::AIScheduler.frame_stats() };
+    textline =
+        "AI full updates: " + std::to_string( aistats.updates ) + " (" + to_string( aistats.cost, 2 ) + " msec)"
+        + ", deferred: " + std::to_string( aistats.deferred ) + " (total: " + std::to_string( simulation::AIScheduler.deferred_total() ) + ")"
+        + ", worst latency: " + to_string( simulation::AIScheduler.worst_latency(), 2 ) + " sec";
+
     Output.emplace_back( textline, Global.UITextColor );
     // current luminance level
     textline = "Light level: " + to_string( Global.fLuminance, 3 ) + ( Global.FakeLight ? "(*)" : "" );
@@ -1245,41 +1259,46 @@ debug_panel::update_section_eventqueue( std::vector<text_line> &Output ) {
 
     // current event queue
     auto const time { Timer::GetTime() };
-    auto const *event { simulation::Events.begin() };
+    auto const queuesize { simulation::Events.queue_size() };
     auto const searchfilter { std::string( m_eventsearch.data() ) };
-
+    // only the displayed events are retrieved, the filters are applied during the queue walk
+    auto const queuedevents {
+        simulation::Events.queued(
+            30 - 2,
+            [&]( basic_event const *Event ) {
+                if( ( true == Event->m_ignored )
+                 || ( true == Event->m_passive )
+                 || ( ( true == m_eventqueueactivevehicleonly )
+                   && ( Event->m_activator != m_input.vehicle ) ) ) {
+                    return false; }
+                return (
+                    searchfilter.empty()
+                 || contains( Event->m_name + ( Event->m_activator ? " (by: " + Event->m_activator->asName + ")" : "" ), searchfilter ) ); } ) };
+
+    auto const &queuestats { simulation::Events.queue_stats() };
+    textline =
+        "Queued: " + std::to_string( queuesize )
+        + " (peak: " + std::to_string( queuestats.depth_peak ) + ")"
+        + ", latency: " + to_string( 1000.0 * queuestats.latency_total / std::max<std::size_t>( 1, queuestats.executed ), 1 ) + " ms"
+        + " (max: " + to_string( 1000.0 * queuestats.latency_max, 1 ) + " ms)";
+    Output.emplace_back( textline, Global.UITextColor );
     Output.emplace_back( "Delay:   Event:", Global.UITextColor );
 
-    while( ( event != nullptr )
-        && ( Output.size() < 30 ) ) {
-
-        if( ( false == event->m_ignored )
-         && ( false == event->m_passive )
-         && ( ( false == m_eventqueueactivevehicleonly )
-           || ( event->m_activator == m_input.vehicle ) ) ) {
-
-            auto const label { event->m_name + ( event->m_activator ? " (by: " + event->m_activator->asName + ")" : "" ) };
+    for( auto const *event : queuedevents ) {
 
-            if( ( false == searchfilter.empty() )
-             && ( false == contains( label, searchfilter ) ) ) {
-                event = event->m_next;
-                continue;
-            }
-
-            auto const delay { "   " + to_string( std::max( 0.0, event->m_launchtime - time ), 1 ) };
-            textline =
-                delay.substr( delay.length() - 6 )
-                + "   "
-                + label + ( event->m_sibling ? " (joint event)" : "" );
+        auto const label { event->m_name + ( event->m_activator ? " (by: " + event->m_activator->asName + ")" : "" ) };
+        auto const delay { "   " + to_string( std::max( 0.0, event->m_launchtime - time ), 1 ) };
+        textline =
+            delay.substr( delay.length() - 6 )
+            + "   "
+            + label + ( event->m_sibling ? " (joint event)" : "" );
 
-            Output.emplace_back( textline, Global.UITextColor );
-        }
-        event = event->m_next;
+        Output.emplace_back( textline, Global.UITextColor );
     }
-    if( Output.size() == 1 ) {
+    if( Output.size() == 2 ) {
         // event queue can be empty either because no event got through active filters, or because it is genuinely empty
-        Output.front().data = (
-            simulation::Events.begin() == nullptr ?
+        Output.back().data = (
+            queuesize == 0 ?
                 "(no queued events)" :
                 "(no matching events)" );
     }
@@ -11,10 +11,12 @@ http://mozilla.org/MPL/2.0/.
 #include "geometrybank.h"
 #include "openglgeometrybank.h"
 #include "opengl33geometrybank.h"
+#include "nullrenderer.h"
 
 #include "sn_utils.h"
 #include "Logs.h"
 #include "Globals.h"
+#include "utilities.h"
 
 namespace gfx {
 
@@ -66,6 +68,30 @@ basic_vertex::deserialize_packed( std::istream &s, bool const Tangent ) {
     }
 }
 
+void
+basic_vertex::deserialize( char const *&s, bool const Tangent ) {
+
+    position = sn_utils::d_vec3( s );
+    normal = sn_utils::d_vec3( s );
+    texture.x = sn_utils::ld_float32( s );
+    texture.y = sn_utils::ld_float32( s );
+    if( Tangent ) {
+        tangent = sn_utils::d_vec4( s );
+    }
+}
+
+void
+basic_vertex::deserialize_packed( char const *&s, bool const Tangent ) {
+
+    position = glm::unpackHalf4x16( sn_utils::ld_uint64( s ) );
+    normal = glm::unpackSnorm3x10_1x2( sn_utils::ld_uint32( s ) );
+    texture.x = glm::unpackHalf1x16( sn_utils::ld_uint16( s ) );
+    texture.y = glm::unpackHalf1x16( sn_utils::ld_uint16( s ) );
+    if( Tangent ) {
+        tangent = glm::unpackSnorm3x10_1x2( sn_utils::ld_uint32( s ) );
+    }
+}
+
 // based on
 // Lengyel, Eric. “Computing Tangent Space Basis Vectors for an Arbitrary Mesh”.
 // Terathon Software, 2001. http://terathon.com/code/tangent.html
@@ -260,6 +286,8 @@ geometry_bank::replace( gfx::vertex_array &Vertices, gfx::geometry_handle const
 
     if( ( Geometry.chunk == 0 ) || ( Geometry.chunk > m_chunks.size() ) ) { return false; }
 
+    restore( Geometry );
+
     auto &chunk = gfx::geometry_bank::chunk( Geometry );
 
     if( ( Offset == 0 )
@@ -286,6 +314,8 @@ geometry_bank::append( gfx::vertex_array &Vertices, gfx::geometry_handle const &
 
     if( ( Geometry.chunk == 0 ) || ( Geometry.chunk > m_chunks.size() ) ) { return false; }
 
+    restore( Geometry );
+
     return replace( Vertices, Geometry, gfx::geometry_bank::chunk( Geometry ).vertices.size() );
 }
 
@@ -306,6 +336,8 @@ geometry_bank::release() {
 // provides direct access to indexdata of specfied chunk
 index_array const &
 geometry_bank::indices( gfx::geometry_handle const &Geometry ) const {
+    // NOTE: retrieval of discarded data doesn't change the content of the chunk, so we treat the bank as logically const
+    const_cast<geometry_bank *>( this )->restore( Geometry );
 
     return geometry_bank::chunk( Geometry ).indices;
 }
@@ -313,10 +345,48 @@ geometry_bank::indices( gfx::geometry_handle const &Geometry ) const {
 // provides direct access to vertex data of specfied chunk
 vertex_array const &
 geometry_bank::vertices( gfx::geometry_handle const &Geometry ) const {
+    // NOTE: retrieval of discarded data doesn't change the content of the chunk, so we treat the bank as logically const
+    const_cast<geometry_bank *>( this )->restore( Geometry );
 
     return geometry_bank::chunk( Geometry ).vertices;
 }
 
+// returns size of geometry data kept on the cpu side, in bytes
+std::size_t
+geometry_bank::cpu_size() const {
+
+    std::size_t size { 0 };
+    for( auto const &chunk : m_chunks ) {
+        size +=
+            chunk.vertices.capacity() * sizeof( gfx::basic_vertex )
+          + chunk.indices.capacity() * sizeof( gfx::basic_index );
+    }
+    return size;
+}
+
+// drops cpu side copy of the data held by specified chunk
+void
+geometry_bank::discard( gfx::geometry_handle const &Geometry ) {
+
+    auto &chunk = geometry_bank::chunk( Geometry );
+    if( false == chunk.is_resident ) { return; }
+
+    gfx::vertex_array().swap( chunk.vertices );
+    gfx::index_array().swap( chunk.indices );
+    chunk.is_resident = false;
+}
+
+// makes sure the cpu side copy of the data held by specified chunk is available
+void
+geometry_bank::restore( gfx::geometry_handle const &Geometry ) {
+
+    auto &chunk = geometry_bank::chunk( Geometry );
+    if( true == chunk.is_resident ) { return; }
+    // template method implementation
+    fetch_( Geometry );
+    chunk.is_resident = true;
+}
+
 // geometry bank manager, holds collection of geometry banks
 
 // performs a resource sweep
@@ -326,11 +396,30 @@ geometrybank_manager::update() {
     m_garbagecollector.sweep();
 }
 
+// debug performance string
+std::string
+geometrybank_manager::info() const {
+
+    std::size_t cpusize { 0 };
+    std::size_t gpusize { 0 };
+    for( auto const &bank : m_geometrybanks ) {
+        cpusize += bank.first->cpu_size();
+        gpusize += bank.first->gpu_size();
+    }
+
+    return
+        "geometry: "
+        + std::to_string( m_geometrybanks.size() ) + " banks, "
+        + to_string( cpusize / ( 1024.0f * 1024.0f ), 2 ) + " mb in ram, "
+        + to_string( gpusize / ( 1024.0f * 1024.0f ), 2 ) + " mb in vram";
+}
+
 // creates a new geometry bank. returns: handle to the bank or NULL
 gfx::geometrybank_handle
 geometrybank_manager::create_bank() {
 
          if( Global.GfxRenderer == "default" ) { m_geometrybanks.emplace_back( std::make_shared<opengl33_vaogeometrybank>(), std::chrono::steady_clock::time_point() ); }
+    else if( Global.GfxRenderer == "null" )    { m_geometrybanks.emplace_back( std::make_shared<null_geometrybank>(),        std::chrono::steady_clock::time_point() ); }
     else if( true == Global.bUseVBO )          { m_geometrybanks.emplace_back( std::make_shared<opengl_vbogeometrybank>(), std::chrono::steady_clock::time_point() ); }
     else                                       { m_geometrybanks.emplace_back( std::make_shared<opengl_dlgeometrybank>(),  std::chrono::steady_clock::time_point() ); }
     // NOTE: handle is effectively (index into chunk array + 1) this leaves value of 0 to serve as error/empty handle indication
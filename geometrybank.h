@@ -28,6 +28,9 @@ struct basic_vertex {
     void deserialize( std::istream&, bool const Tangent = false );
     void serialize_packed( std::ostream&, bool const Tangent = false ) const;
     void deserialize_packed( std::istream&, bool const Tangent = false );
+    // in-memory variants, advance provided location past the read data
+    void deserialize( char const *&, bool const Tangent = false );
+    void deserialize_packed( char const *&, bool const Tangent = false );
 };
 
 // data streams carried in a vertex
@@ -119,6 +122,10 @@ public:
     auto indices( gfx::geometry_handle const &Geometry ) const -> gfx::index_array const &;
     // provides direct access to vertex data of specfied chunk
     auto vertices( gfx::geometry_handle const &Geometry ) const -> gfx::vertex_array const &;
+    // returns size of geometry data kept on the cpu side, in bytes
+    auto cpu_size() const -> std::size_t;
+    // returns size of geometry data kept on the opengl end, in bytes
+    virtual auto gpu_size() const -> std::size_t { return 0; }
 
 protected:
 // types:
@@ -126,6 +133,7 @@ protected:
         unsigned int type; // kind of geometry used by the chunk
         gfx::vertex_array vertices; // geometry data
         gfx::index_array indices; // index data
+        bool is_resident { true }; // false if the geometry data was discarded after upload, and has to be fetched back before use
         // NOTE: constructor doesn't copy provided geometry data, but moves it
         geometry_chunk( gfx::vertex_array &Vertices, unsigned int Type ) :
                                                             type( Type )
@@ -151,6 +159,11 @@ protected:
     auto chunk( gfx::geometry_handle const Geometry ) const -> geometry_chunk const & {
             return m_chunks[ Geometry.chunk - 1 ]; }
 
+    // drops cpu side copy of the data held by specified chunk
+    void discard( gfx::geometry_handle const &Geometry );
+    // makes sure the cpu side copy of the data held by specified chunk is available
+    void restore( gfx::geometry_handle const &Geometry );
+
 // members:
     geometrychunk_sequence m_chunks;
 
@@ -164,6 +177,8 @@ private:
     virtual auto draw_( gfx::geometry_handle const &Geometry, gfx::stream_units const &Units, unsigned int const Streams ) -> std::size_t = 0;
     // resource release subclass details
     virtual void release_() = 0;
+    // restore() subclass details, retrieves geometry data of specified chunk from the opengl end
+    virtual void fetch_( gfx::geometry_handle const &Geometry ) {}
 };
 
 // geometry bank manager, holds collection of geometry banks
@@ -204,6 +219,8 @@ public:
     // provides access to primitives count
     auto primitives_count() const -> std::size_t const & { return m_primitivecount; }
     auto primitives_count() -> std::size_t & { return m_primitivecount; }
+    // debug performance string
+    auto info() const -> std::string;
 
 private:
 // types:
@@ -0,0 +1,276 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "jobsystem.h"
+
+#include "Logs.h"
+
+namespace threading {
+
+job_system jobs;
+
+namespace {
+// queue owned by the calling thread. 0 for threads outside of the pool
+thread_local std::size_t t_queue { 0 };
+}
+
+// starts specified number of worker threads. -1: one less than the number of available cores
+void
+job_system::start( int Workercount ) {
+
+    stop();
+
+    if( Workercount < 0 ) {
+        Workercount = std::max( 0, static_cast<int>( std::thread::hardware_concurrency() ) - 1 );
+    }
+    m_queues.clear();
+    for( int idx = 0; idx <= Workercount; ++idx ) {
+        m_queues.emplace_back( std::make_unique<job_queue>() );
+    }
+    m_exit = false;
+    m_active = true;
+    for( int idx = 1; idx <= Workercount; ++idx ) {
+        m_workers.emplace_back( &job_system::run_worker, this, idx );
+    }
+    WriteLog( "Jobs: " + std::to_string( Workercount ) + " worker thread(s) active" );
+}
+
+// stops the workers. jobs still in the queues are executed by the calling thread
+void
+job_system::stop() {
+
+    if( false == m_active ) { return; }
+
+    {
+        std::lock_guard<std::mutex> lock( m_idlemutex );
+        m_exit = true;
+    }
+    m_idlecondition.notify_all();
+    for( auto &worker : m_workers ) {
+        worker.join();
+    }
+    m_workers.clear();
+    // jobs may have other jobs depending on them, so the queues are drained rather than discarded
+    while( true == execute() ) {
+        ;
+    }
+    m_active = false;
+}
+
+// queues provided task for execution after completion of all specified jobs
+job_handle
+job_system::submit( std::function<void()> Task, std::vector<job_handle> const &Dependencies ) {
+
+    auto job { std::make_shared<threading::job>( std::move( Task ) ) };
+
+    for( auto const &dependency : Dependencies ) {
+        if( dependency == nullptr ) { continue; }
+        std::lock_guard<std::mutex> lock( dependency->m_mutex );
+        if( true == dependency->m_done ) { continue; }
+        ++job->m_blockers;
+        dependency->m_dependents.emplace_back( job );
+        job->m_dependencies.emplace_back( dependency );
+    }
+    // release the blocker held during setup. if no dependency is pending the job can be queued right away
+    if( --job->m_blockers == 0 ) {
+        schedule( job );
+    }
+    return job;
+}
+
+// blocks until specified job is completed, executing the job and its pending dependencies in the meantime if they weren't started yet
+// rethrows exception thrown by the job
+void
+job_system::wait( job_handle const &Job ) {
+
+    if( Job == nullptr ) { return; }
+
+    complete( Job );
+    if( Job->m_exception ) {
+        std::rethrow_exception( Job->m_exception );
+    }
+}
+
+// blocks until all specified jobs are completed. rethrows the first exception thrown by the jobs, after all of them are completed
+void
+job_system::wait( std::vector<job_handle> const &Jobs ) {
+
+    for( auto const &job : Jobs ) {
+        complete( job );
+    }
+    for( auto const &job : Jobs ) {
+        wait( job );
+    }
+}
+
+// blocks until specified job is completed, without rethrowing its exception
+void
+job_system::complete( job_handle const &Job ) {
+
+    if( Job == nullptr ) { return; }
+
+    // unrelated queued jobs are left alone, they could hold the waiting thread for much longer than the job it waits for
+    while( false == Job->done() ) {
+        if( false == help( Job ) ) {
+            // the job or its dependencies are being executed by other threads
+            std::this_thread::yield();
+        }
+    }
+}
+
+// executes provided job if it's ready and wasn't started yet, or one of its pending dependencies. returns: true if a job was executed
+bool
+job_system::help( job_handle const &Job ) {
+
+    if( true == Job->done() ) { return false; }
+
+    if( Job->m_blockers == 0 ) {
+        // the job is queued, or already being executed
+        return execute( Job );
+    }
+    for( auto const &dependency : Job->m_dependencies ) {
+        auto const job { dependency.lock() };
+        if( ( job != nullptr )
+         && ( true == help( job ) ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// places provided job in the queue of the calling thread, and wakes up a worker to take care of it
+void
+job_system::schedule( job_handle Job ) {
+
+    if( ( false == m_active )
+     || ( true == m_exit ) ) {
+        // no pool to hand the job to, so we take care of it ourselves
+        execute( Job );
+        return;
+    }
+    {
+        auto &queue { *m_queues[ t_queue ] };
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        queue.jobs.emplace_back( std::move( Job ) );
+    }
+    ++m_queuedcount;
+    // taking the mutex ensures the notification can't slip between a worker's check of the job count and its wait
+    {
+        std::lock_guard<std::mutex> lock( m_idlemutex );
+    }
+    m_idlecondition.notify_one();
+}
+
+// retrieves a job from the queue of the calling thread, or from queues of other threads if it's empty. returns: null if there's no work available
+job_handle
+job_system::acquire() {
+
+    if( ( m_queuedcount <= 0 )
+     || ( true == m_queues.empty() ) ) {
+        return nullptr;
+    }
+    job_handle job;
+    // workers take the most recent job from their own queue, as its data is the most likely to still be in the cache
+    if( t_queue != 0 ) {
+        auto &queue { *m_queues[ t_queue ] };
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( false == queue.jobs.empty() ) {
+            job = std::move( queue.jobs.back() );
+            queue.jobs.pop_back();
+        }
+    }
+    // jobs from other queues are taken from the opposite end, starting with the shared queue
+    auto const queuecount { m_queues.size() };
+    for( std::size_t idx = 0; ( idx < queuecount ) && ( job == nullptr ); ++idx ) {
+        auto const queueindex { ( idx == 0 ? 0 : ( ( t_queue + idx - 1 ) % ( queuecount - 1 ) ) + 1 ) };
+        if( ( queueindex == t_queue ) && ( t_queue != 0 ) ) { continue; }
+        auto &queue { *m_queues[ queueindex ] };
+        std::lock_guard<std::mutex> lock( queue.mutex );
+        if( false == queue.jobs.empty() ) {
+            job = std::move( queue.jobs.front() );
+            queue.jobs.pop_front();
+        }
+    }
+    if( job != nullptr ) {
+        --m_queuedcount;
+    }
+    return job;
+}
+
+// executes a single queued job. returns: true if there was a job to execute, false otherwise
+bool
+job_system::execute() {
+
+    job_handle job;
+    while( ( job = acquire() ) != nullptr ) {
+        // queued jobs can be claimed by threads waiting for them, such entries are skipped
+        if( true == execute( job ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// executes provided job, unless another thread already started it. returns: true if the job was executed by the calling thread
+bool
+job_system::execute( job_handle const &Job ) {
+
+    if( true == Job->m_started.exchange( true ) ) { return false; }
+
+    try {
+        Job->m_task();
+    }
+    catch( std::exception const &Exception ) {
+        ErrorLog( "Jobs: task failed with exception: " + std::string( Exception.what() ) );
+        Job->m_exception = std::current_exception();
+    }
+    catch( ... ) {
+        ErrorLog( "Jobs: task failed with unknown exception" );
+        Job->m_exception = std::current_exception();
+    }
+    // release captured data right away, the handle itself can be held by the submitter for a long time
+    Job->m_task = nullptr;
+
+    // dependents of a failed job are still executed, it's up to them to check the outcome
+    std::vector<job_handle> dependents;
+    {
+        std::lock_guard<std::mutex> lock( Job->m_mutex );
+        Job->m_done.store( true, std::memory_order_release );
+        dependents.swap( Job->m_dependents );
+    }
+    for( auto &dependent : dependents ) {
+        if( --dependent->m_blockers == 0 ) {
+            schedule( std::move( dependent ) );
+        }
+    }
+    return true;
+}
+
+// worker thread main loop
+void
+job_system::run_worker( std::size_t const Queue ) {
+
+    t_queue = Queue;
+
+    while( true ) {
+        if( true == execute() ) { continue; }
+
+        std::unique_lock<std::mutex> lock( m_idlemutex );
+        m_idlecondition.wait(
+            lock,
+            [&]() {
+                return ( ( true == m_exit ) || ( m_queuedcount > 0 ) ); } );
+        if( true == m_exit ) { return; }
+    }
+}
+
+} // threading
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,178 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace threading {
+
+class job;
+using job_handle = std::shared_ptr<job>;
+
+// unit of work executed by the job system
+class job {
+
+    friend class job_system;
+
+public:
+// constructors
+    job( std::function<void()> Task ) :
+        m_task( std::move( Task ) )
+    {}
+// methods
+    // returns true if the job was completed
+    // NOTE: a job which threw an exception counts as completed
+    bool
+        done() const {
+            return m_done.load( std::memory_order_acquire ); }
+
+private:
+// members
+    std::function<void()> m_task;
+    std::atomic<int> m_blockers { 1 }; // unfinished dependencies, plus one held by the submitting thread until the job is set up
+    std::vector< std::weak_ptr<job> > m_dependencies; // jobs this one waits for. set up by the submitting thread, read-only afterwards
+    std::mutex m_mutex; // guards the completion flag against changes to the list of dependents
+    std::vector<job_handle> m_dependents; // jobs waiting for this one to complete
+    std::atomic<bool> m_started { false }; // set by the thread which executes the job, queued copies of started jobs are skipped
+    std::atomic<bool> m_done { false };
+    std::exception_ptr m_exception; // exception thrown by the task, if any. set before the job is marked as done
+};
+
+// pool of worker threads shared by the engine subsystems. each worker has its own queue of jobs, and takes work from queues of others when its own is empty
+class job_system {
+
+public:
+// destructor
+    ~job_system() {
+        stop(); }
+// methods
+    // starts specified number of worker threads. -1: one less than the number of available cores
+    void
+        start( int Workercount );
+    // stops the workers. jobs still in the queues are executed by the calling thread
+    void
+        stop();
+    // queues provided task for execution after completion of all specified jobs
+    job_handle
+        submit( std::function<void()> Task, std::vector<job_handle> const &Dependencies = {} );
+    // blocks until specified job is completed, executing the job and its pending dependencies in the meantime if they weren't started yet
+    // rethrows exception thrown by the job
+    void
+        wait( job_handle const &Job );
+    // blocks until all specified jobs are completed. rethrows the first exception thrown by the jobs, after all of them are completed
+    void
+        wait( std::vector<job_handle> const &Jobs );
+    // calls provided task for each index in range 0 to Count - 1, spread across the calling thread and up to specified number of workers. -1: all workers
+    // NOTE: the call returns after all indices are processed. if the task throws, the remaining indices are skipped and the exception is rethrown
+    template <typename Function_>
+    void
+        parallel_for( std::size_t const Count, Function_ Task, int const Workerlimit = -1 );
+    // returns number of active worker threads
+    int
+        workers() const {
+            return static_cast<int>( m_workers.size() ); }
+
+private:
+// types
+    struct job_queue {
+        std::mutex mutex;
+        std::deque<job_handle> jobs;
+    };
+// methods
+    // places provided job in the queue of the calling thread, and wakes up a worker to take care of it
+    void
+        schedule( job_handle Job );
+    // retrieves a job from the queue of the calling thread, or from queues of other threads if it's empty. returns: null if there's no work available
+    job_handle
+        acquire();
+    // executes a single queued job. returns: true if there was a job to execute, false otherwise
+    bool
+        execute();
+    // executes provided job, unless another thread already started it. returns: true if the job was executed by the calling thread
+    bool
+        execute( job_handle const &Job );
+    // executes provided job if it's ready and wasn't started yet, or one of its pending dependencies. returns: true if a job was executed
+    bool
+        help( job_handle const &Job );
+    // blocks until specified job is completed, without rethrowing its exception
+    void
+        complete( job_handle const &Job );
+    // worker thread main loop
+    void
+        run_worker( std::size_t const Queue );
+// members
+    std::vector< std::unique_ptr<job_queue> > m_queues; // queue 0 receives jobs from threads outside of the pool, rest are owned by the workers
+    std::vector<std::thread> m_workers;
+    std::mutex m_idlemutex;
+    std::condition_variable m_idlecondition; // wakes up the workers
+    std::atomic<int> m_queuedcount { 0 }; // number of jobs waiting in the queues
+    std::atomic<bool> m_exit { false }; // signals the workers to quit. changed under the idle mutex
+    bool m_active { false }; // the pool was started and accepts jobs
+};
+
+template <typename Function_>
+void
+job_system::parallel_for( std::size_t const Count, Function_ Task, int const Workerlimit ) {
+
+    if( Count == 0 ) { return; }
+
+    auto const helpercount {
+        std::min<std::size_t>(
+            Count - 1,
+            static_cast<std::size_t>( (
+                Workerlimit < 0 ?
+                    workers() :
+                    std::min( Workerlimit, workers() ) ) ) ) };
+    // indices are handed out one at a time, so the callers should make each item worth the synchronization cost
+    std::atomic<std::size_t> next { 0 };
+    auto const process = [&]() {
+        std::size_t index;
+        try {
+            while( ( index = next++ ) < Count ) {
+                Task( index );
+            }
+        }
+        catch( ... ) {
+            // exhaust the range, so the other participants stop early
+            next = Count;
+            throw;
+        } };
+
+    if( helpercount == 0 ) {
+        process();
+        return;
+    }
+    std::vector<job_handle> helpers;
+    helpers.reserve( helpercount );
+    for( std::size_t idx = 0; idx < helpercount; ++idx ) {
+        helpers.emplace_back( submit( process ) );
+    }
+    std::exception_ptr exception;
+    try {
+        process();
+    }
+    catch( ... ) {
+        exception = std::current_exception();
+    }
+    // helpers which didn't get to start yet are claimed by the wait, and find the range exhausted
+    // NOTE: the helpers reference local data, so they have to be completed even if the calling thread failed
+    if( exception ) {
+        for( auto const &helper : helpers ) {
+            complete( helper );
+        }
+        std::rethrow_exception( exception );
+    }
+    wait( helpers );
+}
+
+// engine-wide job system
+extern job_system jobs;
+
+} // threading
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,241 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "jobsystem.h"
+
+namespace threading {
+
+// background loader of resource data. the data is loaded by the job system into helper objects which are handed over to the actual resources
+// by the owner thread, so the jobs never touch resources visible to the rest of the simulation.
+// pending requests are served in order of their priority, lower values first; requests of equal priority are served in order of insertion
+template <typename Key_, typename Resource_>
+class load_queue {
+
+public:
+// types
+    using load_function = std::function<void( Resource_ & )>;
+    using priority_function = std::function<float( Key_ const, Resource_ const & )>;
+    using resource_sequence = std::vector< std::pair<Key_, Resource_> >;
+// constructors
+    load_queue( load_function Load ) :
+        m_load( std::move( Load ) )
+    {}
+// destructor
+    ~load_queue() {
+        stop(); }
+// methods
+    // adds request to load provided resource, with specified priority
+    void
+        insert( Key_ const Key, Resource_ Resource, float const Priority );
+    // recalculates priorities of the requests still waiting for their turn
+    void
+        prioritize( priority_function const &Priority );
+    // moves loaded data of specified resource to provided object, loading it on the calling thread if the jobs didn't get to it yet.
+    // returns: false if the resource isn't queued
+    bool
+        acquire( Key_ const Key, Resource_ &Resource );
+    // moves resources which were completed by the jobs to provided container
+    void
+        collect( resource_sequence &Resources );
+    // waits for the jobs in progress and discards remaining requests
+    void
+        stop();
+
+private:
+// types
+    enum class request_state {
+        queued,
+        loading,
+        ready
+    };
+    struct request {
+        request_state state { request_state::queued };
+        float priority { 0.f };
+        std::uint64_t sequence { 0 }; // insertion order, resolves ties between equal priorities
+        Key_ key;
+        Resource_ resource; // helper object receiving the loaded data
+    };
+    using request_handle = std::shared_ptr<request>;
+    // heap ordering predicate, places the most important request at the top
+    struct request_order {
+        bool operator()( request_handle const &Left, request_handle const &Right ) const {
+            return (
+                Left->priority != Right->priority ?
+                    Left->priority > Right->priority :
+                    Left->sequence > Right->sequence ); } };
+// methods
+    // loads data of the most important request still waiting for its turn
+    void
+        load_next();
+// members
+    load_function m_load;
+    std::mutex m_mutex;
+    std::condition_variable m_readycondition; // signals completed loads to waiting threads
+    std::unordered_map<Key_, request_handle> m_requests; // requests not yet claimed by their owners
+    std::vector<request_handle> m_pending; // heap of queued requests. requests claimed by the owners are skipped when they reach the top
+    std::vector<job_handle> m_jobs; // submitted load jobs, not yet known to be completed
+    std::uint64_t m_sequence { 0 };
+    bool m_exit { false };
+};
+
+// adds request to load provided resource, with specified priority
+template <typename Key_, typename Resource_>
+void
+load_queue<Key_, Resource_>::insert( Key_ const Key, Resource_ Resource, float const Priority ) {
+
+    auto entry { std::make_shared<request>() };
+    entry->priority = Priority;
+    entry->key = Key;
+    entry->resource = std::move( Resource );
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        entry->sequence = m_sequence++;
+        m_requests[ Key ] = entry;
+        m_pending.emplace_back( entry );
+        std::push_heap( std::begin( m_pending ), std::end( m_pending ), request_order() );
+    }
+    // each job serves whichever request is the most important when it gets to run, not necessarily the one it was submitted for
+    // NOTE: the job can be executed right away if the job system isn't running, so it's submitted without holding the lock
+    auto job {
+        jobs.submit(
+            [=]() {
+                load_next(); } ) };
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_jobs.erase(
+        std::remove_if(
+            std::begin( m_jobs ), std::end( m_jobs ),
+            []( job_handle const &Job ) {
+                return Job->done(); } ),
+        std::end( m_jobs ) );
+    m_jobs.emplace_back( std::move( job ) );
+}
+
+// recalculates priorities of the requests still waiting for their turn
+template <typename Key_, typename Resource_>
+void
+load_queue<Key_, Resource_>::prioritize( priority_function const &Priority ) {
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    // drop requests claimed since the last pass while we're at it
+    m_pending.erase(
+        std::remove_if(
+            std::begin( m_pending ), std::end( m_pending ),
+            []( request_handle const &Request ) {
+                return Request->state != request_state::queued; } ),
+        std::end( m_pending ) );
+    for( auto &entry : m_pending ) {
+        entry->priority = Priority( entry->key, entry->resource );
+    }
+    std::make_heap( std::begin( m_pending ), std::end( m_pending ), request_order() );
+}
+
+// moves loaded data of specified resource to provided object, loading it on the calling thread if the jobs didn't get to it yet
+template <typename Key_, typename Resource_>
+bool
+load_queue<Key_, Resource_>::acquire( Key_ const Key, Resource_ &Resource ) {
+
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    auto lookup { m_requests.find( Key ) };
+    if( lookup == m_requests.end() ) { return false; }
+
+    auto entry { lookup->second };
+    m_requests.erase( lookup );
+    if( entry->state == request_state::queued ) {
+        // the jobs didn't get to this resource yet, so we don't wait for them
+        entry->state = request_state::loading;
+        lock.unlock();
+        m_load( entry->resource );
+        lock.lock();
+        entry->state = request_state::ready;
+    }
+    m_readycondition.wait(
+        lock,
+        [&]() {
+            return entry->state == request_state::ready; } );
+
+    Resource = std::move( entry->resource );
+    return true;
+}
+
+// moves resources which were completed by the jobs to provided container
+template <typename Key_, typename Resource_>
+void
+load_queue<Key_, Resource_>::collect( resource_sequence &Resources ) {
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    for( auto entry { std::begin( m_requests ) }; entry != std::end( m_requests ); ) {
+        if( entry->second->state == request_state::ready ) {
+            Resources.emplace_back( entry->first, std::move( entry->second->resource ) );
+            entry = m_requests.erase( entry );
+        }
+        else {
+            ++entry;
+        }
+    }
+}
+
+// waits for the jobs in progress and discards remaining requests
+template <typename Key_, typename Resource_>
+void
+load_queue<Key_, Resource_>::stop() {
+
+    std::vector<job_handle> pendingjobs;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_exit = true;
+        pendingjobs.swap( m_jobs );
+    }
+    // jobs which didn't start yet will quit right away, but they still hold a pointer to the queue
+    jobs.wait( pendingjobs );
+    m_requests.clear();
+    m_pending.clear();
+}
+
+// loads data of the most important request still waiting for its turn
+template <typename Key_, typename Resource_>
+void
+load_queue<Key_, Resource_>::load_next() {
+
+    std::unique_lock<std::mutex> lock( m_mutex );
+
+    if( true == m_exit ) { return; }
+
+    request_handle entry;
+    while( ( entry == nullptr )
+        && ( false == m_pending.empty() ) ) {
+        std::pop_heap( std::begin( m_pending ), std::end( m_pending ), request_order() );
+        if( m_pending.back()->state == request_state::queued ) {
+            entry = m_pending.back();
+        }
+        // requests already picked up by the owner thread are discarded
+        m_pending.pop_back();
+    }
+    // there's one job per request, but the owner thread can claim requests on its own, leaving some jobs with nothing to do
+    if( entry == nullptr ) { return; }
+
+    entry->state = request_state::loading;
+    lock.unlock();
+
+    m_load( entry->resource );
+
+    lock.lock();
+    entry->state = request_state::ready;
+    lock.unlock();
+    m_readycondition.notify_all();
+}
+
+} // threading
+
+//---------------------------------------------------------------------------
@@ -101,7 +101,7 @@ OnCommandGet(multiplayer::DaneRozkaz *pRozkaz)
             CommLog(Now() + " " + to_string(pRozkaz->iComm) + " " +
                     std::string(pRozkaz->cString + 1, (unsigned)(pRozkaz->cString[0])) + " rcvd");
 
-            auto *track = simulation::Paths.find( std::string( pRozkaz->cString + 1, (unsigned)( pRozkaz->cString[ 0 ] ) ) );
+            auto *track = simulation::Paths.find( std::string_view( pRozkaz->cString + 1, (unsigned)( pRozkaz->cString[ 0 ] ) ) );
             if( ( track != nullptr )
              && ( track->IsEmpty() ) ) {
                 WyslijWolny( track->name() );
@@ -141,7 +141,7 @@ OnCommandGet(multiplayer::DaneRozkaz *pRozkaz)
                     auto *vehicle = (
                         pRozkaz->cString[ 1 ] == '*' ?
                             simulation::Vehicles.find( Global.local_start_vehicle ) :
-                            simulation::Vehicles.find( std::string{ pRozkaz->cString + 1, (unsigned)pRozkaz->cString[ 0 ] } ) );
+                            simulation::Vehicles.find( std::string_view{ pRozkaz->cString + 1, (unsigned)pRozkaz->cString[ 0 ] } ) );
                     if( vehicle != nullptr ) {
                         WyslijNamiary( vehicle ); // wysłanie informacji o pojeździe
                     }
@@ -182,7 +182,7 @@ OnCommandGet(multiplayer::DaneRozkaz *pRozkaz)
                 auto *lookup = (
                     pRozkaz->cString[ 2 ] == '*' ?
                         simulation::Vehicles.find( Global.local_start_vehicle ) : // nazwa pojazdu użytkownika
-                        simulation::Vehicles.find( std::string( pRozkaz->cString + 2, (unsigned)pRozkaz->cString[ 1 ] ) ) ); // nazwa pojazdu
+                        simulation::Vehicles.find( std::string_view( pRozkaz->cString + 2, (unsigned)pRozkaz->cString[ 1 ] ) ) ); // nazwa pojazdu
                 if( lookup == nullptr ) { break; } // nothing found, nothing to do
                 auto *d { lookup };
                 while( d != nullptr ) {
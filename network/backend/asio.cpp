@@ -24,6 +24,7 @@ void network::tcp::connection::disconnect()
 
 void network::tcp::connection::send_data(std::shared_ptr<std::string> buffer)
 {
+	pending_writes++;
 	asio::async_write(m_socket, asio::buffer(*buffer.get()), std::bind(&connection::send_complete, this, buffer));
 }
 
@@ -60,11 +61,11 @@ void network::tcp::connection::handle_header(const asio::error_code &err, size_t
 	}
 
 	uint32_t len = sn_utils::ld_uint32(header);
-	m_body_buffer.resize(len);
 	if (len > MAX_MSG_SIZE) {
 		disconnect();
 		return;
 	}
+	m_body_buffer.resize(len);
 
 	asio::async_read(m_socket, asio::buffer(m_body_buffer),
 	                 std::bind(&connection::handle_data, this, std::placeholders::_1, std::placeholders::_2));
@@ -83,7 +84,7 @@ void network::tcp::connection::handle_data(const asio::error_code &err, size_t b
 	}
 
 	std::istringstream stream(m_body_buffer);
-	std::shared_ptr<message> msg = deserialize_message(stream);
+	std::shared_ptr<message> msg = deserialize_message(stream, receive_context);
 	if (message_handler)
 		message_handler(*msg);
 
@@ -97,7 +98,7 @@ void network::tcp::connection::write_message(const message &msg, std::ostream &s
 	sn_utils::ls_uint32(stream, NETWORK_MAGIC);
 	sn_utils::ls_uint32(stream, 0);
 
-	serialize_message(msg, stream);
+	serialize_message(msg, stream, send_context);
 
 	size_t size = (size_t)stream.tellp() - beg - 8;
 	if (size > MAX_MSG_SIZE) {
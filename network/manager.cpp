@@ -28,7 +28,7 @@ command_queue::commands_map network::server_manager::pop_commands()
 	return map;
 }
 
-void network::server_manager::push_delta(double render_dt, double dt, double sync, const command_queue::commands_map &commands)
+void network::server_manager::push_delta(double render_dt, double dt, double sync, const glm::dvec3 &events_origin, const command_queue::commands_map &commands)
 {
 	if (dt == 0.0 && commands.empty())
 		return;
@@ -37,12 +37,13 @@ void network::server_manager::push_delta(double render_dt, double dt, double syn
 	msg.render_dt = render_dt;
 	msg.dt = dt;
 	msg.sync = sync;
+	msg.events_origin = events_origin;
 	msg.commands = commands;
 
 	for (auto srv : servers)
 		srv->push_delta(msg);
 
-	serialize_message(msg, *backbuffer.get());
+	serialize_message(msg, *backbuffer.get(), backbuffer_context);
 }
 
 void network::server_manager::create_server(const std::string &backend, const std::string &conf)
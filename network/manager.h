@@ -10,11 +10,12 @@ namespace network
 	private:
 		std::vector<std::shared_ptr<server>> servers;
 		std::shared_ptr<std::fstream> backbuffer;
+		stream_context backbuffer_context; // state of the recording, as written
 
 	public:
 		server_manager();
 
-		void push_delta(double render_dt, double dt, double sync, const command_queue::commands_map &commands);
+		void push_delta(double render_dt, double dt, double sync, const glm::dvec3 &events_origin, const command_queue::commands_map &commands);
 		command_queue::commands_map pop_commands();
 		void create_server(const std::string &backend, const std::string &conf);
 	};
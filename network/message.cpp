@@ -2,6 +2,84 @@
 #include "network/message.h"
 #include "sn_utils.h"
 
+#include <cstring>
+
+namespace {
+
+// command field flags
+enum command_flags : uint8_t
+{
+	param1_integer = 0x1,
+	param2_integer = 0x2,
+	has_location = 0x4,
+	has_payload = 0x8
+};
+
+// frame field flags
+enum frame_flags : uint8_t
+{
+	has_origin = 0x1
+};
+
+bool is_integer(double const value)
+{
+	return std::trunc(value) == value
+	    && std::abs(value) < 1e15
+	    && !(value == 0.0 && std::signbit(value));
+}
+
+// returns bit pattern of provided value
+uint64_t double_bits(double const value)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// stores value as difference from reference value, trimmed to the bytes which differ
+void s_double_delta(std::ostream &stream, double const value, double const reference)
+{
+	uint64_t delta = double_bits(value) ^ double_bits(reference);
+	uint8_t size = 0;
+	uint8_t buf[8];
+	while (delta != 0)
+	{
+		buf[size++] = (uint8_t)delta;
+		delta >>= 8;
+	}
+	sn_utils::s_uint8(stream, size);
+	stream.write((char *)buf, size);
+}
+
+double d_double_delta(std::istream &stream, double const reference)
+{
+	uint8_t const size = std::min<uint8_t>(sn_utils::d_uint8(stream), 8);
+	uint8_t buf[8];
+	stream.read((char *)buf, size);
+	uint64_t delta = 0;
+	for (int i = size - 1; i >= 0; i--)
+		delta = (delta << 8) | buf[i];
+	uint64_t const bits = double_bits(reference) ^ delta;
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+void s_number(std::ostream &stream, double const value, bool const integer)
+{
+	if (integer)
+		sn_utils::s_varint(stream, (int64_t)value);
+	else
+		sn_utils::ls_float64(stream, value);
+}
+
+double d_number(std::istream &stream, bool const integer)
+{
+	return integer ? (double)sn_utils::d_varint(stream) : sn_utils::ld_float64(stream);
+}
+
+} // namespace
+
 void network::client_hello::serialize(std::ostream &stream) const
 {
 	sn_utils::ls_int32(stream, version);
@@ -30,49 +108,68 @@ void network::server_hello::deserialize(std::istream &stream)
     scenario = sn_utils::d_str(stream);
 }
 
+// commands are stored with command and recipient ids as variable length integers, and optional fields skipped when empty
 void ::network::request_command::serialize(std::ostream &stream) const
 {
-	sn_utils::ls_uint32(stream, commands.size());
+	sn_utils::s_varuint(stream, commands.size());
 	for (auto const &kv : commands)
 	{
-		sn_utils::ls_uint32(stream, kv.first);
-		sn_utils::ls_uint32(stream, kv.second.size());
+		sn_utils::s_varuint(stream, kv.first);
+		sn_utils::s_varuint(stream, kv.second.size());
+		double time_delta = 0.0;
 		for (command_data const &data : kv.second)
 		{
-			sn_utils::ls_uint32(stream, (uint32_t)data.command);
-			sn_utils::ls_int32(stream, data.action);
-			sn_utils::ls_float64(stream, data.param1);
-			sn_utils::ls_float64(stream, data.param2);
-			sn_utils::ls_float64(stream, data.time_delta);
+			uint8_t flags = 0;
+			if (is_integer(data.param1))
+				flags |= param1_integer;
+			if (is_integer(data.param2))
+				flags |= param2_integer;
+			if (data.location != glm::vec3(0.0f))
+				flags |= has_location;
+			if (!data.payload.empty())
+				flags |= has_payload;
 
-			sn_utils::s_vec3(stream, data.location);
+			sn_utils::s_varuint(stream, (uint32_t)data.command);
+			sn_utils::s_uint8(stream, flags);
+			sn_utils::s_varint(stream, data.action);
+			s_number(stream, data.param1, flags & param1_integer);
+			s_number(stream, data.param2, flags & param2_integer);
+			// commands issued in the same frame tend to share the time delta
+			s_double_delta(stream, data.time_delta, time_delta);
+			time_delta = data.time_delta;
 
-			sn_utils::s_str(stream, data.payload);
+			if (flags & has_location)
+				sn_utils::s_vec3(stream, data.location);
+			if (flags & has_payload)
+				sn_utils::s_str(stream, data.payload);
 		}
 	}
 }
 
 void network::request_command::deserialize(std::istream &stream)
 {
-	uint32_t commands_size = sn_utils::ld_uint32(stream);
-	for (uint32_t i = 0; i < commands_size; i++)
+	uint64_t commands_size = sn_utils::d_varuint(stream);
+	for (uint64_t i = 0; i < commands_size && stream; i++)
 	{
-		uint32_t recipient = sn_utils::ld_uint32(stream);
-		uint32_t sequence_size = sn_utils::ld_uint32(stream);
+		uint32_t recipient = (uint32_t)sn_utils::d_varuint(stream);
+		uint64_t sequence_size = sn_utils::d_varuint(stream);
 
 		command_queue::commanddata_sequence sequence;
-		for (uint32_t i = 0; i < sequence_size; i++)
+		double time_delta = 0.0;
+		for (uint64_t i = 0; i < sequence_size && stream; i++)
 		{
 			command_data data;
-			data.command = (user_command)sn_utils::ld_uint32(stream);
-			data.action = sn_utils::ld_int32(stream);
-			data.param1 = sn_utils::ld_float64(stream);
-			data.param2 = sn_utils::ld_float64(stream);
-			data.time_delta = sn_utils::ld_float64(stream);
-
-			data.location = sn_utils::d_vec3(stream);
+			data.command = (user_command)sn_utils::d_varuint(stream);
+			uint8_t flags = sn_utils::d_uint8(stream);
+			data.action = (int)sn_utils::d_varint(stream);
+			data.param1 = d_number(stream, flags & param1_integer);
+			data.param2 = d_number(stream, flags & param2_integer);
+			data.time_delta = d_double_delta(stream, time_delta);
+			time_delta = data.time_delta;
 
-			data.payload = sn_utils::d_str(stream);
+			data.location = (flags & has_location) ? sn_utils::d_vec3(stream) : glm::vec3(0.0f);
+			if (flags & has_payload)
+				data.payload = sn_utils::d_str(stream);
 
 			sequence.emplace_back(data);
 		}
@@ -83,23 +180,114 @@ void network::request_command::deserialize(std::istream &stream)
 
 void network::frame_info::serialize(std::ostream &stream) const
 {
-	sn_utils::ls_float64(stream, render_dt);
+	stream_context context;
+	serialize(stream, context);
+}
+
+void network::frame_info::deserialize(std::istream &stream)
+{
+	stream_context context;
+	deserialize(stream, context);
+}
+
+void network::frame_info::serialize(std::ostream &stream, stream_context &context) const
+{
 	sn_utils::ls_float64(stream, dt);
+	s_double_delta(stream, render_dt, dt);
 	sn_utils::ls_float64(stream, sync);
+	// origin is included only when the camera moved since the preceding frame
+	uint8_t const flags = (events_origin != context.events_origin) ? has_origin : 0;
+	sn_utils::s_uint8(stream, flags);
+	if (flags & has_origin)
+		for (int i = 0; i < 3; i++)
+			s_double_delta(stream, events_origin[i], context.events_origin[i]);
+	context.events_origin = events_origin;
 
 	request_command::serialize(stream);
 }
 
-void network::frame_info::deserialize(std::istream &stream)
+void network::frame_info::deserialize(std::istream &stream, stream_context &context)
 {
-	render_dt = sn_utils::ld_float64(stream);
 	dt = sn_utils::ld_float64(stream);
+	render_dt = d_double_delta(stream, dt);
 	sync = sn_utils::ld_float64(stream);
+	uint8_t const flags = sn_utils::d_uint8(stream);
+	events_origin = context.events_origin;
+	if (flags & has_origin)
+		for (int i = 0; i < 3; i++)
+			events_origin[i] = d_double_delta(stream, context.events_origin[i]);
+	context.events_origin = events_origin;
 
 	request_command::deserialize(stream);
 }
 
+void network::frame_batch::serialize(std::ostream &stream) const
+{
+	stream_context context;
+	serialize(stream, context);
+}
+
+void network::frame_batch::deserialize(std::istream &stream)
+{
+	stream_context context;
+	deserialize(stream, context);
+}
+
+void network::frame_batch::serialize(std::ostream &stream, stream_context &context) const
+{
+	sn_utils::s_varuint(stream, frames.size());
+	double dt = 0.0;
+	glm::dvec3 &events_origin = context.events_origin;
+	for (frame_info const &frame : frames)
+	{
+		s_double_delta(stream, frame.dt, dt);
+		s_double_delta(stream, frame.render_dt, frame.dt);
+		sn_utils::ls_float64(stream, frame.sync);
+		dt = frame.dt;
+		// the camera tends to stay in place, or move in small steps
+		for (int i = 0; i < 3; i++)
+			s_double_delta(stream, frame.events_origin[i], events_origin[i]);
+		events_origin = frame.events_origin;
+
+		frame.request_command::serialize(stream);
+	}
+}
+
+void network::frame_batch::deserialize(std::istream &stream, stream_context &context)
+{
+	uint64_t frames_size = sn_utils::d_varuint(stream);
+	double dt = 0.0;
+	glm::dvec3 &events_origin = context.events_origin;
+	for (uint64_t i = 0; i < frames_size && stream; i++)
+	{
+		frame_info frame;
+		frame.dt = d_double_delta(stream, dt);
+		frame.render_dt = d_double_delta(stream, frame.dt);
+		frame.sync = sn_utils::ld_float64(stream);
+		dt = frame.dt;
+		for (int j = 0; j < 3; j++)
+			frame.events_origin[j] = d_double_delta(stream, events_origin[j]);
+		events_origin = frame.events_origin;
+
+		frame.request_command::deserialize(stream);
+
+		frames.emplace_back(std::move(frame));
+	}
+}
+
 std::shared_ptr<network::message> network::deserialize_message(std::istream &stream)
+{
+	stream_context context;
+	return deserialize_message(stream, context);
+}
+
+void network::serialize_message(const message &msg, std::ostream &stream)
+{
+	stream_context context;
+	serialize_message(msg, stream, context);
+}
+
+std::shared_ptr<network::message> network::deserialize_message(std::istream &stream, stream_context &context)
 {
 	message::type_e type = (message::type_e)sn_utils::ld_uint16(stream);
 
@@ -113,14 +301,22 @@ std::shared_ptr<network::message> network::deserialize_message(std::istream &str
 		msg = std::make_shared<frame_info>();
 	else if (type == message::REQUEST_COMMAND)
 		msg = std::make_shared<request_command>();
+	else if (type == message::FRAME_BATCH)
+		msg = std::make_shared<frame_batch>();
+	else
+		// unknown message, handlers drop the peer on it
+		return std::make_shared<message>(message::TYPE_MAX);
 
-	msg->deserialize(stream);
+	msg->deserialize(stream, context);
+	if (!stream)
+		// message cut short, its content can't be trusted
+		return std::make_shared<message>(message::TYPE_MAX);
 
 	return msg;
 }
 
-void network::serialize_message(const message &msg, std::ostream &stream)
+void network::serialize_message(const message &msg, std::ostream &stream, stream_context &context)
 {
 	sn_utils::ls_uint16(stream, (uint16_t)msg.type);
-	msg.serialize(stream);
+	msg.serialize(stream, context);
 }
@@ -5,6 +5,13 @@
 
 namespace network
 {
+// values carried over between consecutive messages of a single stream, so frames can skip or delta-encode the ones repeated from the preceding frame.
+// each direction of a connection and each recording has its own
+struct stream_context
+{
+	glm::dvec3 events_origin;
+};
+
 struct message
 {
 	enum type_e
@@ -13,6 +20,7 @@ struct message
 		SERVER_HELLO,
 		FRAME_INFO,
 		REQUEST_COMMAND,
+		FRAME_BATCH,
 		TYPE_MAX
 	};
 
@@ -21,6 +29,9 @@ struct message
 	message(type_e t) : type(t) {}
 	virtual void serialize(std::ostream &stream) const {}
 	virtual void deserialize(std::istream &stream) {}
+	// messages which don't depend on the preceding ones ignore the stream context
+	virtual void serialize(std::ostream &stream, stream_context &context) const { serialize(stream); }
+	virtual void deserialize(std::istream &stream, stream_context &context) { deserialize(stream); }
 };
 
 struct client_hello : public message
@@ -65,11 +76,31 @@ struct frame_info : public request_command
 	double render_dt;
 	double dt;
 	double sync;
+	glm::dvec3 events_origin; // location around which the frame polled event launchers
+
+	virtual void serialize(std::ostream &stream) const override;
+	virtual void deserialize(std::istream &stream) override;
+	// the origin is sent only if it differs from the one of the preceding frame
+	virtual void serialize(std::ostream &stream, stream_context &context) const override;
+	virtual void deserialize(std::istream &stream, stream_context &context) override;
+};
+
+// several consecutive frames sent together, with timing fields delta-encoded against the preceding frame
+struct frame_batch : public message
+{
+	frame_batch() : message(FRAME_BATCH) {}
+
+	std::vector<frame_info> frames;
 
 	virtual void serialize(std::ostream &stream) const override;
 	virtual void deserialize(std::istream &stream) override;
+	virtual void serialize(std::ostream &stream, stream_context &context) const override;
+	virtual void deserialize(std::istream &stream, stream_context &context) override;
 };
 
+// messages without context are self-contained, and can be read on their own
 std::shared_ptr<message> deserialize_message(std::istream &stream);
 void serialize_message(const message &msg, std::ostream &stream);
+std::shared_ptr<message> deserialize_message(std::istream &stream, stream_context &context);
+void serialize_message(const message &msg, std::ostream &stream, stream_context &context);
 } // namespace network
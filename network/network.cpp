@@ -7,7 +7,7 @@
 #include "application.h"
 #include "Globals.h"
 
-std::uint32_t const EU07_NETWORK_VERSION = 2;
+std::uint32_t const EU07_NETWORK_VERSION = 6;
 
 namespace network {
 
@@ -53,6 +53,7 @@ void network::connection::catch_up()
 	backbuffer->seekg(backbuffer_pos);
 
 	std::vector<std::shared_ptr<message>> messages;
+	std::shared_ptr<frame_batch> batch;
 
 	for (int i = 0; i < CATCHUP_PACKETS; i++) {
 		if (backbuffer->peek() == EOF) {
@@ -62,7 +63,7 @@ void network::connection::catch_up()
 			return;
 		}
 
-		auto msg = deserialize_message(*backbuffer.get());
+		auto msg = deserialize_message(*backbuffer.get(), backbuffer_context);
 
 		if (packet_counter) {
 			packet_counter--;
@@ -70,6 +71,17 @@ void network::connection::catch_up()
 			continue;
 		}
 
+		// recorded frames are sent in batches, to share the per-message overhead and timing deltas
+		if (msg->type == message::FRAME_INFO) {
+			if (!batch || batch->frames.size() >= (size_t)CATCHUP_BATCH) {
+				batch = std::make_shared<frame_batch>();
+				messages.push_back(batch);
+			}
+			batch->frames.push_back(static_cast<const frame_info&>(*msg));
+			continue;
+		}
+
+		batch.reset();
 		messages.push_back(msg);
 	}
 
@@ -81,9 +93,42 @@ void network::connection::catch_up()
 
 void network::connection::send_complete(std::shared_ptr<std::string> buf)
 {
+	if (pending_writes > 0)
+		pending_writes--;
+
 	if (!is_client && state == CATCHING_UP) {
 		catch_up();
 	}
+	else if (pending_writes == 0 && live_batch) {
+		send_live_batch();
+	}
+}
+
+void network::connection::send_frame(const frame_info &msg)
+{
+	if (pending_writes == 0 && !live_batch) {
+		send_message(msg);
+		return;
+	}
+
+	// frames which pile up behind a slow write go out together, sharing the per-message overhead and timing deltas
+	if (!live_batch)
+		live_batch = std::make_shared<frame_batch>();
+	live_batch->frames.push_back(msg);
+
+	if (live_batch->frames.size() >= (size_t)CATCHUP_BATCH)
+		send_live_batch();
+}
+
+void network::connection::send_live_batch()
+{
+	auto batch = std::move(live_batch);
+	live_batch.reset();
+
+	if (batch->frames.size() == 1)
+		send_message(batch->frames.front());
+	else
+		send_message(*batch);
 }
 
 // --------------
@@ -103,7 +148,7 @@ void network::server::push_delta(const frame_info &msg)
 		}
 
 		if ((*it)->state == connection::ACTIVE)
-			(*it)->send_message(msg);
+			(*it)->send_frame(msg);
 
 		it++;
 	}
@@ -173,7 +218,7 @@ void network::client::update()
 }
 
 // client
-std::tuple<double, double, command_queue::commands_map> network::client::get_next_delta(int counter)
+std::tuple<double, double, command_queue::commands_map, glm::dvec3> network::client::get_next_delta(int counter)
 {
 	auto now = std::chrono::high_resolution_clock::now();
 	if (counter == 1) {
@@ -184,7 +229,7 @@ std::tuple<double, double, command_queue::commands_map> network::client::get_nex
 	if (delta_queue.empty()) {
 		// buffer underflow
 		return std::tuple<double, double,
-		        command_queue::commands_map>(0.0, 0.0, command_queue::commands_map());
+		        command_queue::commands_map, glm::dvec3>(0.0, 0.0, command_queue::commands_map(), glm::dvec3());
 	}
 
 
@@ -212,11 +257,11 @@ std::tuple<double, double, command_queue::commands_map> network::client::get_nex
 
 		delta_queue.pop();
 
-		return std::make_tuple(entry.dt, entry.sync, entry.commands);
+		return std::make_tuple(entry.dt, entry.sync, entry.commands, entry.events_origin);
 	} else {
 		// nothing to push
 		return std::tuple<double, double,
-		        command_queue::commands_map>(0.0, 0.0, command_queue::commands_map());
+		        command_queue::commands_map, glm::dvec3>(0.0, 0.0, command_queue::commands_map(), glm::dvec3());
 	}
 }
 
@@ -270,6 +315,14 @@ void network::client::handle_message(std::shared_ptr<connection> conn, const mes
 		delta_queue.push(delta);
 		last_rcv = std::chrono::high_resolution_clock::now();
 	}
+	else if (msg.type == message::FRAME_BATCH) {
+		auto const &batch = dynamic_cast<const frame_batch&>(msg);
+		for (auto const &delta : batch.frames) {
+			resume_frame_counter++;
+			delta_queue.push(delta);
+		}
+		last_rcv = std::chrono::high_resolution_clock::now();
+	}
 }
 
 // --------------
@@ -18,6 +18,7 @@ namespace network
 
 	private:
 		const int CATCHUP_PACKETS = 300;
+		const int CATCHUP_BATCH = 50; // frames packed into single message during catch-up and live transmission
 
 		bool is_client;
 
@@ -25,9 +26,15 @@ namespace network
 		std::shared_ptr<std::istream> backbuffer;
 		size_t backbuffer_pos;
 		size_t packet_counter;
+		size_t pending_writes = 0; // writes passed to the backend and not yet completed
+		std::shared_ptr<frame_batch> live_batch; // live frames held back until the pending writes complete
+		stream_context backbuffer_context; // state of the recording, as read during catch-up
+		stream_context send_context;
+		stream_context receive_context;
 
 		void send_complete(std::shared_ptr<std::string> buf);
 		void catch_up();
+		void send_live_batch();
 
 	public:
 		std::function<void(const message &msg)> message_handler;
@@ -35,6 +42,8 @@ namespace network
 		virtual void connected() = 0;
 		virtual void send_message(const message &msg) = 0;
 		virtual void send_messages(const std::vector<std::shared_ptr<message>> &messages) = 0;
+		// sends live frame, or holds it for the next write if the peer didn't take the previous one yet
+		void send_frame(const frame_info &msg);
 
 		connection(bool client = false, size_t counter = 0);
 		void set_handler(std::function<void(const message &msg)> handler);
@@ -97,7 +106,7 @@ namespace network
 
 	public:
 		void update();
-		std::tuple<double, double, command_queue::commands_map> get_next_delta(int counter);
+		std::tuple<double, double, command_queue::commands_map, glm::dvec3> get_next_delta(int counter);
 		void send_commands(command_queue::commands_map commands);
 		int get_frame_counter() {
 			return resume_frame_counter;
@@ -0,0 +1,68 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "nullrenderer.h"
+
+// creates a new geometry bank. returns: handle to the bank or NULL
+gfx::geometrybank_handle
+null_renderer::Create_Bank() {
+
+    return m_geometry.create_bank();
+}
+
+// creates a new indexed geometry chunk of specified type from supplied data, in specified bank. returns: handle to the chunk or NULL
+gfx::geometry_handle
+null_renderer::Insert( gfx::index_array &Indices, gfx::vertex_array &Vertices, gfx::geometrybank_handle const &Geometry, int const Type ) {
+
+    return m_geometry.create_chunk( Indices, Vertices, Geometry, Type );
+}
+
+// creates a new geometry chunk of specified type from supplied data, in specified bank. returns: handle to the chunk or NULL
+gfx::geometry_handle
+null_renderer::Insert( gfx::vertex_array &Vertices, gfx::geometrybank_handle const &Geometry, int const Type ) {
+
+    return m_geometry.create_chunk( Vertices, Geometry, Type );
+}
+
+// replaces data of specified chunk with the supplied vertex data, starting from specified offset
+bool
+null_renderer::Replace( gfx::vertex_array &Vertices, gfx::geometry_handle const &Geometry, int const Type, std::size_t const Offset ) {
+
+    return m_geometry.replace( Vertices, Geometry, Offset );
+}
+
+// adds supplied vertex data at the end of specified chunk
+bool
+null_renderer::Append( gfx::vertex_array &Vertices, gfx::geometry_handle const &Geometry, int const Type ) {
+
+    return m_geometry.append( Vertices, Geometry );
+}
+
+// provides direct access to index data of specfied chunk
+gfx::index_array const &
+null_renderer::Indices( gfx::geometry_handle const &Geometry ) const {
+
+    return m_geometry.indices( Geometry );
+}
+
+// provides direct access to vertex data of specfied chunk
+gfx::vertex_array const &
+null_renderer::Vertices( gfx::geometry_handle const &Geometry ) const {
+
+    return m_geometry.vertices( Geometry );
+}
+
+void
+null_renderer::Update( double const Deltatime ) {
+    // geometry banks are the only resource we hold, let the garbage collector sweep them
+    m_geometry.update();
+}
+
+//---------------------------------------------------------------------------
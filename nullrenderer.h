@@ -0,0 +1,139 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "renderer.h"
+#include "Texture.h"
+
+namespace gfx {
+
+// geometry bank variant which keeps the data on the cpu side only, used when there's no opengl context to upload it to
+
+class null_geometrybank : public geometry_bank {
+
+public:
+// constructors:
+    null_geometrybank() = default;
+
+private:
+// methods:
+    // create() subclass details
+    void
+        create_( gfx::geometry_handle const &Geometry ) override {}
+    // replace() subclass details
+    void
+        replace_( gfx::geometry_handle const &Geometry ) override {}
+    // draw() subclass details
+    auto
+        draw_( gfx::geometry_handle const &Geometry, gfx::stream_units const &Units, unsigned int const Streams ) -> std::size_t override { return 0; }
+    // release () subclass details
+    void
+        release_() override {}
+};
+
+} // namespace gfx
+
+// renderer stub for runs without a window, e.g. headless simulation.
+// accepts geometry so the scenery loader can work unchanged, ignores materials, textures and draw requests
+class null_renderer : public gfx_renderer {
+
+public:
+// constructors
+    null_renderer() = default;
+// destructor
+    ~null_renderer() {}
+// methods
+    bool
+        Init( GLFWwindow *Window ) override { return true; }
+    // main draw call. returns false on error
+    bool
+        Render() override { return true; }
+    void
+        SwapBuffers() override {}
+    float
+        Framerate() override { return 0.f; }
+    // geometry methods
+    // creates a new geometry bank. returns: handle to the bank or NULL
+    gfx::geometrybank_handle
+        Create_Bank() override;
+    // creates a new indexed geometry chunk of specified type from supplied data, in specified bank. returns: handle to the chunk or NULL
+    gfx::geometry_handle
+        Insert( gfx::index_array &Indices, gfx::vertex_array &Vertices, gfx::geometrybank_handle const &Geometry, int const Type ) override;
+    // creates a new geometry chunk of specified type from supplied data, in specified bank. returns: handle to the chunk or NULL
+    gfx::geometry_handle
+        Insert( gfx::vertex_array &Vertices, gfx::geometrybank_handle const &Geometry, int const Type ) override;
+    // replaces data of specified chunk with the supplied vertex data, starting from specified offset
+    bool
+        Replace( gfx::vertex_array &Vertices, gfx::geometry_handle const &Geometry, int const Type, std::size_t const Offset = 0 ) override;
+    // adds supplied vertex data at the end of specified chunk
+    bool
+        Append( gfx::vertex_array &Vertices, gfx::geometry_handle const &Geometry, int const Type ) override;
+    // provides direct access to index data of specfied chunk
+    gfx::index_array const &
+        Indices( gfx::geometry_handle const &Geometry ) const override;
+    // provides direct access to vertex data of specfied chunk
+    gfx::vertex_array const &
+        Vertices( gfx::geometry_handle const &Geometry ) const override;
+    // material methods
+    material_handle
+        Fetch_Material( std::string const &Filename, bool const Loadnow = true ) override { return null_handle; }
+    void
+        Bind_Material( material_handle const Material, TSubModel const *sm = nullptr, lighting_data const *lighting = nullptr ) override {}
+    opengl_material const &
+        Material( material_handle const Material ) const override { return m_material; }
+    // shader methods
+    std::shared_ptr<gl::program>
+        Fetch_Shader( std::string const &name ) override { return nullptr; }
+    // texture methods
+    texture_handle
+        Fetch_Texture( std::string const &Filename, bool const Loadnow = true, GLint format_hint = GL_SRGB_ALPHA ) override { return null_handle; }
+    void
+        Bind_Texture( texture_handle const Texture ) override {}
+    void
+        Bind_Texture( std::size_t const Unit, texture_handle const Texture ) override {}
+    opengl_texture &
+        Texture( texture_handle const Texture ) override { return m_texture; }
+    opengl_texture const &
+        Texture( texture_handle const Texture ) const override { return m_texture; }
+    // utility methods
+    void
+        Pick_Control_Callback( std::function<void( TSubModel const * )> Callback ) override {}
+    void
+        Pick_Node_Callback( std::function<void( scene::basic_node * )> Callback ) override {}
+    TSubModel const *
+        Pick_Control() const override { return nullptr; }
+    scene::basic_node const *
+        Pick_Node() const override { return nullptr; }
+    glm::dvec3
+        Mouse_Position() const override { return {}; }
+    // maintenance methods
+    void
+        Update( double const Deltatime ) override;
+    void
+        Update_Pick_Control() override {}
+    void
+        Update_Pick_Node() override {}
+    glm::dvec3
+        Update_Mouse_Position() override { return {}; }
+    // debug methods
+    std::string const &
+        info_times() const override { return m_info; }
+    std::string const &
+        info_stats() const override { return m_info; }
+
+private:
+// members
+    gfx::geometrybank_manager m_geometry;
+    opengl_material m_material; // placeholder returned for all material queries
+    opengl_texture m_texture; // placeholder returned for all texture queries
+    std::string m_info;
+};
+
+//---------------------------------------------------------------------------
@@ -11,6 +11,7 @@ http://mozilla.org/MPL/2.0/.
 #include "opengl33geometrybank.h"
 
 #include "Logs.h"
+#include "Globals.h"
 
 namespace gfx {
 
@@ -21,6 +22,7 @@ void
 opengl33_vaogeometrybank::create_( gfx::geometry_handle const &Geometry ) {
     // adding a chunk means we'll be (re)building the buffer, which will fill the chunk records, amongst other things.
     // thus we don't need to initialize the values here
+    restore_chunks();
     m_chunkrecords.emplace_back( chunk_record() );
     // kiss the existing buffer goodbye, new overall data size means we'll be making a new one
     delete_buffer();
@@ -37,6 +39,7 @@ opengl33_vaogeometrybank::replace_( gfx::geometry_handle const &Geometry ) {
         // ...but otherwise we'll need to allocate a new one
         // TBD: we could keep and reuse the old buffer also if the new chunk is smaller than the old one,
         // but it'd require some extra tracking and work to keep all chunks up to date; also wasting vram; may be not worth it?
+        restore_chunks();
         delete_buffer();
     }
 }
@@ -124,6 +127,10 @@ opengl33_vaogeometrybank::draw_( gfx::geometry_handle const &Geometry, gfx::stre
         }
         m_vertexbuffer->upload( gl::buffer::ARRAY_BUFFER, chunk.vertices.data(), chunkrecord.vertex_offset * sizeof( gfx::basic_vertex ), chunkrecord.vertex_count * sizeof( gfx::basic_vertex ) );
         chunkrecord.is_good = true;
+        if( true == Global.ResourceMove ) {
+            // the buffer holds the only copy of the data from now on, it's retrieved if the chunk or the buffer change
+            discard( Geometry );
+        }
     }
     // render
     if( chunkrecord.index_count > 0 ) {
@@ -157,9 +164,53 @@ opengl33_vaogeometrybank::draw_( gfx::geometry_handle const &Geometry, gfx::stre
 void
 opengl33_vaogeometrybank::release_() {
 
+    restore_chunks();
     delete_buffer();
 }
 
+// restore() subclass details
+void
+opengl33_vaogeometrybank::fetch_( gfx::geometry_handle const &Geometry ) {
+
+    // NOTE: chunks are discarded only after upload, and restored before the buffers are released, so the buffers hold valid data
+    auto &chunk = geometry_bank::chunk( Geometry );
+    auto const &chunkrecord = m_chunkrecords[ Geometry.chunk - 1 ];
+    // copy read target is used for both buffers to leave element array binding of the currently bound vao intact
+    chunk.vertices.resize( chunkrecord.vertex_count );
+    m_vertexbuffer->download( gl::buffer::COPY_READ_BUFFER, chunk.vertices.data(), chunkrecord.vertex_offset * sizeof( gfx::basic_vertex ), chunkrecord.vertex_count * sizeof( gfx::basic_vertex ) );
+    if( chunkrecord.index_count > 0 ) {
+        chunk.indices.resize( chunkrecord.index_count );
+        m_indexbuffer->download( gl::buffer::COPY_READ_BUFFER, chunk.indices.data(), chunkrecord.index_offset * sizeof( gfx::basic_index ), chunkrecord.index_count * sizeof( gfx::basic_index ) );
+    }
+}
+
+// retrieves discarded data of all chunks, before the buffers holding it are released
+void
+opengl33_vaogeometrybank::restore_chunks() {
+
+    if( !m_vertexbuffer ) { return; }
+
+    auto const chunkcount { std::min( m_chunks.size(), m_chunkrecords.size() ) };
+    for( std::size_t chunkindex = 0; chunkindex < chunkcount; ++chunkindex ) {
+        restore( { 0, static_cast<std::uint32_t>( chunkindex + 1 ) } );
+    }
+}
+
+// returns size of geometry data kept on the opengl end, in bytes
+std::size_t
+opengl33_vaogeometrybank::gpu_size() const {
+
+    if( !m_vertexbuffer ) { return 0; }
+
+    std::size_t size { 0 };
+    for( auto const &chunkrecord : m_chunkrecords ) {
+        size +=
+            chunkrecord.vertex_count * sizeof( gfx::basic_vertex )
+          + chunkrecord.index_count * sizeof( gfx::basic_index );
+    }
+    return size;
+}
+
 void
 opengl33_vaogeometrybank::delete_buffer() {
 
@@ -29,6 +29,9 @@ public:
     static
     void
         reset() {;}
+    // returns size of geometry data kept on the opengl end, in bytes
+    auto
+        gpu_size() const -> std::size_t override;
 
 private:
 // types:
@@ -55,6 +58,12 @@ private:
     // release() subclass details
     void
         release_() override;
+    // restore() subclass details
+    void
+        fetch_( gfx::geometry_handle const &Geometry ) override;
+    // retrieves discarded data of all chunks, before the buffers holding it are released
+    void
+        restore_chunks();
     void
         setup_buffer();
     void
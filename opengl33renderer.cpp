@@ -17,6 +17,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Camera.h"
 #include "simulation.h"
 #include "Logs.h"
+#include "profiler.h"
 #include "utilities.h"
 #include "simulationtime.h"
 #include "application.h"
@@ -445,6 +446,7 @@ std::unique_ptr<gl::program> opengl33_renderer::make_shader(std::string v, std::
 
 bool opengl33_renderer::Render()
 {
+    EU07_PROFILE_SCOPE( "opengl33_renderer::Render" );
 	Timer::subsystem.gfx_total.start();
 
 	if (!Global.gfx_usegles)
@@ -527,7 +529,7 @@ void opengl33_renderer::SwapBuffers()
     }
     m_debugtimestext += "uilayer: " + to_string( Timer::subsystem.gfx_gui.average(), 2 ) + " ms\n";
     if( DebugModeFlag )
-        m_debugtimestext += m_textures.info();
+        m_debugtimestext += m_textures.info() + "\n" + m_geometry.info();
 
     debug_stats shadowstats;
     for( auto const &shadowpass : m_shadowpass ) {
@@ -578,6 +580,8 @@ void opengl33_renderer::draw_debug_ui()
 // runs jobs needed to generate graphics for specified render pass
 void opengl33_renderer::Render_pass(viewport_config &vp, rendermode const Mode)
 {
+    EU07_PROFILE_SCOPE( ( std::array<char const *, 6> { {
+        "render pass: none", "render pass: color", "render pass: shadows", "render pass: reflections", "render pass: pickcontrols", "render pass: pickscenery" } } )[ static_cast<std::size_t>( Mode ) ] );
 	setup_pass(vp, m_renderpass, Mode);
     switch (m_renderpass.draw_mode)
 	{
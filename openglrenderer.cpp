@@ -22,6 +22,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Traction.h"
 #include "application.h"
 #include "Logs.h"
+#include "profiler.h"
 #include "utilities.h"
 
 int const EU07_PICKBUFFERSIZE { 1024 }; // size of (square) textures bound with the pick framebuffer
@@ -319,6 +320,7 @@ opengl_renderer::Init( GLFWwindow *Window ) {
 bool
 opengl_renderer::Render() {
 
+    EU07_PROFILE_SCOPE( "opengl_renderer::Render" );
     Timer::subsystem.gfx_total.stop();
     Timer::subsystem.gfx_total.start(); // note: gfx_total is actually frame total, clean this up
     Timer::subsystem.gfx_color.start();
@@ -394,6 +396,8 @@ opengl_renderer::SwapBuffers() {
 void
 opengl_renderer::Render_pass( rendermode const Mode ) {
 
+    EU07_PROFILE_SCOPE( ( std::array<char const *, 7> { {
+        "render pass: none", "render pass: color", "render pass: shadows", "render pass: cabshadows", "render pass: reflections", "render pass: pickcontrols", "render pass: pickscenery" } } )[ static_cast<std::size_t>( Mode ) ] );
 #ifdef EU07_USE_DEBUG_CAMERA
     // setup world camera for potential visualization
     setup_pass(
@@ -4245,7 +4249,7 @@ opengl_renderer::Update( double const Deltatime ) {
     }
 
     if( true == DebugModeFlag ) {
-        m_debugtimestext += m_textures.info();
+        m_debugtimestext += m_textures.info() + "\n" + m_geometry.info();
     }
 
     // dump last opengl error, if any
@@ -11,6 +11,8 @@ http://mozilla.org/MPL/2.0/.
 #include "parser.h"
 #include "utilities.h"
 #include "Logs.h"
+#include "profiler.h"
+#include "jobsystem.h"
 
 #include "scenenodegroups.h"
 
@@ -23,6 +25,222 @@ http://mozilla.org/MPL/2.0/.
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 // cParser -- generic class for parsing text data.
 
+// background loader of included files. files are mapped ahead of the parser by the job system and scanned for further include directives,
+// while the parser itself still consumes them in document order on the calling thread
+struct cParser::preload_cache {
+// types
+    enum class entry_state {
+        queued,
+        loading,
+        ready
+    };
+    struct entry {
+        entry_state state { entry_state::queued };
+        bool scanned { false };
+        std::shared_ptr<source_buffer> buffer;
+    };
+// destructor
+    ~preload_cache() {
+        stop(); }
+// methods
+    void
+        start( std::string const &Filename, std::string const &Path, bool const Loadtraction );
+    void
+        stop();
+    // returns data of specified file if it's part of the preload set, loading it if it isn't ready yet. returns: null if the file isn't preloaded
+    std::shared_ptr<source_buffer>
+        acquire( std::string const &Filename );
+    // loads specified file and queues files it includes
+    void
+        process( std::string const &Filename );
+    // queues loading of specified file. returns: true if the file is new to the preload set
+    bool
+        insert( std::string const &Filename );
+    // collects names of files referenced by include directives in provided data
+    static
+    void
+        scan( std::string_view const Data, bool const Loadtraction, std::vector<std::string> &Includes );
+// members
+    std::mutex mutex;
+    std::condition_variable readycondition; // signals completed loads to waiting threads
+    std::unordered_map<std::string, entry> entries; // preload set, keyed by full path
+    std::vector<threading::job_handle> jobs; // submitted load jobs, not yet known to be completed
+    std::string path; // root path of included files
+    bool loadtraction { true };
+    bool active { false };
+    bool exit { false };
+};
+
+void
+cParser::preload_cache::start( std::string const &Filename, std::string const &Path, bool const Loadtraction ) {
+
+    stop();
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        path = Path;
+        loadtraction = Loadtraction;
+        active = true;
+        exit = false;
+    }
+    insert( Path + Filename );
+}
+
+void
+cParser::preload_cache::stop() {
+
+    std::vector<threading::job_handle> pendingjobs;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        active = false;
+        exit = true;
+    }
+    // jobs which are already running can still submit jobs for included files, so we keep at it until there's none left
+    while( true ) {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( true == jobs.empty() ) { break; }
+            pendingjobs.swap( jobs );
+        }
+        threading::jobs.wait( pendingjobs );
+        pendingjobs.clear();
+    }
+    // parsers still using preloaded data hold their own references
+    std::lock_guard<std::mutex> lock( mutex );
+    entries.clear();
+}
+
+std::shared_ptr<cParser::source_buffer>
+cParser::preload_cache::acquire( std::string const &Filename ) {
+
+    std::unique_lock<std::mutex> lock( mutex );
+
+    if( false == active ) { return nullptr; }
+
+    auto lookup { entries.find( Filename ) };
+    if( lookup == entries.end() ) { return nullptr; }
+
+    auto &file { lookup->second };
+    if( file.state == entry_state::queued ) {
+        // the jobs didn't get to this file yet, so we don't wait for them. the scan is still left to the job
+        file.state = entry_state::loading;
+        lock.unlock();
+        auto buffer { std::make_shared<source_buffer>() };
+        buffer->valid = buffer->map( Filename );
+        lock.lock();
+        file.buffer = buffer;
+        file.state = entry_state::ready;
+        readycondition.notify_all();
+    }
+    readycondition.wait(
+        lock,
+        [&]() {
+            return file.state == entry_state::ready; } );
+
+    return file.buffer;
+}
+
+// queues loading of specified file. returns: true if the file is new to the preload set
+bool
+cParser::preload_cache::insert( std::string const &Filename ) {
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( false == entries.emplace( Filename, entry() ).second ) { return false; }
+    }
+    // NOTE: the job can be executed right away if the job system isn't running, so it's submitted without holding the lock
+    auto job {
+        threading::jobs.submit(
+            [=]() {
+                process( Filename ); } ) };
+
+    std::lock_guard<std::mutex> lock( mutex );
+    jobs.emplace_back( std::move( job ) );
+    return true;
+}
+
+// loads specified file and queues files it includes
+void
+cParser::preload_cache::process( std::string const &Filename ) {
+
+    std::unique_lock<std::mutex> lock( mutex );
+
+    if( true == exit ) { return; }
+
+    auto &file { entries[ Filename ] };
+    if( true == file.scanned ) { return; }
+    file.scanned = true;
+
+    if( file.state == entry_state::queued ) {
+        file.state = entry_state::loading;
+        lock.unlock();
+        auto buffer { std::make_shared<source_buffer>() };
+        buffer->valid = buffer->map( Filename );
+        lock.lock();
+        file.buffer = buffer;
+        file.state = entry_state::ready;
+        readycondition.notify_all();
+    }
+    readycondition.wait(
+        lock,
+        [&]() {
+            return file.state == entry_state::ready; } );
+    auto const buffer { file.buffer };
+    lock.unlock();
+
+    if( false == buffer->valid ) { return; }
+    // NOTE: scanning touches the whole file, which also brings mapped data into memory ahead of the parser
+    std::vector<std::string> includes;
+    scan( buffer->view(), loadtraction, includes );
+    // jobs submitted by a worker are picked up most recent first, so submitting them in reverse makes the loading roughly follow the parser
+    for( auto include { std::rbegin( includes ) }; include != std::rend( includes ); ++include ) {
+        insert( path + *include );
+    }
+}
+
+void
+cParser::preload_cache::scan( std::string_view const Data, bool const Loadtraction, std::vector<std::string> &Includes ) {
+
+    auto const separators { "\n\r\t ;" };
+    auto position { Data.find_first_not_of( separators ) };
+    auto includenext { false };
+    while( position < Data.size() ) {
+        // skip comments and quoted text
+        if( Data.compare( position, 2, "//" ) == 0 ) {
+            position = Data.find( '\n', position );
+        }
+        else if( Data.compare( position, 2, "/*" ) == 0 ) {
+            position = Data.find( "*/", position + 2 );
+            if( position != std::string_view::npos ) { position += 2; }
+        }
+        else if( Data[ position ] == '\"' ) {
+            position = Data.find( '\"', position + 1 );
+            if( position != std::string_view::npos ) { position += 1; }
+            includenext = false;
+        }
+        else {
+            auto const tokenend { std::min( Data.find_first_of( separators, position ), Data.size() ) };
+            auto token { ToLower( std::string( Data.substr( position, tokenend - position ) ) ) };
+            position = tokenend;
+            if( true == includenext ) {
+                includenext = false;
+                // file names built from include parameters can't be resolved ahead of time
+                if( ( false == contains( token, "(p" ) )
+                 && ( ( true == Loadtraction )
+                   || ( ( false == contains( token, "tr/" ) )
+                     && ( false == contains( token, "tra/" ) ) ) ) ) {
+                    Includes.emplace_back( token );
+                }
+            }
+            else {
+                includenext = ( token == "include" );
+            }
+        }
+        if( position == std::string_view::npos ) { break; }
+        position = Data.find_first_not_of( separators, position );
+    }
+}
+
 // constructors
 cParser::cParser( std::string const &Stream, buffertype const Type, std::string Path, bool const Loadtraction, std::vector<std::string> Parameters ) :
     mPath(Path),
@@ -35,7 +253,15 @@ cParser::cParser( std::string const &Stream, buffertype const Type, std::string
     switch (Type) {
         case buffer_FILE: {
             Path.append( Stream );
-            mStream = std::make_shared<std::ifstream>( Path );
+            mBuffer = preloadCache().acquire( Path );
+            if( mBuffer == nullptr ) {
+                mBuffer = std::make_shared<source_buffer>();
+                mBuffer->valid = mBuffer->map( Path );
+            }
+            mFail = ( false == mBuffer->valid );
+            if( false == mFail ) {
+                mFiles = std::make_shared<std::vector<std::string>>( 1, Path );
+            }
             // content of *.inc files is potentially grouped together
             if( ( Stream.size() >= 4 )
              && ( ToLower( Stream.substr( Stream.size() - 4 ) ) == ".inc" ) ) {
@@ -45,7 +271,8 @@ cParser::cParser( std::string const &Stream, buffertype const Type, std::string
             break;
         }
         case buffer_TEXT: {
-            mStream = std::make_shared<std::istringstream>( Stream );
+            mBuffer = std::make_shared<source_buffer>();
+            mBuffer->assign( Stream );
             break;
         }
         default: {
@@ -53,14 +280,14 @@ cParser::cParser( std::string const &Stream, buffertype const Type, std::string
         }
     }
     // calculate stream size
-    if (mStream)
+    if (mBuffer)
     {
-        if( true == mStream->fail() ) {
+        if( true == mFail ) {
             ErrorLog( "Failed to open file \"" + Path + "\"" );
         }
         else {
-            mSize = mStream->rdbuf()->pubseekoff( 0, std::ios_base::end );
-            mStream->rdbuf()->pubseekoff( 0, std::ios_base::beg );
+            mData = mBuffer->view();
+            mSize = mData.size();
             mLine = 1;
         }
     }
@@ -140,6 +367,8 @@ cParser::autoclear( bool const Autoclear ) {
 
 bool cParser::getTokens(unsigned int Count, bool ToLower, const char *Break)
 {
+    EU07_PROFILE_SCOPE( "cParser::getTokens" );
+
     if( true == m_autoclear ) {
         // legacy parser behaviour
         tokens.clear();
@@ -194,9 +423,34 @@ std::string cParser::readToken( bool ToLower, const char *Break ) {
     }
     if( true == token.empty() ) {
         // get the token yourself if the delegation attempt failed
+        updateBreakTable( Break );
+        updateSpecialTable();
         char c { 0 };
         do {
-            while( mStream->peek() != EOF && strchr( Break, c = mStream->get() ) == NULL ) {
+            while( false == exhausted() ) {
+                // grab the run of plain chars in one go, they can't affect token boundaries
+                auto const runstart { mPosition };
+                while( ( mPosition < mData.size() )
+                    && ( false == mBreakTable[ static_cast<unsigned char>( mData[ mPosition ] ) ] )
+                    && ( false == mSpecialTable[ static_cast<unsigned char>( mData[ mPosition ] ) ] ) ) {
+                    ++mPosition;
+                }
+                if( mPosition > runstart ) {
+                    auto const tokensize { token.size() };
+                    token.append( mData.substr( runstart, mPosition - runstart ) );
+                    if( ToLower ) {
+                        std::transform(
+                            std::begin( token ) + tokensize, std::end( token ),
+                            std::begin( token ) + tokensize,
+                            []( char const Char ) {
+                                return ( ( Char >= 'A' ) && ( Char <= 'Z' ) ? Char + ( 'a' - 'A' ) : Char ); } );
+                    }
+                    c = token.back();
+                    if( true == exhausted() ) { break; }
+                }
+                // process the char which stopped the run
+                c = readChar();
+                if( true == mBreakTable[ static_cast<unsigned char>( c ) ] ) { break; }
                 if( ToLower )
                     c = tolower( c );
                 token += c;
@@ -209,7 +463,7 @@ std::string cParser::readToken( bool ToLower, const char *Break ) {
                 // update line counter
                 ++mLine;
             }
-        } while( token == "" && mStream->peek() != EOF ); // double check in case of consecutive separators
+        } while( token == "" && false == exhausted() ); // double check in case of consecutive separators
     }
     // check the first token for potential presence of utf bom
     if( mFirstToken ) {
@@ -250,6 +504,7 @@ std::string cParser::readToken( bool ToLower, const char *Break ) {
            && ( false == contains( includefile, "tra/" ) ) ) ) {
             mIncludeParser = std::make_shared<cParser>( includefile, buffer_FILE, mPath, LoadTraction, readParameters( *this ) );
             mIncludeParser->autoclear( m_autoclear );
+            mIncludeParser->trackFiles( mFiles );
             if( mIncludeParser->mSize <= 0 ) {
                 ErrorLog( "Bad include: can't open file \"" + includefile + "\"" );
             }
@@ -270,6 +525,7 @@ std::string cParser::readToken( bool ToLower, const char *Break ) {
            && ( false == contains( includefile, "tra/" ) ) ) ) {
             mIncludeParser = std::make_shared<cParser>( includefile, buffer_FILE, mPath, LoadTraction, readParameters( includeparser ) );
             mIncludeParser->autoclear( m_autoclear );
+            mIncludeParser->trackFiles( mFiles );
             if( mIncludeParser->mSize <= 0 ) {
                 ErrorLog( "Bad include: can't open file \"" + includefile + "\"" );
             }
@@ -295,7 +551,7 @@ std::vector<std::string> cParser::readParameters( cParser &Input ) {
 std::string cParser::readQuotes(char const Quote) { // read the stream until specified char or stream end
     std::string token = "";
     char c { 0 };
-    while( mStream->peek() != EOF && Quote != (c = mStream->get()) ) { // get all chars until the quote mark
+    while( false == exhausted() && Quote != (c = readChar()) ) { // get all chars until the quote mark
         if( c == '\n' ) {
             // update line counter
             ++mLine;
@@ -306,25 +562,21 @@ std::string cParser::readQuotes(char const Quote) { // read the stream until spe
 }
 
 void cParser::skipComment( std::string const &Endmark ) { // pobieranie znaków aż do znalezienia znacznika końca
-    std::string input = "";
-    char c { 0 };
-    auto const endmarksize = Endmark.size();
-    while( mStream->peek() != EOF ) {
-        // o ile nie koniec pliku
-        c = mStream->get(); // pobranie znaku
-        if( c == '\n' ) {
-            // update line counter
-            ++mLine;
-        }
-        input += c;
-        if( input == Endmark ) // szukanie znacznika końca
-            break;
-        if( input.size() >= endmarksize ) {
-            // keep the read text short, to avoid pointless string re-allocations on longer comments
-            input = input.substr( 1 );
-        }
+    auto const endmark { (
+        Endmark.empty() ?
+            std::string_view::npos :
+            mData.find( Endmark, mPosition ) ) };
+    auto const commentend { (
+        endmark != std::string_view::npos ?
+            endmark + Endmark.size() :
+            mData.size() ) };
+    // update line counter
+    mLine += std::count( std::begin( mData ) + mPosition, std::begin( mData ) + commentend, '\n' );
+    mPosition = commentend;
+    if( endmark == std::string_view::npos ) {
+        // we've run out of data while looking for the end mark
+        exhausted();
     }
-    return;
 }
 
 bool cParser::findQuotes( std::string &String ) {
@@ -356,7 +608,10 @@ bool cParser::trimComments(std::string &String)
 
 int cParser::getProgress() const
 {
-    return static_cast<int>( mStream->rdbuf()->pubseekoff(0, std::ios_base::cur) * 100 / mSize );
+    return (
+        mSize > 0 ?
+            static_cast<int>( mPosition * 100 / mSize ) :
+            100 );
 }
 
 int cParser::getFullProgress() const {
@@ -371,6 +626,23 @@ std::size_t cParser::countTokens( std::string const &Stream, std::string Path )
     return cParser( Stream, buffer_FILE, Path ).count();
 }
 
+void cParser::startPreload( std::string const &Stream, std::string const &Path, bool const Loadtraction ) {
+
+    preloadCache().start( Stream, Path, Loadtraction );
+}
+
+void cParser::stopPreload() {
+
+    preloadCache().stop();
+}
+
+cParser::preload_cache &
+cParser::preloadCache() {
+
+    static preload_cache cache;
+    return cache;
+}
+
 std::size_t cParser::count() {
 
     std::string token;
@@ -387,6 +659,39 @@ std::size_t cParser::count() {
 void cParser::addCommentStyle( std::string const &Commentstart, std::string const &Commentend ) {
 
     mComments.insert( commentmap::value_type(Commentstart, Commentend) );
+    mSpecialTableValid = false;
+}
+
+// rebuilds separator lookup table if provided set differs from the cached one
+void cParser::updateBreakTable( char const *Break ) {
+
+    if( mBreakChars == Break ) { return; }
+
+    mBreakChars = Break;
+    mBreakTable.fill( false );
+    for( auto const breakchar : mBreakChars ) {
+        mBreakTable[ static_cast<unsigned char>( breakchar ) ] = true;
+    }
+}
+
+// rebuilds lookup table of chars which require per-char processing
+void cParser::updateSpecialTable() {
+
+    if( true == mSpecialTableValid ) { return; }
+
+    mSpecialTable.fill( false );
+    // quotes
+    mSpecialTable[ '\"' ] = true;
+    // windows line ends, folded by readChar()
+    mSpecialTable[ '\r' ] = true;
+    // chars completing comment marks, in either letter case
+    for( auto const &comment : mComments ) {
+        if( comment.first.empty() ) { continue; }
+        auto const lastchar { static_cast<unsigned char>( comment.first.back() ) };
+        mSpecialTable[ lastchar ] = true;
+        mSpecialTable[ static_cast<unsigned char>( std::toupper( lastchar ) ) ] = true;
+    }
+    mSpecialTableValid = true;
 }
 
 // returns name of currently open file, or empty string for text type stream
@@ -397,6 +702,29 @@ cParser::Name() const {
     else                 { return mPath + mFile; }
 }
 
+// returns list of files opened so far by the parser and its include directives
+std::vector<std::string> const &
+cParser::Files() const {
+
+    static std::vector<std::string> const nofiles;
+    return (
+        mFiles ?
+            *mFiles :
+            nofiles );
+}
+
+// adds files opened by the parser to the list shared by provided parser chain
+void
+cParser::trackFiles( std::shared_ptr<std::vector<std::string>> Files ) {
+
+    if( Files == nullptr ) { return; }
+
+    if( mFiles ) {
+        Files->insert( std::end( *Files ), std::begin( *mFiles ), std::end( *mFiles ) );
+    }
+    mFiles = Files;
+}
+
 // returns number of currently processed line
 std::size_t
 cParser::Line() const {
@@ -14,6 +14,12 @@ http://mozilla.org/MPL/2.0/.
 #include <fstream>
 #include <vector>
 #include <map>
+#include <array>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+
+struct mapped_buffer;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////
 // cParser -- generic class for parsing text data, either from file or provided string
@@ -53,11 +59,11 @@ class cParser //: public std::stringstream
     inline
     bool
         eof() {
-            return mStream->eof(); };
+            return mEof; };
     inline
     bool
         ok() {
-            return ( !mStream->fail() ); };
+            return ( !mFail ); };
     cParser &
         autoclear( bool const Autoclear );
     inline
@@ -79,16 +85,48 @@ class cParser //: public std::stringstream
     int getFullProgress() const;
     //
     static std::size_t countTokens( std::string const &Stream, std::string Path = "" );
+    // starts background loading of specified file and files referenced by its include directives
+    static void startPreload( std::string const &Stream, std::string const &Path, bool const Loadtraction );
+    // stops background loading and releases preloaded data
+    static void stopPreload();
     // add custom definition of text which should be ignored when retrieving tokens
     void addCommentStyle( std::string const &Commentstart, std::string const &Commentend );
     // returns name of currently open file, or empty string for text type stream
     std::string Name() const;
     // returns number of currently processed line
     std::size_t Line() const;
+    // returns list of files opened so far by the parser and its include directives
+    std::vector<std::string> const & Files() const;
 
   private:
+    // types:
+    // read-only source data, either memory-mapped file or owned copy of provided text
+    using source_buffer = mapped_buffer;
+    // background loader of included files
+    struct preload_cache;
+    using char_table = std::array<bool, 256>;
     // methods:
     std::string readToken(bool ToLower = true, const char *Break = "\n\r\t ;");
+    // returns true if there's no more data to read. updates end of stream flag
+    inline
+    bool
+        exhausted() {
+            if( mPosition < mData.size() ) { return false; }
+            mEof = true;
+            return true; }
+    // retrieves next char from the source, folding windows line ends into a single \n
+    inline
+    char
+        readChar() {
+            auto const c { mData[ mPosition++ ] };
+            if( ( c == '\r' ) && ( mPosition < mData.size() ) && ( mData[ mPosition ] == '\n' ) ) {
+                ++mPosition;
+                return '\n'; }
+            return c; }
+    void updateBreakTable( char const *Break );
+    void updateSpecialTable();
+    static preload_cache &preloadCache();
+    void trackFiles( std::shared_ptr<std::vector<std::string>> Files );
     std::vector<std::string> readParameters( cParser &Input );
     std::string readQuotes( char const Quote = '\"' );
     void skipComment( std::string const &Endmark );
@@ -98,7 +136,15 @@ class cParser //: public std::stringstream
     // members:
     bool m_autoclear { true }; // unretrieved tokens are discarded when another read command is issued (legacy behaviour)
     bool LoadTraction { true }; // load traction?
-    std::shared_ptr<std::istream> mStream; // relevant kind of buffer is attached on creation.
+    std::shared_ptr<source_buffer> mBuffer; // relevant kind of buffer is attached on creation.
+    std::string_view mData; // content of the attached buffer
+    std::size_t mPosition { 0 }; // current read position in the buffer
+    bool mEof { false }; // set when attempt was made to read past the end of the buffer
+    bool mFail { false }; // set when the buffer couldn't be attached
+    std::string mBreakChars; // token separators the break table was built for
+    char_table mBreakTable {}; // lookup table, true for token separators
+    char_table mSpecialTable {}; // lookup table, true for chars which can start quotes or complete comment marks
+    bool mSpecialTableValid { false };
     std::string mFile; // name of the open file, if any
     std::string mPath; // path to open stream, for relative path lookups.
     std::streamoff mSize { 0 }; // size of open stream, for progress report.
@@ -111,6 +157,7 @@ class cParser //: public std::stringstream
         commentmap::value_type( "//", "\n" ) };
     std::shared_ptr<cParser> mIncludeParser; // child class to handle include directives.
     std::vector<std::string> parameters; // parameter list for included file.
+    std::shared_ptr<std::vector<std::string>> mFiles; // files opened by the parser chain, shared with include parsers
     std::deque<std::string> tokens;
 };
 
@@ -126,7 +173,22 @@ cParser::operator>>( Type_ &Right ) {
 
     if( true == this->tokens.empty() ) { return *this; }
 
-    std::stringstream converter( this->tokens.front() );
+    auto const &token { this->tokens.front() };
+    if constexpr(
+        ( std::is_floating_point_v<Type_> )
+     || ( ( std::is_integral_v<Type_> )
+       && ( false == std::is_same_v<Type_, bool> )
+       && ( false == std::is_same_v<Type_, char> )
+       && ( false == std::is_same_v<Type_, signed char> )
+       && ( false == std::is_same_v<Type_, unsigned char> ) ) ) {
+        // fast path for numeric values. anything it can't handle (leading +, out of range values etc) goes through the stream
+        auto const result { std::from_chars( token.data(), token.data() + token.size(), Right ) };
+        if( result.ec == std::errc() ) {
+            this->tokens.pop_front();
+            return *this;
+        }
+    }
+    std::stringstream converter( token );
     converter >> Right;
     this->tokens.pop_front();
 
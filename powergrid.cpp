@@ -0,0 +1,345 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "powergrid.h"
+
+#include "Logs.h"
+
+double const EU07_POWERGRID_MINRESISTANCE { 1e-4 }; // [ohm] lower limit of branch resistance, keeps the matrix well conditioned
+double const EU07_POWERGRID_LEAKAGE { 1e-10 }; // [S] leakage conductance of each node
+std::size_t const EU07_POWERGRID_UPDATEBUDGET { 1 << 20 }; // estimated number of solver operations allowed in single update
+
+namespace powergrid {
+
+// removes all nodes, branches and sources from the network
+void
+network::clear() {
+
+    m_nodes.clear();
+    m_branches.clear();
+    m_supplies.clear();
+    m_subgrids.clear();
+    m_nextsubgrid = 0;
+}
+
+// returns index of a new node
+int
+network::insert_node() {
+
+    m_nodes.emplace_back();
+    return static_cast<int>( m_nodes.size() - 1 );
+}
+
+// connects two nodes with a branch of specified resistance
+void
+network::insert_branch( int const Node1, int const Node2, double const Resistance ) {
+
+    m_branches.push_back( {
+        { Node1, Node2 },
+        1.0 / std::max( Resistance, EU07_POWERGRID_MINRESISTANCE ) } );
+}
+
+// attaches power source to specified node. returns: index of the source
+int
+network::insert_supply( int const Node ) {
+
+    m_supplies.emplace_back();
+    m_supplies.back().node = Node;
+    return static_cast<int>( m_supplies.size() - 1 );
+}
+
+// splits the network into sub-grids and calculates their initial state
+void
+network::build() {
+
+    m_subgrids.clear();
+    m_nextsubgrid = 0;
+    for( auto &node : m_nodes ) {
+        node.subgrid = -1;
+        node.index = -1;
+    }
+
+    std::vector<std::vector<int>> neighbours( m_nodes.size() );
+    for( auto const &branch : m_branches ) {
+        if( branch.nodes[ 0 ] == branch.nodes[ 1 ] ) { continue; }
+        neighbours[ branch.nodes[ 0 ] ].emplace_back( branch.nodes[ 1 ] );
+        neighbours[ branch.nodes[ 1 ] ].emplace_back( branch.nodes[ 0 ] );
+    }
+    std::vector<int> component;
+    for( int nodeindex = 0; nodeindex < static_cast<int>( m_nodes.size() ); ++nodeindex ) {
+        if( m_nodes[ nodeindex ].subgrid != -1 ) { continue; }
+        auto const subgridindex { static_cast<int>( m_subgrids.size() ) };
+        m_subgrids.emplace_back();
+        // gather nodes of the sub-grid, and pick one with the lowest degree as the ordering starting point
+        component.clear();
+        component.emplace_back( nodeindex );
+        m_nodes[ nodeindex ].subgrid = subgridindex;
+        auto start { nodeindex };
+        for( std::size_t idx = 0; idx < component.size(); ++idx ) {
+            auto const current { component[ idx ] };
+            if( neighbours[ current ].size() < neighbours[ start ].size() ) {
+                start = current;
+            }
+            for( auto const neighbour : neighbours[ current ] ) {
+                if( m_nodes[ neighbour ].subgrid != -1 ) { continue; }
+                m_nodes[ neighbour ].subgrid = subgridindex;
+                component.emplace_back( neighbour );
+            }
+        }
+        // reverse cuthill-mckee ordering keeps the factor within narrow envelope
+        auto &subgrid { m_subgrids.back() };
+        auto &ordering { subgrid.nodes };
+        ordering.reserve( component.size() );
+        ordering.emplace_back( start );
+        m_nodes[ start ].index = 0;
+        for( std::size_t idx = 0; idx < ordering.size(); ++idx ) {
+            auto candidates { neighbours[ ordering[ idx ] ] };
+            std::sort(
+                std::begin( candidates ), std::end( candidates ),
+                [&]( int const Left, int const Right ) {
+                    return ( neighbours[ Left ].size() < neighbours[ Right ].size() ); } );
+            for( auto const candidate : candidates ) {
+                if( m_nodes[ candidate ].index != -1 ) { continue; }
+                m_nodes[ candidate ].index = static_cast<int>( ordering.size() );
+                ordering.emplace_back( candidate );
+            }
+        }
+        std::reverse( std::begin( ordering ), std::end( ordering ) );
+        auto const size { static_cast<int>( ordering.size() ) };
+        subgrid.firstcolumns.resize( size );
+        subgrid.rowoffsets.resize( size );
+        std::size_t offset { 0 };
+        for( int row = 0; row < size; ++row ) {
+            m_nodes[ ordering[ row ] ].index = row;
+        }
+        for( int row = 0; row < size; ++row ) {
+            auto first { row };
+            for( auto const neighbour : neighbours[ ordering[ row ] ] ) {
+                first = std::min( first, m_nodes[ neighbour ].index );
+            }
+            auto const rowlength { static_cast<std::size_t>( row - first + 1 ) };
+            subgrid.firstcolumns[ row ] = first;
+            subgrid.rowoffsets[ row ] = offset;
+            offset += rowlength;
+            subgrid.cost += rowlength * rowlength;
+        }
+        subgrid.factor.resize( offset );
+        subgrid.solution.resize( size );
+    }
+    for( int branchindex = 0; branchindex < static_cast<int>( m_branches.size() ); ++branchindex ) {
+        m_subgrids[ m_nodes[ m_branches[ branchindex ].nodes[ 0 ] ].subgrid ].branches.emplace_back( branchindex );
+    }
+    for( int feedindex = 0; feedindex < static_cast<int>( m_supplies.size() ); ++feedindex ) {
+        m_subgrids[ m_nodes[ m_supplies[ feedindex ].node ].subgrid ].feeds.emplace_back( feedindex );
+    }
+    // initial state of the whole network
+    for( auto &subgrid : m_subgrids ) {
+        subgrid.is_dirty = ( false == solve( subgrid ) );
+    }
+
+    WriteLog(
+        "Power grid: " + std::to_string( m_nodes.size() ) + " nodes in " + std::to_string( m_subgrids.size() ) + " sub-grids, "
+        + std::to_string( m_supplies.size() ) + " power sources" );
+}
+
+// adds load drawing specified current at specified voltage, shared equally by two provided nodes, for the current step
+void
+network::insert_load( int const Node1, int const Node2, double const Voltage, double const Current ) {
+
+    if( Current == 0.0 ) { return; }
+
+    auto const resistance { Voltage / Current };
+    for( auto const nodeindex : { Node1, Node2 } ) {
+        auto &node { m_nodes[ nodeindex ] };
+        if( Current > 0.0 ) {
+            node.loadconductance += 0.5 / std::max( resistance, 0.01 );
+        }
+        else {
+            // recuperating vehicle is a current source
+            node.loadcurrent -= 0.5 * Current;
+        }
+    }
+    auto &subgrid { m_subgrids[ m_nodes[ Node1 ].subgrid ] };
+    subgrid.is_loaded = true;
+    if( resistance < 100.0 ) {
+        subgrid.is_overloaded = true;
+    }
+}
+
+// calculates node voltages of sub-grids affected by changes since the last update
+void
+network::update() {
+
+    if( true == m_subgrids.empty() ) { return; }
+
+    for( auto &subgrid : m_subgrids ) {
+        if( ( true == subgrid.is_loaded )
+         || ( true == subgrid.was_loaded ) ) {
+            subgrid.is_dirty = true;
+        }
+        for( auto const feedindex : subgrid.feeds ) {
+            auto &feed { m_supplies[ feedindex ] };
+            if( feed.fuse != feed.state.fuse ) {
+                subgrid.is_dirty = true;
+            }
+            feed.state.overloaded = subgrid.is_overloaded;
+        }
+    }
+    // solve dirty sub-grids in round-robin order until the budget is spent.
+    // sub-grids left out keep their last solution until one of the following updates gets to them
+    auto const subgridcount { m_subgrids.size() };
+    std::size_t work { 0 };
+    for( std::size_t idx = 0; ( idx < subgridcount ) && ( work < EU07_POWERGRID_UPDATEBUDGET ); ++idx ) {
+        auto const subgridindex { ( m_nextsubgrid + idx ) % subgridcount };
+        auto &subgrid { m_subgrids[ subgridindex ] };
+        if( false == subgrid.is_dirty ) { continue; }
+        // sub-grid which failed to solve stays dirty, so following updates try again
+        subgrid.is_dirty = ( false == solve( subgrid ) );
+        work += subgrid.cost;
+        subgrid.was_loaded = subgrid.is_loaded;
+        m_nextsubgrid = ( subgridindex + 1 ) % subgridcount;
+    }
+    // loads are registered anew in each step
+    for( auto &subgrid : m_subgrids ) {
+        if( false == subgrid.is_loaded ) { continue; }
+        for( auto const nodeindex : subgrid.nodes ) {
+            m_nodes[ nodeindex ].loadconductance = 0.0;
+            m_nodes[ nodeindex ].loadcurrent = 0.0;
+        }
+        subgrid.is_loaded = false;
+        subgrid.is_overloaded = false;
+    }
+}
+
+// calculates node voltages of specified sub-grid. returns: true on success
+bool
+network::solve( subgrid &Subgrid ) {
+
+    auto const size { static_cast<int>( Subgrid.nodes.size() ) };
+    auto &factor { Subgrid.factor };
+    auto &solution { Subgrid.solution };
+    auto const element {
+        [&]( int const Row, int const Column ) -> double & {
+            return factor[ Subgrid.rowoffsets[ Row ] + Column - Subgrid.firstcolumns[ Row ] ]; } };
+
+    auto isfed { false };
+    for( auto const feedindex : Subgrid.feeds ) {
+        auto &feed { m_supplies[ feedindex ] };
+        feed.fuse = feed.state.fuse;
+        if( false == feed.fuse ) {
+            isfed = true;
+        }
+    }
+    if( false == isfed ) {
+        // sub-grid without working power source is dead
+        deenergize( Subgrid );
+        Subgrid.is_failed = false;
+        return true;
+    }
+    // assemble conductance matrix and vector of injected currents
+    std::fill( std::begin( factor ), std::end( factor ), 0.0 );
+    for( int row = 0; row < size; ++row ) {
+        auto const &node { m_nodes[ Subgrid.nodes[ row ] ] };
+        element( row, row ) = EU07_POWERGRID_LEAKAGE + node.loadconductance;
+        solution[ row ] = node.loadcurrent;
+    }
+    for( auto const branchindex : Subgrid.branches ) {
+        auto const &branch { m_branches[ branchindex ] };
+        auto const row1 { m_nodes[ branch.nodes[ 0 ] ].index };
+        auto const row2 { m_nodes[ branch.nodes[ 1 ] ].index };
+        element( row1, row1 ) += branch.conductance;
+        if( row1 == row2 ) { continue; }
+        element( row2, row2 ) += branch.conductance;
+        element( std::max( row1, row2 ), std::min( row1, row2 ) ) -= branch.conductance;
+    }
+    for( auto const feedindex : Subgrid.feeds ) {
+        auto const &feed { m_supplies[ feedindex ] };
+        if( true == feed.fuse ) { continue; }
+        auto const row { m_nodes[ feed.node ].index };
+        auto const conductance { 1.0 / feed.state.resistance };
+        element( row, row ) += conductance;
+        solution[ row ] += feed.state.voltage * conductance;
+    }
+    // cholesky factorization in place, within the matrix envelope
+    for( int row = 0; row < size; ++row ) {
+        auto const rowfirst { Subgrid.firstcolumns[ row ] };
+        for( int column = rowfirst; column < row; ++column ) {
+            auto value { element( row, column ) };
+            for( int k = std::max( rowfirst, Subgrid.firstcolumns[ column ] ); k < column; ++k ) {
+                value -= element( row, k ) * element( column, k );
+            }
+            element( row, column ) = value / element( column, column );
+        }
+        auto diagonal { element( row, row ) };
+        for( int k = rowfirst; k < row; ++k ) {
+            diagonal -= element( row, k ) * element( row, k );
+        }
+        if( diagonal <= 0.0 ) {
+            // partial results can't be trusted, so the sub-grid goes without power until it's solved again.
+            // the failure is likely to repeat in the following updates, so it's reported only once
+            if( false == Subgrid.is_failed ) {
+                ErrorLog( "Power grid: failed to calculate state of sub-grid with " + std::to_string( size ) + " nodes" );
+                Subgrid.is_failed = true;
+            }
+            deenergize( Subgrid );
+            return false;
+        }
+        element( row, row ) = std::sqrt( diagonal );
+    }
+    // forward and back substitution
+    for( int row = 0; row < size; ++row ) {
+        auto value { solution[ row ] };
+        for( int k = Subgrid.firstcolumns[ row ]; k < row; ++k ) {
+            value -= element( row, k ) * solution[ k ];
+        }
+        solution[ row ] = value / element( row, row );
+    }
+    for( int row = size - 1; row >= 0; --row ) {
+        solution[ row ] /= element( row, row );
+        for( int k = Subgrid.firstcolumns[ row ]; k < row; ++k ) {
+            solution[ k ] -= element( row, k ) * solution[ row ];
+        }
+    }
+
+    for( int row = 0; row < size; ++row ) {
+        m_nodes[ Subgrid.nodes[ row ] ].voltage = solution[ row ];
+    }
+    for( auto const feedindex : Subgrid.feeds ) {
+        auto const &feed { m_supplies[ feedindex ] };
+        auto &source { m_supplies[ feedindex ].state };
+        if( true == feed.fuse ) {
+            source.current = 0.0;
+            source.outputvoltage = 0.0;
+            continue;
+        }
+        source.outputvoltage = m_nodes[ feed.node ].voltage;
+        source.current = ( source.voltage - source.outputvoltage ) / source.resistance;
+    }
+    Subgrid.is_failed = false;
+    return true;
+}
+
+// sets voltages of specified sub-grid and outputs of its power sources to zero
+void
+network::deenergize( subgrid &Subgrid ) {
+
+    for( auto const nodeindex : Subgrid.nodes ) {
+        m_nodes[ nodeindex ].voltage = 0.0;
+    }
+    for( auto const feedindex : Subgrid.feeds ) {
+        auto &source { m_supplies[ feedindex ].state };
+        source.current = 0.0;
+        source.outputvoltage = 0.0;
+    }
+}
+
+} // powergrid
+
+//---------------------------------------------------------------------------
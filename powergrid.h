@@ -0,0 +1,125 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace powergrid {
+
+// power source feeding the network, represented by its norton equivalent
+struct supply {
+    // inputs, set by the owner before each update
+    double voltage { 0.0 }; // [V] nominal voltage of the source
+    double resistance { 0.2 }; // [ohm] internal resistance of the source
+    bool fuse { false }; // the source is disconnected from the network
+    // outputs, calculated by the last solution of the sub-grid fed by the source
+    double current { 0.0 }; // [A]
+    double outputvoltage { 0.0 }; // [V]
+    bool overloaded { false }; // there was a load with low resistance attached to the sub-grid in the last update
+};
+
+// nodal model of a dc power network. lines are conductances between their end nodes, power sources are attached to
+// their busbar nodes, and loads are placed on the nodes in each step.
+// the network is split into independent sub-grids, and only sub-grids with changed loads are solved in given step
+class network {
+
+public:
+// methods
+    // removes all nodes, branches and sources from the network
+    void
+        clear();
+    // returns index of a new node
+    int
+        insert_node();
+    // connects two nodes with a branch of specified resistance
+    void
+        insert_branch( int const Node1, int const Node2, double const Resistance );
+    // attaches power source to specified node. returns: index of the source
+    int
+        insert_supply( int const Node );
+    // splits the network into sub-grids and calculates their initial state. to be called after all nodes and branches are in place
+    void
+        build();
+    // adds load drawing specified current at specified voltage, shared equally by two provided nodes, for the current step
+    void
+        insert_load( int const Node1, int const Node2, double const Voltage, double const Current );
+    // calculates node voltages of sub-grids affected by changes since the last update
+    void
+        update();
+    // returns voltage at specified node, calculated by the last solution of its sub-grid
+    double
+        voltage( int const Node ) const {
+            return m_nodes[ Node ].voltage; }
+    supply &
+        source( int const Supply ) {
+            return m_supplies[ Supply ].state; }
+    supply const &
+        source( int const Supply ) const {
+            return m_supplies[ Supply ].state; }
+    std::size_t
+        source_count() const {
+            return m_supplies.size(); }
+    std::size_t
+        subgrid_count() const {
+            return m_subgrids.size(); }
+    // returns true if the network doesn't hold any nodes
+    bool
+        empty() const {
+            return m_nodes.empty(); }
+
+private:
+// types
+    struct node {
+        int subgrid { -1 };
+        int index { -1 }; // position of the node in the sub-grid matrix
+        double voltage { 0.0 };
+        double loadconductance { 0.0 }; // sum of conductances of the loads attached to the node in the current step
+        double loadcurrent { 0.0 }; // sum of currents injected into the node by recuperating loads in the current step
+    };
+    struct branch {
+        int nodes[ 2 ];
+        double conductance;
+    };
+    struct feed {
+        supply state;
+        int node; // busbar node of the source
+        bool fuse { false }; // fuse state at the time of the last solution
+    };
+    struct subgrid {
+        std::vector<int> nodes; // network nodes, in envelope-reducing order
+        std::vector<int> branches;
+        std::vector<int> feeds;
+        std::vector<int> firstcolumns; // first non-zero column of each matrix row
+        std::vector<std::size_t> rowoffsets; // start of each matrix row in the factor storage
+        std::vector<double> factor; // lower triangle of the matrix, within its envelope
+        std::vector<double> solution;
+        std::size_t cost { 0 }; // estimated number of operations performed by the solver
+        bool is_loaded { false }; // there are loads attached to the sub-grid in the current step
+        bool was_loaded { false }; // there were loads attached to the sub-grid in the last solution
+        bool is_overloaded { false }; // there's a load with low resistance attached in the current step
+        bool is_dirty { true }; // the last solution doesn't reflect current state of the sub-grid
+        bool is_failed { false }; // the last attempt to solve the sub-grid failed
+    };
+// methods
+    // calculates node voltages of specified sub-grid. returns: true on success
+    bool
+        solve( subgrid &Subgrid );
+    // sets voltages of specified sub-grid and outputs of its power sources to zero
+    void
+        deenergize( subgrid &Subgrid );
+// members
+    std::vector<node> m_nodes;
+    std::vector<branch> m_branches;
+    std::vector<feed> m_supplies;
+    std::vector<subgrid> m_subgrids;
+    std::size_t m_nextsubgrid { 0 }; // round-robin starting point for sub-grid updates
+};
+
+} // powergrid
+
+//---------------------------------------------------------------------------
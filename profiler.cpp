@@ -0,0 +1,132 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "profiler.h"
+
+#ifdef EU07_USE_PROFILER
+
+#include "Logs.h"
+
+namespace profiler {
+
+namespace {
+
+std::size_t const EU07_PROFILER_BUFFERSIZE { 1 << 16 }; // markers kept per thread, older ones get overwritten
+std::size_t const EU07_PROFILER_EXPORTMARGIN { 1 << 10 }; // oldest markers skipped on export of a wrapped buffer, as the owner thread may be overwriting them
+
+struct thread_buffer {
+    std::array<marker, EU07_PROFILER_BUFFERSIZE> markers;
+    std::atomic<std::uint64_t> count { 0 }; // total number of markers written to the buffer
+    std::size_t thread { 0 }; // sequential id, in order of the first recorded marker
+};
+
+std::mutex bufferslock;
+// NOTE: buffers are shared with the owner threads, so markers of threads which already finished remain available for export
+std::vector<std::shared_ptr<thread_buffer>> buffers;
+
+thread_buffer &
+local_buffer() {
+
+    thread_local std::shared_ptr<thread_buffer> buffer { [] {
+        auto newbuffer { std::make_shared<thread_buffer>() };
+        std::lock_guard<std::mutex> lock( bufferslock );
+        newbuffer->thread = buffers.size();
+        buffers.emplace_back( newbuffer );
+        return newbuffer; }() };
+
+    return *buffer;
+}
+
+void
+record( char const *Name, bool const Begin ) {
+
+    auto &buffer { local_buffer() };
+    auto const index { buffer.count.load( std::memory_order_relaxed ) };
+    buffer.markers[ index % EU07_PROFILER_BUFFERSIZE ] = {
+        Name,
+        std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count(),
+        Begin };
+    buffer.count.store( index + 1, std::memory_order_release );
+}
+
+} // anonymous
+
+void
+begin( char const *Name ) {
+
+    record( Name, true );
+}
+
+void
+end( char const *Name ) {
+
+    record( Name, false );
+}
+
+// sends markers recorded by all threads to specified file, in chrome trace event format. returns: true on success
+bool
+export_trace( std::string const &Filename ) {
+
+    std::vector<std::pair<std::size_t, std::vector<marker>>> threadmarkers;
+    {
+        std::lock_guard<std::mutex> lock( bufferslock );
+        for( auto const &buffer : buffers ) {
+            auto const count { buffer->count.load( std::memory_order_acquire ) };
+            auto const first { (
+                count > EU07_PROFILER_BUFFERSIZE ?
+                    count - EU07_PROFILER_BUFFERSIZE + EU07_PROFILER_EXPORTMARGIN :
+                    0 ) };
+            std::vector<marker> markers;
+            markers.reserve( count - first );
+            for( auto index { first }; index < count; ++index ) {
+                markers.emplace_back( buffer->markers[ index % EU07_PROFILER_BUFFERSIZE ] );
+            }
+            threadmarkers.emplace_back( buffer->thread, std::move( markers ) );
+        }
+    }
+
+    std::ofstream output( Filename, std::ios::trunc );
+    if( false == output.is_open() ) {
+        ErrorLog( "Bad file: failed to open trace output \"" + Filename + "\"" );
+        return false;
+    }
+    // timestamps are reported relative to the oldest marker
+    auto timestart { std::numeric_limits<std::int64_t>::max() };
+    for( auto const &markers : threadmarkers ) {
+        if( false == markers.second.empty() ) {
+            timestart = std::min( timestart, markers.second.front().timestamp );
+        }
+    }
+
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    auto first { true };
+    for( auto const &markers : threadmarkers ) {
+        for( auto const &marker : markers.second ) {
+            output
+                << ( first ? "" : ",\n" )
+                << "{\"name\":\"" << marker.name << "\""
+                << ",\"cat\":\"eu07\""
+                << ",\"ph\":\"" << ( marker.begin ? 'B' : 'E' ) << "\""
+                << ",\"ts\":" << std::fixed << std::setprecision( 3 ) << ( marker.timestamp - timestart ) / 1000.0
+                << ",\"pid\":1,\"tid\":" << markers.first << "}";
+            first = false;
+        }
+    }
+    output << "\n]}\n";
+
+    WriteLog( "Profiler trace saved to \"" + Filename + "\"" );
+    return true;
+}
+
+} // profiler
+
+#endif
+
+//---------------------------------------------------------------------------
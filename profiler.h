@@ -0,0 +1,65 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+// uncomment to enable instrumentation of marked code sections. when disabled, the markers compile to nothing
+//#define EU07_USE_PROFILER
+
+#ifdef EU07_USE_PROFILER
+
+namespace profiler {
+
+// start or end of instrumented code section
+struct marker {
+    char const *name; // static string identifying the section
+    std::int64_t timestamp; // nanoseconds, steady clock
+    bool begin;
+};
+
+// record start and end of instrumented section in the ring buffer of the calling thread
+void
+    begin( char const *Name );
+void
+    end( char const *Name );
+// sends markers recorded by all threads to specified file, in chrome trace event format. returns: true on success
+bool
+    export_trace( std::string const &Filename );
+
+// marks execution of the enclosing scope
+class scope {
+
+public:
+// constructors
+    scope( char const *Name ) :
+        m_name( Name ) {
+            begin( m_name ); }
+// destructor
+    ~scope() {
+        end( m_name ); }
+
+private:
+// members
+    char const *m_name;
+};
+
+} // profiler
+
+#define EU07_PROFILE_CONCAT_( First, Second ) First##Second
+#define EU07_PROFILE_CONCAT( First, Second ) EU07_PROFILE_CONCAT_( First, Second )
+// marks the rest of enclosing scope as instrumented section with specified name. the name has to be a string literal
+#define EU07_PROFILE_SCOPE( Name ) profiler::scope EU07_PROFILE_CONCAT( profilerscope, __LINE__ ) { Name }
+
+#else
+
+#define EU07_PROFILE_SCOPE( Name )
+
+#endif
+
+//---------------------------------------------------------------------------
@@ -16,16 +16,33 @@ http://mozilla.org/MPL/2.0/.
 #include "AnimModel.h"
 #include "Event.h"
 #include "EvLaunch.h"
+#include "MemCell.h"
+#include "TractionPower.h"
+#include "scenenodegroups.h"
+#include "particles.h"
 #include "Timer.h"
 #include "Logs.h"
 #include "sn_utils.h"
 #include "renderer.h"
 
+//#define EU07_RECORD_PANTOGRAPHS // writes traction layout and pantograph wire lookups to pantographs.txt, for replay in tests/tractiontree_benchmark
+
 namespace scene {
 
 std::string const EU07_FILEEXTENSION_REGION { ".sbt" };
 std::uint32_t const EU07_FILEHEADER { MAKE_ID4( 'E','U','0','7' ) };
-std::uint32_t const EU07_FILEVERSION_REGION { MAKE_ID4( 'S', 'B', 'T', 1 ) };
+std::uint32_t const EU07_FILEVERSION_REGION { MAKE_ID4( 'S', 'B', 'T', 3 ) };
+
+#ifdef EU07_RECORD_PANTOGRAPHS
+// provides access to the recording of pantograph wire lookups. each line starts with record type and center of the section it belongs to
+std::ofstream &
+pantograph_recording() {
+
+    static std::ofstream output { "pantographs.txt" };
+    output.precision( 10 );
+    return output;
+}
+#endif
 
 // potentially activates event handler with the same name as provided node, and within handler activation range
 void
@@ -40,93 +57,15 @@ basic_cell::on_click( TAnimModel const *Instance ) {
     }
 }
 
-// legacy method, finds and assigns traction piece to specified pantograph of provided vehicle
-void
-basic_cell::update_traction( TDynamicObject *Vehicle, int const Pantographindex ) {
-    // Winger 170204 - szukanie trakcji nad pantografami
-    auto const vFront = glm::make_vec3( Vehicle->VectorFront().getArray() ); // wektor normalny dla płaszczyzny ruchu pantografu
-    auto const vUp = glm::make_vec3( Vehicle->VectorUp().getArray() ); // wektor pionu pudła (pochylony od pionu na przechyłce)
-    auto const vLeft = glm::make_vec3( Vehicle->VectorLeft().getArray() ); // wektor odległości w bok (odchylony od poziomu na przechyłce)
-    auto const position = glm::dvec3 { Vehicle->GetPosition() }; // współrzędne środka pojazdu
-
-    auto pantograph = Vehicle->pants[ Pantographindex ].fParamPants;
-    auto const pantographposition = position + ( vLeft * pantograph->vPos.z ) + ( vUp * pantograph->vPos.y ) + ( vFront * pantograph->vPos.x );
-    
-    for( auto *traction : m_directories.traction ) {
-
-        // współczynniki równania parametrycznego
-        auto const paramfrontdot = glm::dot( traction->vParametric, vFront );
-        auto const fRaParam =
-            -( glm::dot( traction->pPoint1, vFront ) - glm::dot( pantographposition, vFront ) )
-            / ( paramfrontdot != 0.0 ?
-                    paramfrontdot :
-                    0.001 ); // div0 trap
-
-        if( ( fRaParam < -0.001 )
-         || ( fRaParam >  1.001 ) ) { continue; }
-        // jeśli tylko jest w przedziale, wyznaczyć odległość wzdłuż wektorów vUp i vLeft
-        // punkt styku płaszczyzny z drutem (dla generatora łuku el.)
-        auto const vStyk = traction->pPoint1 + fRaParam * traction->vParametric;
-        // wektor musi się mieścić w przedziale ruchu pantografu
-        auto const vGdzie = vStyk - pantographposition;
-        auto fVertical = glm::dot( vGdzie, vUp );
-        if( fVertical >= 0.0 ) {
-            // jeśli ponad pantografem (bo może łapać druty spod wiaduktu)
-            auto const fHorizontal = std::abs( glm::dot( vGdzie, vLeft ) ) - pantograph->fWidth;
-
-            if( ( Global.bEnableTraction )
-             && ( fVertical < pantograph->PantWys - 0.15 ) ) {
-                // jeśli drut jest niżej niż 15cm pod ślizgiem przełączamy w tryb połamania, o ile jedzie;
-                // (bEnableTraction) aby dało się jeździć na koślawych sceneriach
-                // i do tego jeszcze wejdzie pod ślizg
-                if( fHorizontal <= 0.0 ) {
-                    // 0.635 dla AKP-1 AKP-4E
-                    SetFlag( Vehicle->MoverParameters->DamageFlag, dtrain_pantograph );
-                    pantograph->PantWys = -1.0; // ujemna liczba oznacza połamanie
-                    pantograph->hvPowerWire = nullptr; // bo inaczej się zasila w nieskończoność z połamanego
-                    if( Vehicle->MoverParameters->EnginePowerSource.CollectorParameters.CollectorsNo > 0 ) {
-                        // liczba pantografów teraz będzie mniejsza
-                        --Vehicle->MoverParameters->EnginePowerSource.CollectorParameters.CollectorsNo;
-                    }
-                    if( DebugModeFlag ) {
-                        ErrorLog( "Bad traction: " + Vehicle->name() + " broke pantograph at " + to_string( pantographposition ) );
-                    }
-                }
-            }
-            else if( fVertical < pantograph->PantTraction ) {
-                // ale niżej, niż poprzednio znaleziony
-                if( fHorizontal <= 0.0 ) {
-                    // 0.635 dla AKP-1 AKP-4E
-                    // to się musi mieścić w przedziale zaleznym od szerokości pantografu
-                    pantograph->hvPowerWire = traction; // jakiś znaleziony
-                    pantograph->PantTraction = fVertical; // zapamiętanie nowej wysokości
-                }
-                else if( fHorizontal < pantograph->fWidthExtra ) {
-                    // czy zmieścił się w zakresie nabieżnika? problem jest, gdy nowy drut jest wyżej,
-                    // wtedy pantograf odłącza się od starego, a na podniesienie do nowego potrzebuje czasu
-                    // korekta wysokości o nabieżnik - drut nad nabieżnikiem jest geometrycznie jakby nieco wyżej
-                    fVertical += 0.15 * fHorizontal / pantograph->fWidthExtra;
-                    if( fVertical < pantograph->PantTraction ) {
-                        // gdy po korekcie jest niżej, niż poprzednio znaleziony
-                        // gdyby to wystarczyło, to możemy go uznać
-                        pantograph->hvPowerWire = traction; // może być
-                        pantograph->PantTraction = fVertical; // na razie liniowo na nabieżniku, dokładność poprawi się później
-                    }
-                }
-            }
-        }
-    }
-}
-
 // legacy method, updates sounds and polls event launchers within radius around specified point
 void
-basic_cell::update_events() {
+basic_cell::update_events( glm::dvec3 const &Location ) {
 
     // event launchers
     for( auto *launcher : m_eventlaunchers ) {
         if( launcher->check_conditions()
             && ( launcher->dRadius < 0.0
-                || SquareMagnitude( launcher->location() - Global.pCamera.Pos ) < launcher->dRadius ) ) {
+                || glm::length2( launcher->location() - Location ) < launcher->dRadius ) ) {
             if( launcher->check_activation() )
                 launch_event( launcher, true );
             if( launcher->check_activation_key() )
@@ -647,7 +586,7 @@ basic_section::on_click( TAnimModel const *Instance ) {
 // legacy method, finds and assigns traction piece(s) to pantographs of provided vehicle
 void
 basic_section::update_traction( TDynamicObject *Vehicle, int const Pantographindex ) {
-
+    // Winger 170204 - szukanie trakcji nad pantografami
     auto const vFront = glm::make_vec3( Vehicle->VectorFront().getArray() ); // wektor normalny dla płaszczyzny ruchu pantografu
     auto const vUp = glm::make_vec3( Vehicle->VectorUp().getArray() ); // wektor pionu pudła (pochylony od pionu na przechyłce)
     auto const vLeft = glm::make_vec3( Vehicle->VectorLeft().getArray() ); // wektor odległości w bok (odchylony od poziomu na przechyłce)
@@ -655,13 +594,78 @@ basic_section::update_traction( TDynamicObject *Vehicle, int const Pantographind
 
     auto pantograph = Vehicle->pants[ Pantographindex ].fParamPants;
     auto const pantographposition = position + ( vLeft * pantograph->vPos.z ) + ( vUp * pantograph->vPos.y ) + ( vFront * pantograph->vPos.x );
+    // wires the pantograph can possibly reach are within radius of its full extension and width of the head
+    auto const radius { glm::length( glm::dvec2 {
+        std::max( pantograph->fLenL1 + pantograph->fLenU1 + pantograph->fHeight, 3.0 ) + 1.0,
+        pantograph->fWidth + pantograph->fWidthExtra + 1.0 } ) };
+#ifdef EU07_RECORD_PANTOGRAPHS
+    pantograph_recording()
+        << "lookup " << m_area.center.x << ' ' << m_area.center.z << ' '
+        << pantographposition.x << ' ' << pantographposition.y << ' ' << pantographposition.z << ' ' << radius << '\n';
+#endif
+
+    for( auto *traction : m_traction.find( pantographposition, radius ) ) {
 
-    auto const radius { EU07_CELLSIZE * 0.5 }; // redius around point of interest
+        // współczynniki równania parametrycznego
+        auto const paramfrontdot = glm::dot( traction->vParametric, vFront );
+        auto const fRaParam =
+            -( glm::dot( traction->pPoint1, vFront ) - glm::dot( pantographposition, vFront ) )
+            / ( paramfrontdot != 0.0 ?
+                    paramfrontdot :
+                    0.001 ); // div0 trap
 
-    for( auto &cell : m_cells ) {
-        // we reject early cells which aren't within our area of interest
-        if( glm::length2( cell.area().center - pantographposition ) < ( ( cell.area().radius + radius ) * ( cell.area().radius + radius ) ) ) {
-            cell.update_traction( Vehicle, Pantographindex );
+        if( ( fRaParam < -0.001 )
+         || ( fRaParam >  1.001 ) ) { continue; }
+        // jeśli tylko jest w przedziale, wyznaczyć odległość wzdłuż wektorów vUp i vLeft
+        // punkt styku płaszczyzny z drutem (dla generatora łuku el.)
+        auto const vStyk = traction->pPoint1 + fRaParam * traction->vParametric;
+        // wektor musi się mieścić w przedziale ruchu pantografu
+        auto const vGdzie = vStyk - pantographposition;
+        auto fVertical = glm::dot( vGdzie, vUp );
+        if( fVertical >= 0.0 ) {
+            // jeśli ponad pantografem (bo może łapać druty spod wiaduktu)
+            auto const fHorizontal = std::abs( glm::dot( vGdzie, vLeft ) ) - pantograph->fWidth;
+
+            if( ( Global.bEnableTraction )
+             && ( fVertical < pantograph->PantWys - 0.15 ) ) {
+                // jeśli drut jest niżej niż 15cm pod ślizgiem przełączamy w tryb połamania, o ile jedzie;
+                // (bEnableTraction) aby dało się jeździć na koślawych sceneriach
+                // i do tego jeszcze wejdzie pod ślizg
+                if( fHorizontal <= 0.0 ) {
+                    // 0.635 dla AKP-1 AKP-4E
+                    SetFlag( Vehicle->MoverParameters->DamageFlag, dtrain_pantograph );
+                    pantograph->PantWys = -1.0; // ujemna liczba oznacza połamanie
+                    pantograph->hvPowerWire = nullptr; // bo inaczej się zasila w nieskończoność z połamanego
+                    if( Vehicle->MoverParameters->EnginePowerSource.CollectorParameters.CollectorsNo > 0 ) {
+                        // liczba pantografów teraz będzie mniejsza
+                        --Vehicle->MoverParameters->EnginePowerSource.CollectorParameters.CollectorsNo;
+                    }
+                    if( DebugModeFlag ) {
+                        ErrorLog( "Bad traction: " + Vehicle->name() + " broke pantograph at " + to_string( pantographposition ) );
+                    }
+                }
+            }
+            else if( fVertical < pantograph->PantTraction ) {
+                // ale niżej, niż poprzednio znaleziony
+                if( fHorizontal <= 0.0 ) {
+                    // 0.635 dla AKP-1 AKP-4E
+                    // to się musi mieścić w przedziale zaleznym od szerokości pantografu
+                    pantograph->hvPowerWire = traction; // jakiś znaleziony
+                    pantograph->PantTraction = fVertical; // zapamiętanie nowej wysokości
+                }
+                else if( fHorizontal < pantograph->fWidthExtra ) {
+                    // czy zmieścił się w zakresie nabieżnika? problem jest, gdy nowy drut jest wyżej,
+                    // wtedy pantograf odłącza się od starego, a na podniesienie do nowego potrzebuje czasu
+                    // korekta wysokości o nabieżnik - drut nad nabieżnikiem jest geometrycznie jakby nieco wyżej
+                    fVertical += 0.15 * fHorizontal / pantograph->fWidthExtra;
+                    if( fVertical < pantograph->PantTraction ) {
+                        // gdy po korekcie jest niżej, niż poprzednio znaleziony
+                        // gdyby to wystarczyło, to możemy go uznać
+                        pantograph->hvPowerWire = traction; // może być
+                        pantograph->PantTraction = fVertical; // na razie liniowo na nabieżniku, dokładność poprawi się później
+                    }
+                }
+            }
         }
     }
 }
@@ -674,7 +678,7 @@ basic_section::update_events( glm::dvec3 const &Location, float const Radius ) {
 
         if( glm::length2( cell.area().center - Location ) < ( ( cell.area().radius + Radius ) * ( cell.area().radius + Radius ) ) ) {
             // we reject cells which aren't within our area of interest
-            cell.update_events();
+            cell.update_events( Location );
         }
     }
 }
@@ -928,6 +932,23 @@ basic_section::cell( glm::dvec3 const &Location ) {
             + clamp( column, 0, ( EU07_SECTIONSIZE / EU07_CELLSIZE ) - 1 ) ] ;
 }
 
+// adds provided traction piece to the wire lookup helper
+void
+basic_section::register_traction( TTraction *Traction ) {
+
+    auto const margin { 0.001 * glm::length( Traction->vParametric ) + 0.01 }; // matches tolerance of the pantograph test
+    m_traction.insert(
+        Traction,
+        glm::min( Traction->pPoint1, Traction->pPoint2 ) - margin,
+        glm::max( Traction->pPoint1, Traction->pPoint2 ) + margin );
+#ifdef EU07_RECORD_PANTOGRAPHS
+    pantograph_recording()
+        << "wire " << m_area.center.x << ' ' << m_area.center.z << ' '
+        << Traction->pPoint1.x << ' ' << Traction->pPoint1.y << ' ' << Traction->pPoint1.z << ' '
+        << Traction->pPoint2.x << ' ' << Traction->pPoint2.y << ' ' << Traction->pPoint2.z << '\n';
+#endif
+}
+
 
 
 basic_region::basic_region() {
@@ -953,17 +974,22 @@ basic_region::on_click( TAnimModel const *Instance ) {
     }
 }
 
-// legacy method, polls event launchers around camera
+// legacy method, polls event launchers around camera, or around location set by set_events_origin()
 void
 basic_region::update_events() {
 
     if( false == simulation::is_ready ) { return; }
 
+    m_eventsorigin = (
+        m_eventsoriginoverride ?
+            *m_eventsoriginoverride :
+            glm::dvec3 { Global.pCamera.Pos } );
+    m_eventsoriginoverride.reset();
     // render events and sounds from sectors near enough to the viewer
     auto const range = EU07_SECTIONSIZE; // arbitrary range
-    auto const &sectionlist = sections( Global.pCamera.Pos, range );
+    auto const &sectionlist = sections( m_eventsorigin, range );
     for( auto *section : sectionlist ) {
-        section->update_events( Global.pCamera.Pos, range );
+        section->update_events( m_eventsorigin, range );
     }
 }
 
@@ -1001,52 +1027,41 @@ basic_region::update_traction( TDynamicObject *Vehicle, int const Pantographinde
 bool
 basic_region::is_scene( std::string const &Scenariofile ) const {
 
-    auto filename { Scenariofile };
-    while( filename[ 0 ] == '$' ) {
-        // trim leading $ char rainsted utility may add to the base name for modified .scn files
-        filename.erase( 0, 1 );
-    }
-    erase_extension( filename );
-    filename = Global.asCurrentSceneryPath + filename;
-    filename += EU07_FILEEXTENSION_REGION;
+    auto const filename { region_file( Scenariofile ) };
 
     if( false == FileExists( filename ) ) {
         return false;
     }
-    // file type and version check
+    // file type, version and source data check
     std::ifstream input( filename, std::ios::binary );
 
-    uint32_t headermain{ sn_utils::ld_uint32( input ) };
-    uint32_t headertype{ sn_utils::ld_uint32( input ) };
-
-    if( ( headermain != EU07_FILEHEADER
-     || ( headertype != EU07_FILEVERSION_REGION ) ) ) {
-        // wrong file type
-        return false;
-    }
-
-    return true;
+    return deserialize_header( input, filename );
 }
 
-// stores content of the class in file with specified name
+// stores content of the class in file with specified name, along with stamps of provided source files
 void
-basic_region::serialize( std::string const &Scenariofile ) const {
+basic_region::serialize( std::string const &Scenariofile, std::vector<std::string> const &Sourcefiles ) const {
 
-    auto filename { Scenariofile };
-    while( filename[ 0 ] == '$' ) {
-        // trim leading $ char rainsted utility may add to the base name for modified .scn files
-        filename.erase( 0, 1 );
-    }
-    erase_extension( filename );
-    filename = Global.asCurrentSceneryPath + filename;
-    filename += EU07_FILEEXTENSION_REGION;
+    auto const filename { region_file( Scenariofile ) };
 
     std::ofstream output { filename, std::ios::binary };
 
-    // region file version 1
+    // region file version 3
     // header: EU07SBT + version (0-255)
     sn_utils::ls_uint32( output, EU07_FILEHEADER );
     sn_utils::ls_uint32( output, EU07_FILEVERSION_REGION );
+    // settings which affect file content
+    sn_utils::ls_uint32( output, region_settings() );
+    // source files: count, followed by name, size and modification time of each file
+    sn_utils::ls_uint32( output, static_cast<std::uint32_t>( Sourcefiles.size() ) );
+    for( auto const &sourcefile : Sourcefiles ) {
+        std::error_code error;
+        auto const filesize { std::filesystem::file_size( sourcefile, error ) };
+        auto const filetime { std::filesystem::last_write_time( sourcefile, error ) };
+        sn_utils::s_str( output, sourcefile );
+        sn_utils::ls_uint64( output, ( error ? 0 : filesize ) );
+        sn_utils::ls_int64( output, ( error ? 0 : filetime.time_since_epoch().count() ) );
+    }
     // sections
     // TBD, TODO: build table of sections and file offsets, if we postpone section loading until they're within range
     std::uint32_t sectioncount { 0 };
@@ -1065,35 +1080,25 @@ basic_region::serialize( std::string const &Scenariofile ) const {
             section->serialize( output ); }
         ++sectionindex;
     }
+    // non-geometry nodes
+    serialize_nodes( output );
 }
 
 // restores content of the class from file with specified name. returns: true on success, false otherwise
 bool
 basic_region::deserialize( std::string const &Scenariofile ) {
 
-    auto filename { Scenariofile };
-    while( filename[ 0 ] == '$' ) {
-        // trim leading $ char rainsted utility may add to the base name for modified .scn files
-        filename.erase( 0, 1 );
-    }
-    erase_extension( filename );
-    filename = Global.asCurrentSceneryPath + filename;
-    filename += EU07_FILEEXTENSION_REGION;
+    auto const filename { region_file( Scenariofile ) };
 
     if( false == FileExists( filename ) ) {
         return false;
     }
-    // region file version 1
+    // region file version 3
     // file type and version check
     std::ifstream input( filename, std::ios::binary );
 
-    uint32_t headermain { sn_utils::ld_uint32( input ) };
-    uint32_t headertype { sn_utils::ld_uint32( input ) };
-
-    if( ( headermain != EU07_FILEHEADER
-     || ( headertype != EU07_FILEVERSION_REGION ) ) ) {
-        // wrong file type
-        WriteLog( "Bad file: \"" + filename + "\" is of either unrecognized type or version" );
+    if( false == deserialize_header( input, filename ) ) {
+        WriteLog( "Bad file: \"" + filename + "\" is of either unrecognized type or version, or is out of date" );
         return false;
     }
     // sections
@@ -1109,10 +1114,216 @@ basic_region::deserialize( std::string const &Scenariofile ) {
         }
         m_sections[ sectionindex ]->deserialize( input );
     }
+    // non-geometry nodes
+    deserialize_nodes( input );
 
     return true;
 }
 
+// returns name of the region data file for specified scenario
+std::string
+basic_region::region_file( std::string const &Scenariofile ) {
+
+    auto filename { Scenariofile };
+    while( filename[ 0 ] == '$' ) {
+        // trim leading $ char rainsted utility may add to the base name for modified .scn files
+        filename.erase( 0, 1 );
+    }
+    erase_extension( filename );
+    filename = Global.asCurrentSceneryPath + filename;
+    filename += EU07_FILEEXTENSION_REGION;
+
+    return filename;
+}
+
+// returns bit mask of the settings which affect content of the region data file
+std::uint32_t
+basic_region::region_settings() {
+
+    return (
+        ( Global.bLoadTraction ? 0x1 : 0 )
+      | ( Global.CreateSwitchTrackbeds ? 0x2 : 0 ) );
+}
+
+// reads and validates header of the region data file. returns: true if the file is of correct type and up to date
+bool
+basic_region::deserialize_header( std::istream &Input, std::string const &Filename ) {
+
+    uint32_t headermain { sn_utils::ld_uint32( Input ) };
+    uint32_t headertype { sn_utils::ld_uint32( Input ) };
+
+    if( ( headermain != EU07_FILEHEADER
+     || ( headertype != EU07_FILEVERSION_REGION ) ) ) {
+        // wrong file type
+        return false;
+    }
+    if( sn_utils::ld_uint32( Input ) != region_settings() ) {
+        WriteLog( "Binary scene file \"" + Filename + "\" was created with different settings and will be rebuilt" );
+        return false;
+    }
+    // source files check. the file is only valid if all its sources are unchanged
+    auto sourcecount { sn_utils::ld_uint32( Input ) };
+    auto isuptodate { true };
+    while( sourcecount-- ) {
+        auto const sourcefile { sn_utils::d_str( Input ) };
+        auto const sourcesize { sn_utils::ld_uint64( Input ) };
+        auto const sourcetime { sn_utils::ld_int64( Input ) };
+        if( false == isuptodate ) {
+            // we still need to go through the list, to leave the stream at the start of actual data
+            continue;
+        }
+        std::error_code error;
+        auto const filesize { std::filesystem::file_size( sourcefile, error ) };
+        auto const filetime { std::filesystem::last_write_time( sourcefile, error ) };
+        if( ( error )
+         || ( filesize != sourcesize )
+         || ( filetime.time_since_epoch().count() != sourcetime ) ) {
+            WriteLog( "Binary scene file \"" + Filename + "\" is out of date, source file \"" + sourcefile + "\" has changed" );
+            isuptodate = false;
+        }
+    }
+
+    return ( ( true == isuptodate ) && ( Input.good() ) );
+}
+
+// sends content of the non-geometry nodes to provided stream
+// NOTE: tracks, events, sounds and trainsets aren't stored yet; their text loaders resolve links and build geometry
+// as they go, and they're still imported from the scenario text files
+void
+basic_region::serialize_nodes( std::ostream &Output ) const {
+
+    // memory cells. autogenerated cells are skipped, they're created anew when the scenario is loaded
+    std::vector<TMemCell const *> memorycells;
+    for( auto const *memorycell : simulation::Memory.sequence() ) {
+        if( ( memorycell != nullptr )
+         && ( true == memorycell->is_exportable ) ) {
+            memorycells.emplace_back( memorycell );
+        }
+    }
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( memorycells.size() ) );
+    for( auto const *memorycell : memorycells ) {
+        serialize_node( Output, *memorycell );
+    }
+    // event launchers
+    auto const eventlaunchers { simulation::Events.launchers() };
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( eventlaunchers.size() ) );
+    for( auto const *eventlauncher : eventlaunchers ) {
+        serialize_node( Output, *eventlauncher );
+    }
+    // 3d model instances
+    std::vector<TAnimModel const *> instances;
+    for( auto const *instance : simulation::Instances.sequence() ) {
+        if( instance != nullptr ) {
+            instances.emplace_back( instance );
+        }
+    }
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( instances.size() ) );
+    for( auto const *instance : instances ) {
+        serialize_node( Output, *instance );
+    }
+    // traction power sources. autogenerated sources are skipped, they're created anew when the traction is initialized
+    std::vector<TTractionPowerSource const *> powersources;
+    for( auto const *powersource : simulation::Powergrid.sequence() ) {
+        if( ( powersource != nullptr )
+         && ( false == powersource->IsAutogenerated ) ) {
+            powersources.emplace_back( powersource );
+        }
+    }
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( powersources.size() ) );
+    for( auto const *powersource : powersources ) {
+        serialize_node( Output, *powersource );
+    }
+    // traction
+    std::vector<TTraction const *> traction;
+    for( auto const *tractionpiece : simulation::Traction.sequence() ) {
+        if( tractionpiece != nullptr ) {
+            traction.emplace_back( tractionpiece );
+        }
+    }
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( traction.size() ) );
+    for( auto const *tractionpiece : traction ) {
+        serialize_node( Output, *tractionpiece );
+    }
+}
+
+// sends content of provided node to provided stream, preceded by the handle of the node group it belongs to
+void
+basic_region::serialize_node( std::ostream &Output, scene::basic_node const &Node ) {
+
+    sn_utils::ls_uint64( Output, Node.group() );
+    Node.serialize( Output );
+}
+
+// restores content of provided node from provided stream, and places it in the node group it belonged to
+void
+basic_region::deserialize_node( std::istream &Input, scene::basic_node &Node ) {
+
+    // NOTE: group handles are assigned in order of group creation, and the scenario files are still parsed
+    // for the content not present in the region file, so the restored nodes end up in the same groups as before
+    auto const group { static_cast<scene::group_handle>( sn_utils::ld_uint64( Input ) ) };
+    Node.deserialize( Input );
+    scene::Groups.insert( group, &Node );
+}
+
+// restores content of the non-geometry nodes from provided stream
+void
+basic_region::deserialize_nodes( std::istream &Input ) {
+
+    // memory cells
+    auto memorycellcount { sn_utils::ld_uint32( Input ) };
+    while( memorycellcount-- ) {
+        auto *memorycell { new TMemCell( scene::node_data() ) };
+        deserialize_node( Input, *memorycell );
+        simulation::Memory.insert( memorycell );
+        insert( memorycell );
+    }
+    // event launchers
+    auto eventlaunchercount { sn_utils::ld_uint32( Input ) };
+    while( eventlaunchercount-- ) {
+        auto *eventlauncher { new TEventLauncher( scene::node_data() ) };
+        deserialize_node( Input, *eventlauncher );
+        simulation::Events.insert( eventlauncher );
+        // event launchers can be either global, or local with limited range of activation
+        if( true == eventlauncher->IsGlobal() ) {
+            simulation::Events.queue( eventlauncher );
+        }
+        else if( false == eventlauncher->IsRadioActivated() ) {
+            insert( eventlauncher );
+        }
+    }
+    // 3d model instances
+    auto instancecount { sn_utils::ld_uint32( Input ) };
+    while( instancecount-- ) {
+        auto *instance { new TAnimModel( scene::node_data() ) };
+        deserialize_node( Input, *instance );
+        if( instance->Model() != nullptr ) {
+            for( auto const &smokesource : instance->Model()->smoke_sources() ) {
+                simulation::Particles.insert(
+                    smokesource.first,
+                    instance,
+                    smokesource.second );
+            }
+        }
+        simulation::Instances.insert( instance );
+        insert( instance );
+    }
+    // traction power sources
+    auto powersourcecount { sn_utils::ld_uint32( Input ) };
+    while( powersourcecount-- ) {
+        auto *powersource { new TTractionPowerSource( scene::node_data() ) };
+        deserialize_node( Input, *powersource );
+        simulation::Powergrid.insert( powersource );
+    }
+    // traction
+    auto tractioncount { sn_utils::ld_uint32( Input ) };
+    while( tractioncount-- ) {
+        auto *traction { new TTraction( scene::node_data() ) };
+        deserialize_node( Input, *traction );
+        simulation::Traction.insert( traction );
+        insert_and_register( traction );
+    }
+}
+
 // sends content of the class in legacy (text) format to provided stream
 void
 basic_region::export_as_text( std::ostream &Output ) const {
@@ -21,6 +21,7 @@ http://mozilla.org/MPL/2.0/.
 #include "Track.h"
 #include "Traction.h"
 #include "sound.h"
+#include "boundingtree.h"
 
 class opengl_renderer;
 class opengl33_renderer;
@@ -35,7 +36,7 @@ struct scratch_data {
 
     struct binary_data {
 
-        bool terrain{ false };
+        bool terrain{ false }; // binary scene file is present; holds terrain geometry, memory cells, event launchers and model instances
     } binary;
 
     struct location_data {
@@ -76,12 +77,9 @@ public:
     // potentially activates event handler with the same name as provided node, and within handler activation range
     void
         on_click( TAnimModel const *Instance );
-    // legacy method, finds and assigns traction piece to specified pantograph of provided vehicle
-    void
-        update_traction( TDynamicObject *Vehicle, int const Pantographindex );
     // legacy method, polls event launchers within radius around specified point
     void
-        update_events();
+        update_events( glm::dvec3 const &Location );
     // legacy method, updates sounds within radius around specified point
     void
         update_sounds();
@@ -201,6 +199,9 @@ private:
     TTrack *tTrackAnim = nullptr; // obiekty do przeliczenia animacji
 };
 
+// lookup helper for wires near pantographs
+using traction_tree = bounding_tree<TTraction>;
+
 // basic scene partitioning structure, holds terrain geometry and collection of cells
 class basic_section {
 
@@ -262,7 +263,9 @@ public:
     template <class Type_>
     void
         register_node( Type_ *Node, glm::dvec3 const &Point ) {
-            cell( Point ).register_end( Node ); }
+            cell( Point ).register_end( Node );
+            if constexpr( std::is_same<Type_, TTraction>::value ) {
+                register_traction( Node ); } }
     // find a vehicle located nearest to specified point, within specified radius. reurns: located vehicle and distance
     std::tuple<TDynamicObject *, float>
         find( glm::dvec3 const &Point, float const Radius, bool const Onlycontrolled, bool const Findbycoupler );
@@ -294,11 +297,15 @@ private:
     // provides access to section enclosing specified point
     basic_cell &
         cell( glm::dvec3 const &Location );
+    // adds provided traction piece to the wire lookup helper
+    void
+        register_traction( TTraction *Traction );
 // members
     // placement and visibility
     scene::bounding_area m_area { glm::dvec3(), static_cast<float>( 0.5 * M_SQRT2 * EU07_SECTIONSIZE ) };
     // content
     cell_array m_cells; // partitioning scheme
+    traction_tree m_traction; // lookup helper for traction pieces registered in the cells
     shapenode_sequence m_shapes; // large pieces of opaque geometry and (legacy) terrain
     // TODO: implement dedicated, higher fidelity, fixed resolution terrain mesh item
     // gfx renderer data
@@ -324,18 +331,27 @@ public:
     // legacy method, finds and assigns traction piece to specified pantograph of provided vehicle
     void
         update_traction( TDynamicObject *Vehicle, int const Pantographindex );
-    // legacy method, polls event launchers around camera
+    // legacy method, polls event launchers around camera, or around location set by set_events_origin()
     void
         update_events();
+    // makes the next poll of event launchers take place around specified location instead of the camera
+    // NOTE: used to repeat the polls of recorded session, launchers with limited range depend on the camera of the recording side
+    void
+        set_events_origin( glm::dvec3 const &Location ) {
+            m_eventsoriginoverride = Location; }
+    // returns location around which event launchers were polled during the last update
+    glm::dvec3 const &
+        events_origin() const {
+            return m_eventsorigin; }
     // legacy method, updates sounds around camera
     void
         update_sounds();
     // checks whether specified file is a valid region data file
     bool
         is_scene( std::string const &Scenariofile ) const;
-    // stores content of the class in file with specified name
+    // stores content of the class in file with specified name, along with stamps of provided source files
     void
-        serialize( std::string const &Scenariofile ) const;
+        serialize( std::string const &Scenariofile, std::vector<std::string> const &Sourcefiles ) const;
     // restores content of the class from file with specified name. returns: true on success, false otherwise
     bool
         deserialize( std::string const &Scenariofile );
@@ -405,6 +421,32 @@ private:
     };
 
 // methods
+    // returns name of the region data file for specified scenario
+    static
+    std::string
+        region_file( std::string const &Scenariofile );
+    // returns bit mask of the settings which affect content of the region data file
+    static
+    std::uint32_t
+        region_settings();
+    // reads and validates header of the region data file. returns: true if the file is of correct type and up to date
+    static
+    bool
+        deserialize_header( std::istream &Input, std::string const &Filename );
+    // sends content of the non-geometry nodes to provided stream
+    void
+        serialize_nodes( std::ostream &Output ) const;
+    // restores content of the non-geometry nodes from provided stream
+    void
+        deserialize_nodes( std::istream &Input );
+    // sends content of provided node to provided stream, preceded by the handle of the node group it belongs to
+    static
+    void
+        serialize_node( std::ostream &Output, scene::basic_node const &Node );
+    // restores content of provided node from provided stream, and places it in the node group it belonged to
+    static
+    void
+        deserialize_node( std::istream &Input, scene::basic_node &Node );
     // checks whether specified point is within boundaries of the region
     bool
         point_inside( glm::dvec3 const &Location );
@@ -419,6 +461,8 @@ private:
 // members
     section_array m_sections;
     region_scratchpad m_scratchpad;
+    glm::dvec3 m_eventsorigin; // location of the last event launcher poll
+    std::optional<glm::dvec3> m_eventsoriginoverride; // location of the next event launcher poll, if not around the camera
 
 };
 
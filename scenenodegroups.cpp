@@ -163,9 +163,11 @@ node_groups::erase( group_map::const_iterator Group ) {
 group_handle
 node_groups::create_handle() {
     // NOTE: for simplification nested group structure are flattened
+    // NOTE: handles aren't reused, so the same scenario files always produce the same handles, in order of group creation.
+    // this allows the binary region file to restore group membership of the nodes it holds
     return(
         m_activegroup.empty() ?
-            m_groupmap.size() + 1 : // new group isn't created until node registration
+            ++m_handlecount : // new group isn't created until node registration
             m_activegroup.top() );
 }
 
@@ -63,6 +63,7 @@ private:
 // members
     group_map m_groupmap; // map of established node groups
     std::stack<scene::group_handle> m_activegroup; // helper, group to be assigned to newly created nodes
+    scene::group_handle m_handlecount { null_handle }; // last assigned group handle
 };
 
 extern node_groups Groups;
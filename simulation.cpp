@@ -21,12 +21,14 @@ http://mozilla.org/MPL/2.0/.
 #include "sound.h"
 #include "AnimModel.h"
 #include "DynObj.h"
+#include "Driver.h"
 #include "lightarray.h"
 #include "particles.h"
 #include "scene.h"
 #include "Train.h"
 #include "application.h"
 #include "Logs.h"
+#include "Timer.h"
 
 namespace simulation {
 
@@ -38,6 +40,7 @@ traction_table Traction;
 powergridsource_table Powergrid;
 instance_table Instances;
 vehicle_table Vehicles;
+ai_scheduler AIScheduler;
 train_table Trains;
 light_array Lights;
 particle_manager Particles;
@@ -67,15 +70,24 @@ state_manager::export_as_text( std::string const &Scenariofile ) const {
     return m_serializer.export_as_text( Scenariofile );
 }
 
+// sends dynamic state of the simulation to provided stream, in binary format. used to compare state of the simulation between runs
+void
+state_manager::export_state( std::ostream &Output ) const {
+
+    m_serializer.export_state( Output );
+}
+
 void
 state_manager::init_scripting_interface() {
 
     // create scenario data memory cells
+    // NOTE: these are created anew for each session, so they're excluded from exports and binary scene files
     {
         auto *memorycell = new TMemCell( {
             0, -1,
             "__simulation.weather",
             "memcell" } );
+        memorycell->is_exportable = false;
         simulation::Memory.insert( memorycell );
         simulation::Region->insert( memorycell );
     }
@@ -84,6 +96,7 @@ state_manager::init_scripting_interface() {
             0, -1,
             "__simulation.time",
             "memcell" } );
+        memorycell->is_exportable = false;
         simulation::Memory.insert( memorycell );
         simulation::Region->insert( memorycell );
     }
@@ -92,9 +105,14 @@ state_manager::init_scripting_interface() {
             0, -1,
             "__simulation.date",
             "memcell" } );
+        memorycell->is_exportable = false;
         simulation::Memory.insert( memorycell );
         simulation::Region->insert( memorycell );
     }
+    // the cells are accessed on each update, resolve them once
+    m_scriptinginterface.weathercell = simulation::Memory.find_handle( "__simulation.weather" );
+    m_scriptinginterface.timecell = simulation::Memory.find_handle( "__simulation.time" );
+    m_scriptinginterface.datecell = simulation::Memory.find_handle( "__simulation.date" );
 }
 
 // legacy method, calculates changes in simulation state over specified time
@@ -111,6 +129,67 @@ state_manager::update( double const Deltatime, int Iterationcount ) {
     simulation::Vehicles.update( Deltatime, Iterationcount );
 }
 
+// advances simulation clock and vehicle dynamics by specified time, split into steps no longer than specified rate
+void
+state_manager::update_dynamics( double const Deltatime, double const Steprate ) {
+
+    if( Deltatime == 0.0 ) { return; }
+
+    simulation::Time.update( Deltatime );
+    {
+        ai_scheduler::settings aisettings;
+        aisettings.relaxedinterval = Global.AIRelaxedInterval;
+        aisettings.framebudget = Global.AIFrameBudget;
+        // reduced update rates and budget are only used when they can't lead to differences between simulation instances
+        aisettings.adaptive = (
+            ( false == Application.is_server() )
+         && ( false == Application.is_client() )
+         && ( true == Global.headless_replay.empty() ) );
+        // NOTE: fixed step runs are expected to be repeatable, so they can't depend on wall clock
+        aisettings.budgeted = ( false == Global.headless );
+        simulation::AIScheduler.begin_frame( aisettings );
+    }
+
+    int updatecount = 1;
+    if( Deltatime > Steprate ) // normalnie 0.01s
+    {
+        // NOTE: physics update cap is experimentally disabled, dt is distributed over as many steps as needed
+        updatecount = std::ceil( Deltatime / Steprate );
+    }
+    auto const stepdeltatime { Deltatime / updatecount };
+
+    Timer::subsystem.sim_dynamics.start();
+    if( true == Global.FullPhysics ) {
+        // mixed calculation mode, steps calculated in ~0.05s chunks
+        while( updatecount >= 5 ) {
+            update( stepdeltatime, 5 );
+            updatecount -= 5;
+        }
+        if( updatecount ) {
+            update( stepdeltatime, updatecount );
+        }
+    }
+    else {
+        // simplified calculation mode; faster but can lead to errors
+        update( stepdeltatime, updatecount );
+    }
+    Timer::subsystem.sim_dynamics.stop();
+}
+
+// updates scenario logic which follows vehicle dynamics; trains, event queue and scenery lights
+void
+state_manager::update_scenario( double const Deltatime ) {
+
+    if( Deltatime == 0.0 ) { return; }
+
+    simulation::Trains.update( Deltatime );
+    Timer::subsystem.sim_events.start();
+    simulation::Events.update();
+    simulation::Region->update_events();
+    Timer::subsystem.sim_events.stop();
+    simulation::Lights.update();
+}
+
 void
 state_manager::update_clocks() {
 
@@ -128,9 +207,9 @@ state_manager::update_clocks() {
 void
 state_manager::update_scripting_interface() {
 
-    auto *weather{ Memory.find( "__simulation.weather" ) };
-    auto *time{ Memory.find( "__simulation.time" ) };
-    auto *date{ Memory.find( "__simulation.date" ) };
+    auto *weather{ Memory.find( m_scriptinginterface.weathercell ) };
+    auto *time{ Memory.find( m_scriptinginterface.timecell ) };
+    auto *date{ Memory.find( m_scriptinginterface.datecell ) };
 
     if( simulation::is_ready ) {
         // potentially adjust weather
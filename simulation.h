@@ -11,6 +11,7 @@ http://mozilla.org/MPL/2.0/.
 
 #include "simulationstateserializer.h"
 #include "Classes.h"
+#include "Names.h"
 
 namespace simulation {
 
@@ -23,6 +24,12 @@ public:
     // legacy method, calculates changes in simulation state over specified time
     void
         update( double Deltatime, int Iterationcount );
+    // advances simulation clock and vehicle dynamics by specified time, split into steps no longer than specified rate
+    void
+        update_dynamics( double Deltatime, double Steprate );
+    // updates scenario logic which follows vehicle dynamics; trains, event queue and scenery lights
+    void
+        update_scenario( double Deltatime );
     void
         update_clocks();
     void
@@ -51,12 +58,16 @@ public:
     // stores class data in specified file, in legacy (text) format
     void
         export_as_text( std::string const &Scenariofile ) const;
+    // sends dynamic state of the simulation to provided stream, in binary format. used to compare state of the simulation between runs
+    void
+        export_state( std::ostream &Output ) const;
 
 private:
 // members
     state_serializer m_serializer;
     struct {
         std::shared_ptr<TMemCell> weather, time, date;
+        basic_table<TMemCell>::handle weathercell, timecell, datecell; // memory cells exposed to the scenario
     } m_scriptinginterface;
 };
 
@@ -71,6 +82,7 @@ extern traction_table Traction;
 extern powergridsource_table Powergrid;
 extern instance_table Instances;
 extern vehicle_table Vehicles;
+extern ai_scheduler AIScheduler;
 extern train_table Trains;
 extern light_array Lights;
 extern particle_manager Particles;
@@ -0,0 +1,468 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "simulationbenchmark.h"
+
+#include "simulation.h"
+#include "Driver.h"
+#include "Globals.h"
+#include "Timer.h"
+#include "Logs.h"
+
+namespace {
+
+std::atomic<bool> allocationcounting { false };
+std::atomic<std::uint64_t> allocationcount { 0 };
+
+// counts the allocation if requested and passes it to the c runtime. returns: allocated memory, or nullptr on failure
+void *
+counted_malloc( std::size_t const Size ) noexcept {
+
+    if( true == allocationcounting.load( std::memory_order_relaxed ) ) {
+        allocationcount.fetch_add( 1, std::memory_order_relaxed );
+    }
+    return std::malloc( Size != 0 ? Size : 1 );
+}
+
+} // anonymous
+
+// global allocation hooks, let headless runs report allocations per frame. outside of these the cost is a check of single flag
+// NOTE: all non-aligned forms are replaced together, so memory from any of them is released by the matching one
+#ifdef DBG_NEW
+// debug builds map new to its debug form, which would mangle the definitions
+#pragma push_macro("new")
+#undef new
+#endif
+void *
+operator new( std::size_t Size ) {
+
+    auto *memory { counted_malloc( Size ) };
+    if( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *
+operator new[]( std::size_t Size ) {
+
+    return operator new( Size );
+}
+
+void *
+operator new( std::size_t Size, std::nothrow_t const & ) noexcept {
+
+    return counted_malloc( Size );
+}
+
+void *
+operator new[]( std::size_t Size, std::nothrow_t const & ) noexcept {
+
+    return counted_malloc( Size );
+}
+
+void
+operator delete( void *Memory ) noexcept {
+
+    std::free( Memory );
+}
+
+void
+operator delete[]( void *Memory ) noexcept {
+
+    std::free( Memory );
+}
+
+void
+operator delete( void *Memory, std::size_t ) noexcept {
+
+    std::free( Memory );
+}
+
+void
+operator delete[]( void *Memory, std::size_t ) noexcept {
+
+    std::free( Memory );
+}
+
+void
+operator delete( void *Memory, std::nothrow_t const & ) noexcept {
+
+    std::free( Memory );
+}
+
+void
+operator delete[]( void *Memory, std::nothrow_t const & ) noexcept {
+
+    std::free( Memory );
+}
+#ifdef DBG_NEW
+#pragma pop_macro("new")
+#endif
+
+namespace simulation {
+
+namespace {
+
+// location and heading on the ground plane, used to lay out generated track
+struct track_point {
+    glm::dvec3 location;
+    double heading; // radians, counterclockwise from x axis
+};
+
+auto const EU07_BENCHMARK_SEGMENTLENGTH { 50.0 }; // length of generated track pieces, in meters
+
+glm::dvec3
+direction( double const Heading ) {
+
+    return { std::cos( Heading ), 0.0, std::sin( Heading ) };
+}
+
+// left hand side of the specified heading
+glm::dvec3
+normal( double const Heading ) {
+
+    return { -std::sin( Heading ), 0.0, std::cos( Heading ) };
+}
+
+void
+export_vector( std::ostream &Output, glm::dvec3 const &Vector ) {
+
+    Output << Vector.x << ' ' << Vector.y << ' ' << Vector.z << ' ';
+}
+
+// sends data of a straight (zero radius) or circular arc path starting at specified point; positive radius turns left
+// returns: end point of the path
+track_point
+export_path( std::ostream &Output, track_point const &Start, double const Length, double const Radius ) {
+
+    track_point end { Start };
+    glm::dvec3 control1, control2; // relative to the path ends, zero for straights
+    if( Radius == 0.0 ) {
+        end.location += direction( Start.heading ) * Length;
+    }
+    else {
+        auto const angle { Length / Radius };
+        auto const side { ( Radius > 0.0 ? 1.0 : -1.0 ) };
+        auto const radius { std::abs( Radius ) };
+        auto const centre { Start.location + normal( Start.heading ) * radius * side };
+        end.heading += angle;
+        end.location = centre - normal( end.heading ) * radius * side;
+        // cubic bezier approximation of the arc
+        auto const handle { 4.0 / 3.0 * std::tan( std::abs( angle ) / 4.0 ) * radius };
+        control1 = direction( Start.heading ) * handle;
+        control2 = -direction( end.heading ) * handle;
+    }
+    export_vector( Output, Start.location );
+    Output << "0 ";
+    export_vector( Output, control1 );
+    export_vector( Output, control2 );
+    export_vector( Output, end.location );
+    Output << "0 " << Radius << ' ';
+
+    return end;
+}
+
+void
+export_track_header( std::ostream &Output, std::string const &Name, std::string const &Type, double const Length ) {
+
+    Output << "node -1 0 " << Name << " track " << Type << ' ' << Length << " 1.435 0.25 20 20 0 flat unvis ";
+}
+
+// sends single path track piece, with optional event bindings. returns: end point of the piece
+track_point
+export_track( std::ostream &Output, std::string const &Name, track_point const &Start, double const Length, double const Radius, std::string const &Extras = "" ) {
+
+    export_track_header( Output, Name, "normal", Length );
+    auto const end { export_path( Output, Start, Length, Radius ) };
+    Output << "velocity 100 " << Extras << "endtrack\n";
+
+    return end;
+}
+
+void
+export_consist( std::ostream &Output, std::string const &Name, std::string const &Track, double const Velocity, int const Vehicles, std::string const &Vehicle, bool const Driven ) {
+
+    Output << "trainset none " << Track << " 0 " << Velocity << "\n";
+    for( auto idx = 0; idx < Vehicles; ++idx ) {
+        Output
+            << "node -1 0 " << Name << '_' << idx << " dynamic " << Vehicle << " -1 "
+            << ( ( Driven && ( idx == 0 ) ) ? "headdriver" : "nobody" )
+            << " 3 0 enddynamic\n";
+    }
+    Output << "endtrainset\n";
+}
+
+// circular track made of equal arcs, starting at the origin heading along x axis. returns: start points of the pieces
+std::vector<track_point>
+export_loop( std::ostream &Output, std::string const &Name, double const Circumference, std::vector<std::string> const &Extras = {} ) {
+
+    auto const piececount { static_cast<std::size_t>( std::ceil( Circumference / EU07_BENCHMARK_SEGMENTLENGTH ) ) };
+    auto const piecelength { Circumference / piececount };
+    auto const radius { Circumference / ( 2.0 * M_PI ) };
+
+    std::vector<track_point> points;
+    track_point point { { 0.0, 0.0, 0.0 }, 0.0 };
+    for( std::size_t idx = 0; idx < piececount; ++idx ) {
+        points.emplace_back( point );
+        point = export_track(
+            Output, Name + '_' + std::to_string( idx ), point, piecelength, radius,
+            ( idx < Extras.size() ? Extras[ idx ] : "" ) );
+    }
+    return points;
+}
+
+// consists evenly spread over a loop long enough to fit them with a margin
+void
+generate_loop( std::ostream &Output, int const Size, std::string const &Vehicle ) {
+
+    auto const consistcount { ( Size > 0 ? Size : 10 ) };
+    auto const points { export_loop( Output, "loop", std::max( 2000.0, consistcount * 300.0 ) ) };
+
+    for( auto idx = 0; idx < consistcount; ++idx ) {
+        export_consist(
+            Output, "consist_" + std::to_string( idx ),
+            "loop_" + std::to_string( idx * points.size() / consistcount ),
+            60.0, 3, Vehicle, true );
+    }
+}
+
+// memory cells acting as signals along a loop, read by passing consists and updated by track events
+void
+generate_signals( std::ostream &Output, int const Size, std::string const &Vehicle ) {
+
+    auto const signalcount { ( Size > 0 ? Size : 200 ) };
+    auto const circumference { std::max( 2000.0, signalcount * 25.0 ) };
+    auto const piececount { static_cast<int>( std::ceil( circumference / EU07_BENCHMARK_SEGMENTLENGTH ) ) };
+
+    std::vector<std::string> extras( piececount );
+    for( auto idx = 0; idx < signalcount; ++idx ) {
+        auto const signal { "signal_" + std::to_string( idx ) };
+        extras[ idx * piececount / signalcount ] +=
+            "event1 " + signal + "_get event2 " + signal + "_get "
+            + "eventall1 " + signal + "_set eventall2 " + signal + "_set ";
+    }
+    auto const points { export_loop( Output, "loop", circumference, extras ) };
+
+    for( auto idx = 0; idx < signalcount; ++idx ) {
+        auto const signal { "signal_" + std::to_string( idx ) };
+        auto const piece { idx * piececount / signalcount };
+        Output << "node -1 0 " << signal << " memcell ";
+        export_vector( Output, points[ piece ].location + normal( points[ piece ].heading ) * 3.0 );
+        Output << "SetVelocity 60 60 loop_" << piece << " endmemcell\n";
+        Output
+            << "event " << signal << "_get getvalues 0 " << signal << " endevent\n"
+            << "event " << signal << "_set updatevalues 0.5 " << signal << " * " << ( idx % 2 == 0 ? 40 : 100 ) << " * endevent\n";
+    }
+
+    auto const consistcount { std::max( 1, signalcount / 100 ) };
+    for( auto idx = 0; idx < consistcount; ++idx ) {
+        export_consist(
+            Output, "consist_" + std::to_string( idx ),
+            "loop_" + std::to_string( idx * piececount / consistcount ),
+            60.0, 3, Vehicle, true );
+    }
+}
+
+// parallel straight lines under traction wires, each line with own power source and a consist
+void
+generate_catenary( std::ostream &Output, int const Size, std::string const &Vehicle ) {
+
+    auto const linecount { ( Size > 0 ? Size : 10 ) };
+    auto const piececount { 40 };
+    auto const wireheight { 5.6 };
+    auto const carrierheight { 7.0 };
+
+    for( auto line = 0; line < linecount; ++line ) {
+        auto const name { "line_" + std::to_string( line ) };
+        track_point point { { 0.0, 0.0, line * 5.0 }, 0.0 };
+
+        Output << "node -1 0 " << name << "_power tractionpowersource ";
+        export_vector( Output, point.location );
+        Output << "3000 0 0.2 4000 1 5 10 end\n";
+
+        for( auto idx = 0; idx < piececount; ++idx ) {
+            auto const start { point };
+            point = export_track( Output, name + '_' + std::to_string( idx ), point, EU07_BENCHMARK_SEGMENTLENGTH, 0.0 );
+
+            Output << "node -1 0 " << name << "_wire_" << idx << " traction " << name << "_power 3000 4000 0.075 cu 100 0 ";
+            export_vector( Output, start.location + glm::dvec3{ 0.0, wireheight, 0.0 } );
+            export_vector( Output, point.location + glm::dvec3{ 0.0, wireheight, 0.0 } );
+            export_vector( Output, start.location + glm::dvec3{ 0.0, carrierheight, 0.0 } );
+            export_vector( Output, point.location + glm::dvec3{ 0.0, carrierheight, 0.0 } );
+            Output << "1.0 10 2 0 unvis endtraction\n";
+        }
+
+        export_consist( Output, name + "_consist", name + "_2", 60.0, 3, Vehicle, true );
+    }
+}
+
+// diagonal switch ladder, each switch leading to a siding occupied by a parked consist
+void
+generate_depot( std::ostream &Output, int const Size, std::string const &Vehicle ) {
+
+    auto const sidingcount { ( Size > 0 ? Size : 20 ) };
+    auto const switchangle { std::atan( 1.0 / 9.0 ) }; // standard 1:9 turnout
+    auto const switchradius { 190.0 };
+    auto const switchlength { switchradius * switchangle };
+    auto const ladderspacing { 45.0 }; // distance between consecutive switches, gives ~5m between sidings
+
+    auto point { export_track( Output, "depot_lead", { { 0.0, 0.0, 0.0 }, switchangle }, 100.0, 0.0 ) };
+
+    for( auto idx = 0; idx < sidingcount; ++idx ) {
+        auto const index { std::to_string( idx ) };
+
+        export_track_header( Output, "depot_switch_" + index, "switch", switchlength );
+        auto const straight { export_path( Output, point, switchlength, 0.0 ) };
+        auto const diverging { export_path( Output, point, switchlength, -switchradius ) };
+        Output << "velocity 40 endtrack\n";
+
+        point = export_track( Output, "depot_ladder_" + index, straight, ladderspacing - switchlength, 0.0 );
+        export_track( Output, "depot_siding_" + index, diverging, 400.0, 0.0 );
+
+        export_consist( Output, "parked_" + index, "depot_siding_" + index, 0.0, 4, Vehicle, false );
+    }
+}
+
+} // anonymous
+
+// generates synthetic scenario of specified layout and scale, for benchmark runs.
+// returns: name of the generated scenario file, or empty string on failure
+std::string
+generate_benchmark_scenario( std::string const &Layout, int Size, std::string const &Vehicle ) {
+
+    std::vector< std::pair< std::string, void (*)( std::ostream &, int const, std::string const & ) > > const generators {
+        { "loop", &generate_loop },
+        { "signals", &generate_signals },
+        { "catenary", &generate_catenary },
+        { "depot", &generate_depot } };
+
+    auto const lookup { std::find_if(
+        std::begin( generators ), std::end( generators ),
+        [&]( auto const &generator ) {
+            return generator.first == Layout; } ) };
+    if( lookup == std::end( generators ) ) {
+        ErrorLog( "Bad init: unknown benchmark layout \"" + Layout + "\"" );
+        return "";
+    }
+
+    auto const scenariofile { "benchmark_" + Layout + ".scn" };
+    std::ofstream output( Global.asCurrentSceneryPath + scenariofile, std::ios::trunc );
+    if( false == output.is_open() ) {
+        ErrorLog( "Bad file: failed to create benchmark scenario \"" + Global.asCurrentSceneryPath + scenariofile + "\"" );
+        return "";
+    }
+    // vehicle is specified as comma separated data folder, skin and model
+    auto vehicle { Vehicle };
+    std::replace( std::begin( vehicle ), std::end( vehicle ), ',', ' ' );
+
+    output
+        << "// generated benchmark scenario, layout: " << Layout << ", size: " << Size << "\n"
+        << std::fixed << std::setprecision( 4 );
+    lookup->second( output, Size, vehicle );
+
+    WriteLog( "Generated benchmark scenario \"" + scenariofile + "\"" );
+    return scenariofile;
+}
+
+// starts or stops counting memory allocations made by the application. allocations aren't counted by default
+void
+count_allocations( bool const State ) {
+
+    allocationcounting.store( State, std::memory_order_relaxed );
+}
+
+// number of memory allocations counted so far
+std::uint64_t
+allocation_count() {
+
+    return allocationcount.load( std::memory_order_relaxed );
+}
+
+// stores scenario loading time, in seconds
+void
+benchmark_recorder::load_time( double const Seconds ) {
+
+    m_loadtime = Seconds;
+}
+
+// stores subsystem costs and allocations of the frame which just finished, resets the stopwatches for the next one
+void
+benchmark_recorder::record_frame( std::uint64_t const Allocations ) {
+
+    std::vector< std::pair< sample_sequence *, Timer::stopwatch * > > const sources {
+        { &m_total, &Timer::subsystem.sim_total },
+        { &m_dynamics, &Timer::subsystem.sim_dynamics },
+        { &m_events, &Timer::subsystem.sim_events } };
+
+    for( auto &source : sources ) {
+        source.first->emplace_back( source.second->sum().count() / 1000.f );
+        source.second->reset_sum();
+    }
+    // ai drivers are timed by their scheduler, which already measures each full update
+    m_ai.emplace_back( simulation::AIScheduler.frame_cost() );
+    if( true == allocationcounting.load( std::memory_order_relaxed ) ) {
+        m_allocations.emplace_back( static_cast<float>( Allocations ) );
+    }
+}
+
+// sends collected data in json format to provided stream
+void
+benchmark_recorder::export_as_json( std::ostream &Output, std::string const &Scenario, double const Simulationtime ) const {
+
+    Output
+        << "{\n"
+        << "  \"scenario\": \"" << Scenario << "\",\n"
+        << "  \"frames\": " << m_total.size() << ",\n"
+        << "  \"simulation_time\": " << Simulationtime << ",\n"
+        << "  \"load_time\": " << m_loadtime << ",\n"
+        << "  \"frame_cost_ms\": {\n";
+    std::vector< std::pair< std::string, sample_sequence const * > > const costs {
+        { "total", &m_total },
+        { "dynamics", &m_dynamics },
+        { "events", &m_events },
+        { "ai", &m_ai } };
+    for( auto const &cost : costs ) {
+        Output << "    \"" << cost.first << "\": ";
+        export_distribution( Output, *cost.second );
+        Output << ( &cost != &costs.back() ? ",\n" : "\n" );
+    }
+    Output
+        << "  },\n"
+        << "  \"allocations_per_frame\": ";
+    export_distribution( Output, m_allocations );
+    Output
+        << "\n"
+        << "}\n";
+}
+
+void
+benchmark_recorder::export_distribution( std::ostream &Output, sample_sequence Samples ) const {
+
+    if( Samples.empty() ) {
+        Output << "null";
+        return;
+    }
+    std::sort( std::begin( Samples ), std::end( Samples ) );
+    auto const percentile = [&]( double const Fraction ) {
+        return Samples[ static_cast<std::size_t>( std::round( Fraction * ( Samples.size() - 1 ) ) ) ]; };
+    auto const mean { std::accumulate( std::begin( Samples ), std::end( Samples ), 0.0 ) / Samples.size() };
+
+    Output
+        << "{ \"p50\": " << percentile( 0.50 )
+        << ", \"p99\": " << percentile( 0.99 )
+        << ", \"mean\": " << mean
+        << ", \"max\": " << Samples.back()
+        << " }";
+}
+
+} // simulation
+
+//---------------------------------------------------------------------------
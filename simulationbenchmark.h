@@ -0,0 +1,61 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+namespace simulation {
+
+// generates synthetic scenario of specified layout and scale, for benchmark runs.
+// layouts: loop (consists on a circular track), signals (consist on a loop lined with memory cells and signalling events),
+// catenary (parallel electrified tracks under dense traction grid), depot (switch ladder with sidings filled by parked consists)
+// returns: name of the generated scenario file, or empty string on failure
+std::string
+    generate_benchmark_scenario( std::string const &Layout, int Size, std::string const &Vehicle );
+
+// starts or stops counting memory allocations made by the application. allocations aren't counted by default
+void
+    count_allocations( bool const State );
+
+// number of memory allocations counted so far
+std::uint64_t
+    allocation_count();
+
+// collects per-frame cost of simulation subsystems during headless runs, reports their distribution
+class benchmark_recorder {
+
+public:
+// methods
+    // stores scenario loading time, in seconds
+    void
+        load_time( double const Seconds );
+    // stores subsystem costs and allocations of the frame which just finished, resets the stopwatches for the next one
+    void
+        record_frame( std::uint64_t const Allocations );
+    // sends collected data in json format to provided stream
+    void
+        export_as_json( std::ostream &Output, std::string const &Scenario, double const Simulationtime ) const;
+
+private:
+// types
+    using sample_sequence = std::vector<float>;
+// methods
+    void
+        export_distribution( std::ostream &Output, sample_sequence Samples ) const;
+// members
+    double m_loadtime { 0.0 };
+    sample_sequence m_total; // whole frame simulation update, msec
+    sample_sequence m_dynamics; // vehicle physics, msec
+    sample_sequence m_events; // event queue and event launchers, msec
+    sample_sequence m_ai; // full updates of ai drivers, msec. included in the dynamics cost
+    sample_sequence m_allocations; // memory allocations per frame, if counted during the run
+};
+
+} // simulation
+
+//---------------------------------------------------------------------------
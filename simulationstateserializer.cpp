@@ -29,6 +29,8 @@ http://mozilla.org/MPL/2.0/.
 #include "application.h"
 #include "renderer.h"
 #include "Logs.h"
+#include "Timer.h"
+#include "sn_utils.h"
 
 namespace simulation {
 
@@ -41,6 +43,11 @@ state_serializer::deserialize_begin( std::string const &Scenariofile ) {
 
     simulation::State.init_scripting_interface();
 
+    if( true == Global.file_preload ) {
+        // start loading included files while we're busy with the main scenario file
+        cParser::startPreload( Scenariofile, Global.asCurrentSceneryPath, Global.bLoadTraction );
+    }
+
 	// NOTE: for the time being import from text format is a given, since we don't have full binary serialization
 	std::shared_ptr<deserializer_state> state =
 	        std::make_shared<deserializer_state>(Scenariofile, cParser::buffer_FILE, Global.asCurrentSceneryPath, Global.bLoadTraction);
@@ -55,8 +62,10 @@ state_serializer::deserialize_begin( std::string const &Scenariofile ) {
 		state->scratchpad.binary.terrain = Region->is_scene( Scenariofile ) ;
     }
 
-	if( false == state->input.ok() )
+	if( false == state->input.ok() ) {
+        cParser::stopPreload();
 		throw invalid_scenery_exception();
+    }
 
 	// prepare deserialization function table
 	// since all methods use the same objects, we can have simple, hard-coded binds or lambdas for the task
@@ -121,6 +130,8 @@ state_serializer::deserialize_continue(std::shared_ptr<deserializer_state> state
 
         token = Input.getToken<std::string>();
     }
+    // the scenario is processed, preloaded data is no longer needed
+    cParser::stopPreload();
 
     if( false == Scratchpad.initialized ) {
         // manually perform scenario initialization
@@ -135,7 +146,7 @@ state_serializer::deserialize_continue(std::shared_ptr<deserializer_state> state
 	 && ( state->scenariofile != "$.scn" ) ) {
 		// if we didn't find usable binary version of the scenario files, create them now for future use
 		// as long as the scenario file wasn't rainsted-created base file override
-		Region->serialize( state->scenariofile );
+		Region->serialize( state->scenariofile, Input.Files() );
 	}
 
 	return false;
@@ -406,6 +417,11 @@ state_serializer::deserialize_node( cParser &Input, scene::scratch_data &Scratch
     }
     else if( nodedata.type == "traction" ) {
 
+        if( true == Scratchpad.binary.terrain ) {
+            // if binary scene file was present, we already have this data
+            skip_until( Input, "endtraction" );
+            return;
+        }
         auto *traction { deserialize_traction( Input, Scratchpad, nodedata ) };
         // traction loading is optional
         if( traction == nullptr ) { return; }
@@ -418,6 +434,11 @@ state_serializer::deserialize_node( cParser &Input, scene::scratch_data &Scratch
     }
     else if( nodedata.type == "tractionpowersource" ) {
 
+        if( true == Scratchpad.binary.terrain ) {
+            // if binary scene file was present, we already have this data
+            skip_until( Input, "end" );
+            return;
+        }
         auto *powersource { deserialize_tractionpowersource( Input, Scratchpad, nodedata ) };
         // traction loading is optional
         if( powersource == nullptr ) { return; }
@@ -465,6 +486,10 @@ state_serializer::deserialize_node( cParser &Input, scene::scratch_data &Scratch
                 skip_until( Input, "endmodel" );
             }
         }
+        else if( true == Scratchpad.binary.terrain ) {
+            // if binary scene file was present, we already have this data
+            skip_until( Input, "endmodel" );
+        }
         else {
             // regular instance of 3d mesh
             auto *instance { deserialize_model( Input, Scratchpad, nodedata ) };
@@ -530,6 +555,11 @@ state_serializer::deserialize_node( cParser &Input, scene::scratch_data &Scratch
     }
     else if( nodedata.type == "memcell" ) {
 
+        if( true == Scratchpad.binary.terrain ) {
+            // if binary scene file was present, we already have this data
+            skip_until( Input, "endmemcell" );
+            return;
+        }
         auto *memorycell { deserialize_memorycell( Input, Scratchpad, nodedata ) };
         if( false == simulation::Memory.insert( memorycell ) ) {
             ErrorLog( "Bad scenario: duplicate memory cell name \"" + memorycell->name() + "\" defined in file \"" + Input.Name() + "\" (line " + std::to_string( inputline ) + ")" );
@@ -539,6 +569,11 @@ state_serializer::deserialize_node( cParser &Input, scene::scratch_data &Scratch
     }
     else if( nodedata.type == "eventlauncher" ) {
 
+        if( true == Scratchpad.binary.terrain ) {
+            // if binary scene file was present, we already have this data
+            skip_until( Input, "end" );
+            return;
+        }
         auto *eventlauncher { deserialize_eventlauncher( Input, Scratchpad, nodedata ) };
         if( false == simulation::Events.insert( eventlauncher ) ) {
             ErrorLog( "Bad scenario: duplicate event launcher name \"" + eventlauncher->name() + "\" defined in file \"" + Input.Name() + "\" (line " + std::to_string( inputline ) + ")" );
@@ -816,8 +851,14 @@ state_serializer::deserialize_model( cParser &Input, scene::scratch_data &Scratc
     auto *instance = new TAnimModel( Nodedata );
     instance->Angles( Scratchpad.location.rotation + rotation ); // dostosowanie do pochylania linii
 
-    if( instance->Load( &Input, false ) ) {
-        instance->location( transform( location, Scratchpad ) );
+    location = transform( location, Scratchpad );
+    // textures of the model are loaded in the background, and the location lets the loader serve the closest models first
+    texture_manager::request_location( location );
+    auto const isloaded { instance->Load( &Input, false ) };
+    texture_manager::request_location( std::nullopt );
+
+    if( true == isloaded ) {
+        instance->location( location );
     }
     else {
         // model nie wczytał się - ignorowanie node
@@ -1132,6 +1173,50 @@ state_serializer::export_as_text(std::string const &Scenariofile) const {
     WriteLog( "Scenery data export done." );
 }
 
+// sends dynamic state of the simulation to provided stream, in binary format. used to compare state of the simulation between runs
+// NOTE: static content of the scenario isn't included
+// NOTE: vehicles contribute motion, brakes, power, controls and coupler state, and the driver its orders and targets; the driver's
+// speed table and timetable progress, vehicle temperatures, lights, traction network voltages, sounds and animations aren't included,
+// so divergence there shows up only once it affects one of the covered values
+void
+state_serializer::export_state( std::ostream &Output ) const {
+
+    // clocks
+    sn_utils::ls_float64( Output, Timer::GetTime() );
+    Time.serialize( Output );
+    {
+        std::ostringstream randomstate;
+        randomstate << Global.random_engine;
+        sn_utils::s_str( Output, randomstate.str() );
+    }
+    // mem cells
+    for( auto const *memorycell : Memory.sequence() ) {
+        if( memorycell == nullptr ) { continue; }
+        sn_utils::s_str( Output, memorycell->name() );
+        sn_utils::s_str( Output, memorycell->Text() );
+        sn_utils::ls_float64( Output, memorycell->Value1() );
+        sn_utils::ls_float64( Output, memorycell->Value2() );
+    }
+    // switches
+    for( auto const *path : Paths.sequence() ) {
+        if( ( path == nullptr )
+         || ( path->eType != tt_Switch ) ) {
+            continue;
+        }
+        sn_utils::s_str( Output, path->name() );
+        sn_utils::ls_int32( Output, path->GetSwitchState() );
+    }
+    // vehicles
+    for( auto const *vehicle : Vehicles.sequence() ) {
+        if( vehicle == nullptr ) { continue; }
+        sn_utils::s_str( Output, vehicle->name() );
+        sn_utils::s_bool( Output, vehicle->bEnabled );
+        vehicle->export_state( Output );
+    }
+    // events
+    Events.serialize_queue( Output );
+}
+
 void
 state_serializer::export_nodes_to_stream(std::ostream &scmfile, bool Dirty) const {
 	// groups
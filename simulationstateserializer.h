@@ -40,6 +40,9 @@ public:
     // stores class data in specified file, in legacy (text) format
     void
         export_as_text( std::string const &Scenariofile ) const;
+    // sends dynamic state of the simulation to provided stream, in binary format. used to compare state of the simulation between runs
+    void
+        export_state( std::ostream &Output ) const;
 	// create new model from node stirng
 	TAnimModel * create_model(std::string const &src, std::string const &name, const glm::dvec3 &position);
 	// create new eventlauncher from node stirng
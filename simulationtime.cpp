@@ -12,6 +12,7 @@ http://mozilla.org/MPL/2.0/.
 
 #include "Globals.h"
 #include "utilities.h"
+#include "sn_utils.h"
 
 namespace simulation {
 
@@ -213,6 +214,17 @@ void scenario_time::set_time(int yearday, int minute) {
 	m_time.wMinute = minute % 60;
 }
 
+// sends current state of the clock to provided stream, in binary format
+void
+scenario_time::serialize( std::ostream &Output ) const {
+
+    for( auto const field : { m_time.wYear, m_time.wMonth, m_time.wDayOfWeek, m_time.wDay, m_time.wHour, m_time.wMinute, m_time.wSecond, m_time.wMilliseconds } ) {
+        sn_utils::ls_uint16( Output, field );
+    }
+    sn_utils::ls_float64( Output, m_milliseconds );
+    sn_utils::ls_int32( Output, m_yearday );
+}
+
 // calculates day of week for provided date
 int
 scenario_time::day_of_week( int const Day, int const Month, int const Year ) const {
@@ -43,6 +43,9 @@ public:
             return m_timezonebias; }
 	void
 	    set_time(int yearday, int minute);
+    // sends current state of the clock to provided stream, in binary format
+    void
+        serialize( std::ostream &Output ) const;
 
 private:
     // converts provided time transition date to regular date
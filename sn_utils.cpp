@@ -91,8 +91,8 @@ std::string sn_utils::d_str(std::istream &s)
 	char buf[1];
 	while (true)
 	{
-		s.read(buf, 1);
-		if (buf[0] == 0)
+		// string cut short by the end of data ends there, too
+		if (!s.read(buf, 1) || buf[0] == 0)
 			break;
 		r.push_back(buf[0]);
 	}
@@ -129,6 +129,27 @@ glm::vec4 sn_utils::d_vec4( std::istream& s )
         ld_float32(s) };
 }
 
+uint64_t sn_utils::d_varuint(std::istream &s)
+{
+	uint64_t v = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		char buf[1];
+		if (!s.read(buf, 1))
+			break;
+		v |= (uint64_t)(buf[0] & 0x7f) << shift;
+		if ((buf[0] & 0x80) == 0)
+			break;
+	}
+	return v;
+}
+
+int64_t sn_utils::d_varint(std::istream &s)
+{
+	uint64_t v = d_varuint(s);
+	return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
 uint8_t sn_utils::d_uint8( std::istream& s ) {
 
 	uint8_t buf;
@@ -137,6 +158,69 @@ uint8_t sn_utils::d_uint8( std::istream& s ) {
 }
 
 
+// deserialize little endian uint16 from memory
+uint16_t sn_utils::ld_uint16(char const *&d)
+{
+	auto const *buf = reinterpret_cast<uint8_t const *>(d);
+	d += 2;
+	return (uint16_t)((buf[1] << 8) | buf[0]);
+}
+
+// deserialize little endian uint32 from memory
+uint32_t sn_utils::ld_uint32(char const *&d)
+{
+	auto const *buf = reinterpret_cast<uint8_t const *>(d);
+	d += 4;
+	return ((uint32_t)buf[3] << 24) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[1] << 8) | (uint32_t)buf[0];
+}
+
+// deserialize little endian int32 from memory
+int32_t sn_utils::ld_int32(char const *&d)
+{
+	uint32_t v = ld_uint32(d);
+	return reinterpret_cast<int32_t&>(v);
+}
+
+// deserialize little endian uint64 from memory
+uint64_t sn_utils::ld_uint64(char const *&d)
+{
+	uint64_t const low = ld_uint32(d);
+	uint64_t const high = ld_uint32(d);
+	return (high << 32) | low;
+}
+
+// deserialize little endian ieee754 float32 from memory
+float sn_utils::ld_float32(char const *&d)
+{
+	uint32_t v = ld_uint32(d);
+	return reinterpret_cast<float&>(v);
+}
+
+uint8_t sn_utils::d_uint8(char const *&d)
+{
+	return static_cast<uint8_t>(*d++);
+}
+
+glm::vec3 sn_utils::d_vec3(char const *&d)
+{
+	glm::vec3 v;
+	v.x = ld_float32(d);
+	v.y = ld_float32(d);
+	v.z = ld_float32(d);
+	return v;
+}
+
+glm::vec4 sn_utils::d_vec4(char const *&d)
+{
+	glm::vec4 v;
+	v.x = ld_float32(d);
+	v.y = ld_float32(d);
+	v.z = ld_float32(d);
+	v.w = ld_float32(d);
+	return v;
+}
+
+
 void sn_utils::ls_uint16(std::ostream &s, uint16_t v)
 {
 	uint8_t buf[2];
@@ -260,3 +344,21 @@ void sn_utils::s_vec4(std::ostream &s, glm::vec4 const &v)
     ls_float32(s, v.z);
     ls_float32(s, v.w);
 }
+
+void sn_utils::s_varuint(std::ostream &s, uint64_t v)
+{
+	uint8_t buf[10];
+	int size = 0;
+	while (v >= 0x80)
+	{
+		buf[size++] = (uint8_t)(v | 0x80);
+		v >>= 7;
+	}
+	buf[size++] = (uint8_t)v;
+	s.write((char*)buf, size);
+}
+
+void sn_utils::s_varint(std::ostream &s, int64_t v)
+{
+	s_varuint(s, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
@@ -3,6 +3,7 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <string>
+#include <streambuf>
 
 class sn_utils
 {
@@ -20,6 +21,18 @@ public:
     static glm::dvec3 d_dvec3(std::istream&);
 	static glm::vec3 d_vec3(std::istream&);
     static glm::vec4 d_vec4(std::istream&);
+	// variable length integers, 7 bits per byte with the high bit marking continuation. signed values are zigzag encoded
+	static uint64_t d_varuint(std::istream&);
+	static int64_t d_varint(std::istream&);
+	// in-memory variants, reading from provided location and advancing it past the read data
+	static uint16_t ld_uint16(char const *&);
+	static uint32_t ld_uint32(char const *&);
+	static int32_t ld_int32(char const *&);
+	static uint64_t ld_uint64(char const *&);
+	static float ld_float32(char const *&);
+	static uint8_t d_uint8(char const *&);
+	static glm::vec3 d_vec3(char const *&);
+	static glm::vec4 d_vec4(char const *&);
 
 	static void ls_uint16(std::ostream&, uint16_t);
 	static void ls_uint32(std::ostream&, uint32_t);
@@ -34,4 +47,34 @@ public:
     static void s_dvec3(std::ostream&, glm::dvec3 const &);
 	static void s_vec3(std::ostream&, glm::vec3 const &);
     static void s_vec4(std::ostream&, glm::vec4 const &);
-};
\ No newline at end of file
+	static void s_varuint(std::ostream&, uint64_t);
+	static void s_varint(std::ostream&, int64_t);
+};
+
+// read-only stream buffer over a block of memory, lets stream based deserialization work on mapped data without copying it
+class memory_streambuf : public std::streambuf
+{
+public:
+	memory_streambuf(char const *Data, std::size_t const Size)
+	{
+		auto *data = const_cast<char *>(Data);
+		setg(data, data, data + Size);
+	}
+
+protected:
+	pos_type seekoff(off_type Offset, std::ios_base::seekdir Direction, std::ios_base::openmode Mode) override
+	{
+		char *target =
+			Direction == std::ios_base::beg ? eback() + Offset :
+			Direction == std::ios_base::cur ? gptr() + Offset :
+			egptr() + Offset;
+		if ((target < eback()) || (target > egptr()))
+			return pos_type(off_type(-1));
+		setg(eback(), target, egptr());
+		return pos_type(target - eback());
+	}
+	pos_type seekpos(pos_type Position, std::ios_base::openmode Mode) override
+	{
+		return seekoff(off_type(Position), std::ios_base::beg, Mode);
+	}
+};
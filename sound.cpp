@@ -146,6 +146,15 @@ sound_source::deserialize( cParser &Input, sound_type const Legacytype, int cons
     if( m_sounds[ end ].buffer == m_sounds[ main ].buffer ) {
         m_sounds[ end ].buffer = null_handle;
     }
+    // the beginning is played in sequence with the main sound or the first chunk. such sequences can't be streamed,
+    // so long samples which can end up in them are loaded whole now rather than on first use, in the middle of the simulation
+    if( m_sounds[ begin ].buffer != null_handle ) {
+        audio::renderer.load_buffer( m_sounds[ begin ].buffer );
+        audio::renderer.load_buffer( m_sounds[ main ].buffer );
+        if( false == m_soundchunks.empty() ) {
+            audio::renderer.load_buffer( m_soundchunks.front().first.buffer );
+        }
+    }
 
     return *this;
 }
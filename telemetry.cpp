@@ -0,0 +1,330 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "telemetry.h"
+
+#include "sn_utils.h"
+#include "Logs.h"
+
+#ifdef __unix__
+#include <sys/stat.h>
+#endif
+
+namespace telemetry {
+
+recorder Recorder;
+
+namespace {
+
+// recording layout:
+// header: magic, version, column count, followed by (type, name) pair for each column
+// chunks: marker, count and content of strings added to the string table, sample count, followed by values of each column in turn
+char const magic[] = "EU07TLM";
+std::uint32_t const version { 1 };
+std::uint32_t const chunkmarker { 0x4b4e4843 }; // CHNK
+std::size_t const chunksize { 4096 }; // samples buffered before they're handed over to be written
+
+enum class column_type : std::uint8_t {
+    float64,
+    float32,
+    int32,
+    string // index of the string table entry
+};
+
+struct column {
+    char const *name;
+    column_type type;
+    std::size_t offset;
+};
+
+column const columns[] = {
+    { "Time[s]", column_type::float64, offsetof( sample, time ) },
+    { "Vehicle", column_type::string, offsetof( sample, vehicle ) },
+    { "Velocity[m/s]", column_type::float32, offsetof( sample, velocity ) },
+    { "Acceleration[m/ss]", column_type::float32, offsetof( sample, acceleration ) },
+    { "Coupler.Dist[m]", column_type::float32, offsetof( sample, coupler_distance ) },
+    { "Coupler.Force[N]", column_type::float32, offsetof( sample, coupler_force ) },
+    { "TractionForce[kN]", column_type::float32, offsetof( sample, traction_force ) },
+    { "FrictionForce[kN]", column_type::float32, offsetof( sample, friction_force ) },
+    { "BrakeForce[kN]", column_type::float32, offsetof( sample, brake_force ) },
+    { "BrakePress[MPa]", column_type::float32, offsetof( sample, brake_pressure ) },
+    { "PipePress[MPa]", column_type::float32, offsetof( sample, pipe_pressure ) },
+    { "MotorCurrent[A]", column_type::float32, offsetof( sample, motor_current ) },
+    { "MCP", column_type::int32, offsetof( sample, main_controller ) },
+    { "SCP", column_type::int32, offsetof( sample, secondary_controller ) },
+    { "BCP", column_type::float32, offsetof( sample, brake_controller ) },
+    { "LBP", column_type::float32, offsetof( sample, local_brake ) },
+    { "Direction", column_type::int32, offsetof( sample, direction ) },
+    { "Command", column_type::string, offsetof( sample, command ) },
+    { "CVal1", column_type::float32, offsetof( sample, command_value1 ) },
+    { "CVal2", column_type::float32, offsetof( sample, command_value2 ) },
+    { "Security", column_type::int32, offsetof( sample, security_status ) },
+    { "Wheelslip", column_type::int32, offsetof( sample, wheelslip ) },
+    { "EngineTemp[Deg]", column_type::float32, offsetof( sample, engine_temperature ) },
+    { "OilTemp[Deg]", column_type::float32, offsetof( sample, oil_temperature ) },
+    { "WaterTemp[Deg]", column_type::float32, offsetof( sample, water_temperature ) },
+    { "WaterAuxTemp[Deg]", column_type::float32, offsetof( sample, water_aux_temperature ) },
+};
+
+template <typename Type_>
+Type_
+field( sample const &Sample, std::size_t const Offset ) {
+
+    Type_ value;
+    std::memcpy( &value, reinterpret_cast<char const *>( &Sample ) + Offset, sizeof( Type_ ) );
+    return value;
+}
+
+void
+write_string( std::ostream &Output, std::string const &String ) {
+
+    auto const length { std::min<std::size_t>( String.size(), std::numeric_limits<std::uint16_t>::max() ) };
+    sn_utils::ls_uint16( Output, static_cast<std::uint16_t>( length ) );
+    Output.write( String.data(), length );
+}
+
+std::string
+read_string( std::istream &Input ) {
+
+    std::string string( sn_utils::ld_uint16( Input ), '\0' );
+    Input.read( &string[ 0 ], string.size() );
+    return string;
+}
+
+} // anonymous
+
+// starts new recording in specified file. returns: true on success
+bool
+recorder::open( std::string const &Filename ) {
+
+    close();
+
+    auto const directory { Filename.substr( 0, Filename.rfind( '/' ) ) };
+    if( directory != Filename ) {
+#ifdef _WIN32
+        _mkdir( directory.c_str() );
+#elif __linux__
+        mkdir( directory.c_str(), 0755 );
+#endif
+    }
+    auto output { std::make_shared<std::ofstream>( Filename, std::ios::out | std::ios::binary | std::ios::trunc ) };
+    if( false == output->is_open() ) {
+        ErrorLog( "Bad file: failed to create telemetry recording \"" + Filename + "\"", logtype::file );
+        return false;
+    }
+    output->write( magic, sizeof( magic ) );
+    sn_utils::ls_uint32( *output, version );
+    sn_utils::ls_uint32( *output, static_cast<std::uint32_t>( std::size( columns ) ) );
+    for( auto const &column : columns ) {
+        sn_utils::s_uint8( *output, static_cast<std::uint8_t>( column.type ) );
+        write_string( *output, column.name );
+    }
+
+    m_output = output;
+    m_samples.reserve( chunksize );
+    WriteLog( "Telemetry: recording vehicle data to \"" + Filename + "\"" );
+
+    return true;
+}
+
+// writes remaining samples and closes the recording
+void
+recorder::close() {
+
+    if( false == is_open() ) { return; }
+
+    flush();
+    threading::jobs.wait( m_lastwrite );
+    m_lastwrite.reset();
+    m_output->close();
+    m_output.reset();
+    m_strings.clear();
+    m_newstrings.clear();
+}
+
+// adds provided sample, with string fields taken from specified vehicle name and command
+// NOTE: the recorder isn't thread safe, samples are expected to come from the main simulation thread
+void
+recorder::record( sample Sample, std::string const &Vehicle, std::string const &Command ) {
+
+    if( false == is_open() ) { return; }
+
+    Sample.vehicle = string_index( Vehicle );
+    Sample.command = string_index( Command );
+    m_samples.emplace_back( Sample );
+
+    if( m_samples.size() >= chunksize ) {
+        flush();
+    }
+}
+
+// returns string table index of provided string, adding it to the table if needed
+std::uint32_t
+recorder::string_index( std::string const &String ) {
+
+    auto const lookup { m_strings.emplace( String, static_cast<std::uint32_t>( m_strings.size() ) ) };
+    if( true == lookup.second ) {
+        m_newstrings.emplace_back( String );
+    }
+    return lookup.first->second;
+}
+
+// hands buffered samples over to the job system
+void
+recorder::flush() {
+
+    if( m_samples.empty() ) { return; }
+
+    auto strings { std::make_shared<string_sequence>() };
+    strings->swap( m_newstrings );
+    auto samples { std::make_shared<sample_sequence>() };
+    samples->swap( m_samples );
+    m_samples.reserve( chunksize );
+
+    m_lastwrite =
+        threading::jobs.submit(
+            [ output = m_output, strings, samples ]() {
+                write_chunk( *output, *strings, *samples ); },
+            { m_lastwrite } );
+}
+
+// sends block of samples and strings added to the table since previous block to provided stream
+void
+recorder::write_chunk( std::ostream &Output, string_sequence const &Strings, sample_sequence const &Samples ) {
+
+    sn_utils::ls_uint32( Output, chunkmarker );
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( Strings.size() ) );
+    for( auto const &string : Strings ) {
+        write_string( Output, string );
+    }
+    sn_utils::ls_uint32( Output, static_cast<std::uint32_t>( Samples.size() ) );
+    for( auto const &column : columns ) {
+        switch( column.type ) {
+            case column_type::float64: {
+                for( auto const &sample : Samples ) {
+                    sn_utils::ls_float64( Output, field<double>( sample, column.offset ) ); }
+                break; }
+            case column_type::float32: {
+                for( auto const &sample : Samples ) {
+                    sn_utils::ls_float32( Output, field<float>( sample, column.offset ) ); }
+                break; }
+            case column_type::int32: {
+                for( auto const &sample : Samples ) {
+                    sn_utils::ls_int32( Output, field<std::int32_t>( sample, column.offset ) ); }
+                break; }
+            case column_type::string: {
+                for( auto const &sample : Samples ) {
+                    sn_utils::ls_uint32( Output, field<std::uint32_t>( sample, column.offset ) ); }
+                break; }
+            default: {
+                break; }
+        }
+    }
+    Output.flush();
+}
+
+// converts specified recording to comma separated text file. returns: true on success
+bool
+recorder::export_as_csv( std::string const &Input, std::string const &Output ) {
+
+    std::ifstream input( Input, std::ios::in | std::ios::binary );
+    if( false == input.is_open() ) {
+        ErrorLog( "Bad file: failed to open telemetry recording \"" + Input + "\"", logtype::file );
+        return false;
+    }
+    char filemagic[ sizeof( magic ) ];
+    input.read( filemagic, sizeof( filemagic ) );
+    if( ( false == input.good() )
+     || ( std::memcmp( filemagic, magic, sizeof( magic ) ) != 0 )
+     || ( sn_utils::ld_uint32( input ) != version ) ) {
+        ErrorLog( "Bad file: \"" + Input + "\" isn't a supported telemetry recording", logtype::file );
+        return false;
+    }
+    // the column layout is taken from the recording, so files made by other versions of the schema can be converted as well
+    std::vector<column_type> types;
+    std::vector<std::string> names;
+    auto const columncount { sn_utils::ld_uint32( input ) };
+    for( std::uint32_t idx = 0; ( idx < columncount ) && ( true == input.good() ); ++idx ) {
+        types.emplace_back( static_cast<column_type>( sn_utils::d_uint8( input ) ) );
+        names.emplace_back( read_string( input ) );
+    }
+
+    std::ofstream output( Output, std::ios::out | std::ios::trunc );
+    if( false == output.is_open() ) {
+        ErrorLog( "Bad file: failed to create \"" + Output + "\"", logtype::file );
+        return false;
+    }
+    for( std::size_t idx = 0; idx < names.size(); ++idx ) {
+        output << ( idx > 0 ? "," : "" ) << names[ idx ];
+    }
+    output << "\n" << std::fixed << std::setprecision( 4 );
+
+    std::vector<std::string> strings;
+    std::vector< std::vector<double> > values( types.size() ); // all column types are exactly representable as double
+    std::size_t samplecount { 0 };
+    while( input.peek() != std::char_traits<char>::eof() ) {
+        if( sn_utils::ld_uint32( input ) != chunkmarker ) {
+            ErrorLog( "Bad file: corrupted data in telemetry recording \"" + Input + "\"", logtype::file );
+            return false;
+        }
+        auto const stringcount { sn_utils::ld_uint32( input ) };
+        for( std::uint32_t idx = 0; ( idx < stringcount ) && ( true == input.good() ); ++idx ) {
+            strings.emplace_back( read_string( input ) );
+        }
+        auto const count { sn_utils::ld_uint32( input ) };
+        for( std::size_t columnidx = 0; columnidx < types.size(); ++columnidx ) {
+            auto &columnvalues { values[ columnidx ] };
+            columnvalues.resize( count );
+            for( auto &value : columnvalues ) {
+                switch( types[ columnidx ] ) {
+                    case column_type::float64: { value = sn_utils::ld_float64( input ); break; }
+                    case column_type::float32: { value = sn_utils::ld_float32( input ); break; }
+                    case column_type::int32:   { value = sn_utils::ld_int32( input ); break; }
+                    case column_type::string:  { value = sn_utils::ld_uint32( input ); break; }
+                    default:                   { value = 0.0; break; }
+                }
+            }
+        }
+        if( false == input.good() ) {
+            // last chunk may be incomplete if the simulation didn't shut down cleanly
+            WriteLog( "Telemetry: truncated chunk in \"" + Input + "\", remaining data skipped" );
+            break;
+        }
+        for( std::size_t sampleidx = 0; sampleidx < count; ++sampleidx ) {
+            for( std::size_t columnidx = 0; columnidx < types.size(); ++columnidx ) {
+                auto const value { values[ columnidx ][ sampleidx ] };
+                if( columnidx > 0 ) {
+                    output << ",";
+                }
+                switch( types[ columnidx ] ) {
+                    case column_type::int32: {
+                        output << static_cast<std::int32_t>( value );
+                        break; }
+                    case column_type::string: {
+                        auto const index { static_cast<std::size_t>( value ) };
+                        output << ( index < strings.size() ? strings[ index ] : "" );
+                        break; }
+                    default: {
+                        output << value;
+                        break; }
+                }
+            }
+            output << "\n";
+        }
+        samplecount += count;
+    }
+
+    WriteLog( "Telemetry: exported " + std::to_string( samplecount ) + " samples from \"" + Input + "\" to \"" + Output + "\"" );
+    return true;
+}
+
+} // telemetry
+
+//---------------------------------------------------------------------------
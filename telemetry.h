@@ -0,0 +1,105 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "jobsystem.h"
+
+class TMoverParameters;
+
+namespace telemetry {
+
+// state of a vehicle at given moment. the layout is fixed, each field is stored in the recording as a separate column
+struct sample {
+    double time; // seconds of simulation time
+    std::uint32_t vehicle; // string table index of the vehicle name
+    float velocity; // m/s
+    float acceleration; // m/s^2
+    float coupler_distance; // m
+    float coupler_force; // N
+    float traction_force; // kN
+    float friction_force; // kN
+    float brake_force; // kN
+    float brake_pressure; // MPa
+    float pipe_pressure; // MPa
+    float motor_current; // A
+    std::int32_t main_controller;
+    std::int32_t secondary_controller;
+    float brake_controller;
+    float local_brake;
+    std::int32_t direction;
+    std::uint32_t command; // string table index of the last received command
+    float command_value1;
+    float command_value2;
+    std::int32_t security_status;
+    std::int32_t wheelslip;
+    float engine_temperature; // deg C
+    float oil_temperature; // deg C
+    float water_temperature; // deg C
+    float water_aux_temperature; // deg C
+};
+
+// collects vehicle samples in memory and writes them in columnar binary format, with the file access done by the job system
+class recorder {
+
+public:
+// destructor
+    ~recorder() {
+        close(); }
+// methods
+    // starts new recording in specified file. returns: true on success
+    bool
+        open( std::string const &Filename );
+    // writes remaining samples and closes the recording
+    void
+        close();
+    bool
+        is_open() const {
+            return ( m_output != nullptr ); }
+    // adds provided sample, with string fields taken from specified vehicle name and command
+    void
+        record( sample Sample, std::string const &Vehicle, std::string const &Command );
+    // converts specified recording to comma separated text file. returns: true on success
+    static
+    bool
+        export_as_csv( std::string const &Input, std::string const &Output );
+
+private:
+// types
+    using sample_sequence = std::vector<sample>;
+    using string_sequence = std::vector<std::string>;
+// methods
+    // returns string table index of provided string, adding it to the table if needed
+    std::uint32_t
+        string_index( std::string const &String );
+    // hands buffered samples over to the job system
+    void
+        flush();
+    // sends block of samples and strings added to the table since previous block to provided stream
+    static
+    void
+        write_chunk( std::ostream &Output, string_sequence const &Strings, sample_sequence const &Samples );
+// members
+    std::shared_ptr<std::ofstream> m_output; // shared with the write jobs
+    std::unordered_map<std::string, std::uint32_t> m_strings;
+    string_sequence m_newstrings; // strings added to the table since last flush
+    sample_sequence m_samples;
+    threading::job_handle m_lastwrite; // each write job waits for the previous one, so the chunks retain their order
+};
+
+extern recorder Recorder;
+
+// adds to specified recording state of a vehicle, taken from the mover operating the brakes and the mover operating the controllers.
+// defined in telemetrysample.cpp, so the recorder itself doesn't depend on the vehicle code
+void
+record_vehicle( recorder &Output, std::string const &Vehicle, TMoverParameters const &Occupied, TMoverParameters const &Controlling );
+
+} // telemetry
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,55 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#include "stdafx.h"
+#include "telemetry.h"
+
+#include "MOVER.h"
+#include "Timer.h"
+
+namespace telemetry {
+
+// adds to specified recording state of a vehicle, taken from the mover operating the brakes and the mover operating the controllers
+void
+record_vehicle( recorder &Output, std::string const &Vehicle, TMoverParameters const &Occupied, TMoverParameters const &Controlling ) {
+
+    if( false == Output.is_open() ) { return; }
+
+    sample sample;
+    sample.time = Timer::GetTime();
+    sample.velocity = static_cast<float>( std::abs( 11.31 * Occupied.WheelDiameter * Occupied.nrot ) );
+    sample.acceleration = static_cast<float>( Controlling.AccS );
+    sample.coupler_distance = static_cast<float>( Occupied.Couplers[ end::rear ].Dist );
+    sample.coupler_force = static_cast<float>( Occupied.Couplers[ end::rear ].CForce );
+    sample.traction_force = static_cast<float>( Occupied.Ft );
+    sample.friction_force = static_cast<float>( Occupied.Ff );
+    sample.brake_force = static_cast<float>( Occupied.Fb );
+    sample.brake_pressure = static_cast<float>( Occupied.BrakePress );
+    sample.pipe_pressure = static_cast<float>( Occupied.PipePress );
+    sample.motor_current = static_cast<float>( Controlling.Im );
+    sample.main_controller = Controlling.MainCtrlPos;
+    sample.secondary_controller = Controlling.ScndCtrlPos;
+    sample.brake_controller = static_cast<float>( Occupied.fBrakeCtrlPos );
+    sample.local_brake = static_cast<float>( Occupied.LocalBrakePosA );
+    sample.direction = Controlling.DirActive;
+    sample.command_value1 = static_cast<float>( Occupied.CommandIn.Value1 );
+    sample.command_value2 = static_cast<float>( Occupied.CommandIn.Value2 );
+    sample.security_status = Controlling.SecuritySystem.Status;
+    sample.wheelslip = ( Controlling.SlippingWheels ? 1 : 0 );
+    sample.engine_temperature = static_cast<float>( Controlling.dizel_heat.Ts );
+    sample.oil_temperature = static_cast<float>( Controlling.dizel_heat.To );
+    sample.water_temperature = static_cast<float>( Controlling.dizel_heat.temperatura1 );
+    sample.water_aux_temperature = static_cast<float>( Controlling.dizel_heat.temperatura2 );
+
+    Output.record( sample, Vehicle, ( Occupied.CommandIn.Command.empty() ? "none" : Occupied.CommandIn.Command ) );
+}
+
+} // telemetry
+
+//---------------------------------------------------------------------------
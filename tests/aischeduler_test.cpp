@@ -0,0 +1,182 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// ai driver scheduler: checks update rates and budget decisions, and runs a crowd of synthetic drivers through the scheduler
+// the way the drivers use it, with fixed update costs in place of measured ones
+
+#include "stdafx.h"
+#include "aischeduler.h"
+
+#include "testing.h"
+
+namespace {
+
+using urgency = ai_scheduler::urgency;
+
+auto const microsecond { std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::microseconds( 1 ) ) };
+
+void
+test_intervals() {
+
+    ai_scheduler scheduler;
+    ai_scheduler::settings settings;
+    settings.relaxedinterval = 1.5;
+    scheduler.begin_frame( settings );
+
+    EU07_CHECK( scheduler.interval( urgency::urgent, 0.5 ) == 0.5 );
+    EU07_CHECK( scheduler.interval( urgency::normal, 0.5 ) == 0.5 );
+    EU07_CHECK( scheduler.interval( urgency::relaxed, 0.5 ) == 1.5 );
+    // the reduced rate never speeds up a slow driver
+    EU07_CHECK( scheduler.interval( urgency::relaxed, 2.0 ) == 2.0 );
+    // without adaptive rates everyone keeps their reaction time
+    settings.adaptive = false;
+    scheduler.begin_frame( settings );
+    EU07_CHECK( scheduler.interval( urgency::relaxed, 0.5 ) == 0.5 );
+}
+
+void
+test_budget() {
+
+    ai_scheduler scheduler;
+    ai_scheduler::settings settings;
+    settings.framebudget = 1.f;
+    scheduler.begin_frame( settings );
+
+    // within the budget everything goes
+    EU07_CHECK( scheduler.request( urgency::normal, 0.0 ) );
+    scheduler.complete( 600 * microsecond, 0.0 );
+    EU07_CHECK( scheduler.request( urgency::relaxed, 0.0 ) );
+    scheduler.complete( 600 * microsecond, 0.0 );
+    // past the budget only urgent and long overdue updates run
+    EU07_CHECK( false == scheduler.request( urgency::normal, 0.0 ) );
+    EU07_CHECK( false == scheduler.request( urgency::relaxed, 0.5 ) );
+    EU07_CHECK( scheduler.request( urgency::urgent, 0.0 ) );
+    scheduler.complete( 100 * microsecond, 0.0 );
+    EU07_CHECK( scheduler.request( urgency::normal, 1.0 ) );
+    scheduler.complete( 100 * microsecond, 1.0 );
+    EU07_CHECK( scheduler.deferred_total() == 2 );
+    EU07_CHECK( std::abs( scheduler.frame_cost() - 1.4f ) < 1e-3f );
+
+    // statistics of the frame become available once the next one starts
+    scheduler.begin_frame( settings );
+    EU07_CHECK( scheduler.frame_stats().updates == 4 );
+    EU07_CHECK( scheduler.frame_stats().deferred == 2 );
+    EU07_CHECK( std::abs( scheduler.frame_stats().cost - 1.4f ) < 1e-3f );
+    EU07_CHECK( scheduler.frame_cost() == 0.f );
+    EU07_CHECK( scheduler.worst_latency() == 1.0 );
+    EU07_CHECK( scheduler.request( urgency::relaxed, 0.0 ) );
+
+    // disabled budget, repeatable runs and runs shared with other instances never defer
+    for( auto const change : {
+            +[]( ai_scheduler::settings &Settings ) { Settings.framebudget = 0.f; },
+            +[]( ai_scheduler::settings &Settings ) { Settings.budgeted = false; },
+            +[]( ai_scheduler::settings &Settings ) { Settings.adaptive = false; } } ) {
+        auto modified { settings };
+        change( modified );
+        scheduler.begin_frame( modified );
+        scheduler.complete( 5000 * microsecond, 0.0 );
+        EU07_CHECK( scheduler.request( urgency::relaxed, 0.0 ) );
+    }
+}
+
+// stands in for the driver, follows the same steps as TController::Update
+struct synthetic_driver {
+    urgency situation;
+    double reactiontime;
+    std::chrono::steady_clock::duration cost;
+    double lastreaction { 0.0 };
+    int updates { 0 };
+
+    void
+        update( ai_scheduler &Scheduler, double const Timedelta ) {
+            lastreaction += Timedelta;
+            auto const interval { Scheduler.interval( situation, reactiontime ) };
+            if( lastreaction < interval ) { return; }
+            auto const overdue { lastreaction - interval };
+            if( false == Scheduler.request( situation, overdue ) ) { return; }
+            lastreaction -= interval;
+            ++updates;
+            Scheduler.complete( cost, overdue ); }
+};
+
+// crowd of drivers with more work than the budget allows. urgent drivers keep their rate, the rest are spread over time
+// without starving anyone
+void
+test_crowd() {
+
+    ai_scheduler scheduler;
+    ai_scheduler::settings settings;
+    settings.framebudget = 2.f;
+    settings.relaxedinterval = 1.0;
+
+    std::mt19937 generator { 5 };
+    std::uniform_real_distribution<double> reaction( 0.2, 0.5 );
+    std::vector<synthetic_driver> drivers;
+    for( int idx = 0; idx < 300; ++idx ) {
+        auto const situation { (
+            idx % 10 == 0 ? urgency::urgent :
+            idx % 3 == 0 ? urgency::normal :
+            urgency::relaxed ) };
+        drivers.push_back( { situation, reaction( generator ), 150 * microsecond } );
+        // spread the first updates, like drivers placed in the scenario at different times
+        drivers.back().lastreaction = reaction( generator );
+    }
+
+    auto const timedelta { 1.0 / 60.0 };
+    auto const framecount { 60 * 30 };
+    auto maxdeferrablecost { 0.f };
+    for( int frame = 0; frame < framecount; ++frame ) {
+        scheduler.begin_frame( settings );
+        // drivers are visited in fixed order, as in the vehicle table. urgent updates count against the budget too
+        auto deferrablecost { 0.f };
+        for( auto &driver : drivers ) {
+            auto const updatesbefore { driver.updates };
+            driver.update( scheduler, timedelta );
+            if( ( driver.updates != updatesbefore )
+             && ( driver.situation != urgency::urgent ) ) {
+                deferrablecost += 0.15f;
+            }
+        }
+        maxdeferrablecost = std::max( maxdeferrablecost, deferrablecost );
+    }
+    auto const duration { framecount * timedelta };
+
+    auto urgentrateok { true };
+    auto everyoneupdated { true };
+    for( auto const &driver : drivers ) {
+        if( driver.situation == urgency::urgent ) {
+            // urgent drivers run at their reaction rate, the time left over from each update carries to the next one
+            urgentrateok = urgentrateok && ( driver.updates >= std::floor( duration / driver.reactiontime ) - 1 );
+        }
+        // updates held back past the deferral limit are forced through, so every driver keeps updating at least once a second or so
+        everyoneupdated = everyoneupdated && ( driver.updates >= duration / 2.5 );
+    }
+    EU07_CHECK( urgentrateok );
+    EU07_CHECK( everyoneupdated );
+    EU07_CHECK( scheduler.deferred_total() > 0 );
+    // deferred updates are held back no longer than the deferral limit, plus the frame it takes to notice
+    EU07_CHECK( scheduler.worst_latency() < 1.0 + 2 * timedelta );
+    std::cout
+        << std::fixed << std::setprecision( 2 )
+        << "deferred updates: " << scheduler.deferred_total()
+        << ", worst latency: " << scheduler.worst_latency() << " s"
+        << ", highest deferrable cost in a frame: " << maxdeferrablecost << " ms" << std::endl;
+}
+
+} // anonymous
+
+int
+main() {
+
+    testing::run( "update intervals", test_intervals );
+    testing::run( "frame budget", test_budget );
+    testing::run( "crowd of drivers", test_crowd );
+
+    return testing::result();
+}
@@ -0,0 +1,316 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// streamed sounds: plays generated sound files through the null audio device and compares the played data with the file content,
+// checks the stream doesn't hold the calling thread when the decoding falls behind, and reports decoding speed
+
+#include "stdafx.h"
+#include "audiostream.h"
+#include "support/nullaudio.h"
+
+#include "testing.h"
+
+namespace {
+
+unsigned int const rate { 44100 };
+std::size_t const frametime { rate / 60 }; // samples played during a frame of the simulation at 60 fps
+
+// occupies the worker of the job system until released
+struct worker_gate {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool open { false };
+    bool entered { false };
+    threading::job_handle job;
+
+    void
+        close() {
+            job = threading::jobs.submit(
+                [this]() {
+                    std::unique_lock<std::mutex> lock( mutex );
+                    entered = true;
+                    condition.notify_all();
+                    condition.wait( lock, [this]() { return open; } ); } );
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait( lock, [this]() { return entered; } ); }
+    void
+        release() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                open = true;
+            }
+            condition.notify_all();
+            // the gate can't go away before the worker is done with it
+            threading::jobs.wait( job ); }
+};
+
+// sends 16 bit pcm .wav file with provided interleaved data to specified file
+void
+write_wav( std::string const &Filename, std::vector<std::int16_t> const &Data, std::uint16_t const Channels ) {
+
+    auto const datasize { static_cast<std::uint32_t>( Data.size() * sizeof( std::int16_t ) ) };
+    std::ofstream output( Filename, std::ios::out | std::ios::binary | std::ios::trunc );
+    auto const write {
+        [&]( auto const Value ) {
+            output.write( reinterpret_cast<char const *>( &Value ), sizeof( Value ) ); } };
+    output.write( "RIFF", 4 );
+    write( std::uint32_t { 36 + datasize } );
+    output.write( "WAVEfmt ", 8 );
+    write( std::uint32_t { 16 } );
+    write( std::uint16_t { 1 } ); // pcm
+    write( Channels );
+    write( std::uint32_t { rate } );
+    write( std::uint32_t { rate * Channels * 2 } );
+    write( std::uint16_t( Channels * 2 ) );
+    write( std::uint16_t { 16 } );
+    output.write( "data", 4 );
+    write( datasize );
+    output.write( reinterpret_cast<char const *>( Data.data() ), datasize );
+}
+
+// generates sound file of specified length. returns: content of the file mixed down to mono, the way the stream plays it
+std::vector<std::int16_t>
+make_sound( std::string const &Filename, std::size_t const Framecount, std::uint16_t const Channels ) {
+
+    std::vector<std::int16_t> data( Framecount * Channels );
+    for( std::size_t idx = 0; idx < data.size(); ++idx ) {
+        // every frame differs from its neighbours, so misplaced or repeated pieces show up in the comparisons
+        data[ idx ] = static_cast<std::int16_t>( ( idx / Channels * 7 + ( idx % Channels ) * 1000 ) % 30000 - 15000 );
+    }
+    write_wav( Filename, data, Channels );
+    audio::narrow_to_mono( data, Channels );
+    return data;
+}
+
+// plays the stream like the renderer does, one simulation frame at a time, until it's finished
+void
+play( audio::openal_stream &Stream, ALuint const Source, std::size_t const Framelimit = 100000 ) {
+
+    for( std::size_t frame = 0; ( frame < Framelimit ) && ( false == Stream.is_finished() ); ++frame ) {
+        nullaudio::advance( Source, frametime );
+        Stream.update( Source );
+        // give the decoding a chance to keep up, the sandboxed test can have only one core to share with the worker
+        std::this_thread::yield();
+    }
+}
+
+ALuint
+make_source() {
+
+    ALuint source;
+    ::alGenSources( 1, &source );
+    return source;
+}
+
+// stops specified source and releases its buffers, the way the renderer does before it lets go of the stream
+void
+release( ALuint const Source ) {
+
+    ::alSourceStop( Source );
+    ::alSourcei( Source, AL_BUFFER, 0 );
+}
+
+void
+test_decoder() {
+
+    auto const expected { make_sound( "audiostream_test.wav", 50000, 1 ) };
+    audio::decoder decoder { "audiostream_test.wav" };
+    EU07_CHECK( decoder.is_open() );
+    EU07_CHECK( decoder.rate() == rate );
+    EU07_CHECK( decoder.channels() == 1 );
+    EU07_CHECK( decoder.frames() == expected.size() );
+
+    std::vector<std::int16_t> data( expected.size() + 100 );
+    data.resize( decoder.read( data.data(), data.size() ) );
+    EU07_CHECK( data == expected );
+    // reads past the end return nothing, seeks put the read position back in the data
+    EU07_CHECK( decoder.read( data.data(), 1 ) == 0 );
+    EU07_CHECK( decoder.seek( 12345 ) );
+    std::int16_t sample;
+    EU07_CHECK( ( decoder.read( &sample, 1 ) == 1 ) && ( sample == expected[ 12345 ] ) );
+
+    EU07_CHECK( false == audio::decoder( "audiostream_test.mp3" ).is_open() );
+    EU07_CHECK( false == audio::decoder( "audiostream_test_missing.wav" ).is_open() );
+}
+
+void
+test_playback() {
+
+    // stereo data, several blocks long and ending with a partial block
+    auto const expected { make_sound( "audiostream_test.wav", 16384 * 9 + 1000, 2 ) };
+    auto const source { make_source() };
+    {
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.bind( source, 0.f );
+        ::alSourcePlay( source );
+        play( stream, source );
+        EU07_CHECK( stream.is_finished() );
+    }
+    EU07_CHECK( nullaudio::played( source ) == expected );
+    EU07_CHECK( nullaudio::errors() == 0 );
+}
+
+void
+test_start_offset() {
+
+    auto const expected { make_sound( "audiostream_test.wav", 16384 * 5, 1 ) };
+    auto const source { make_source() };
+    {
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.bind( source, 0.25f );
+        ::alSourcePlay( source );
+        play( stream, source );
+    }
+    EU07_CHECK( nullaudio::played( source ) == std::vector<std::int16_t>( std::begin( expected ) + expected.size() / 4, std::end( expected ) ) );
+    EU07_CHECK( nullaudio::errors() == 0 );
+}
+
+void
+test_looping() {
+
+    // the length doesn't line up with the blocks, so the loop point falls inside a block
+    auto const expected { make_sound( "audiostream_test.wav", 16384 * 2 + 333, 1 ) };
+    auto const source { make_source() };
+    {
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.loop( true );
+        stream.bind( source, 0.f );
+        ::alSourcePlay( source );
+        while( nullaudio::played( source ).size() < expected.size() * 5 / 2 ) {
+            nullaudio::advance( source, frametime );
+            stream.update( source );
+            std::this_thread::yield();
+        }
+        EU07_CHECK( false == stream.is_finished() );
+        // with the looping disabled the stream plays what it has decoded ahead, and ends with the end of the sound
+        stream.loop( false );
+        play( stream, source );
+        EU07_CHECK( stream.is_finished() );
+    }
+    auto const &played { nullaudio::played( source ) };
+    EU07_CHECK( played.size() % expected.size() == 0 );
+    auto matches { true };
+    for( std::size_t idx = 0; idx < played.size(); ++idx ) {
+        matches = matches && ( played[ idx ] == expected[ idx % expected.size() ] );
+    }
+    EU07_CHECK( matches );
+    EU07_CHECK( nullaudio::errors() == 0 );
+}
+
+void
+test_starvation() {
+
+    auto const expected { make_sound( "audiostream_test.wav", 16384 * 6, 1 ) };
+    auto const source { make_source() };
+    worker_gate gate;
+    {
+        // the worker is busy, so the data past the block decoded on start isn't coming
+        gate.close();
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.bind( source, 0.f );
+        ::alSourcePlay( source );
+        for( int frame = 0; frame < 60; ++frame ) {
+            nullaudio::advance( source, frametime );
+            stream.update( source );
+        }
+        // the source ran dry, and the stream left the decoding to the job system rather than doing it on the calling thread
+        ALint state;
+        ::alGetSourcei( source, AL_SOURCE_STATE, &state );
+        EU07_CHECK( state == AL_STOPPED );
+        EU07_CHECK( nullaudio::played( source ).size() == 16384 );
+        EU07_CHECK( false == stream.is_finished() );
+        // playback resumes once the data arrives, and continues where it stopped
+        gate.release();
+        play( stream, source );
+        EU07_CHECK( stream.is_finished() );
+    }
+    EU07_CHECK( nullaudio::played( source ) == expected );
+
+    // stream can go away while its data is being decoded
+    worker_gate secondgate;
+    secondgate.close();
+    auto const start { std::chrono::steady_clock::now() };
+    {
+        auto const secondsource { make_source() };
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.bind( secondsource, 0.f );
+        release( secondsource );
+    }
+    auto const elapsed { std::chrono::steady_clock::now() - start };
+    secondgate.release();
+    std::cout << "stream released with decoding pending in " << std::chrono::duration<double, std::micro>( elapsed ).count() << " us" << std::endl;
+    EU07_CHECK( nullaudio::errors() == 0 );
+}
+
+// reports time taken to decode a long sound whole and block by block, and the cost of stream updates for the calling thread
+void
+benchmark_decoding() {
+
+    auto const seconds { 120 };
+    auto const expected { make_sound( "audiostream_test.wav", rate * seconds, 2 ) };
+
+    auto const wholestart { std::chrono::steady_clock::now() };
+    {
+        audio::decoder decoder { "audiostream_test.wav" };
+        std::vector<std::int16_t> data( decoder.frames() * decoder.channels() );
+        data.resize( decoder.read( data.data(), decoder.frames() ) * decoder.channels() );
+        audio::narrow_to_mono( data, decoder.channels() );
+        EU07_CHECK( data.size() == expected.size() );
+    }
+    auto const whole { std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - wholestart ).count() };
+
+    auto const source { make_source() };
+    std::chrono::steady_clock::duration updatecost { 0 };
+    std::chrono::steady_clock::duration worstupdate { 0 };
+    std::size_t updatecount { 0 };
+    {
+        audio::openal_stream stream { "audiostream_test.wav" };
+        stream.bind( source, 0.f );
+        ::alSourcePlay( source );
+        while( false == stream.is_finished() ) {
+            nullaudio::advance( source, frametime );
+            auto const updatestart { std::chrono::steady_clock::now() };
+            stream.update( source );
+            auto const cost { std::chrono::steady_clock::now() - updatestart };
+            updatecost += cost;
+            worstupdate = std::max( worstupdate, cost );
+            ++updatecount;
+            std::this_thread::yield();
+        }
+    }
+    EU07_CHECK( nullaudio::played( source ) == expected );
+
+    std::cout
+        << std::fixed << std::setprecision( 1 )
+        << seconds << " s of stereo sound decoded whole in " << whole << " ms (" << seconds * 1000.0 / whole << "x real time)" << std::endl
+        << "stream update: " << std::setprecision( 2 )
+        << std::chrono::duration<double, std::micro>( updatecost ).count() / std::max<std::size_t>( 1, updatecount ) << " us on average, "
+        << std::chrono::duration<double, std::micro>( worstupdate ).count() << " us at worst, over " << updatecount << " frames" << std::endl;
+}
+
+} // anonymous
+
+int
+main() {
+
+    // the streams hand the decoding to the job system, like in the simulation
+    threading::jobs.start( 1 );
+
+    testing::run( "decoder", test_decoder );
+    testing::run( "playback", test_playback );
+    testing::run( "start offset", test_start_offset );
+    testing::run( "looping", test_looping );
+    testing::run( "data starvation", test_starvation );
+    testing::run( "decoding speed", benchmark_decoding );
+
+    threading::jobs.stop();
+    std::remove( "audiostream_test.wav" );
+
+    return testing::result();
+}
@@ -0,0 +1,291 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// sound voices: checks the loudness estimate, and how the voice pool hands out device-side sources through a mock backend,
+// then moves a crowd of emitters around the listener and reports how often the voices change hands
+
+#include "stdafx.h"
+#include "audiovoices.h"
+
+#include "testing.h"
+
+namespace {
+
+// emitter the way the backend sees it
+struct mock_emitter {
+    ALuint voice { audio::null_resource };
+    float audibility { 0.f };
+    bool pinned { false };
+};
+
+// device with limited number of sources, which carries out the voice changes on a list of emitters
+class mock_backend : public audio::voice_backend {
+
+public:
+// constructors
+    explicit mock_backend( int const Capacity ) :
+        m_capacity( Capacity ) {}
+// methods
+    ALuint
+        create_voice() override {
+            ++created;
+            return (
+                created <= m_capacity ?
+                    static_cast<ALuint>( created ) :
+                    audio::null_resource ); }
+    ALuint
+        virtualize( std::size_t const Emitter ) override {
+            ++virtualized;
+            auto &emitter { emitters[ Emitter ] };
+            EU07_CHECK( emitter.voice != audio::null_resource );
+            auto const voice { emitter.voice };
+            emitter.voice = audio::null_resource;
+            return voice; }
+    void
+        realize( std::size_t const Emitter, ALuint const Voice ) override {
+            ++realized;
+            auto &emitter { emitters[ Emitter ] };
+            EU07_CHECK( emitter.voice == audio::null_resource );
+            EU07_CHECK( Voice != audio::null_resource );
+            emitter.voice = Voice; }
+    // describes the emitters to the voice pool
+    std::vector<audio::voice_candidate>
+        candidates() const {
+            std::vector<audio::voice_candidate> candidates;
+            for( auto const &emitter : emitters ) {
+                candidates.push_back( { emitter.audibility, ( emitter.voice != audio::null_resource ), emitter.pinned } );
+            }
+            return candidates; }
+    // returns number of emitters holding a voice
+    int
+        voiced() const {
+            return static_cast<int>( std::count_if(
+                std::begin( emitters ), std::end( emitters ),
+                []( mock_emitter const &Emitter ) {
+                    return Emitter.voice != audio::null_resource; } ) ); }
+    // returns true if no voice is held by more than one emitter
+    bool
+        voices_unique() const {
+            std::set<ALuint> voices;
+            for( auto const &emitter : emitters ) {
+                if( ( emitter.voice != audio::null_resource )
+                 && ( false == voices.insert( emitter.voice ).second ) ) {
+                    return false;
+                }
+            }
+            return true; }
+// members
+    std::vector<mock_emitter> emitters;
+    int created { 0 }; // calls to create_voice, including failed ones
+    int virtualized { 0 };
+    int realized { 0 };
+
+private:
+    int m_capacity;
+};
+
+sound_properties
+make_properties( sound_category const Category, float const Gain, float const Soundproofing = 1.f ) {
+
+    sound_properties properties;
+    properties.category = Category;
+    properties.gain = Gain;
+    properties.soundproofing = Soundproofing;
+    return properties;
+}
+
+void
+test_audibility() {
+
+    audio::category_volumes const volumes { 0.5f, 0.8f, 0.25f };
+    auto const sound { make_properties( sound_category::vehicle, 1.f ) };
+
+    // category volume and soundproofing scale the gain
+    EU07_CHECK( audio::category_gain( sound, volumes ) == 0.5f );
+    EU07_CHECK( audio::category_gain( make_properties( sound_category::ambient, 2.f, 0.5f ), volumes ) == 0.25f );
+    EU07_CHECK( audio::category_gain( make_properties( sound_category::unknown, 0.7f ), volumes ) == 0.7f );
+    // sounds of unlimited range play at the listener
+    EU07_CHECK( audio::estimate_audibility( sound, -1.f, 1000.f, volumes ) == 0.5f );
+    // full gain within the reference distance, range / 16, quieter further away, silent past the fade out
+    EU07_CHECK( audio::estimate_audibility( sound, 160.f, 5.f, volumes ) == 0.5f );
+    auto previous { 1.f };
+    auto decreasing { true };
+    for( auto distance { 10.f }; distance < 300.f; distance += 10.f ) {
+        auto const audibility { audio::estimate_audibility( sound, 160.f, distance, volumes ) };
+        decreasing = decreasing && ( audibility <= previous );
+        previous = audibility;
+    }
+    EU07_CHECK( decreasing );
+    EU07_CHECK( audio::estimate_audibility( sound, 160.f, 160.f * 1.26f, volumes ) == 0.f );
+    // soundproofing also brings the reference distance closer
+    EU07_CHECK(
+        audio::estimate_audibility( make_properties( sound_category::vehicle, 1.f, 0.5f ), 160.f, 50.f, volumes )
+        < 0.5f * audio::estimate_audibility( sound, 160.f, 50.f, volumes ) );
+}
+
+void
+test_voice_limit() {
+
+    mock_backend backend { 100 };
+    audio::voice_pool voices { backend };
+    // emitters of increasing loudness, all starting as virtual
+    for( int idx = 0; idx < 10; ++idx ) {
+        backend.emitters.push_back( { audio::null_resource, 0.1f * ( idx + 1 ) } );
+    }
+    voices.assign( backend.candidates(), 4 );
+    EU07_CHECK( backend.voiced() == 4 );
+    EU07_CHECK( voices.count() == 4 );
+    auto loudestvoiced { true };
+    for( int idx = 6; idx < 10; ++idx ) {
+        loudestvoiced = loudestvoiced && ( backend.emitters[ idx ].voice != audio::null_resource );
+    }
+    EU07_CHECK( loudestvoiced );
+
+    // slightly louder virtual emitter doesn't take the voice away...
+    backend.emitters[ 0 ].audibility = 0.8f;
+    voices.assign( backend.candidates(), 4 );
+    EU07_CHECK( backend.emitters[ 0 ].voice == audio::null_resource );
+    EU07_CHECK( backend.virtualized == 0 );
+    // ...but clearly louder one does, and gets the released voice rather than a new one
+    backend.emitters[ 0 ].audibility = 2.f;
+    voices.assign( backend.candidates(), 4 );
+    EU07_CHECK( backend.emitters[ 0 ].voice != audio::null_resource );
+    EU07_CHECK( backend.emitters[ 6 ].voice == audio::null_resource );
+    EU07_CHECK( backend.virtualized == 1 );
+    EU07_CHECK( voices.count() == 4 );
+    EU07_CHECK( backend.voices_unique() );
+
+    // lowered limit takes voices away, raised limit brings them back
+    voices.assign( backend.candidates(), 2 );
+    EU07_CHECK( backend.voiced() == 2 );
+    voices.assign( backend.candidates(), 6 );
+    EU07_CHECK( backend.voiced() == 6 );
+    EU07_CHECK( voices.count() == 6 );
+    EU07_CHECK( backend.voices_unique() );
+}
+
+void
+test_pinned() {
+
+    mock_backend backend { 100 };
+    audio::voice_pool voices { backend };
+    for( int idx = 0; idx < 6; ++idx ) {
+        backend.emitters.push_back( { audio::null_resource, 1.f } );
+    }
+    // quiet emitter which can't be virtualized keeps its voice
+    backend.emitters.push_back( { voices.acquire( 3 ), 0.001f, true } );
+    voices.assign( backend.candidates(), 3 );
+    EU07_CHECK( backend.voiced() == 3 );
+    EU07_CHECK( backend.emitters.back().voice != audio::null_resource );
+    EU07_CHECK( backend.virtualized == 0 );
+}
+
+void
+test_device_limit() {
+
+    // the device runs out of sources before the configured limit is reached
+    mock_backend backend { 3 };
+    audio::voice_pool voices { backend };
+    for( int idx = 0; idx < 6; ++idx ) {
+        backend.emitters.push_back( { audio::null_resource, 1.f + idx } );
+    }
+    voices.assign( backend.candidates(), 8 );
+    EU07_CHECK( backend.voiced() == 3 );
+    EU07_CHECK( voices.limit() == 3 );
+    EU07_CHECK( backend.created == 4 );
+    // the pool doesn't ask the device again, and ranks the emitters within the lowered limit
+    backend.emitters[ 0 ].audibility = 100.f;
+    voices.assign( backend.candidates(), 8 );
+    EU07_CHECK( backend.created == 4 );
+    EU07_CHECK( backend.emitters[ 0 ].voice != audio::null_resource );
+    EU07_CHECK( backend.voiced() == 3 );
+    EU07_CHECK( backend.voices_unique() );
+    EU07_CHECK( voices.acquire( 8 ) == audio::null_resource );
+
+    // released sources are reused
+    auto &emitter { backend.emitters[ 0 ] };
+    auto const voice { emitter.voice };
+    voices.release( voice );
+    emitter.voice = audio::null_resource;
+    EU07_CHECK( voices.acquire( 8 ) == voice );
+    EU07_CHECK( backend.created == 4 );
+}
+
+// crowd of emitters moving around the listener. the voices go to the loudest emitters, without flipping between sounds of
+// similar loudness each update
+void
+test_crowd() {
+
+    auto const voicelimit { 32 };
+    mock_backend backend { 1000 };
+    audio::voice_pool voices { backend };
+    audio::category_volumes const volumes;
+
+    std::mt19937 generator { 11 };
+    std::uniform_real_distribution<float> position( -400.f, 400.f );
+    std::uniform_real_distribution<float> speed( -20.f, 20.f );
+    struct moving_emitter {
+        glm::vec2 location;
+        glm::vec2 velocity;
+        float range;
+    };
+    std::vector<moving_emitter> crowd;
+    for( int idx = 0; idx < 200; ++idx ) {
+        crowd.push_back( {
+            { position( generator ), position( generator ) },
+            { speed( generator ), speed( generator ) },
+            ( idx % 4 == 0 ? 250.f : 60.f ) } );
+        backend.emitters.emplace_back();
+    }
+    auto const sound { make_properties( sound_category::vehicle, 1.f ) };
+
+    auto const framecount { 60 * 20 };
+    auto const timedelta { 1.f / 60.f };
+    auto withinlimit { true };
+    auto loudestvoiced { true };
+    for( int frame = 0; frame < framecount; ++frame ) {
+        for( std::size_t idx = 0; idx < crowd.size(); ++idx ) {
+            auto &emitter { crowd[ idx ] };
+            emitter.location += emitter.velocity * timedelta;
+            backend.emitters[ idx ].audibility = audio::estimate_audibility( sound, emitter.range, glm::length( emitter.location ), volumes );
+        }
+        voices.assign( backend.candidates(), voicelimit );
+        withinlimit = withinlimit && ( backend.voiced() <= voicelimit ) && ( voices.count() <= voicelimit );
+        // any emitter clearly louder than every voiced one would have taken a voice
+        auto quietestvoiced { std::numeric_limits<float>::max() };
+        auto loudestvirtual { 0.f };
+        for( auto const &emitter : backend.emitters ) {
+            if( emitter.voice != audio::null_resource ) { quietestvoiced = std::min( quietestvoiced, emitter.audibility ); }
+            else                                        { loudestvirtual = std::max( loudestvirtual, emitter.audibility ); }
+        }
+        loudestvoiced = loudestvoiced && ( loudestvirtual <= quietestvoiced * 1.25f + 1e-6f );
+    }
+    EU07_CHECK( withinlimit );
+    EU07_CHECK( loudestvoiced );
+    EU07_CHECK( backend.voices_unique() );
+    std::cout
+        << std::fixed << std::setprecision( 2 )
+        << crowd.size() << " emitters, " << voicelimit << " voices: "
+        << static_cast<float>( backend.virtualized ) / framecount << " voices taken away per frame, "
+        << static_cast<float>( backend.realized ) / framecount << " handed out per frame" << std::endl;
+}
+
+} // anonymous
+
+int
+main() {
+
+    testing::run( "audibility estimate", test_audibility );
+    testing::run( "voice limit", test_voice_limit );
+    testing::run( "pinned emitters", test_pinned );
+    testing::run( "device limit", test_device_limit );
+    testing::run( "crowd of emitters", test_crowd );
+
+    return testing::result();
+}
@@ -0,0 +1,295 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// job system: checks ordering of dependent jobs, what waiting threads execute, exception handling, and reports how parallel_for
+// scales with the number of workers
+
+#include "stdafx.h"
+#include "jobsystem.h"
+
+#include "testing.h"
+
+namespace {
+
+// occupies a worker of the job system until released
+struct worker_gate {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool open { false };
+    int entered { 0 };
+
+    threading::job_handle
+        close( threading::job_system &Jobs ) {
+            auto job {
+                Jobs.submit(
+                    [this]() {
+                        std::unique_lock<std::mutex> lock( mutex );
+                        ++entered;
+                        condition.notify_all();
+                        condition.wait( lock, [this]() { return open; } ); } ) };
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait( lock, [&]() { return entered > 0; } );
+            return job; }
+    void
+        release() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                open = true;
+            }
+            condition.notify_all(); }
+};
+
+void
+test_dependencies() {
+
+    threading::job_system jobs;
+    jobs.start( 3 );
+
+    // chain of jobs, each depending on the previous one, and a job depending on all of them
+    std::mutex mutex;
+    std::vector<int> order;
+    std::vector<threading::job_handle> chain;
+    for( int idx = 0; idx < 50; ++idx ) {
+        chain.emplace_back(
+            jobs.submit(
+                [&, idx]() {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    order.emplace_back( idx ); },
+                { ( chain.empty() ? nullptr : chain.back() ) } ) );
+    }
+    auto sum { 0 };
+    auto const last {
+        jobs.submit(
+            [&]() {
+                sum = std::accumulate( std::begin( order ), std::end( order ), 0 ); },
+            chain ) };
+    jobs.wait( last );
+
+    std::vector<int> expected( 50 );
+    std::iota( std::begin( expected ), std::end( expected ), 0 );
+    EU07_CHECK( order == expected );
+    EU07_CHECK( sum == 49 * 50 / 2 );
+    // jobs submitted after their dependencies completed run right away
+    auto const late { jobs.submit( []() {}, chain ) };
+    jobs.wait( late );
+    EU07_CHECK( late->done() );
+}
+
+void
+test_wait_leaves_unrelated_jobs() {
+
+    threading::job_system jobs;
+    jobs.start( 1 );
+    worker_gate gate;
+    auto const gatejob { gate.close( jobs ) };
+
+    // the worker is busy, so everything below stays queued until claimed
+    std::atomic<bool> unrelatedstarted { false };
+    auto const unrelated { jobs.submit( [&]() { unrelatedstarted = true; } ) };
+    std::thread::id runner;
+    auto const dependency { jobs.submit( [&]() { runner = std::this_thread::get_id(); } ) };
+    auto const awaited { jobs.submit( []() {}, { dependency } ) };
+
+    jobs.wait( awaited );
+    EU07_CHECK( awaited->done() );
+    // the waiting thread took care of the job and its dependency, and didn't touch the other queued job
+    EU07_CHECK( runner == std::this_thread::get_id() );
+    EU07_CHECK( false == unrelatedstarted );
+
+    gate.release();
+    jobs.wait( unrelated );
+    EU07_CHECK( unrelatedstarted );
+    jobs.wait( gatejob );
+}
+
+void
+test_exceptions() {
+
+    threading::job_system jobs;
+    jobs.start( 2 );
+
+    // exception is held by the job and rethrown to the waiting thread. dependents still run
+    auto const failing { jobs.submit( []() { throw std::runtime_error( "expected failure" ); } ) };
+    std::atomic<bool> dependentran { false };
+    auto const dependent { jobs.submit( [&]() { dependentran = true; }, { failing } ) };
+    auto caught { false };
+    try {
+        jobs.wait( failing );
+    }
+    catch( std::runtime_error const &Exception ) {
+        caught = ( std::string( Exception.what() ) == "expected failure" );
+    }
+    EU07_CHECK( caught );
+    EU07_CHECK( failing->done() );
+    jobs.wait( dependent );
+    EU07_CHECK( dependentran );
+
+    // group wait completes all the jobs before it rethrows
+    std::atomic<int> completed { 0 };
+    std::vector<threading::job_handle> group;
+    for( int idx = 0; idx < 20; ++idx ) {
+        group.emplace_back(
+            jobs.submit(
+                [&, idx]() {
+                    std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+                    ++completed;
+                    if( idx == 3 ) { throw std::logic_error( "expected failure" ); } } ) );
+    }
+    caught = false;
+    try {
+        jobs.wait( group );
+    }
+    catch( std::logic_error const & ) {
+        caught = true;
+    }
+    EU07_CHECK( caught );
+    EU07_CHECK( completed == 20 );
+
+    // parallel_for stops handing out indices, and returns only after all participants are done
+    std::atomic<int> processed { 0 };
+    std::atomic<int> active { 0 };
+    caught = false;
+    try {
+        jobs.parallel_for(
+            10000,
+            [&]( std::size_t const Index ) {
+                ++active;
+                ++processed;
+                std::this_thread::sleep_for( std::chrono::microseconds( 10 ) );
+                --active;
+                if( Index == 100 ) { throw std::runtime_error( "expected failure" ); } } );
+    }
+    catch( std::runtime_error const & ) {
+        caught = true;
+    }
+    EU07_CHECK( caught );
+    EU07_CHECK( active == 0 );
+    EU07_CHECK( processed < 10000 );
+
+    jobs.stop();
+}
+
+void
+test_parallel_for() {
+
+    threading::job_system jobs;
+    jobs.start( 3 );
+
+    for( auto const count : { 0, 1, 2, 3, 7, 100, 5000 } ) {
+        std::vector<std::atomic<int>> visits( count );
+        jobs.parallel_for(
+            count,
+            [&]( std::size_t const Index ) {
+                ++visits[ Index ]; } );
+        EU07_CHECK( std::all_of(
+            std::begin( visits ), std::end( visits ),
+            []( std::atomic<int> const &Visits ) {
+                return Visits == 1; } ) );
+    }
+    // with the workers busy the calling thread processes the whole range and claims its own helpers
+    worker_gate gate;
+    std::vector<threading::job_handle> gatejobs;
+    for( int idx = 0; idx < jobs.workers(); ++idx ) {
+        gatejobs.emplace_back(
+            jobs.submit(
+                [&]() {
+                    std::unique_lock<std::mutex> lock( gate.mutex );
+                    ++gate.entered;
+                    gate.condition.notify_all();
+                    gate.condition.wait( lock, [&]() { return gate.open; } ); } ) );
+    }
+    {
+        std::unique_lock<std::mutex> lock( gate.mutex );
+        gate.condition.wait( lock, [&]() { return gate.entered == jobs.workers(); } );
+    }
+    std::atomic<int> processed { 0 };
+    jobs.parallel_for( 64, [&]( std::size_t ) { ++processed; } );
+    EU07_CHECK( processed == 64 );
+    gate.release();
+    jobs.wait( gatejobs );
+
+    jobs.stop();
+}
+
+void
+test_stop_drains_queues() {
+
+    threading::job_system jobs;
+    jobs.start( 1 );
+    worker_gate gate;
+    gate.close( jobs );
+
+    std::atomic<int> completed { 0 };
+    for( int idx = 0; idx < 10; ++idx ) {
+        jobs.submit( [&]() { ++completed; } );
+    }
+    std::thread releaser( [&]() {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+        gate.release(); } );
+    jobs.stop();
+    releaser.join();
+    EU07_CHECK( completed == 10 );
+    // without workers jobs are executed on submission
+    auto const job { jobs.submit( [&]() { ++completed; } ) };
+    EU07_CHECK( job->done() );
+    EU07_CHECK( completed == 11 );
+}
+
+// reports time taken by parallel_for over a fixed workload, for increasing number of workers
+void
+benchmark_scaling() {
+
+    auto const itemcount { 2000 };
+    // work item of roughly the size of a vehicle update
+    auto const work {
+        []( std::size_t const Index ) {
+            auto value { static_cast<double>( Index ) };
+            for( int idx = 0; idx < 5000; ++idx ) {
+                value = std::sin( value ) + 1.0;
+            }
+            return value; } };
+    std::vector<double> results( itemcount );
+
+    auto const hardwarethreads { static_cast<int>( std::max( 1u, std::thread::hardware_concurrency() ) ) };
+    std::cout << hardwarethreads << " hardware threads" << std::endl;
+    double baseline { 0.0 };
+    for( int workercount = 0; workercount <= std::max( 4, hardwarethreads ); workercount = std::max( 1, workercount * 2 ) ) {
+        threading::job_system jobs;
+        jobs.start( workercount );
+        auto const start { std::chrono::steady_clock::now() };
+        jobs.parallel_for(
+            itemcount,
+            [&]( std::size_t const Index ) {
+                results[ Index ] = work( Index ); } );
+        auto const elapsed { std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() };
+        jobs.stop();
+        if( workercount == 0 ) {
+            baseline = elapsed;
+        }
+        std::cout
+            << std::fixed << std::setprecision( 1 )
+            << workercount << " worker(s): " << elapsed << " ms, speedup " << std::setprecision( 2 ) << baseline / elapsed << "x" << std::endl;
+    }
+    EU07_CHECK( std::all_of( std::begin( results ), std::end( results ), []( double const Value ) { return Value > 0.0; } ) );
+}
+
+} // anonymous
+
+int
+main() {
+
+    testing::run( "dependencies", test_dependencies );
+    testing::run( "wait leaves unrelated jobs alone", test_wait_leaves_unrelated_jobs );
+    testing::run( "exceptions", test_exceptions );
+    testing::run( "parallel_for", test_parallel_for );
+    testing::run( "stop drains queues", test_stop_drains_queues );
+    testing::run( "parallel_for scaling", benchmark_scaling );
+
+    return testing::result();
+}
@@ -0,0 +1,244 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// background resource loader: checks the order in which requests are served, without the renderer or actual resource files
+
+#include "stdafx.h"
+#include "loadqueue.h"
+
+#include "testing.h"
+
+namespace {
+
+struct fake_resource {
+    int id { -1 };
+    bool loaded { false };
+    std::thread::id loader;
+};
+
+// records order in which the resources were loaded
+struct load_log {
+    std::mutex mutex;
+    std::vector<int> order;
+
+    void
+        load( fake_resource &Resource ) {
+            Resource.loaded = true;
+            Resource.loader = std::this_thread::get_id();
+            std::lock_guard<std::mutex> lock( mutex );
+            order.emplace_back( Resource.id ); }
+    std::size_t
+        size() {
+            std::lock_guard<std::mutex> lock( mutex );
+            return order.size(); }
+};
+
+// occupies the single worker of the job system until released, so the requests can be queued before any of them is served
+struct worker_gate {
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool open { false };
+    bool entered { false };
+
+    void
+        close() {
+            threading::jobs.submit(
+                [this]() {
+                    std::unique_lock<std::mutex> lock( mutex );
+                    entered = true;
+                    condition.notify_all();
+                    condition.wait( lock, [this]() { return open; } ); } );
+            std::unique_lock<std::mutex> lock( mutex );
+            condition.wait( lock, [this]() { return entered; } ); }
+    void
+        release() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                open = true;
+            }
+            condition.notify_all(); }
+};
+
+using queue_type = threading::load_queue<int, fake_resource>;
+
+// waits until the loader served specified number of requests
+bool
+wait_for( load_log &Log, std::size_t const Count ) {
+
+    auto const deadline { std::chrono::steady_clock::now() + std::chrono::seconds( 10 ) };
+    while( Log.size() < Count ) {
+        if( std::chrono::steady_clock::now() > deadline ) { return false; }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return true;
+}
+
+// gathers resources completed by the loader, until there's specified number of them
+queue_type::resource_sequence
+collect_all( queue_type &Queue, std::size_t const Count ) {
+
+    // the load is logged before the request is marked as completed, so some of the requests can still be in flight
+    queue_type::resource_sequence loaded;
+    auto const deadline { std::chrono::steady_clock::now() + std::chrono::seconds( 10 ) };
+    while( ( loaded.size() < Count )
+        && ( std::chrono::steady_clock::now() < deadline ) ) {
+        Queue.collect( loaded );
+        std::this_thread::yield();
+    }
+    return loaded;
+}
+
+fake_resource
+make_resource( int const Id ) {
+
+    fake_resource resource;
+    resource.id = Id;
+    return resource;
+}
+
+void
+test_priority_order() {
+
+    load_log log;
+    queue_type queue { [&]( fake_resource &Resource ) { log.load( Resource ); } };
+    worker_gate gate;
+    gate.close();
+
+    std::vector<int> priorities( 64 );
+    std::iota( std::begin( priorities ), std::end( priorities ), 0 );
+    std::shuffle( std::begin( priorities ), std::end( priorities ), std::mt19937 { 7 } );
+    for( auto const priority : priorities ) {
+        // the resource id doubles as its priority
+        queue.insert( priority, make_resource( priority ), static_cast<float>( priority ) );
+    }
+    gate.release();
+
+    EU07_CHECK( wait_for( log, priorities.size() ) );
+    EU07_CHECK( std::is_sorted( std::begin( log.order ), std::end( log.order ) ) );
+
+    auto const loaded { collect_all( queue, priorities.size() ) };
+    EU07_CHECK( loaded.size() == priorities.size() );
+    for( auto const &entry : loaded ) {
+        EU07_CHECK( entry.first == entry.second.id );
+        EU07_CHECK( entry.second.loaded );
+    }
+}
+
+void
+test_equal_priority_keeps_insertion_order() {
+
+    load_log log;
+    queue_type queue { [&]( fake_resource &Resource ) { log.load( Resource ); } };
+    worker_gate gate;
+    gate.close();
+
+    for( int id = 0; id < 32; ++id ) {
+        queue.insert( id, make_resource( id ), 5.f );
+    }
+    gate.release();
+
+    EU07_CHECK( wait_for( log, 32 ) );
+    std::vector<int> expected( 32 );
+    std::iota( std::begin( expected ), std::end( expected ), 0 );
+    EU07_CHECK( log.order == expected );
+}
+
+void
+test_reprioritize() {
+
+    load_log log;
+    queue_type queue { [&]( fake_resource &Resource ) { log.load( Resource ); } };
+    worker_gate gate;
+    gate.close();
+
+    for( int id = 0; id < 32; ++id ) {
+        queue.insert( id, make_resource( id ), static_cast<float>( id ) );
+    }
+    // the camera moved, and the requests farthest away at insertion time are now the closest
+    queue.prioritize(
+        []( int const Key, fake_resource const & ) {
+            return static_cast<float>( -Key ); } );
+    gate.release();
+
+    EU07_CHECK( wait_for( log, 32 ) );
+    EU07_CHECK( std::is_sorted( std::rbegin( log.order ), std::rend( log.order ) ) );
+}
+
+void
+test_acquire_jumps_the_queue() {
+
+    load_log log;
+    queue_type queue { [&]( fake_resource &Resource ) { log.load( Resource ); } };
+    worker_gate gate;
+    gate.close();
+
+    for( int id = 0; id < 16; ++id ) {
+        queue.insert( id, make_resource( id ), static_cast<float>( id ) );
+    }
+    // the least important request is needed right away
+    fake_resource resource;
+    EU07_CHECK( queue.acquire( 15, resource ) );
+    EU07_CHECK( resource.id == 15 );
+    EU07_CHECK( resource.loaded );
+    EU07_CHECK( resource.loader == std::this_thread::get_id() );
+    EU07_CHECK( log.order.size() == 1 );
+    // requests which aren't queued can't be acquired
+    EU07_CHECK( false == queue.acquire( 15, resource ) );
+    EU07_CHECK( false == queue.acquire( 100, resource ) );
+
+    gate.release();
+    EU07_CHECK( wait_for( log, 16 ) );
+    // the claimed request isn't loaded again by the jobs
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    EU07_CHECK( log.size() == 16 );
+    EU07_CHECK( std::count( std::begin( log.order ), std::end( log.order ), 15 ) == 1 );
+
+    auto const loaded { collect_all( queue, 15 ) };
+    EU07_CHECK( loaded.size() == 15 );
+}
+
+void
+test_stop_discards_pending() {
+
+    load_log log;
+    worker_gate gate;
+    {
+        queue_type queue { [&]( fake_resource &Resource ) { log.load( Resource ); } };
+        gate.close();
+        for( int id = 0; id < 16; ++id ) {
+            queue.insert( id, make_resource( id ), 0.f );
+        }
+        // stop waits for the jobs, so the gate has to open on its own
+        std::thread opener(
+            [&]() {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+                gate.release(); } );
+        queue.stop();
+        opener.join();
+    }
+    EU07_CHECK( log.size() == 0 );
+}
+
+} // anonymous
+
+int
+main() {
+
+    threading::jobs.start( 1 );
+
+    testing::run( "priority order", test_priority_order );
+    testing::run( "equal priority keeps insertion order", test_equal_priority_keeps_insertion_order );
+    testing::run( "reprioritize", test_reprioritize );
+    testing::run( "acquire jumps the queue", test_acquire_jumps_the_queue );
+    testing::run( "stop discards pending requests", test_stop_discards_pending );
+
+    threading::jobs.stop();
+
+    return testing::result();
+}
@@ -0,0 +1,388 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// network messages: sends messages through serialization and back, and reports size and encoding speed of recorded frames.
+// the frame statistics come from synthetic session, 60 fps with commands in some of the frames
+
+#include "stdafx.h"
+#include "network/message.h"
+#include "sn_utils.h"
+
+#include <cstring>
+
+#include "testing.h"
+
+namespace {
+
+// sends provided message through serialization and back
+template <typename Message_>
+std::shared_ptr<Message_>
+loopback( Message_ const &Message, std::size_t *Size = nullptr ) {
+
+    std::stringstream stream;
+    network::serialize_message( Message, stream );
+    if( Size != nullptr ) {
+        *Size = stream.str().size();
+    }
+    auto const result { network::deserialize_message( stream ) };
+    EU07_CHECK( result->type == Message.type );
+    EU07_CHECK( stream.peek() == EOF );
+    return std::dynamic_pointer_cast<Message_>( result );
+}
+
+// compares numbers bit for bit, so the test tells apart signed zeros and catches any rounding
+bool
+is_same( double const Left, double const Right ) {
+
+    return ( std::memcmp( &Left, &Right, sizeof( double ) ) == 0 );
+}
+
+bool
+is_same( command_data const &Left, command_data const &Right ) {
+
+    return (
+        ( Left.command == Right.command )
+     && ( Left.action == Right.action )
+     && ( is_same( Left.param1, Right.param1 ) )
+     && ( is_same( Left.param2, Right.param2 ) )
+     && ( is_same( Left.time_delta, Right.time_delta ) )
+     && ( Left.location == Right.location )
+     && ( Left.payload == Right.payload ) );
+}
+
+bool
+is_same( command_queue::commands_map const &Left, command_queue::commands_map const &Right ) {
+
+    if( Left.size() != Right.size() ) { return false; }
+    for( auto const &recipient : Left ) {
+        auto const lookup { Right.find( recipient.first ) };
+        if( lookup == Right.end() ) { return false; }
+        if( lookup->second.size() != recipient.second.size() ) { return false; }
+        for( std::size_t idx = 0; idx < recipient.second.size(); ++idx ) {
+            if( false == is_same( recipient.second[ idx ], lookup->second[ idx ] ) ) { return false; }
+        }
+    }
+    return true;
+}
+
+bool
+is_same( network::frame_info const &Left, network::frame_info const &Right ) {
+
+    return (
+        ( is_same( Left.dt, Right.dt ) )
+     && ( is_same( Left.render_dt, Right.render_dt ) )
+     && ( is_same( Left.sync, Right.sync ) )
+     && ( is_same( Left.events_origin.x, Right.events_origin.x ) )
+     && ( is_same( Left.events_origin.y, Right.events_origin.y ) )
+     && ( is_same( Left.events_origin.z, Right.events_origin.z ) )
+     && ( is_same( Left.commands, Right.commands ) ) );
+}
+
+command_data
+make_command( user_command const Command, int const Action, double const Param1, double const Param2, double const Timedelta ) {
+
+    command_data command;
+    command.command = Command;
+    command.action = Action;
+    command.param1 = Param1;
+    command.param2 = Param2;
+    command.time_delta = Timedelta;
+    command.location = glm::vec3( 0.f );
+    return command;
+}
+
+// generates frames of synthetic session: 60 fps with some jitter, commands in every tenth frame on average,
+// camera riding in the cab of the train for the most part and occasionally moved elsewhere
+std::vector<network::frame_info>
+make_session( std::size_t const Count ) {
+
+    std::mt19937 generator { 3 };
+    std::uniform_real_distribution<double> jitter( -0.002, 0.002 );
+    std::uniform_int_distribution<int> chance( 0, 9 );
+    std::uniform_int_distribution<int> command( 0, static_cast<int>( user_command::mastercontrollerincrease ) );
+
+    std::vector<network::frame_info> frames( Count );
+    double sync { 0.0 };
+    glm::dvec3 camera { 1520.25, 2.5, -3400.75 };
+    for( auto &frame : frames ) {
+        frame.dt = 1.0 / 60.0 + jitter( generator );
+        frame.render_dt = ( chance( generator ) == 0 ? frame.dt * 0.5 : frame.dt );
+        sync += frame.dt * 1000.0;
+        frame.sync = std::floor( sync );
+        camera.z += 20.0 * frame.dt;
+        if( ( chance( generator ) == 0 )
+         && ( chance( generator ) == 0 ) ) {
+            camera.x += 100.0 * jitter( generator );
+        }
+        frame.events_origin = camera;
+        if( chance( generator ) == 0 ) {
+            auto &sequence { frame.commands[ 1 + chance( generator ) % 2 ] };
+            auto const count { 1 + chance( generator ) % 3 };
+            for( int idx = 0; idx < count; ++idx ) {
+                sequence.emplace_back(
+                    make_command(
+                        static_cast<user_command>( command( generator ) ), chance( generator ) % 3,
+                        chance( generator ), ( chance( generator ) < 5 ? 0.0 : jitter( generator ) ), frame.dt * 0.5 ) );
+            }
+        }
+    }
+    return frames;
+}
+
+// size of the frame in the fixed layout used by the protocol version 2
+std::size_t
+fixed_layout_size( network::frame_info const &Frame ) {
+
+    std::size_t size { 2 + 3 * 8 + 4 };
+    for( auto const &recipient : Frame.commands ) {
+        size += 4 + 4;
+        for( auto const &command : recipient.second ) {
+            size += 4 + 4 + 3 * 8 + 3 * 4 + command.payload.size() + 1;
+        }
+    }
+    return size;
+}
+
+void
+test_hello() {
+
+    network::client_hello clienthello;
+    clienthello.version = 4;
+    clienthello.start_packet = 123456;
+    auto const client { loopback( clienthello ) };
+    EU07_CHECK( client->version == 4 );
+    EU07_CHECK( client->start_packet == 123456 );
+
+    network::server_hello serverhello;
+    serverhello.seed = 0xdeadbeef;
+    serverhello.timestamp = -5;
+    serverhello.config = 1ll << 40;
+    serverhello.scenario = "scenery/td.scn";
+    auto const server { loopback( serverhello ) };
+    EU07_CHECK( server->seed == 0xdeadbeef );
+    EU07_CHECK( server->timestamp == -5 );
+    EU07_CHECK( server->config == 1ll << 40 );
+    EU07_CHECK( server->scenario == "scenery/td.scn" );
+}
+
+void
+test_frame() {
+
+    network::frame_info frame;
+    frame.dt = 0.016;
+    frame.render_dt = 0.0;
+    frame.sync = 1234.0;
+    frame.events_origin = glm::dvec3 { -12345.678, 0.0, 1e-9 };
+    // parameters exercise both integer and floating point encoding, including values the integer encoding can't hold
+    auto &sequence { frame.commands[ 7 ] };
+    sequence.emplace_back( make_command( user_command::aidriverenable, 1, 0.0, -0.0, 0.0 ) );
+    sequence.emplace_back( make_command( user_command::jointcontrollerset, 2, 0.25, -1e300, 0.004 ) );
+    sequence.emplace_back( make_command( user_command::mastercontrollerincrease, 0, -42.0, 1e16, 0.004 ) );
+    sequence.emplace_back( make_command( user_command::aidriverdisable, 0, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::denorm_min(), 0.008 ) );
+    sequence.back().location = glm::vec3( 1.5f, -2.f, 1e6f );
+    sequence.back().payload = "vehicle name";
+    frame.commands[ 0 ].emplace_back( make_command( user_command::aidriverenable, 0, 1.0, 2.0, -0.001 ) );
+
+    auto const result { loopback( frame ) };
+    EU07_CHECK( is_same( *result, frame ) );
+
+    network::request_command request;
+    request.commands = frame.commands;
+    auto const requestresult { loopback( request ) };
+    EU07_CHECK( is_same( requestresult->commands, frame.commands ) );
+}
+
+void
+test_frame_batch() {
+
+    network::frame_batch batch;
+    batch.frames = make_session( 200 );
+    // value with all bits different from the preceding one
+    batch.frames[ 10 ].dt = -std::numeric_limits<double>::max();
+
+    auto const result { loopback( batch ) };
+    EU07_CHECK( result->frames.size() == batch.frames.size() );
+    auto matches { true };
+    for( std::size_t idx = 0; idx < std::min( result->frames.size(), batch.frames.size() ); ++idx ) {
+        matches = matches && is_same( result->frames[ idx ], batch.frames[ idx ] );
+    }
+    EU07_CHECK( matches );
+}
+
+// frames sent one after another through the same stream carry the origin only when it moved, with batches
+// in between sharing the stream state
+void
+test_frame_stream() {
+
+    auto const frames { make_session( 300 ) };
+    std::stringstream stream;
+    network::stream_context sendcontext;
+    network::frame_batch batch;
+    batch.frames.assign( std::begin( frames ) + 100, std::begin( frames ) + 150 );
+    for( std::size_t idx = 0; idx < frames.size(); ++idx ) {
+        if( ( idx >= 100 ) && ( idx < 150 ) ) {
+            if( idx == 100 ) {
+                network::serialize_message( batch, stream, sendcontext );
+            }
+            continue;
+        }
+        network::serialize_message( frames[ idx ], stream, sendcontext );
+    }
+
+    network::stream_context receivecontext;
+    std::vector<network::frame_info> received;
+    while( stream.peek() != EOF ) {
+        auto const message { network::deserialize_message( stream, receivecontext ) };
+        if( message->type == network::message::FRAME_BATCH ) {
+            auto const &batchframes { static_cast<network::frame_batch const &>( *message ).frames };
+            received.insert( std::end( received ), std::begin( batchframes ), std::end( batchframes ) );
+        }
+        else if( message->type == network::message::FRAME_INFO ) {
+            received.emplace_back( static_cast<network::frame_info const &>( *message ) );
+        }
+        else {
+            break;
+        }
+    }
+    EU07_CHECK( received.size() == frames.size() );
+    auto matches { true };
+    for( std::size_t idx = 0; idx < std::min( received.size(), frames.size() ); ++idx ) {
+        matches = matches && is_same( received[ idx ], frames[ idx ] );
+    }
+    EU07_CHECK( matches );
+
+    // repeated origin takes a single byte
+    network::frame_info frame;
+    frame.dt = frame.render_dt = frame.sync = 0.0;
+    frame.events_origin = glm::dvec3 { 100.0, 2.0, -300.0 };
+    network::stream_context context;
+    std::ostringstream first, second;
+    network::serialize_message( frame, first, context );
+    network::serialize_message( frame, second, context );
+    EU07_CHECK( second.str().size() + 3 * 8 <= first.str().size() + 1 );
+}
+
+void
+test_malformed() {
+
+    // unknown message type is reported as such
+    std::stringstream unknown;
+    sn_utils::ls_uint16( unknown, 0x7fff );
+    EU07_CHECK( network::deserialize_message( unknown )->type == network::message::TYPE_MAX );
+
+    // truncated messages end the read without running past the data, and are reported as unknown
+    network::frame_batch batch;
+    batch.frames = make_session( 50 );
+    batch.frames[ 5 ].commands[ 1 ].emplace_back( make_command( user_command::aidriverenable, 0, 1.0, 0.0, 0.0 ) );
+    batch.frames[ 5 ].commands[ 1 ].back().payload = "vehicle name";
+    std::stringstream source;
+    network::serialize_message( batch, source );
+    auto const data { source.str() };
+    auto rejected { true };
+    for( std::size_t length = 0; length < data.size(); length += 7 ) {
+        std::stringstream truncated( data.substr( 0, length ) );
+        rejected = rejected && ( network::deserialize_message( truncated )->type == network::message::TYPE_MAX );
+    }
+    EU07_CHECK( rejected );
+
+    // string without the terminator
+    network::server_hello hello;
+    hello.scenario = "scenery/td.scn";
+    std::stringstream hellosource;
+    network::serialize_message( hello, hellosource );
+    auto const hellodata { hellosource.str() };
+    std::stringstream unterminated( hellodata.substr( 0, hellodata.size() - 1 ) );
+    EU07_CHECK( network::deserialize_message( unterminated )->type == network::message::TYPE_MAX );
+
+    // element counts larger than the data end the read at the end of data
+    std::stringstream oversized;
+    sn_utils::ls_uint16( oversized, network::message::FRAME_BATCH );
+    sn_utils::s_varuint( oversized, std::numeric_limits<std::uint32_t>::max() );
+    EU07_CHECK( network::deserialize_message( oversized )->type == network::message::TYPE_MAX );
+}
+
+// reports size of the session in each encoding, and time taken to encode and decode it
+void
+benchmark_frames() {
+
+    auto const frames { make_session( 36000 ) };
+
+    std::size_t fixedsize { 0 };
+    for( auto const &frame : frames ) {
+        fixedsize += fixed_layout_size( frame );
+    }
+    std::size_t framesize { 0 };
+    {
+        // consecutive frames share the stream state, as they do on a connection
+        std::ostringstream stream;
+        network::stream_context context;
+        for( auto const &frame : frames ) {
+            network::serialize_message( frame, stream, context );
+        }
+        framesize = stream.str().size();
+    }
+    std::vector<network::frame_batch> batches;
+    for( std::size_t idx = 0; idx < frames.size(); idx += 50 ) {
+        batches.emplace_back();
+        batches.back().frames.assign(
+            std::begin( frames ) + idx,
+            std::begin( frames ) + std::min( idx + 50, frames.size() ) );
+    }
+    std::size_t batchsize { 0 };
+    for( auto const &batch : batches ) {
+        std::size_t size;
+        loopback( batch, &size );
+        batchsize += size;
+    }
+    auto const count { static_cast<double>( frames.size() ) };
+    std::cout
+        << std::fixed << std::setprecision( 1 )
+        << "bytes per frame: fixed layout " << fixedsize / count
+        << ", frame_info " << framesize / count
+        << ", frame_batch of 50 " << batchsize / count << std::endl;
+
+    std::string encoded;
+    auto const encodestart { std::chrono::steady_clock::now() };
+    {
+        std::ostringstream stream;
+        for( auto const &batch : batches ) {
+            network::serialize_message( batch, stream );
+        }
+        encoded = stream.str();
+    }
+    auto const encodeend { std::chrono::steady_clock::now() };
+    std::size_t decodedcount { 0 };
+    {
+        std::istringstream stream( encoded );
+        while( stream.peek() != EOF ) {
+            auto const message { network::deserialize_message( stream ) };
+            decodedcount += static_cast<network::frame_batch const &>( *message ).frames.size();
+        }
+    }
+    auto const decodeend { std::chrono::steady_clock::now() };
+    EU07_CHECK( decodedcount == frames.size() );
+    std::cout
+        << "encode: " << std::chrono::duration<double, std::nano>( encodeend - encodestart ).count() / count << " ns per frame, "
+        << "decode: " << std::chrono::duration<double, std::nano>( decodeend - encodeend ).count() / count << " ns per frame" << std::endl;
+}
+
+} // anonymous
+
+int
+main() {
+
+    testing::run( "hello messages", test_hello );
+    testing::run( "frame with commands", test_frame );
+    testing::run( "frame batch", test_frame_batch );
+    testing::run( "stream of frames", test_frame_stream );
+    testing::run( "malformed messages", test_malformed );
+    testing::run( "frame size and encoding speed", benchmark_frames );
+
+    return testing::result();
+}
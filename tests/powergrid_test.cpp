@@ -0,0 +1,307 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// traction power flow solver: checks solutions of synthetic networks against closed form results and a dense reference solver.
+// NOTE: this doesn't replace a run of actual scenario, the networks here are much smaller and have no real layout
+
+#include "stdafx.h"
+#include "powergrid.h"
+
+#include "testing.h"
+
+namespace {
+
+double const leakage { 1e-10 }; // matches leakage conductance used by the solver
+
+bool
+is_close( double const Left, double const Right, double const Tolerance = 1e-6 ) {
+
+    return std::abs( Left - Right ) <= Tolerance * std::max( 1.0, std::max( std::abs( Left ), std::abs( Right ) ) );
+}
+
+// description of a synthetic network, fed to both the tested solver and the reference
+struct layout {
+    struct line { int nodes[ 2 ]; double resistance; };
+    struct source { int node; double voltage; double resistance; };
+    struct load { int nodes[ 2 ]; double voltage; double current; };
+
+    int nodecount { 0 };
+    std::vector<line> lines;
+    std::vector<source> sources;
+    std::vector<load> loads;
+
+    void
+        build( powergrid::network &Network ) const {
+            Network.clear();
+            for( int idx = 0; idx < nodecount; ++idx ) {
+                Network.insert_node();
+            }
+            for( auto const &line : lines ) {
+                Network.insert_branch( line.nodes[ 0 ], line.nodes[ 1 ], line.resistance );
+            }
+            for( auto const &source : sources ) {
+                auto &supply { Network.source( Network.insert_supply( source.node ) ) };
+                supply.voltage = source.voltage;
+                supply.resistance = source.resistance;
+            }
+            Network.build(); }
+    void
+        apply_loads( powergrid::network &Network ) const {
+            for( auto const &load : loads ) {
+                Network.insert_load( load.nodes[ 0 ], load.nodes[ 1 ], load.voltage, load.current );
+            } }
+    // solves the whole network as one dense system, with gaussian elimination
+    std::vector<double>
+        reference() const {
+            auto const size { static_cast<std::size_t>( nodecount ) };
+            std::vector<std::vector<double>> matrix( size, std::vector<double>( size + 1, 0.0 ) );
+            for( std::size_t idx = 0; idx < size; ++idx ) {
+                matrix[ idx ][ idx ] = leakage;
+            }
+            for( auto const &line : lines ) {
+                auto const conductance { 1.0 / line.resistance };
+                auto const node1 { line.nodes[ 0 ] }, node2 { line.nodes[ 1 ] };
+                matrix[ node1 ][ node1 ] += conductance;
+                matrix[ node2 ][ node2 ] += conductance;
+                matrix[ node1 ][ node2 ] -= conductance;
+                matrix[ node2 ][ node1 ] -= conductance;
+            }
+            for( auto const &source : sources ) {
+                matrix[ source.node ][ source.node ] += 1.0 / source.resistance;
+                matrix[ source.node ][ size ] += source.voltage / source.resistance;
+            }
+            for( auto const &load : loads ) {
+                for( auto const node : load.nodes ) {
+                    if( load.current > 0.0 ) {
+                        matrix[ node ][ node ] += 0.5 * load.current / load.voltage;
+                    }
+                    else {
+                        matrix[ node ][ size ] -= 0.5 * load.current;
+                    }
+                }
+            }
+            for( std::size_t column = 0; column < size; ++column ) {
+                auto pivot { column };
+                for( auto row = column + 1; row < size; ++row ) {
+                    if( std::abs( matrix[ row ][ column ] ) > std::abs( matrix[ pivot ][ column ] ) ) {
+                        pivot = row;
+                    }
+                }
+                std::swap( matrix[ column ], matrix[ pivot ] );
+                for( auto row = column + 1; row < size; ++row ) {
+                    auto const ratio { matrix[ row ][ column ] / matrix[ column ][ column ] };
+                    for( auto idx = column; idx <= size; ++idx ) {
+                        matrix[ row ][ idx ] -= ratio * matrix[ column ][ idx ];
+                    }
+                }
+            }
+            std::vector<double> voltages( size );
+            for( auto row = size; row-- > 0; ) {
+                auto value { matrix[ row ][ size ] };
+                for( auto idx = row + 1; idx < size; ++idx ) {
+                    value -= matrix[ row ][ idx ] * voltages[ idx ];
+                }
+                voltages[ row ] = value / matrix[ row ][ row ];
+            }
+            return voltages; }
+};
+
+// single source feeding single load through a line, the textbook voltage divider
+void
+test_voltage_divider() {
+
+    layout grid;
+    grid.nodecount = 2;
+    grid.lines.push_back( { { 0, 1 }, 0.3 } );
+    grid.sources.push_back( { 0, 3000.0, 0.2 } );
+
+    powergrid::network network;
+    grid.build( network );
+    EU07_CHECK( network.subgrid_count() == 1 );
+    // without loads there's no voltage drop
+    EU07_CHECK( is_close( network.voltage( 1 ), 3000.0 ) );
+    EU07_CHECK( is_close( network.source( 0 ).current, 0.0, 1e-3 ) );
+    // load of 5.5 ohm, registered as current drawn at nominal voltage
+    auto const loadresistance { 5.5 };
+    network.insert_load( 1, 1, 3000.0, 3000.0 / loadresistance );
+    network.update();
+    auto const current { 3000.0 / ( 0.2 + 0.3 + loadresistance ) };
+    EU07_CHECK( is_close( network.voltage( 1 ), current * loadresistance ) );
+    EU07_CHECK( is_close( network.source( 0 ).current, current ) );
+    EU07_CHECK( is_close( network.source( 0 ).outputvoltage, 3000.0 - current * 0.2 ) );
+    // loads are registered anew in each step
+    network.update();
+    EU07_CHECK( is_close( network.voltage( 1 ), 3000.0 ) );
+}
+
+// meshed networks with multiple sources and loads, compared with the dense solution
+void
+test_meshed_network() {
+
+    std::mt19937 generator { 11 };
+    std::uniform_real_distribution<double> resistance( 0.01, 0.5 );
+    std::uniform_real_distribution<double> current( -400.0, 1500.0 );
+
+    for( int pass = 0; pass < 20; ++pass ) {
+        // two parallel tracks with ties every few spans, the usual layout of a double track line
+        layout grid;
+        auto const length { 10 + pass * 7 };
+        grid.nodecount = length * 2;
+        for( int track = 0; track < 2; ++track ) {
+            for( int idx = 0; idx + 1 < length; ++idx ) {
+                grid.lines.push_back( { { track * length + idx, track * length + idx + 1 }, resistance( generator ) } );
+            }
+        }
+        for( int idx = 0; idx < length; idx += 4 ) {
+            grid.lines.push_back( { { idx, length + idx }, 0.01 } );
+        }
+        for( int idx = 0; idx < length; idx += 15 ) {
+            grid.sources.push_back( { idx, 3300.0, 0.2 } );
+        }
+        for( int idx = 0; idx < 6; ++idx ) {
+            auto const node { static_cast<int>( generator() % ( grid.nodecount - 1 ) ) };
+            grid.loads.push_back( { { node, node + 1 }, 3000.0, current( generator ) } );
+        }
+
+        powergrid::network network;
+        grid.build( network );
+        EU07_CHECK( network.subgrid_count() == 1 );
+        grid.apply_loads( network );
+        network.update();
+
+        auto const expected { grid.reference() };
+        for( int node = 0; node < grid.nodecount; ++node ) {
+            EU07_CHECK( is_close( network.voltage( node ), expected[ node ] ) );
+        }
+        // current supplied by the sources matches the voltage drop on their internal resistance
+        for( std::size_t idx = 0; idx < grid.sources.size(); ++idx ) {
+            auto const &source { grid.sources[ idx ] };
+            EU07_CHECK( is_close(
+                network.source( static_cast<int>( idx ) ).current,
+                ( source.voltage - expected[ source.node ] ) / source.resistance,
+                1e-4 ) );
+        }
+    }
+}
+
+// recuperating vehicle pushes the voltage above nominal level of the source
+void
+test_recuperation() {
+
+    layout grid;
+    grid.nodecount = 3;
+    grid.lines.push_back( { { 0, 1 }, 0.1 } );
+    grid.lines.push_back( { { 1, 2 }, 0.1 } );
+    grid.sources.push_back( { 0, 3000.0, 0.2 } );
+    grid.loads.push_back( { { 2, 2 }, 3000.0, -200.0 } );
+
+    powergrid::network network;
+    grid.build( network );
+    grid.apply_loads( network );
+    network.update();
+
+    EU07_CHECK( is_close( network.voltage( 2 ), 3000.0 + 200.0 * ( 0.2 + 0.1 + 0.1 ) ) );
+    EU07_CHECK( is_close( network.source( 0 ).current, -200.0 ) );
+}
+
+// sub-grid without working source is dead, and comes back to life once the source recovers
+void
+test_blown_fuse() {
+
+    layout grid;
+    grid.nodecount = 2;
+    grid.lines.push_back( { { 0, 1 }, 0.3 } );
+    grid.sources.push_back( { 0, 3000.0, 0.2 } );
+
+    powergrid::network network;
+    grid.build( network );
+
+    network.source( 0 ).fuse = true;
+    network.insert_load( 1, 1, 3000.0, 30000.0 );
+    network.update();
+    EU07_CHECK( network.voltage( 0 ) == 0.0 );
+    EU07_CHECK( network.voltage( 1 ) == 0.0 );
+    EU07_CHECK( network.source( 0 ).current == 0.0 );
+    // short circuit on the dead sub-grid is reported, so the owner can hold the fuse
+    EU07_CHECK( network.source( 0 ).overloaded );
+
+    network.source( 0 ).fuse = false;
+    network.update();
+    EU07_CHECK( is_close( network.voltage( 1 ), 3000.0 ) );
+    EU07_CHECK( false == network.source( 0 ).overloaded );
+}
+
+// sub-grid which can't be solved goes without power, and is solved again once its parameters are fixed
+void
+test_failed_solution() {
+
+    layout grid;
+    grid.nodecount = 2;
+    grid.lines.push_back( { { 0, 1 }, 0.3 } );
+    // negative internal resistance makes the conductance matrix indefinite
+    grid.sources.push_back( { 0, 3000.0, -1.0 } );
+
+    powergrid::network network;
+    grid.build( network );
+    EU07_CHECK( network.voltage( 0 ) == 0.0 );
+    EU07_CHECK( network.voltage( 1 ) == 0.0 );
+    EU07_CHECK( network.source( 0 ).current == 0.0 );
+    EU07_CHECK( network.source( 0 ).outputvoltage == 0.0 );
+    // without loads or fuse changes the sub-grid is still retried
+    network.update();
+    EU07_CHECK( network.voltage( 1 ) == 0.0 );
+
+    network.source( 0 ).resistance = 0.2;
+    network.update();
+    EU07_CHECK( is_close( network.voltage( 1 ), 3000.0 ) );
+}
+
+// separate sections of the network don't affect each other
+void
+test_independent_subgrids() {
+
+    layout grid;
+    grid.nodecount = 4;
+    grid.lines.push_back( { { 0, 1 }, 0.3 } );
+    grid.lines.push_back( { { 2, 3 }, 0.3 } );
+    grid.sources.push_back( { 0, 3000.0, 0.2 } );
+    grid.sources.push_back( { 2, 600.0, 0.1 } );
+
+    powergrid::network network;
+    grid.build( network );
+    EU07_CHECK( network.subgrid_count() == 2 );
+
+    network.insert_load( 1, 1, 3000.0, 1000.0 );
+    network.update();
+    EU07_CHECK( network.voltage( 1 ) < 3000.0 );
+    EU07_CHECK( is_close( network.voltage( 3 ), 600.0 ) );
+    EU07_CHECK( is_close( network.source( 1 ).current, 0.0, 1e-3 ) );
+    // isolated node without source stays dead
+    powergrid::network isolated;
+    layout single;
+    single.nodecount = 1;
+    single.build( isolated );
+    EU07_CHECK( isolated.subgrid_count() == 1 );
+    EU07_CHECK( isolated.voltage( 0 ) == 0.0 );
+}
+
+} // anonymous
+
+int
+main() {
+
+    testing::run( "voltage divider", test_voltage_divider );
+    testing::run( "meshed network matches dense solution", test_meshed_network );
+    testing::run( "recuperation", test_recuperation );
+    testing::run( "blown fuse", test_blown_fuse );
+    testing::run( "failed solution", test_failed_solution );
+    testing::run( "independent sub-grids", test_independent_subgrids );
+
+    return testing::result();
+}
@@ -0,0 +1,40 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// log functions used by the engine code compiled into the tests. entries go straight to the console
+
+#include "stdafx.h"
+#include "Logs.h"
+
+void WriteLog( const char *str, logtype const Type ) {
+
+    if( str == nullptr ) { return; }
+    std::cout << str << "\n";
+}
+
+void WriteLog( const std::string &str, logtype const Type ) {
+
+    WriteLog( str.c_str(), Type );
+}
+
+void ErrorLog( const std::string &str, logtype const Type ) {
+
+    std::cerr << str << "\n";
+}
+
+bool FlushLogs() {
+
+    std::cout.flush();
+    return true;
+}
+
+void CloseLogs() {
+
+    FlushLogs();
+}
@@ -0,0 +1,247 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// null audio device. follows the AL rules the engine code relies on: a source stops when it plays through its queue and
+// restarts from the head of the queue, only processed buffers can be unqueued, and queued buffers can't receive new data
+
+#include "stdafx.h"
+#include "support/nullaudio.h"
+
+namespace nullaudio {
+
+namespace {
+
+struct queue_entry {
+    ALuint buffer;
+    bool processed { false };
+};
+
+struct source {
+    std::deque<queue_entry> queue;
+    std::size_t position { 0 }; // playback point in the first unprocessed buffer
+    ALint state { AL_INITIAL };
+    std::vector<std::int16_t> played;
+};
+
+struct device {
+    std::unordered_map<ALuint, std::vector<std::int16_t>> buffers;
+    std::unordered_map<ALuint, source> sources;
+    ALuint nextid { 1 };
+    int errors { 0 };
+    ALenum error { AL_NO_ERROR };
+
+    // registers invalid call
+    void
+        fail( ALenum const Error ) {
+            ++errors;
+            error = Error; }
+    // returns true if the buffer is queued in any of the sources
+    bool
+        is_queued( ALuint const Buffer ) const {
+            for( auto const &source : sources ) {
+                for( auto const &entry : source.second.queue ) {
+                    if( entry.buffer == Buffer ) { return true; }
+                }
+            }
+            return false; }
+};
+
+device Device;
+
+} // anonymous
+
+// advances playback of specified source by specified number of samples, marking buffers played through as processed
+void
+advance( ALuint const Source, std::size_t const Samplecount ) {
+
+    auto &source { Device.sources[ Source ] };
+    if( source.state != AL_PLAYING ) { return; }
+
+    auto remaining { Samplecount };
+    for( auto &entry : source.queue ) {
+        if( true == entry.processed ) { continue; }
+        auto const &data { Device.buffers[ entry.buffer ] };
+        auto const count { std::min( remaining, data.size() - source.position ) };
+        source.played.insert( std::end( source.played ), std::begin( data ) + source.position, std::begin( data ) + source.position + count );
+        source.position += count;
+        remaining -= count;
+        if( source.position < data.size() ) { return; }
+        entry.processed = true;
+        source.position = 0;
+    }
+    // played through the whole queue
+    source.state = AL_STOPPED;
+}
+
+// returns data played by specified source so far
+std::vector<std::int16_t> const &
+played( ALuint const Source ) {
+
+    return Device.sources[ Source ].played;
+}
+
+// returns number of AL calls made with invalid parameters or in invalid state
+int
+errors() {
+
+    return Device.errors;
+}
+
+} // nullaudio
+
+using nullaudio::Device;
+
+ALenum AL_APIENTRY alGetError() {
+
+    auto const error { Device.error };
+    Device.error = AL_NO_ERROR;
+    return error;
+}
+
+void AL_APIENTRY alGenBuffers( ALsizei n, ALuint *buffers ) {
+
+    for( ALsizei idx = 0; idx < n; ++idx ) {
+        buffers[ idx ] = Device.nextid++;
+        Device.buffers[ buffers[ idx ] ];
+    }
+}
+
+void AL_APIENTRY alDeleteBuffers( ALsizei n, const ALuint *buffers ) {
+
+    for( ALsizei idx = 0; idx < n; ++idx ) {
+        if( true == Device.is_queued( buffers[ idx ] ) ) {
+            Device.fail( AL_INVALID_OPERATION );
+            continue;
+        }
+        Device.buffers.erase( buffers[ idx ] );
+    }
+}
+
+void AL_APIENTRY alBufferData( ALuint bid, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq ) {
+
+    auto const lookup { Device.buffers.find( bid ) };
+    if( ( lookup == Device.buffers.end() )
+     || ( format != AL_FORMAT_MONO16 )
+     || ( freq <= 0 ) ) {
+        Device.fail( AL_INVALID_VALUE );
+        return;
+    }
+    if( true == Device.is_queued( bid ) ) {
+        Device.fail( AL_INVALID_OPERATION );
+        return;
+    }
+    auto const *samples { static_cast<std::int16_t const *>( data ) };
+    lookup->second.assign( samples, samples + size / sizeof( std::int16_t ) );
+}
+
+void AL_APIENTRY alGenSources( ALsizei n, ALuint *sources ) {
+
+    for( ALsizei idx = 0; idx < n; ++idx ) {
+        sources[ idx ] = Device.nextid++;
+        Device.sources[ sources[ idx ] ];
+    }
+}
+
+void AL_APIENTRY alDeleteSources( ALsizei n, const ALuint *sources ) {
+
+    for( ALsizei idx = 0; idx < n; ++idx ) {
+        Device.sources.erase( sources[ idx ] );
+    }
+}
+
+void AL_APIENTRY alSourceQueueBuffers( ALuint sid, ALsizei numEntries, const ALuint *bids ) {
+
+    auto &source { Device.sources[ sid ] };
+    for( ALsizei idx = 0; idx < numEntries; ++idx ) {
+        if( Device.buffers.count( bids[ idx ] ) == 0 ) {
+            Device.fail( AL_INVALID_NAME );
+            continue;
+        }
+        source.queue.push_back( { bids[ idx ] } );
+    }
+}
+
+void AL_APIENTRY alSourceUnqueueBuffers( ALuint sid, ALsizei numEntries, ALuint *bids ) {
+
+    auto &source { Device.sources[ sid ] };
+    for( ALsizei idx = 0; idx < numEntries; ++idx ) {
+        if( ( true == source.queue.empty() )
+         || ( false == source.queue.front().processed ) ) {
+            Device.fail( AL_INVALID_VALUE );
+            return;
+        }
+        bids[ idx ] = source.queue.front().buffer;
+        source.queue.pop_front();
+    }
+}
+
+void AL_APIENTRY alSourcePlay( ALuint sid ) {
+
+    auto &source { Device.sources[ sid ] };
+    if( source.state == AL_PLAYING ) { return; }
+    // stopped source starts over from the head of its queue
+    for( auto &entry : source.queue ) {
+        entry.processed = false;
+    }
+    source.position = 0;
+    source.state = (
+        source.queue.empty() ?
+            AL_STOPPED :
+            AL_PLAYING );
+}
+
+void AL_APIENTRY alSourceStop( ALuint sid ) {
+
+    auto &source { Device.sources[ sid ] };
+    for( auto &entry : source.queue ) {
+        entry.processed = true;
+    }
+    source.state = AL_STOPPED;
+}
+
+void AL_APIENTRY alSourcei( ALuint sid, ALenum param, ALint value ) {
+
+    auto &source { Device.sources[ sid ] };
+    if( ( param != AL_BUFFER )
+     || ( value != 0 ) ) {
+        // only the release of the whole queue is supported
+        Device.fail( AL_INVALID_ENUM );
+        return;
+    }
+    if( source.state == AL_PLAYING ) {
+        Device.fail( AL_INVALID_OPERATION );
+        return;
+    }
+    source.queue.clear();
+    source.position = 0;
+}
+
+void AL_APIENTRY alGetSourcei( ALuint sid, ALenum param, ALint *value ) {
+
+    auto const &source { Device.sources[ sid ] };
+    switch( param ) {
+        case AL_SOURCE_STATE: {
+            *value = source.state;
+            break; }
+        case AL_BUFFERS_QUEUED: {
+            *value = static_cast<ALint>( source.queue.size() );
+            break; }
+        case AL_BUFFERS_PROCESSED: {
+            *value = static_cast<ALint>( std::count_if(
+                std::begin( source.queue ), std::end( source.queue ),
+                []( nullaudio::queue_entry const &Entry ) {
+                    return Entry.processed; } ) );
+            break; }
+        default: {
+            Device.fail( AL_INVALID_ENUM );
+            break; }
+    }
+}
+
+//---------------------------------------------------------------------------
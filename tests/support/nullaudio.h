@@ -0,0 +1,30 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include "al.h"
+
+// null audio device, providing the part of the AL interface used by the engine code compiled into the tests.
+// there's no output, the sources move through their buffer queues when told to, and keep the data they went through
+namespace nullaudio {
+
+// advances playback of specified source by specified number of samples, marking buffers played through as processed
+void
+advance( ALuint const Source, std::size_t const Samplecount );
+// returns data played by specified source so far
+std::vector<std::int16_t> const &
+played( ALuint const Source );
+// returns number of AL calls made with invalid parameters or in invalid state
+int
+errors();
+
+} // nullaudio
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,259 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// telemetry recorder: records synthetic samples spanning several chunks, converts the recording to text and compares the result
+// with the recorded values, checks handling of damaged recordings and reports the cost of recording a sample
+
+#include "stdafx.h"
+#include "telemetry.h"
+
+#include "testing.h"
+
+namespace {
+
+std::string const recordingfile { "telemetry_test.tlm" };
+std::string const textfile { "telemetry_test.csv" };
+
+struct recorded_sample {
+    telemetry::sample sample;
+    std::string vehicle;
+    std::string command;
+};
+
+// generates samples of a few vehicles driving around, with values exercising each column type
+std::vector<recorded_sample>
+make_samples( std::size_t const Count ) {
+
+    std::mt19937 generator { 7 };
+    std::uniform_real_distribution<float> value( -1000.f, 1000.f );
+    std::uniform_int_distribution<int> position( -5, 40 );
+    std::string const vehicles[] = { "EU07-424", "ET22-911", "SM42-1001", "EN57-1800" };
+    std::string const commands[] = { "none", "SetVelocity", "ShuntVelocity", "Change_direction", "OutsideStation" };
+
+    std::vector<recorded_sample> samples( Count );
+    for( std::size_t idx = 0; idx < Count; ++idx ) {
+        auto &sample { samples[ idx ].sample };
+        sample = {};
+        sample.time = idx * 0.1;
+        sample.velocity = value( generator );
+        sample.acceleration = value( generator ) * 0.001f;
+        sample.coupler_distance = value( generator ) * 0.01f;
+        sample.coupler_force = value( generator ) * 100.f;
+        sample.traction_force = value( generator );
+        sample.friction_force = value( generator );
+        sample.brake_force = value( generator );
+        sample.brake_pressure = value( generator ) * 0.001f;
+        sample.pipe_pressure = value( generator ) * 0.001f;
+        sample.motor_current = value( generator );
+        sample.main_controller = position( generator );
+        sample.secondary_controller = position( generator );
+        sample.brake_controller = value( generator ) * 0.01f;
+        sample.local_brake = value( generator ) * 0.001f;
+        sample.direction = position( generator ) % 2;
+        sample.command_value1 = value( generator );
+        sample.command_value2 = value( generator );
+        sample.security_status = position( generator ) * 1000;
+        sample.wheelslip = position( generator ) % 2;
+        sample.engine_temperature = value( generator ) * 0.1f;
+        sample.oil_temperature = value( generator ) * 0.1f;
+        sample.water_temperature = value( generator ) * 0.1f;
+        sample.water_aux_temperature = value( generator ) * 0.1f;
+        samples[ idx ].vehicle = vehicles[ idx % std::size( vehicles ) ];
+        // new strings keep coming in later chunks, so the string table is spread across the recording
+        samples[ idx ].command = (
+            idx % 1000 == 999 ?
+                "Command" + std::to_string( idx ) :
+                commands[ ( idx / 7 ) % std::size( commands ) ] );
+    }
+    return samples;
+}
+
+// splits line of comma separated text into its fields
+std::vector<std::string>
+split( std::string const &Line ) {
+
+    std::vector<std::string> fields;
+    std::stringstream stream( Line );
+    std::string field;
+    while( std::getline( stream, field, ',' ) ) {
+        fields.emplace_back( field );
+    }
+    return fields;
+}
+
+// returns true if the text holds the value rounded to 4 decimal places the way the exporter writes it
+bool
+is_same( std::string const &Text, double const Value ) {
+
+    std::ostringstream expected;
+    expected << std::fixed << std::setprecision( 4 ) << Value;
+    return ( Text == expected.str() );
+}
+
+bool
+is_same( std::vector<std::string> const &Fields, recorded_sample const &Recorded ) {
+
+    auto const &sample { Recorded.sample };
+    return (
+        ( Fields.size() == 26 )
+     && ( is_same( Fields[ 0 ], sample.time ) )
+     && ( Fields[ 1 ] == Recorded.vehicle )
+     && ( is_same( Fields[ 2 ], sample.velocity ) )
+     && ( is_same( Fields[ 3 ], sample.acceleration ) )
+     && ( is_same( Fields[ 4 ], sample.coupler_distance ) )
+     && ( is_same( Fields[ 5 ], sample.coupler_force ) )
+     && ( is_same( Fields[ 6 ], sample.traction_force ) )
+     && ( is_same( Fields[ 7 ], sample.friction_force ) )
+     && ( is_same( Fields[ 8 ], sample.brake_force ) )
+     && ( is_same( Fields[ 9 ], sample.brake_pressure ) )
+     && ( is_same( Fields[ 10 ], sample.pipe_pressure ) )
+     && ( is_same( Fields[ 11 ], sample.motor_current ) )
+     && ( Fields[ 12 ] == std::to_string( sample.main_controller ) )
+     && ( Fields[ 13 ] == std::to_string( sample.secondary_controller ) )
+     && ( is_same( Fields[ 14 ], sample.brake_controller ) )
+     && ( is_same( Fields[ 15 ], sample.local_brake ) )
+     && ( Fields[ 16 ] == std::to_string( sample.direction ) )
+     && ( Fields[ 17 ] == Recorded.command )
+     && ( is_same( Fields[ 18 ], sample.command_value1 ) )
+     && ( is_same( Fields[ 19 ], sample.command_value2 ) )
+     && ( Fields[ 20 ] == std::to_string( sample.security_status ) )
+     && ( Fields[ 21 ] == std::to_string( sample.wheelslip ) )
+     && ( is_same( Fields[ 22 ], sample.engine_temperature ) )
+     && ( is_same( Fields[ 23 ], sample.oil_temperature ) )
+     && ( is_same( Fields[ 24 ], sample.water_temperature ) )
+     && ( is_same( Fields[ 25 ], sample.water_aux_temperature ) ) );
+}
+
+// records provided samples in the test recording file
+void
+record( std::vector<recorded_sample> const &Samples ) {
+
+    telemetry::recorder recorder;
+    EU07_CHECK( recorder.open( recordingfile ) );
+    for( auto const &recorded : Samples ) {
+        recorder.record( recorded.sample, recorded.vehicle, recorded.command );
+    }
+    recorder.close();
+}
+
+// returns lines of the converted recording
+std::vector<std::string>
+read_lines( std::string const &Filename ) {
+
+    std::vector<std::string> lines;
+    std::ifstream input( Filename );
+    std::string line;
+    while( std::getline( input, line ) ) {
+        lines.emplace_back( line );
+    }
+    return lines;
+}
+
+void
+test_roundtrip() {
+
+    // enough samples for several full chunks and a partial one
+    auto const samples { make_samples( 4096 * 3 + 123 ) };
+    record( samples );
+    EU07_CHECK( telemetry::recorder::export_as_csv( recordingfile, textfile ) );
+
+    auto const lines { read_lines( textfile ) };
+    EU07_CHECK( lines.size() == samples.size() + 1 );
+    EU07_CHECK( ( false == lines.empty() ) && ( split( lines.front() ).size() == 26 ) );
+    EU07_CHECK( ( false == lines.empty() ) && ( split( lines.front() )[ 0 ] == "Time[s]" ) );
+    auto matches { true };
+    for( std::size_t idx = 1; idx < std::min( lines.size(), samples.size() + 1 ); ++idx ) {
+        matches = matches && is_same( split( lines[ idx ] ), samples[ idx - 1 ] );
+    }
+    EU07_CHECK( matches );
+
+    // recording with no samples holds just the header
+    record( {} );
+    EU07_CHECK( telemetry::recorder::export_as_csv( recordingfile, textfile ) );
+    EU07_CHECK( read_lines( textfile ).size() == 1 );
+}
+
+void
+test_damaged_recordings() {
+
+    auto const samples { make_samples( 4096 * 2 + 10 ) };
+    record( samples );
+    std::string data;
+    {
+        std::ifstream input( recordingfile, std::ios::in | std::ios::binary );
+        data.assign( std::istreambuf_iterator<char>( input ), std::istreambuf_iterator<char>() );
+    }
+    // recording cut short in the last chunk, as left by a simulation which didn't shut down cleanly. complete chunks are kept
+    {
+        std::ofstream output( recordingfile, std::ios::out | std::ios::binary | std::ios::trunc );
+        output.write( data.data(), data.size() - 100 );
+    }
+    EU07_CHECK( telemetry::recorder::export_as_csv( recordingfile, textfile ) );
+    auto const lines { read_lines( textfile ) };
+    EU07_CHECK( lines.size() == 4096 * 2 + 1 );
+    EU07_CHECK( ( lines.size() > 1 ) && is_same( split( lines.back() ), samples[ lines.size() - 2 ] ) );
+
+    // garbage in place of a chunk marker
+    {
+        std::ofstream output( recordingfile, std::ios::out | std::ios::binary | std::ios::trunc );
+        // the second chunk starts right after the first one, which holds the strings and 4096 samples
+        auto corrupted { data };
+        corrupted.replace( data.find( "CHNK", data.find( "CHNK" ) + 1 ), 4, "junk" );
+        output.write( corrupted.data(), corrupted.size() );
+    }
+    EU07_CHECK( false == telemetry::recorder::export_as_csv( recordingfile, textfile ) );
+
+    // file of another kind
+    {
+        std::ofstream output( recordingfile, std::ios::out | std::ios::binary | std::ios::trunc );
+        output << "Time[s],Vehicle\n0.0,EU07-424\n";
+    }
+    EU07_CHECK( false == telemetry::recorder::export_as_csv( recordingfile, textfile ) );
+    // missing file
+    EU07_CHECK( false == telemetry::recorder::export_as_csv( "telemetry_test_missing.tlm", textfile ) );
+}
+
+// reports time taken by the simulation thread to record a sample, file access included for the part done by the caller
+void
+benchmark_record() {
+
+    auto const samples { make_samples( 100000 ) };
+    telemetry::recorder recorder;
+    EU07_CHECK( recorder.open( recordingfile ) );
+    auto const start { std::chrono::steady_clock::now() };
+    for( auto const &recorded : samples ) {
+        recorder.record( recorded.sample, recorded.vehicle, recorded.command );
+    }
+    auto const recorded { std::chrono::steady_clock::now() };
+    recorder.close();
+    auto const closed { std::chrono::steady_clock::now() };
+    std::cout
+        << std::fixed << std::setprecision( 1 )
+        << "record: " << std::chrono::duration<double, std::nano>( recorded - start ).count() / samples.size() << " ns per sample, "
+        << "close: " << std::chrono::duration<double, std::milli>( closed - recorded ).count() << " ms" << std::endl;
+}
+
+} // anonymous
+
+int
+main() {
+
+    // the recorder hands the file writes to the job system, like in the simulation
+    threading::jobs.start( 1 );
+
+    testing::run( "round trip", test_roundtrip );
+    testing::run( "damaged recordings", test_damaged_recordings );
+    testing::run( "recording cost", benchmark_record );
+
+    threading::jobs.stop();
+    std::remove( recordingfile.c_str() );
+    std::remove( textfile.c_str() );
+
+    return testing::result();
+}
@@ -0,0 +1,55 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// minimal test helpers. each test is an executable which reports failed checks and returns non-zero exit code if there were any
+
+namespace testing {
+
+inline int failures { 0 };
+
+// reports failed check. returns: result of the check
+inline
+bool
+check( bool const Result, char const *Condition, char const *File, int const Line ) {
+
+    if( false == Result ) {
+        ++failures;
+        std::cerr << File << ":" << Line << ": check failed: " << Condition << "\n";
+    }
+    return Result;
+}
+
+// runs provided test case, reporting its name
+template <typename Function_>
+void
+run( std::string const &Name, Function_ Test ) {
+
+    auto const failuresbefore { failures };
+    Test();
+    std::cout << ( failures == failuresbefore ? "[ ok ] " : "[fail] " ) << Name << "\n";
+}
+
+// returns: exit code of the test executable
+inline
+int
+result() {
+
+    return ( failures == 0 ? 0 : 1 );
+}
+
+} // testing
+
+#define EU07_CHECK( Condition ) testing::check( ( Condition ), #Condition, __FILE__, __LINE__ )
+
+//---------------------------------------------------------------------------
@@ -0,0 +1,231 @@
+/*
+This Source Code Form is subject to the
+terms of the Mozilla Public License, v.
+2.0. If a copy of the MPL was not
+distributed with this file, You can
+obtain one at
+http://mozilla.org/MPL/2.0/.
+*/
+
+// pantograph wire lookup: replays pantograph positions against the per-section bounding volume hierarchy and against a linear scan
+// of the section wires, checks both find the same wires and reports time taken by each.
+// usage: tractiontree_benchmark [recording [repeats]]
+// the recording is made by the simulator built with EU07_RECORD_PANTOGRAPHS defined in scene.cpp. without one, the benchmark replays
+// a synthetic run of a train along a double track line with stations
+
+#include "stdafx.h"
+#include "boundingtree.h"
+
+#include "testing.h"
+
+// stands in for the traction piece, the hierarchy only deals with pointers and bounds
+class TTraction {
+
+public:
+    glm::dvec3 pPoint1;
+    glm::dvec3 pPoint2;
+};
+
+namespace {
+
+using section_key = std::pair<double, double>; // center of the section
+
+struct section_data {
+    std::deque<TTraction> wires;
+    scene::bounding_tree<TTraction> tree;
+};
+
+struct lookup_data {
+    section_data *section;
+    glm::dvec3 point;
+    double radius;
+};
+
+struct recording {
+    std::map<section_key, section_data> sections;
+    std::vector<lookup_data> lookups;
+
+    section_data &
+        section( glm::dvec3 const &Point ) {
+            return sections[ {
+                std::floor( Point.x / 1000.0 ) * 1000.0 + 500.0,
+                std::floor( Point.z / 1000.0 ) * 1000.0 + 500.0 } ]; }
+    void
+        insert( section_data &Section, glm::dvec3 const &Point1, glm::dvec3 const &Point2 ) {
+            Section.wires.push_back( { Point1, Point2 } );
+            auto *wire { &Section.wires.back() };
+            // same margin as used by the scene
+            auto const margin { 0.001 * glm::length( Point2 - Point1 ) + 0.01 };
+            Section.tree.insert( wire, glm::min( Point1, Point2 ) - margin, glm::max( Point1, Point2 ) + margin ); }
+    // adds wire to sections enclosing its ends, the way the scene registers traction pieces
+    void
+        insert( glm::dvec3 const &Point1, glm::dvec3 const &Point2 ) {
+            auto &section1 { section( Point1 ) };
+            auto &section2 { section( Point2 ) };
+            insert( section1, Point1, Point2 );
+            if( &section2 != &section1 ) {
+                insert( section2, Point1, Point2 );
+            } }
+};
+
+// loads recording made by the simulator. returns: true on success
+bool
+load( std::string const &Filename, recording &Recording ) {
+
+    std::ifstream input( Filename );
+    if( false == input.is_open() ) { return false; }
+
+    std::set<std::tuple<double, double, double, double, double, double, double, double>> wires; // pieces with both ends in the section are recorded twice
+    std::string type;
+    section_key key;
+    while( input >> type >> key.first >> key.second ) {
+        if( type == "wire" ) {
+            glm::dvec3 point1, point2;
+            input >> point1.x >> point1.y >> point1.z >> point2.x >> point2.y >> point2.z;
+            if( true == wires.emplace( key.first, key.second, point1.x, point1.y, point1.z, point2.x, point2.y, point2.z ).second ) {
+                Recording.insert( Recording.sections[ key ], point1, point2 );
+            }
+        }
+        else if( type == "lookup" ) {
+            lookup_data lookup;
+            input >> lookup.point.x >> lookup.point.y >> lookup.point.z >> lookup.radius;
+            lookup.section = &Recording.sections[ key ];
+            Recording.lookups.emplace_back( lookup );
+        }
+        else {
+            return false;
+        }
+    }
+    return ( false == Recording.lookups.empty() );
+}
+
+// generates run of two-pantograph train along 30 km double track line, with 8-track stations every 5 km
+void
+synthesize( recording &Recording ) {
+
+    auto const length { 30000.0 };
+    auto const spanlength { 50.0 };
+    auto const wireheight { 5.6 };
+    // gentle curve, so the route crosses sections diagonally
+    auto const route {
+        []( double const Distance, double const Offset ) {
+            auto const angle { Distance / 20000.0 };
+            auto const radius { 20000.0 + Offset };
+            return glm::dvec3 { radius * std::sin( angle ), 0.0, 20000.0 - radius * std::cos( angle ) }; } };
+
+    for( double distance = 0.0; distance < length; distance += spanlength ) {
+        auto const isstation { std::fmod( distance, 5000.0 ) < 600.0 };
+        auto const trackcount { ( isstation ? 8 : 2 ) };
+        auto const zigzag { ( static_cast<int>( distance / spanlength ) % 2 == 0 ? 0.2 : -0.2 ) };
+        for( int track = 0; track < trackcount; ++track ) {
+            auto const offset { ( track - 0.5 * ( trackcount - 1 ) ) * 4.5 };
+            auto const point1 { route( distance, offset + zigzag ) + glm::dvec3 { 0.0, wireheight, 0.0 } };
+            auto const point2 { route( distance + spanlength, offset - zigzag ) + glm::dvec3 { 0.0, wireheight, 0.0 } };
+            Recording.insert( point1, point2 );
+            if( true == isstation ) {
+                // catenary supports across the station tracks
+                Recording.insert( point1 + glm::dvec3 { 0.0, 1.5, 0.0 }, point1 + glm::dvec3 { 0.0, 1.5, 4.5 } );
+            }
+        }
+    }
+    // 100 km/h, sampled at 60 fps
+    auto const step { 27.8 / 60.0 };
+    for( double distance = 0.0; distance < length - 100.0; distance += step ) {
+        for( auto const pantographoffset : { 10.0, 60.0 } ) {
+            auto const point { route( distance + pantographoffset, -2.25 ) + glm::dvec3 { 0.0, 4.5, 0.0 } };
+            Recording.lookups.push_back( { &Recording.section( point ), point, 4.6 } );
+        }
+    }
+}
+
+// finds wires within lookup area by testing all wires of the section
+std::vector<TTraction *> const &
+scan( lookup_data const &Lookup, std::vector<TTraction *> &Found ) {
+
+    Found.clear();
+    auto const min { Lookup.point - Lookup.radius };
+    auto const max { Lookup.point + Lookup.radius };
+    for( auto &wire : Lookup.section->wires ) {
+        auto const margin { 0.001 * glm::length( wire.pPoint2 - wire.pPoint1 ) + 0.01 };
+        auto const wiremin { glm::min( wire.pPoint1, wire.pPoint2 ) - margin };
+        auto const wiremax { glm::max( wire.pPoint1, wire.pPoint2 ) + margin };
+        if( ( wiremin.x <= max.x ) && ( wiremax.x >= min.x )
+         && ( wiremin.y <= max.y ) && ( wiremax.y >= min.y )
+         && ( wiremin.z <= max.z ) && ( wiremax.z >= min.z ) ) {
+            Found.emplace_back( &wire );
+        }
+    }
+    return Found;
+}
+
+} // anonymous
+
+int
+main( int argc, char *argv[] ) {
+
+    recording replay;
+    if( argc > 1 ) {
+        if( false == load( argv[ 1 ], replay ) ) {
+            std::cerr << "Failed to load pantograph recording \"" << argv[ 1 ] << "\"" << std::endl;
+            return 1;
+        }
+    }
+    else {
+        synthesize( replay );
+    }
+    auto const repeats { ( argc > 2 ? std::max( 1, std::atoi( argv[ 2 ] ) ) : 3 ) };
+
+    std::size_t wirecount { 0 };
+    for( auto const &section : replay.sections ) {
+        wirecount += section.second.wires.size();
+    }
+    std::cout << replay.lookups.size() << " lookups, " << wirecount << " wires in " << replay.sections.size() << " sections" << std::endl;
+
+    testing::run(
+        "hierarchy finds the same wires as linear scan",
+        [&]() {
+            std::vector<TTraction *> expected;
+            std::size_t mismatches { 0 };
+            for( auto const &lookup : replay.lookups ) {
+                auto found { lookup.section->tree.find( lookup.point, lookup.radius ) };
+                scan( lookup, expected );
+                std::sort( std::begin( found ), std::end( found ) );
+                std::sort( std::begin( expected ), std::end( expected ) );
+                if( found != expected ) {
+                    ++mismatches;
+                }
+            }
+            EU07_CHECK( mismatches == 0 ); } );
+
+    // the sum of found wires keeps the compiler from discarding the lookups
+    auto const measure {
+        [&]( std::string const &Name, std::function<std::size_t( lookup_data const & )> const &Lookup ) {
+            std::size_t found { 0 };
+            auto const start { std::chrono::steady_clock::now() };
+            for( int repeat = 0; repeat < repeats; ++repeat ) {
+                for( auto const &lookup : replay.lookups ) {
+                    found += Lookup( lookup );
+                }
+            }
+            auto const elapsed { std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - start ).count() };
+            auto const perlookup { elapsed / ( replay.lookups.size() * repeats ) };
+            std::cout
+                << Name << ": " << std::fixed << std::setprecision( 1 ) << perlookup << " ns per lookup, "
+                << std::setprecision( 2 ) << static_cast<double>( found ) / ( replay.lookups.size() * repeats ) << " wires found on average" << std::endl;
+            return perlookup; } };
+
+    std::vector<TTraction *> scratchpad;
+    auto const treetime {
+        measure(
+            "hierarchy",
+            []( lookup_data const &Lookup ) {
+                return Lookup.section->tree.find( Lookup.point, Lookup.radius ).size(); } ) };
+    auto const scantime {
+        measure(
+            "linear scan",
+            [&]( lookup_data const &Lookup ) {
+                return scan( Lookup, scratchpad ).size(); } ) };
+    std::cout << "speedup: " << std::setprecision( 1 ) << scantime / treetime << "x" << std::endl;
+
+    return testing::result();
+}
@@ -17,6 +17,8 @@ Copyright (C) 2007-2014 Maciej Cierniak
 #include <sys/stat.h>
 #ifndef WIN32
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 #ifdef WIN32
@@ -404,6 +406,84 @@ last_modified( std::string const &Filename ) {
     else                                             { return 0; }
 }
 
+mapped_buffer::~mapped_buffer() {
+
+#ifdef _WIN32
+    if( mappedview != nullptr ) { ::UnmapViewOfFile( mappedview ); }
+#else
+    if( mappedview != nullptr ) { ::munmap( mappedview, size ); }
+#endif
+}
+
+bool
+mapped_buffer::map( std::string const &Filename ) {
+
+    // NOTE: the view remains valid after its file and mapping handles are closed, so we don't hold them.
+    // many buffers can be kept around at once, e.g. by the parser preload cache, and each open handle counts towards the process limit
+#ifdef _WIN32
+    auto const file { ::CreateFileA( Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr ) };
+    if( file == INVALID_HANDLE_VALUE ) { return false; }
+    LARGE_INTEGER filesize;
+    if( FALSE == ::GetFileSizeEx( file, &filesize ) ) {
+        ::CloseHandle( file );
+        return false;
+    }
+    if( filesize.QuadPart == 0 ) {
+        // empty files can't be mapped, but they're still valid input
+        ::CloseHandle( file );
+        return true;
+    }
+    auto const mapping { ::CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr ) };
+    if( mapping != nullptr ) {
+        mappedview = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        ::CloseHandle( mapping );
+    }
+    ::CloseHandle( file );
+    if( mappedview != nullptr ) {
+        data = static_cast<char const *>( mappedview );
+        size = static_cast<std::size_t>( filesize.QuadPart );
+        return true;
+    }
+#else
+    auto const file { ::open( Filename.c_str(), O_RDONLY ) };
+    if( file == -1 ) { return false; }
+    struct stat filestats;
+    if( ( ::fstat( file, &filestats ) != 0 )
+     || ( false == S_ISREG( filestats.st_mode ) ) ) {
+        ::close( file );
+        return false;
+    }
+    if( filestats.st_size == 0 ) {
+        // empty files can't be mapped, but they're still valid input
+        ::close( file );
+        return true;
+    }
+    auto *const view { ::mmap( nullptr, filestats.st_size, PROT_READ, MAP_PRIVATE, file, 0 ) };
+    ::close( file );
+    if( view != MAP_FAILED ) {
+        ::madvise( view, filestats.st_size, MADV_SEQUENTIAL );
+        mappedview = view;
+        data = static_cast<char const *>( mappedview );
+        size = static_cast<std::size_t>( filestats.st_size );
+        return true;
+    }
+#endif
+    // mapping failed, fall back on a regular read
+    std::ifstream input( Filename, std::ios_base::binary );
+    if( false == input.is_open() ) { return false; }
+    assign( { std::istreambuf_iterator<char>( input ), std::istreambuf_iterator<char>() } );
+    return true;
+}
+
+void
+mapped_buffer::assign( std::string const &Text ) {
+
+    text = Text;
+    data = text.data();
+    size = text.size();
+    valid = true;
+}
+
 // potentially erases file extension from provided file name. returns: true if extension was removed, false otherwise
 bool
 erase_extension( std::string &Filename ) {
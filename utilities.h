@@ -201,6 +201,32 @@ std::pair<std::string, std::string> FileExists( std::vector<std::string> const &
 // returns time of last modification for specified file
 std::time_t last_modified( std::string const &Filename );
 
+// read-only data buffer, either memory-mapped content of a file or owned copy of provided text
+struct mapped_buffer {
+// constructors
+    mapped_buffer() = default;
+    mapped_buffer( mapped_buffer const & ) = delete;
+    mapped_buffer & operator=( mapped_buffer const & ) = delete;
+// destructor
+    ~mapped_buffer();
+// methods
+    // attaches content of specified file. returns: true on success, false otherwise
+    bool
+        map( std::string const &Filename );
+    // attaches copy of provided text
+    void
+        assign( std::string const &Text );
+    std::string_view
+        view() const {
+            return { data, size }; }
+// members
+    bool valid { false }; // set if the source data was attached successfully
+    std::string text; // owned content, used for text data and as a fallback if the file can't be mapped
+    char const *data { nullptr };
+    std::size_t size { 0 };
+    void *mappedview { nullptr }; // the view keeps the file content available, file handles are closed once it's created
+};
+
 // potentially erases file extension from provided file name. returns: true if extension was removed, false otherwise
 bool
 erase_extension( std::string &Filename );
@@ -380,8 +406,8 @@ void
 deserialize_map( MapType_ &Map, cParser &Input ) {
 
     while( Input.ok() && !Input.eof() ) {
-        auto const key { Input.getToken<typename MapType_::key_type>( false ) };
-        auto const value { Input.getToken<typename MapType_::mapped_type>( false, "\n" ) };
+        auto const key { Input.template getToken<typename MapType_::key_type>( false ) };
+        auto const value { Input.template getToken<typename MapType_::mapped_type>( false, "\n" ) };
         Map.emplace( key, value );
     }
 }
@@ -1,12 +1,16 @@
 #include "stdafx.h"
 #include "messaging.h"
 #include "utilities.h"
+#include "Logs.h"
 
 #pragma warning (disable: 4091)
 #include <dbghelp.h>
 
 LONG CALLBACK unhandled_handler(::EXCEPTION_POINTERS* e)
 {
+	// get pending log entries on the disk before anything else can go wrong
+	FlushLogs();
+
 	auto hDbgHelp = ::LoadLibraryA("dbghelp");
 	if (hDbgHelp == nullptr)
 		return EXCEPTION_CONTINUE_SEARCH;